@@ -28,10 +28,28 @@ static isr_table_entry_t irq_vector_table[N_IRQS] = { { 0 } };
 
 static int currently_running_irq = -1;
 
+#ifdef CONFIG_PROFILER
+static void *interrupted_frame;
+
+/**
+ * Frame record of the outermost posix_irq_handler() call in progress. As
+ * interrupts are handled in the context of the interrupted thread, it links
+ * to the frames of the interrupted code when frame pointers are used.
+ */
+void *posix_irq_interrupted_frame(void)
+{
+	return interrupted_frame;
+}
+#endif
+
 static inline void vector_to_irq(int irq_nbr, int *may_swap)
 {
 	sys_trace_isr_enter();
 
+#ifdef CONFIG_IRQ_RUNTIME_STATS
+	z_irq_runtime_stats_enter(irq_nbr);
+#endif
+
 	if (irq_vector_table[irq_nbr].func == NULL) { /* LCOV_EXCL_BR_LINE */
 		/* LCOV_EXCL_START */
 		posix_print_error_and_exit("Received irq %i without a "
@@ -52,6 +70,10 @@ static inline void vector_to_irq(int irq_nbr, int *may_swap)
 		}
 	}
 
+#ifdef CONFIG_IRQ_RUNTIME_STATS
+	z_irq_runtime_stats_exit(irq_nbr);
+#endif
+
 	sys_trace_isr_exit();
 }
 
@@ -78,6 +100,9 @@ void posix_irq_handler(void)
 
 	if (_kernel.cpus[0].nested == 0) {
 		may_swap = 0;
+#ifdef CONFIG_PROFILER
+		interrupted_frame = __builtin_frame_address(0);
+#endif
 	}
 
 	_kernel.cpus[0].nested++;
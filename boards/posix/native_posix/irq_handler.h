@@ -17,6 +17,7 @@ extern "C" {
 void posix_irq_handler_im_from_sw(void);
 void posix_sw_set_pending_IRQ(unsigned int IRQn);
 void posix_sw_clear_pending_IRQ(unsigned int IRQn);
+void *posix_irq_interrupted_frame(void);
 
 
 #ifdef __cplusplus
@@ -8,13 +8,19 @@
 
 #include <device.h>
 #include <drivers/flash.h>
+#include <drivers/flash/flash_simulator.h>
 #include <init.h>
 #include <kernel.h>
 #include <sys/util.h>
 #include <random/rand32.h>
 #include <stats/stats.h>
+#include <stdlib.h>
 #include <string.h>
 
+#ifdef CONFIG_FLASH_SIMULATOR_SHELL
+#include <shell/shell.h>
+#endif
+
 #ifdef CONFIG_ARCH_POSIX
 
 #include <unistd.h>
@@ -66,11 +72,19 @@
 /* increment a unit erase cycles counter */
 #define ERASE_CYCLES_INC(U)						     \
 	do {								     \
-		if (U < STATS_PAGE_COUNT_THRESHOLD) {			     \
+		if (U < FLASH_SIMULATOR_FLASH_PAGE_COUNT) {		     \
 			(*(&flash_sim_stats.erase_cycles_unit0 + (U)) += 1); \
 		}							     \
 	} while (0)
 
+/* increment a unit dirty reads counter */
+#define DIRTY_READS_INC(U)						     \
+	do {								     \
+		if (U < FLASH_SIMULATOR_FLASH_PAGE_COUNT) {		     \
+			(*(&flash_sim_stats.dirty_read_unit0 + (U)) += 1);   \
+		}							     \
+	} while (0)
+
 #if (defined(CONFIG_STATS) && \
      (CONFIG_FLASH_SIMULATOR_STAT_PAGE_COUNT > STATS_PAGE_COUNT_THRESHOLD))
        /* Limitation above is caused by used UTIL_REPEAT                    */
@@ -92,6 +106,8 @@ STATS_SECT_ENTRY32(flash_write_calls)   /* calls to flash_write() */
 STATS_SECT_ENTRY32(flash_write_time_us) /* time spent in flash_write() */
 STATS_SECT_ENTRY32(flash_erase_calls)   /* calls to flash_erase() */
 STATS_SECT_ENTRY32(flash_erase_time_us) /* time spent in flash_erase() */
+STATS_SECT_ENTRY32(max_erase_cycles)    /* highest unit erase cycles count */
+STATS_SECT_ENTRY32(worn_units)          /* num. of units past endurance */
 /* -- per-unit statistics -- */
 /* erase cycle count for unit */
 UTIL_EVAL(UTIL_REPEAT(FLASH_SIMULATOR_FLASH_PAGE_COUNT, STATS_SECT_EC))
@@ -110,6 +126,8 @@ STATS_NAME(flash_sim_stats, flash_write_calls)
 STATS_NAME(flash_sim_stats, flash_write_time_us)
 STATS_NAME(flash_sim_stats, flash_erase_calls)
 STATS_NAME(flash_sim_stats, flash_erase_time_us)
+STATS_NAME(flash_sim_stats, max_erase_cycles)
+STATS_NAME(flash_sim_stats, worn_units)
 UTIL_EVAL(UTIL_REPEAT(FLASH_SIMULATOR_FLASH_PAGE_COUNT, STATS_NAME_EC))
 UTIL_EVAL(UTIL_REPEAT(FLASH_SIMULATOR_FLASH_PAGE_COUNT, STATS_NAME_DIRTYR))
 STATS_NAME_END(flash_sim_stats);
@@ -139,6 +157,50 @@ static uint8_t mock_flash[FLASH_SIMULATOR_FLASH_SIZE];
 
 static bool write_protection;
 
+/* erase cycles count of each unit, including those without statistics */
+static uint32_t unit_erase_cycles[FLASH_SIMULATOR_PAGE_COUNT];
+
+#ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
+
+#define READ_TIME_US(len) (CONFIG_FLASH_SIMULATOR_MIN_READ_TIME_US +	    \
+	(uint32_t)(((uint64_t)(len) *					    \
+		    CONFIG_FLASH_SIMULATOR_READ_TIME_NS_PER_BYTE) /	    \
+		   NSEC_PER_USEC))
+
+#define WRITE_TIME_US(len) (CONFIG_FLASH_SIMULATOR_MIN_WRITE_TIME_US +	    \
+	(uint32_t)(((uint64_t)(len) *					    \
+		    CONFIG_FLASH_SIMULATOR_WRITE_TIME_NS_PER_BYTE) /	    \
+		   NSEC_PER_USEC))
+
+#define ERASE_TIME_US(units) (CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US +   \
+	(units) * CONFIG_FLASH_SIMULATOR_ERASE_TIME_US_PER_UNIT)
+
+#ifdef CONFIG_FLASH_SIMULATOR_TIMING_SLEEP
+/* the device is busy with one operation at a time */
+static K_MUTEX_DEFINE(flash_sim_busy);
+#endif
+
+/* wait for the time the simulated operation takes */
+static void flash_sim_wait(uint32_t time_us)
+{
+	if (time_us == 0U) {
+		return;
+	}
+
+#ifdef CONFIG_FLASH_SIMULATOR_TIMING_SLEEP
+	if (!k_is_in_isr()) {
+		k_mutex_lock(&flash_sim_busy, K_FOREVER);
+		k_sleep(K_USEC(time_us));
+		k_mutex_unlock(&flash_sim_busy);
+		return;
+	}
+#endif
+
+	k_busy_wait(time_us);
+}
+
+#endif /* CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING */
+
 static const struct flash_driver_api flash_sim_api;
 
 static const struct flash_parameters flash_sim_parameters = {
@@ -172,6 +234,26 @@ static bool flash_wp_is_set(void)
 	return write_protection;
 }
 
+/* count the reads of units erased more than their endurance */
+static void worn_units_read(const off_t offset, const size_t len)
+{
+	uint32_t unit = (offset - FLASH_SIMULATOR_BASE_OFFSET) /
+			FLASH_SIMULATOR_ERASE_UNIT;
+	uint32_t last = (offset - FLASH_SIMULATOR_BASE_OFFSET + len - 1) /
+			FLASH_SIMULATOR_ERASE_UNIT;
+
+	if ((CONFIG_FLASH_SIMULATOR_ENDURANCE == 0) || (len == 0)) {
+		return;
+	}
+
+	for (; unit <= last; unit++) {
+		if (unit_erase_cycles[unit] >
+		    CONFIG_FLASH_SIMULATOR_ENDURANCE) {
+			DIRTY_READS_INC(unit);
+		}
+	}
+}
+
 static int flash_sim_read(const struct device *dev, const off_t offset,
 			  void *data,
 			  const size_t len)
@@ -193,11 +275,11 @@ static int flash_sim_read(const struct device *dev, const off_t offset,
 
 	memcpy(data, FLASH(offset), len);
 	STATS_INCN(flash_sim_stats, bytes_read, len);
+	worn_units_read(offset, len);
 
 #ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
-	k_busy_wait(CONFIG_FLASH_SIMULATOR_MIN_READ_TIME_US);
-	STATS_INCN(flash_sim_stats, flash_read_time_us,
-		   CONFIG_FLASH_SIMULATOR_MIN_READ_TIME_US);
+	flash_sim_wait(READ_TIME_US(len));
+	STATS_INCN(flash_sim_stats, flash_read_time_us, READ_TIME_US(len));
 #endif
 
 	return 0;
@@ -270,9 +352,8 @@ static int flash_sim_write(const struct device *dev, const off_t offset,
 
 #ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
 	/* wait before returning */
-	k_busy_wait(CONFIG_FLASH_SIMULATOR_MIN_WRITE_TIME_US);
-	STATS_INCN(flash_sim_stats, flash_write_time_us,
-		   CONFIG_FLASH_SIMULATOR_MIN_WRITE_TIME_US);
+	flash_sim_wait(WRITE_TIME_US(len));
+	STATS_INCN(flash_sim_stats, flash_write_time_us, WRITE_TIME_US(len));
 #endif
 
 	return 0;
@@ -288,6 +369,23 @@ static void unit_erase(const uint32_t unit)
 	       FLASH_SIMULATOR_ERASE_UNIT);
 }
 
+/* account an erase cycle of a unit */
+static void unit_wear(const uint32_t unit)
+{
+	ERASE_CYCLES_INC(unit);
+	unit_erase_cycles[unit]++;
+
+	if (unit_erase_cycles[unit] > flash_sim_stats.max_erase_cycles) {
+		flash_sim_stats.max_erase_cycles = unit_erase_cycles[unit];
+	}
+
+	if ((CONFIG_FLASH_SIMULATOR_ENDURANCE != 0) &&
+	    (unit_erase_cycles[unit] ==
+	     CONFIG_FLASH_SIMULATOR_ENDURANCE + 1)) {
+		STATS_INC(flash_sim_stats, worn_units);
+	}
+}
+
 static int flash_sim_erase(const struct device *dev, const off_t offset,
 			   const size_t len)
 {
@@ -322,15 +420,15 @@ static int flash_sim_erase(const struct device *dev, const off_t offset,
 
 	/* erase as many units as necessary and increase their erase counter */
 	for (uint32_t i = 0; i < len / FLASH_SIMULATOR_ERASE_UNIT; i++) {
-		ERASE_CYCLES_INC(unit_start + i);
+		unit_wear(unit_start + i);
 		unit_erase(unit_start + i);
 	}
 
 #ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
 	/* wait before returning */
-	k_busy_wait(CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US);
+	flash_sim_wait(ERASE_TIME_US(len / FLASH_SIMULATOR_ERASE_UNIT));
 	STATS_INCN(flash_sim_stats, flash_erase_time_us,
-		   CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US);
+		   ERASE_TIME_US(len / FLASH_SIMULATOR_ERASE_UNIT));
 #endif
 
 	return 0;
@@ -370,6 +468,53 @@ static const struct flash_driver_api flash_sim_api = {
 #endif
 };
 
+int flash_simulator_erase_cycles_get(const struct device *dev, off_t offset,
+				     uint32_t *erase_cycles)
+{
+	if (!flash_range_is_valid(dev, offset, 1)) {
+		return -EINVAL;
+	}
+
+	*erase_cycles = unit_erase_cycles[(offset -
+					   FLASH_SIMULATOR_BASE_OFFSET) /
+					  FLASH_SIMULATOR_ERASE_UNIT];
+
+	return 0;
+}
+
+void flash_simulator_wear_get(const struct device *dev,
+			      struct flash_simulator_wear *wear)
+{
+	ARG_UNUSED(dev);
+
+	wear->min_erase_cycles = UINT32_MAX;
+	wear->max_erase_cycles = 0U;
+	wear->total_erase_cycles = 0U;
+	wear->worn_units = 0U;
+	wear->unit_count = FLASH_SIMULATOR_PAGE_COUNT;
+
+	for (uint32_t i = 0; i < FLASH_SIMULATOR_PAGE_COUNT; i++) {
+		wear->min_erase_cycles = MIN(wear->min_erase_cycles,
+					     unit_erase_cycles[i]);
+		wear->max_erase_cycles = MAX(wear->max_erase_cycles,
+					     unit_erase_cycles[i]);
+		wear->total_erase_cycles += unit_erase_cycles[i];
+
+		if ((CONFIG_FLASH_SIMULATOR_ENDURANCE != 0) &&
+		    (unit_erase_cycles[i] > CONFIG_FLASH_SIMULATOR_ENDURANCE)) {
+			wear->worn_units++;
+		}
+	}
+}
+
+void flash_simulator_stats_reset(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	stats_reset(&flash_sim_stats.s_hdr);
+	memset(unit_erase_cycles, 0, sizeof(unit_erase_cycles));
+}
+
 #ifdef CONFIG_ARCH_POSIX
 
 static int flash_mock_init(const struct device *dev)
@@ -480,3 +625,83 @@ NATIVE_TASK(flash_native_posix_options, PRE_BOOT_1, 1);
 NATIVE_TASK(flash_native_posix_cleanup, ON_EXIT, 1);
 
 #endif /* CONFIG_ARCH_POSIX */
+
+#ifdef CONFIG_FLASH_SIMULATOR_SHELL
+
+static int cmd_stats(const struct shell *shell, size_t argc, char **argv)
+{
+	shell_print(shell, "read:  %u calls, %u bytes, %u us",
+		    flash_sim_stats.flash_read_calls,
+		    flash_sim_stats.bytes_read,
+		    flash_sim_stats.flash_read_time_us);
+	shell_print(shell, "write: %u calls, %u bytes, %u us, "
+		    "%u double writes",
+		    flash_sim_stats.flash_write_calls,
+		    flash_sim_stats.bytes_written,
+		    flash_sim_stats.flash_write_time_us,
+		    flash_sim_stats.double_writes);
+	shell_print(shell, "erase: %u calls, %u us",
+		    flash_sim_stats.flash_erase_calls,
+		    flash_sim_stats.flash_erase_time_us);
+
+	return 0;
+}
+
+static int cmd_wear(const struct shell *shell, size_t argc, char **argv)
+{
+	struct flash_simulator_wear wear;
+	unsigned long first = 0, count = 0;
+
+	flash_simulator_wear_get(NULL, &wear);
+
+	shell_print(shell, "%u units of %u bytes, erase cycles min %u, "
+		    "max %u, total %u, %u units past %u cycles",
+		    wear.unit_count, (uint32_t)FLASH_SIMULATOR_ERASE_UNIT,
+		    wear.min_erase_cycles, wear.max_erase_cycles,
+		    wear.total_erase_cycles, wear.worn_units,
+		    CONFIG_FLASH_SIMULATOR_ENDURANCE);
+
+	if (argc > 1) {
+		first = strtoul(argv[1], NULL, 0);
+		count = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+	}
+
+	if (first >= FLASH_SIMULATOR_PAGE_COUNT) {
+		shell_error(shell, "Unit out of range.");
+		return -EINVAL;
+	}
+
+	count = MIN(count, FLASH_SIMULATOR_PAGE_COUNT - first);
+
+	for (unsigned long i = first; i < first + count; i++) {
+		shell_print(shell, "unit %lu (0x%08lx): %u", i,
+			    (unsigned long)FLASH_SIMULATOR_BASE_OFFSET +
+			    i * FLASH_SIMULATOR_ERASE_UNIT,
+			    unit_erase_cycles[i]);
+	}
+
+	return 0;
+}
+
+static int cmd_reset(const struct shell *shell, size_t argc, char **argv)
+{
+	flash_simulator_stats_reset(NULL);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(flash_sim_cmds,
+	SHELL_CMD_ARG(stats, NULL, "Print the operation statistics",
+		      cmd_stats, 1, 0),
+	SHELL_CMD_ARG(wear, NULL,
+		      "[<first unit> [<unit count>]] Print the erase cycles",
+		      cmd_wear, 1, 2),
+	SHELL_CMD_ARG(reset, NULL, "Reset the statistics and erase cycles",
+		      cmd_reset, 1, 0),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(flash_sim, &flash_sim_cmds, "Flash simulator commands",
+		   NULL);
+
+#endif /* CONFIG_FLASH_SIMULATOR_SHELL */
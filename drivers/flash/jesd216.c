@@ -286,3 +286,46 @@ int jesd216_bfp_decode_dw14(const struct jesd216_param_header *php,
 
 	return 0;
 }
+
+int jesd216_bfp_decode_suspend(const struct jesd216_param_header *php,
+			       const struct jesd216_bfp *bfp,
+			       struct jesd216_bfp_suspend *res)
+{
+	/* DW12 and DW13 introduced in JESD216A */
+	if (php->len_dw < 13) {
+		return -ENOTSUP;
+	}
+
+	uint32_t dw12 = sys_le32_to_cpu(bfp->dw10[2]);
+	uint32_t dw13 = sys_le32_to_cpu(bfp->dw10[3]);
+
+	if (dw12 & JESD216_SFDP_BFP_DW12_SUSPRESSUP_FLG) {
+		return -ENOTSUP;
+	}
+
+	uint32_t value = 1 + ((dw12 >> 24) & 0x1F);
+
+	switch ((dw12 >> 29) & 0x03) {
+	case 0x00: /* 128 ns */
+		value *= 128;
+		break;
+	case 0x01: /* 1 us */
+		value *= NSEC_PER_USEC;
+		break;
+	case 0x02: /* 8 us */
+		value *= 8 * NSEC_PER_USEC;
+		break;
+	case 0x03: /* 64 us */
+		value *= 64 * NSEC_PER_USEC;
+		break;
+	}
+
+	res->erase_suspend_ns = value;
+	res->erase_resume_interval_ns = (1 + ((dw12 >> 20) & 0x0F)) *
+					64 * NSEC_PER_USEC;
+
+	res->erase_suspend_instr = (dw13 >> 24) & 0xFF;
+	res->erase_resume_instr = (dw13 >> 16) & 0xFF;
+
+	return 0;
+}
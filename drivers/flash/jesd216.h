@@ -173,8 +173,7 @@ struct jesd216_bfp {
  *
  * * DW10 (erase times) use jesd216_bfp_erase_type_times().
  * * DW11 (other times) use jesd216_bfp_decode_dw11().
- * * DW12-13 (suspend/resume) no API except
- *   JESD216_SFDP_BFP_DW12_SUSPRESSUP_FLG.
+ * * DW12-13 (suspend/resume) use jesd216_bfp_decode_suspend().
  * * DW14 (deep power down) use jesd216_bfp_decode_dw14().
  * * DW15-16 no API except jesd216_bfp_read_support().
  *
@@ -415,4 +414,39 @@ int jesd216_bfp_decode_dw14(const struct jesd216_param_header *php,
 			    const struct jesd216_bfp *bfp,
 			    struct jesd216_bfp_dw14 *res);
 
+/* Decoded erase suspend data from JESD216 DW12 and DW13 */
+struct jesd216_bfp_suspend {
+	/* Instruction used to suspend an erase */
+	uint8_t erase_suspend_instr;
+
+	/* Instruction used to resume a suspended erase */
+	uint8_t erase_resume_instr;
+
+	/* Maximum time from issuing the suspend instruction until the
+	 * device is ready to accept a read, in nanoseconds.
+	 */
+	uint32_t erase_suspend_ns;
+
+	/* Minimum time from resuming an erase until it may be suspended
+	 * again, in nanoseconds.
+	 */
+	uint32_t erase_resume_interval_ns;
+};
+
+/* Get the erase suspend data from BFP DW12 and DW13.
+ *
+ * @param php pointer to the BFP header.
+ *
+ * @param bfp pointer to the BFP table.
+ *
+ * @param res pointer to where to store the decoded data.
+ *
+ * @retval -ENOTSUP if the device does not support suspend/resume, or
+ * this information is not available from this BFP table.
+ * @retval 0 on successful storage into @c *res.
+ */
+int jesd216_bfp_decode_suspend(const struct jesd216_param_header *php,
+			       const struct jesd216_bfp *bfp,
+			       struct jesd216_bfp_suspend *res);
+
 #endif /* ZEPHYR_DRIVERS_FLASH_JESD216_H_ */
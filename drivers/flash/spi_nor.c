@@ -11,6 +11,7 @@
 
 #include <errno.h>
 #include <drivers/flash.h>
+#include <drivers/flash/spi_nor.h>
 #include <drivers/spi.h>
 #include <init.h>
 #include <string.h>
@@ -40,6 +41,23 @@ LOG_MODULE_REGISTER(spi_nor, CONFIG_FLASH_LOG_LEVEL);
  * * DEVICE_PM_ACTIVE_STATE covers both active and standby modes;
  * * DEVICE_PM_LOW_POWER_STATE, DEVICE_PM_SUSPEND_STATE, and
  *   DEVICE_PM_OFF_STATE all correspond to deep-power-down mode.
+ *
+ * The device is not put in deep power-down while an erase is in
+ * progress, as the device is released between status polls.
+ */
+
+/* Erase Notes
+ *
+ * Sector and block erases take tens to hundreds of milliseconds.  An
+ * erase of an area is split into the largest erase instructions
+ * aligned with the area, and is driven by erase_step(): each call
+ * either polls the status of the executing instruction or issues the
+ * next one.  Between calls the device is released, so that other
+ * threads can read while the erase is executing:
+ * * when the device supports it, and the read does not overlap the
+ *   area being erased, the erase is suspended for the read;
+ * * otherwise the read waits for the executing instruction to
+ *   complete.
  */
 
 #define SPI_NOR_MAX_ADDR_WIDTH 4
@@ -113,6 +131,40 @@ struct spi_nor_data {
 	uint32_t ts_enter_dpd;
 #endif
 
+	/* An erase is in progress, see erase_step() */
+	bool erase_active;
+	/* An erase instruction may be executing */
+	bool erase_busy;
+	/* Area left to erase */
+	off_t erase_addr;
+	size_t erase_size;
+	/* Area erased by the executing instruction */
+	off_t busy_addr;
+	size_t busy_size;
+
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+	/* Erase suspend and resume instructions, 0 if not supported */
+	uint8_t suspend_cmd;
+	uint8_t resume_cmd;
+	/* Minimum time from a resume to the next suspend */
+	uint32_t resume_interval_us;
+	/* Cycle count at the last resume */
+	uint32_t resume_cycles;
+#endif /* CONFIG_SPI_NOR_ERASE_SUSPEND */
+
+#ifdef CONFIG_SPI_NOR_READ_CACHE
+	/* Address of the cached block, -1 if none */
+	off_t cache_addr;
+	uint8_t cache[CONFIG_SPI_NOR_READ_CACHE_SIZE];
+#endif /* CONFIG_SPI_NOR_READ_CACHE */
+
+#ifdef CONFIG_SPI_NOR_ERASE_ASYNC
+	const struct device *dev;
+	struct k_delayed_work erase_work;
+	spi_nor_erase_cb_t erase_cb;
+	void *erase_user_data;
+#endif /* CONFIG_SPI_NOR_ERASE_ASYNC */
+
 	/* Minimal SFDP stores no dynamic configuration.  Runtime and
 	 * devicetree store page size and erase_types; runtime also
 	 * stores flash size and layout.
@@ -146,6 +198,12 @@ static const struct jesd216_erase_type minimal_erase_types[JESD216_NUM_ERASE_TYP
 		.cmd = SPI_NOR_CMD_SE,
 		.exp = 12,
 	},
+#if DT_INST_PROP(0, has_be32k)
+	{
+		.cmd = SPI_NOR_CMD_BE_32K,
+		.exp = 15,
+	},
+#endif /* DT_INST_PROP(0, has_be32k) */
 };
 #endif /* CONFIG_SPI_NOR_SFDP_MINIMAL */
 
@@ -304,22 +362,24 @@ static int spi_nor_access(const struct device *const dev,
 #define spi_nor_cmd_addr_write(dev, opcode, addr, src, length) \
 	spi_nor_access(dev, opcode, true, addr, (void *)src, length, true)
 
-#if defined(CONFIG_SPI_NOR_SFDP_RUNTIME) || defined(CONFIG_FLASH_JESD216_API)
+#if defined(CONFIG_SPI_NOR_SFDP_RUNTIME) || defined(CONFIG_FLASH_JESD216_API) \
+	|| defined(CONFIG_SPI_NOR_FAST_READ)
 /*
- * @brief Read content from the SFDP hierarchy
+ * @brief Send an addressed read command with 8 wait states
  *
  * @param dev Device struct
+ * @param opcode The command to send
  * @param addr The address to send
- * @param data The buffer to store or read the value
+ * @param data The buffer to store the value
  * @param length The size of the buffer
  * @return 0 on success, negative errno code otherwise
  */
-static int read_sfdp(const struct device *const dev,
-		     off_t addr, void *data, size_t length)
+static int spi_nor_wait_read(const struct device *const dev, uint8_t opcode,
+			     off_t addr, void *data, size_t length)
 {
 	struct spi_nor_data *const driver_data = dev->data;
 	uint8_t buf[] = {
-		JESD216_CMD_READ_SFDP,
+		opcode,
 		addr >> 16,
 		addr >> 8,
 		addr,
@@ -343,6 +403,24 @@ static int read_sfdp(const struct device *const dev,
 	return spi_transceive(driver_data->spi, &driver_data->spi_cfg,
 			      &buf_set, &buf_set);
 }
+#endif
+
+#if defined(CONFIG_SPI_NOR_SFDP_RUNTIME) || defined(CONFIG_FLASH_JESD216_API)
+/*
+ * @brief Read content from the SFDP hierarchy
+ *
+ * @param dev Device struct
+ * @param addr The address to send
+ * @param data The buffer to store or read the value
+ * @param length The size of the buffer
+ * @return 0 on success, negative errno code otherwise
+ */
+static inline int read_sfdp(const struct device *const dev,
+			    off_t addr, void *data, size_t length)
+{
+	return spi_nor_wait_read(dev, JESD216_CMD_READ_SFDP, addr, data,
+				 length);
+}
 #endif /* CONFIG_SPI_NOR_SFDP_RUNTIME */
 
 static int enter_dpd(const struct device *const dev)
@@ -398,13 +476,14 @@ static int exit_dpd(const struct device *const dev)
  */
 static void acquire_device(const struct device *dev)
 {
-	if (IS_ENABLED(CONFIG_MULTITHREADING)) {
-		struct spi_nor_data *const driver_data = dev->data;
+	struct spi_nor_data *const driver_data = dev->data;
 
+	if (IS_ENABLED(CONFIG_MULTITHREADING)) {
 		k_sem_take(&driver_data->sem, K_FOREVER);
 	}
 
-	if (IS_ENABLED(CONFIG_SPI_NOR_IDLE_IN_DPD)) {
+	if (IS_ENABLED(CONFIG_SPI_NOR_IDLE_IN_DPD)
+	    && !driver_data->erase_active) {
 		exit_dpd(dev);
 	}
 }
@@ -416,17 +495,28 @@ static void acquire_device(const struct device *dev)
  */
 static void release_device(const struct device *dev)
 {
-	if (IS_ENABLED(CONFIG_SPI_NOR_IDLE_IN_DPD)) {
+	struct spi_nor_data *const driver_data = dev->data;
+
+	if (IS_ENABLED(CONFIG_SPI_NOR_IDLE_IN_DPD)
+	    && !driver_data->erase_active) {
 		enter_dpd(dev);
 	}
 
 	if (IS_ENABLED(CONFIG_MULTITHREADING)) {
-		struct spi_nor_data *const driver_data = dev->data;
-
 		k_sem_give(&driver_data->sem);
 	}
 }
 
+/* Wait between status polls of an executing erase. */
+static inline void erase_poll_wait(void)
+{
+	if (IS_ENABLED(CONFIG_MULTITHREADING)) {
+		k_sleep(K_MSEC(CONFIG_SPI_NOR_ERASE_POLL_MS));
+	} else {
+		k_busy_wait(CONFIG_SPI_NOR_ERASE_POLL_MS * USEC_PER_MSEC);
+	}
+}
+
 /**
  * @brief Wait until the flash is ready
  *
@@ -435,21 +525,196 @@ static void release_device(const struct device *dev)
  */
 static int spi_nor_wait_until_ready(const struct device *dev)
 {
+	struct spi_nor_data *const driver_data = dev->data;
 	int ret;
 	uint8_t reg;
 
-	do {
+	while (true) {
 		ret = spi_nor_cmd_read(dev, SPI_NOR_CMD_RDSR, &reg, 1);
-	} while (!ret && (reg & SPI_NOR_WIP_BIT));
+		if ((ret != 0) || !(reg & SPI_NOR_WIP_BIT)) {
+			break;
+		}
+
+		/* Don't hog the CPU for the duration of an erase */
+		if (driver_data->erase_busy) {
+			erase_poll_wait();
+		}
+	}
+
+	if (ret == 0) {
+		driver_data->erase_busy = false;
+	}
 
 	return ret;
 }
 
+static inline void cache_invalidate(const struct device *dev)
+{
+#ifdef CONFIG_SPI_NOR_READ_CACHE
+	struct spi_nor_data *const driver_data = dev->data;
+
+	driver_data->cache_addr = -1;
+#endif /* CONFIG_SPI_NOR_READ_CACHE */
+}
+
+static int erase_step(const struct device *dev);
+
+/* Complete the erase in progress if [addr, addr + size) overlaps the
+ * area it erases, from the executing instruction to the end.  The device
+ * must be acquired.
+ */
+static int erase_wait(const struct device *dev, off_t addr, size_t size)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+	const off_t start = driver_data->erase_busy ? driver_data->busy_addr
+						     : driver_data->erase_addr;
+	const off_t end = driver_data->erase_addr + driver_data->erase_size;
+	int ret;
+
+	if (!driver_data->erase_active
+	    || ((addr + size) <= start)
+	    || (addr >= end)) {
+		return 0;
+	}
+
+	while ((ret = erase_step(dev)) == -EINPROGRESS) {
+		erase_poll_wait();
+	}
+
+	return ret;
+}
+
+/* Make the device ready for a read of [addr, addr + size), suspending
+ * the executing erase if possible.  The area must not overlap the erase,
+ * see erase_wait().
+ *
+ * @return true if the erase was suspended and must be resumed.
+ */
+static bool read_prepare(const struct device *dev, off_t addr, size_t size)
+{
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+	struct spi_nor_data *const driver_data = dev->data;
+	uint8_t reg;
+	int ret;
+
+	if (driver_data->erase_busy
+	    && (driver_data->suspend_cmd != 0)
+	    && (spi_nor_cmd_read(dev, SPI_NOR_CMD_RDSR, &reg, 1) == 0)
+	    && (reg & SPI_NOR_WIP_BIT)) {
+		uint32_t since = k_cyc_to_us_floor32(k_cycle_get_32() -
+						     driver_data->resume_cycles);
+
+		/* Let the erase progress between suspends */
+		if (since < driver_data->resume_interval_us) {
+			k_busy_wait(driver_data->resume_interval_us - since);
+		}
+
+		ret = spi_nor_cmd_write(dev, driver_data->suspend_cmd);
+		if (ret == 0) {
+			/* Ready once the erase is suspended */
+			do {
+				ret = spi_nor_cmd_read(dev, SPI_NOR_CMD_RDSR,
+						       &reg, 1);
+			} while ((ret == 0) && (reg & SPI_NOR_WIP_BIT));
+		}
+
+		if (ret == 0) {
+			return true;
+		}
+
+		LOG_DBG("Erase suspend failed: %d", ret);
+		(void)spi_nor_cmd_write(dev, driver_data->resume_cmd);
+	}
+#endif /* CONFIG_SPI_NOR_ERASE_SUSPEND */
+
+	spi_nor_wait_until_ready(dev);
+
+	return false;
+}
+
+/* Resume the erase suspended by read_prepare(). */
+static void read_finish(const struct device *dev, bool suspended)
+{
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+	struct spi_nor_data *const driver_data = dev->data;
+
+	if (suspended) {
+		(void)spi_nor_cmd_write(dev, driver_data->resume_cmd);
+		driver_data->resume_cycles = k_cycle_get_32();
+	}
+#endif /* CONFIG_SPI_NOR_ERASE_SUSPEND */
+}
+
+static int read_data(const struct device *dev, off_t addr, void *dest,
+		     size_t size)
+{
+	bool suspended;
+	int ret;
+
+	/* Don't read data which is about to be erased */
+	ret = erase_wait(dev, addr, size);
+	if (ret != 0) {
+		return ret;
+	}
+
+	suspended = read_prepare(dev, addr, size);
+
+#ifdef CONFIG_SPI_NOR_FAST_READ
+	ret = spi_nor_wait_read(dev, SPI_NOR_CMD_READ_FAST, addr, dest, size);
+#else /* CONFIG_SPI_NOR_FAST_READ */
+	ret = spi_nor_cmd_addr_read(dev, SPI_NOR_CMD_READ, addr, dest, size);
+#endif /* CONFIG_SPI_NOR_FAST_READ */
+
+	read_finish(dev, suspended);
+
+	return ret;
+}
+
+#ifdef CONFIG_SPI_NOR_READ_CACHE
+BUILD_ASSERT(((CONFIG_SPI_NOR_READ_CACHE_SIZE
+	       & (CONFIG_SPI_NOR_READ_CACHE_SIZE - 1)) == 0)
+	     && (CONFIG_SPI_NOR_READ_CACHE_SIZE <= SPI_NOR_SECTOR_SIZE),
+	     "SPI_NOR_READ_CACHE_SIZE must be a power of two up to 4096");
+
+/* Serve a read from the cache, filling it if needed.
+ *
+ * @return -ENOTSUP if the read is not cacheable, otherwise the result
+ * of the read.
+ */
+static int read_cached(const struct device *dev, off_t addr, void *dest,
+		       size_t size)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+	const off_t base = ROUND_DOWN(addr, CONFIG_SPI_NOR_READ_CACHE_SIZE);
+	int ret;
+
+	if ((size >= CONFIG_SPI_NOR_READ_CACHE_SIZE)
+	    || ((addr + size) > (base + CONFIG_SPI_NOR_READ_CACHE_SIZE))) {
+		return -ENOTSUP;
+	}
+
+	if (driver_data->cache_addr != base) {
+		ret = read_data(dev, base, driver_data->cache,
+				CONFIG_SPI_NOR_READ_CACHE_SIZE);
+		if (ret != 0) {
+			cache_invalidate(dev);
+			return ret;
+		}
+
+		driver_data->cache_addr = base;
+	}
+
+	memcpy(dest, &driver_data->cache[addr - base], size);
+
+	return 0;
+}
+#endif /* CONFIG_SPI_NOR_READ_CACHE */
+
 static int spi_nor_read(const struct device *dev, off_t addr, void *dest,
 			size_t size)
 {
 	const size_t flash_size = dev_flash_size(dev);
-	int ret;
+	int ret = -ENOTSUP;
 
 	/* should be between 0 and flash size */
 	if ((addr < 0) || ((addr + size) > flash_size)) {
@@ -458,9 +723,13 @@ static int spi_nor_read(const struct device *dev, off_t addr, void *dest,
 
 	acquire_device(dev);
 
-	spi_nor_wait_until_ready(dev);
+#ifdef CONFIG_SPI_NOR_READ_CACHE
+	ret = read_cached(dev, addr, dest, size);
+#endif /* CONFIG_SPI_NOR_READ_CACHE */
 
-	ret = spi_nor_cmd_addr_read(dev, SPI_NOR_CMD_READ, addr, dest, size);
+	if (ret == -ENOTSUP) {
+		ret = read_data(dev, addr, dest, size);
+	}
 
 	release_device(dev);
 	return ret;
@@ -481,6 +750,17 @@ static int spi_nor_write(const struct device *dev, off_t addr,
 
 	acquire_device(dev);
 
+	cache_invalidate(dev);
+
+	/* Don't write data which is about to be erased */
+	ret = erase_wait(dev, addr, size);
+	if (ret != 0) {
+		goto out;
+	}
+
+	/* An erase may be executing */
+	spi_nor_wait_until_ready(dev);
+
 	while (size > 0) {
 		size_t to_write = size;
 
@@ -514,10 +794,10 @@ out:
 	return ret;
 }
 
-static int spi_nor_erase(const struct device *dev, off_t addr, size_t size)
+/* Check that an area can be erased. */
+static int erase_check(const struct device *dev, off_t addr, size_t size)
 {
 	const size_t flash_size = dev_flash_size(dev);
-	int ret = 0;
 
 	/* erase area must be subregion of device */
 	if ((addr < 0) || ((size + addr) > flash_size)) {
@@ -534,49 +814,228 @@ static int spi_nor_erase(const struct device *dev, off_t addr, size_t size)
 		return -EINVAL;
 	}
 
-	acquire_device(dev);
+	return 0;
+}
 
-	while ((size > 0) && (ret == 0)) {
-		spi_nor_cmd_write(dev, SPI_NOR_CMD_WREN);
+/* Get the largest erase type which erases the beginning of an area. */
+static const struct jesd216_erase_type *
+erase_type_select(const struct device *dev, off_t addr, size_t size)
+{
+	const struct jesd216_erase_type *erase_types = dev_erase_types(dev);
+	const struct jesd216_erase_type *bet = NULL;
+
+	for (uint8_t ei = 0; ei < JESD216_NUM_ERASE_TYPES; ++ei) {
+		const struct jesd216_erase_type *etp = &erase_types[ei];
+
+		if ((etp->exp != 0)
+		    && SPI_NOR_IS_ALIGNED(addr, etp->exp)
+		    && (size >= BIT(etp->exp))
+		    && ((bet == NULL)
+			|| (etp->exp > bet->exp))) {
+			bet = etp;
+		}
+	}
 
-		if (size == flash_size) {
-			/* chip erase */
-			spi_nor_cmd_write(dev, SPI_NOR_CMD_CE);
-			size -= flash_size;
-		} else {
-			const struct jesd216_erase_type *erase_types =
-				dev_erase_types(dev);
-			const struct jesd216_erase_type *bet = NULL;
-
-			for (uint8_t ei = 0; ei < JESD216_NUM_ERASE_TYPES; ++ei) {
-				const struct jesd216_erase_type *etp =
-					&erase_types[ei];
-
-				if ((etp->exp != 0)
-				    && SPI_NOR_IS_ALIGNED(addr, etp->exp)
-				    && SPI_NOR_IS_ALIGNED(size, etp->exp)
-				    && ((bet == NULL)
-					|| (etp->exp > bet->exp))) {
-					bet = etp;
-				}
-			}
-			if (bet != NULL) {
-				spi_nor_cmd_addr_write(dev, bet->cmd, addr, NULL, 0);
-				addr += BIT(bet->exp);
-				size -= BIT(bet->exp);
-			} else {
-				LOG_DBG("Can't erase %zu at 0x%lx",
-					size, (long)addr);
-				ret = -EINVAL;
-			}
+	return bet;
+}
+
+/* Issue the instruction erasing the beginning of the area left to
+ * erase.  The device must be ready.
+ */
+static int erase_issue(const struct device *dev)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+	const size_t flash_size = dev_flash_size(dev);
+	const off_t addr = driver_data->erase_addr;
+	const struct jesd216_erase_type *bet = NULL;
+	size_t len = flash_size;
+	int ret;
+
+	if ((addr != 0) || (driver_data->erase_size != flash_size)) {
+		bet = erase_type_select(dev, addr, driver_data->erase_size);
+		if (bet == NULL) {
+			LOG_DBG("Can't erase %zu at 0x%lx",
+				driver_data->erase_size, (long)addr);
+			return -EINVAL;
 		}
-		spi_nor_wait_until_ready(dev);
+
+		len = BIT(bet->exp);
+	}
+
+	cache_invalidate(dev);
+
+	ret = spi_nor_cmd_write(dev, SPI_NOR_CMD_WREN);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (bet == NULL) {
+		/* chip erase */
+		ret = spi_nor_cmd_write(dev, SPI_NOR_CMD_CE);
+	} else {
+		ret = spi_nor_cmd_addr_write(dev, bet->cmd, addr, NULL, 0);
+	}
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	driver_data->erase_busy = true;
+	driver_data->busy_addr = addr;
+	driver_data->busy_size = len;
+	driver_data->erase_addr += len;
+	driver_data->erase_size -= len;
+
+	return 0;
+}
+
+/* Make progress on the erase in progress.  The device must be
+ * acquired.
+ *
+ * @return -EINPROGRESS while an erase instruction is executing, 0 once
+ * the area is erased, negative errno code otherwise.
+ */
+static int erase_step(const struct device *dev)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+	uint8_t reg;
+	int ret;
+
+	if (driver_data->erase_busy) {
+		ret = spi_nor_cmd_read(dev, SPI_NOR_CMD_RDSR, &reg, 1);
+		if (ret != 0) {
+			return ret;
+		}
+
+		if (reg & SPI_NOR_WIP_BIT) {
+			return -EINPROGRESS;
+		}
+
+		driver_data->erase_busy = false;
+	}
+
+	if (driver_data->erase_size == 0) {
+		return 0;
+	}
+
+	ret = erase_issue(dev);
+
+	return (ret == 0) ? -EINPROGRESS : ret;
+}
+
+/* Start an erase, the device being acquired. */
+static int erase_start(const struct device *dev, off_t addr, size_t size)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+
+	if (driver_data->erase_active) {
+		return -EBUSY;
+	}
+
+	driver_data->erase_active = true;
+	driver_data->erase_addr = addr;
+	driver_data->erase_size = size;
+
+	return 0;
+}
+
+/* End the erase in progress, the device being acquired. */
+static void erase_end(const struct device *dev)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+
+	driver_data->erase_active = false;
+	driver_data->erase_size = 0;
+}
+
+static int spi_nor_erase(const struct device *dev, off_t addr, size_t size)
+{
+	int ret = erase_check(dev, addr, size);
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	acquire_device(dev);
+
+	ret = erase_start(dev, addr, size);
+	if (ret != 0) {
+		release_device(dev);
+		return ret;
+	}
+
+	while ((ret = erase_step(dev)) == -EINPROGRESS) {
+		/* Let other threads read while the instruction executes */
+		release_device(dev);
+		erase_poll_wait();
+		acquire_device(dev);
+	}
+
+	erase_end(dev);
+
+	release_device(dev);
+
+	return ret;
+}
+
+#ifdef CONFIG_SPI_NOR_ERASE_ASYNC
+static void erase_work_handler(struct k_work *work)
+{
+	struct spi_nor_data *const driver_data =
+		CONTAINER_OF(work, struct spi_nor_data, erase_work.work);
+	const struct device *dev = driver_data->dev;
+	spi_nor_erase_cb_t cb = driver_data->erase_cb;
+	void *user_data = driver_data->erase_user_data;
+	int ret;
+
+	acquire_device(dev);
+
+	ret = erase_step(dev);
+	if (ret == -EINPROGRESS) {
+		release_device(dev);
+		k_delayed_work_submit(&driver_data->erase_work,
+				      K_MSEC(CONFIG_SPI_NOR_ERASE_POLL_MS));
+		return;
 	}
 
+	erase_end(dev);
+
 	release_device(dev);
 
+	cb(dev, ret, user_data);
+}
+
+int spi_nor_erase_async(const struct device *dev, off_t addr, size_t size,
+			spi_nor_erase_cb_t cb, void *user_data)
+{
+	struct spi_nor_data *const driver_data = dev->data;
+	int ret = erase_check(dev, addr, size);
+
+	if (cb == NULL) {
+		ret = -EINVAL;
+	}
+
+	if (ret != 0) {
+		return ret;
+	}
+
+	acquire_device(dev);
+
+	ret = erase_start(dev, addr, size);
+	if (ret == 0) {
+		driver_data->erase_cb = cb;
+		driver_data->erase_user_data = user_data;
+	}
+
+	release_device(dev);
+
+	if (ret == 0) {
+		k_delayed_work_submit(&driver_data->erase_work, K_NO_WAIT);
+	}
+
 	return ret;
 }
+#endif /* CONFIG_SPI_NOR_ERASE_ASYNC */
 
 static int spi_nor_write_protection_set(const struct device *dev,
 					bool write_protect)
@@ -661,6 +1120,24 @@ static int spi_nor_process_bfp(const struct device *dev,
 	}
 
 	data->page_size = jesd216_bfp_page_size(php, bfp);
+
+#ifdef CONFIG_SPI_NOR_ERASE_SUSPEND
+	struct jesd216_bfp_suspend sus;
+
+	if (jesd216_bfp_decode_suspend(php, bfp, &sus) == 0) {
+		data->suspend_cmd = sus.erase_suspend_instr;
+		data->resume_cmd = sus.erase_resume_instr;
+		data->resume_interval_us =
+			ceiling_fraction(sus.erase_resume_interval_ns,
+					 NSEC_PER_USEC);
+		LOG_DBG("Erase suspend %02x resume %02x, %u us interval",
+			data->suspend_cmd, data->resume_cmd,
+			data->resume_interval_us);
+	} else {
+		data->suspend_cmd = 0;
+	}
+#endif /* CONFIG_SPI_NOR_ERASE_SUSPEND */
+
 #ifdef CONFIG_SPI_NOR_SFDP_RUNTIME
 	data->flash_size = flash_size;
 #else /* CONFIG_SPI_NOR_SFDP_RUNTIME */
@@ -926,6 +1403,15 @@ static int spi_nor_init(const struct device *dev)
 		k_sem_init(&driver_data->sem, 1, UINT_MAX);
 	}
 
+	cache_invalidate(dev);
+
+#ifdef CONFIG_SPI_NOR_ERASE_ASYNC
+	struct spi_nor_data *const driver_data = dev->data;
+
+	driver_data->dev = dev;
+	k_delayed_work_init(&driver_data->erase_work, erase_work_handler);
+#endif /* CONFIG_SPI_NOR_ERASE_ASYNC */
+
 	return spi_nor_configure(dev);
 }
 
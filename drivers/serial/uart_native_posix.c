@@ -45,15 +45,38 @@ static int np_uart_tty_poll_in(const struct device *dev,
 			       unsigned char *p_char);
 static void np_uart_poll_out(const struct device *dev,
 				      unsigned char out_char);
+#ifdef CONFIG_UART_ASYNC_API
+static int np_uart_callback_set(const struct device *dev,
+				uart_callback_t callback, void *user_data);
+static int np_uart_tx(const struct device *dev, const uint8_t *buf,
+		      size_t len, int32_t timeout);
+static int np_uart_tx_abort(const struct device *dev);
+static int np_uart_rx_enable(const struct device *dev, uint8_t *buf,
+			     size_t len, int32_t timeout);
+static void np_uart_async_init(const struct device *dev);
+#endif
 
 static bool auto_attach;
 static bool wait_pts;
 static const char default_cmd[] = CONFIG_NATIVE_UART_AUTOATTACH_DEFAULT_CMD;
 static char *auto_attach_cmd;
 
+#ifdef CONFIG_UART_ASYNC_API
+struct native_uart_async {
+	uart_callback_t callback;
+	void *user_data;
+	const uint8_t *tx_buf; /* Transfer in progress, NULL if none */
+	size_t tx_len;
+	struct k_timer tx_timer;
+};
+#endif
+
 struct native_uart_status {
 	int out_fd; /* File descriptor used for output */
 	int in_fd; /* File descriptor used for input */
+#ifdef CONFIG_UART_ASYNC_API
+	struct native_uart_async async;
+#endif
 };
 
 static struct native_uart_status native_uart_status_0;
@@ -61,6 +84,12 @@ static struct native_uart_status native_uart_status_0;
 static struct uart_driver_api np_uart_driver_api_0 = {
 	.poll_out = np_uart_poll_out,
 	.poll_in = np_uart_tty_poll_in,
+#ifdef CONFIG_UART_ASYNC_API
+	.callback_set = np_uart_callback_set,
+	.tx = np_uart_tx,
+	.tx_abort = np_uart_tx_abort,
+	.rx_enable = np_uart_rx_enable,
+#endif
 };
 
 #if defined(CONFIG_UART_NATIVE_POSIX_PORT_1_ENABLE)
@@ -69,9 +98,20 @@ static struct native_uart_status native_uart_status_1;
 static struct uart_driver_api np_uart_driver_api_1 = {
 	.poll_out = np_uart_poll_out,
 	.poll_in = np_uart_tty_poll_in,
+#ifdef CONFIG_UART_ASYNC_API
+	.callback_set = np_uart_callback_set,
+	.tx = np_uart_tx,
+	.tx_abort = np_uart_tx_abort,
+	.rx_enable = np_uart_rx_enable,
+#endif
 };
 #endif /* CONFIG_UART_NATIVE_POSIX_PORT_1_ENABLE */
 
+/* Modelled transmission time of a character, 8N1 framing: 10 bits. */
+#if CONFIG_UART_NATIVE_POSIX_BAUDRATE > 0
+#define CHAR_TIME_NS (10ULL * NSEC_PER_SEC / CONFIG_UART_NATIVE_POSIX_BAUDRATE)
+#endif
+
 #define ERROR posix_print_error_and_exit
 #define WARN posix_print_warning
 
@@ -238,6 +278,10 @@ static int np_uart_0_init(const struct device *dev)
 		}
 	}
 
+#ifdef CONFIG_UART_ASYNC_API
+	np_uart_async_init(dev);
+#endif
+
 	return 0;
 }
 
@@ -258,6 +302,10 @@ static int np_uart_1_init(const struct device *dev)
 	d->in_fd = tty_fn;
 	d->out_fd = tty_fn;
 
+#ifdef CONFIG_UART_ASYNC_API
+	np_uart_async_init(dev);
+#endif
+
 	return 0;
 }
 #endif
@@ -287,6 +335,10 @@ static void np_uart_poll_out(const struct device *dev,
 		}
 	}
 
+#if CONFIG_UART_NATIVE_POSIX_BAUDRATE > 0
+	k_busy_wait(MAX(CHAR_TIME_NS / NSEC_PER_USEC, 1));
+#endif
+
 	/* The return value of write() cannot be ignored (there is a warning)
 	 * but we do not need the return value for anything.
 	 */
@@ -364,6 +416,142 @@ static int np_uart_tty_poll_in(const struct device *dev,
 	return 0;
 }
 
+#ifdef CONFIG_UART_ASYNC_API
+/*
+ * Asynchronous API emulation, transmission only.
+ *
+ * The data of a transfer is written out, and the transfer completed, once
+ * the time it would take on a UART running at the modelled baud rate has
+ * elapsed, so that the callers see realistic transfer times and backpressure
+ * in simulated time.
+ * Transfers do not wait for a pseudoterminal client (--wait_uart).
+ */
+
+static void np_uart_tx_done(struct k_timer *timer)
+{
+	const struct device *dev = k_timer_user_data_get(timer);
+	struct native_uart_async *async =
+		&((struct native_uart_status *)dev->data)->async;
+	int out_fd = ((struct native_uart_status *)dev->data)->out_fd;
+	struct uart_event evt = {
+		.type = UART_TX_DONE,
+		.data.tx.buf = async->tx_buf,
+		.data.tx.len = async->tx_len,
+	};
+	size_t offset = 0;
+	ssize_t ret;
+
+	while (offset < async->tx_len) {
+		ret = write(out_fd, &async->tx_buf[offset],
+			    async->tx_len - offset);
+		if (ret <= 0) {
+			break;
+		}
+		offset += ret;
+	}
+
+	async->tx_buf = NULL;
+
+	if (async->callback) {
+		async->callback(dev, &evt, async->user_data);
+	}
+}
+
+static void np_uart_async_init(const struct device *dev)
+{
+	struct native_uart_async *async =
+		&((struct native_uart_status *)dev->data)->async;
+
+	k_timer_init(&async->tx_timer, np_uart_tx_done, NULL);
+	k_timer_user_data_set(&async->tx_timer, (void *)dev);
+}
+
+static int np_uart_callback_set(const struct device *dev,
+				uart_callback_t callback, void *user_data)
+{
+	struct native_uart_async *async =
+		&((struct native_uart_status *)dev->data)->async;
+
+	async->callback = callback;
+	async->user_data = user_data;
+
+	return 0;
+}
+
+static int np_uart_tx(const struct device *dev, const uint8_t *buf,
+		      size_t len, int32_t timeout)
+{
+	struct native_uart_async *async =
+		&((struct native_uart_status *)dev->data)->async;
+	uint64_t duration_us = 0U;
+	unsigned int key;
+
+	ARG_UNUSED(timeout);
+
+#if CONFIG_UART_NATIVE_POSIX_BAUDRATE > 0
+	duration_us = (uint64_t)len * CHAR_TIME_NS / NSEC_PER_USEC;
+#endif
+
+	key = irq_lock();
+
+	if (async->tx_buf != NULL) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	async->tx_buf = buf;
+	async->tx_len = len;
+	k_timer_start(&async->tx_timer, K_USEC(duration_us), K_NO_WAIT);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+static int np_uart_tx_abort(const struct device *dev)
+{
+	struct native_uart_async *async =
+		&((struct native_uart_status *)dev->data)->async;
+	struct uart_event evt = {
+		.type = UART_TX_ABORTED,
+		.data.tx.len = 0,
+	};
+	unsigned int key;
+
+	key = irq_lock();
+
+	if (async->tx_buf == NULL) {
+		irq_unlock(key);
+		return -EFAULT;
+	}
+
+	k_timer_stop(&async->tx_timer);
+	evt.data.tx.buf = async->tx_buf;
+	async->tx_buf = NULL;
+
+	irq_unlock(key);
+
+	/* Nothing has been written out yet. */
+	if (async->callback) {
+		async->callback(dev, &evt, async->user_data);
+	}
+
+	return 0;
+}
+
+static int np_uart_rx_enable(const struct device *dev, uint8_t *buf,
+			     size_t len, int32_t timeout)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(buf);
+	ARG_UNUSED(len);
+	ARG_UNUSED(timeout);
+
+	/* Reception is only supported with polling. */
+	return -ENOTSUP;
+}
+#endif /* CONFIG_UART_ASYNC_API */
+
 DEVICE_AND_API_INIT(uart_native_posix0,
 	    DT_INST_LABEL(0), &np_uart_0_init,
 	    (void *)&native_uart_status_0, NULL,
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_DEBUG_PROFILER_H_
+#define ZEPHYR_INCLUDE_DEBUG_PROFILER_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup profiler Sampling profiler
+ *  @brief Module sampling the code interrupted by the system timer
+ *
+ *  The profiler periodically records the thread and the program counter
+ *  interrupted by the system timer, and optionally the return addresses of
+ *  its call stack, into per CPU buffers. The samples are drained either as
+ *  raw samples, for custom transports, or as text lines which
+ *  scripts/profiler/folded_stacks.py converts into folded stacks.
+ *  @{
+ */
+
+struct k_thread;
+
+#ifdef CONFIG_PROFILER_STACK_DEPTH
+#define PROFILER_STACK_DEPTH CONFIG_PROFILER_STACK_DEPTH
+#else
+#define PROFILER_STACK_DEPTH 1
+#endif
+
+/** @brief Profiler sample. */
+struct profiler_sample {
+	/** Thread running when the sample was taken. */
+	const struct k_thread *thread;
+	/** Number of valid addresses, 0 if an interrupt was interrupted. */
+	uint32_t depth;
+	/** Interrupted program counter followed by the return addresses of
+	 * the call stack, innermost first.
+	 */
+	uintptr_t pc[PROFILER_STACK_DEPTH];
+};
+
+/** @brief Profiler statistics. */
+struct profiler_stats {
+	/** Number of samples taken since boot. */
+	uint32_t samples;
+	/** Number of samples dropped because the buffer was full. */
+	uint32_t dropped;
+};
+
+/** @brief Sample callback.
+ *
+ *  @param sample    Sample.
+ *  @param user_data User data passed to profiler_drain().
+ */
+typedef void (*profiler_sample_cb_t)(const struct profiler_sample *sample,
+				     void *user_data);
+
+/** @brief Text line callback.
+ *
+ *  @param line      Null terminated line, without line ending.
+ *  @param user_data User data passed to profiler_dump().
+ */
+typedef void (*profiler_line_cb_t)(const char *line, void *user_data);
+
+/** @brief Start sampling.
+ *
+ *  @retval 0 on success.
+ *  @retval -EALREADY if the profiler is already running.
+ */
+int profiler_start(void);
+
+/** @brief Stop sampling.
+ *
+ *  The samples already taken stay in the buffers until drained.
+ *
+ *  @retval 0 on success.
+ *  @retval -EALREADY if the profiler is not running.
+ */
+int profiler_stop(void);
+
+/** @brief Check if the profiler is running.
+ *
+ *  @return True if the profiler is sampling.
+ */
+bool profiler_is_running(void);
+
+/** @brief Get the profiler statistics.
+ *
+ *  @param stats Location for the statistics.
+ */
+void profiler_stats_get(struct profiler_stats *stats);
+
+/** @brief Drain the buffered samples.
+ *
+ *  Removes the samples from the buffers and passes them to the callback.
+ *  The profiler may keep sampling meanwhile. Must not be called
+ *  concurrently from several contexts.
+ *
+ *  @param cb        Callback called for each sample.
+ *  @param user_data User data passed to the callback.
+ *
+ *  @return Number of drained samples.
+ */
+uint32_t profiler_drain(profiler_sample_cb_t cb, void *user_data);
+
+/** @brief Drain the buffered samples as text lines.
+ *
+ *  Produces a "PROF-THREAD <thread> <name>" line per thread if
+ *  CONFIG_THREAD_MONITOR is enabled, then a
+ *  "PROF <thread> <pc>[;<return address>...]" line per sample, or
+ *  "PROF <thread> isr" if an interrupt was interrupted, and finally a
+ *  "PROF-END <samples> <dropped>" line with the statistics.
+ *
+ *  @param cb        Callback called for each line.
+ *  @param user_data User data passed to the callback.
+ *
+ *  @return Number of drained samples.
+ */
+uint32_t profiler_dump(profiler_line_cb_t cb, void *user_data);
+
+/** @brief Drain the buffered samples as text lines to the console.
+ *
+ *  @return Number of drained samples.
+ */
+uint32_t profiler_print(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_DEBUG_PROFILER_H_ */
@@ -51,7 +51,13 @@ extern "C" {
 #define DISK_STATUS_WR_PROTECT		0x04
 
 struct disk_operations;
+struct disk_access_req;
 
+/*
+ * A disk_info is the handle of a registered disk, see disk_access_get_di().
+ * The disk_access_di_* functions take it instead of the disk name, which the
+ * name based functions look up at each call.
+ */
 struct disk_info {
 	sys_dnode_t node;
 	char *name;
@@ -59,6 +65,12 @@ struct disk_info {
 	/* Disk device associated to this disk.
 	 */
 	const struct device *dev;
+#ifdef CONFIG_DISK_CACHE
+	/* Sector size and count seen by the block cache, 0 until queried.
+	 */
+	uint32_t cache_sector_size;
+	uint32_t cache_sector_count;
+#endif
 };
 
 struct disk_operations {
@@ -69,6 +81,53 @@ struct disk_operations {
 	int (*write)(struct disk_info *disk, const uint8_t *data_buf,
 		     uint32_t start_sector, uint32_t num_sector);
 	int (*ioctl)(struct disk_info *disk, uint8_t cmd, void *buff);
+	/* Optional. Start an asynchronous request and return, the driver
+	 * calls disk_access_complete() when it is done, possibly from an
+	 * interrupt. Requests of disks without it, or of all disks when
+	 * DISK_CACHE is enabled, are executed by the disk access thread.
+	 */
+	int (*submit)(struct disk_info *disk, struct disk_access_req *req);
+};
+
+/* Segment of a scatter/gather request. */
+struct disk_access_sg {
+	/* Buffer of num_sector sectors */
+	uint8_t *buf;
+	uint32_t num_sector;
+};
+
+enum disk_access_op {
+	DISK_ACCESS_OP_READ,
+	DISK_ACCESS_OP_WRITE,
+};
+
+/*
+ * @brief Callback of a completed asynchronous request
+ *
+ * Called from the disk access thread, or from the context in which the
+ * driver completes the request, possibly before disk_access_submit()
+ * returns.
+ *
+ * @param[in] req     Request, which can be reused or freed.
+ * @param[in] result  0 on success, negative errno code on fail
+ */
+typedef void (*disk_access_cb_t)(struct disk_access_req *req, int result);
+
+/* Asynchronous request. It belongs to the disk access layer from its
+ * submission until its callback is called.
+ */
+struct disk_access_req {
+	/* Used by the request queue */
+	void *fifo_reserved;
+	enum disk_access_op op;
+	uint32_t start_sector;
+	/* Segments, transferred to or from consecutive sectors */
+	const struct disk_access_sg *sg;
+	size_t sg_cnt;
+	disk_access_cb_t cb;
+	void *user_data;
+	/* Used by the disk access layer and the driver */
+	struct disk_info *disk;
 };
 
 /*
@@ -129,6 +188,94 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
  */
 int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buff);
 
+/*
+ * @brief Initialize a disk, see disk_access_init()
+ */
+int disk_access_di_init(struct disk_info *disk);
+
+/*
+ * @brief Get the status of a disk, see disk_access_status()
+ */
+int disk_access_di_status(struct disk_info *disk);
+
+/*
+ * @brief Read data from a disk, see disk_access_read()
+ */
+int disk_access_di_read(struct disk_info *disk, uint8_t *data_buf,
+			uint32_t start_sector, uint32_t num_sector);
+
+/*
+ * @brief Write data to a disk, see disk_access_write()
+ */
+int disk_access_di_write(struct disk_info *disk, const uint8_t *data_buf,
+			 uint32_t start_sector, uint32_t num_sector);
+
+/*
+ * @brief Get/Configure the parameters of a disk, see disk_access_ioctl()
+ */
+int disk_access_di_ioctl(struct disk_info *disk, uint8_t cmd, void *buff);
+
+/*
+ * @brief Read consecutive sectors of a disk into several buffers
+ *
+ * @param[in] start_sector  Start disk sector to read from
+ * @param[in] sg            Buffers, filled in order
+ * @param[in] sg_cnt        Number of buffers
+ *
+ * @return 0 on success, negative errno code on fail
+ */
+int disk_access_di_readv(struct disk_info *disk, uint32_t start_sector,
+			 const struct disk_access_sg *sg, size_t sg_cnt);
+
+/*
+ * @brief Write several buffers to consecutive sectors of a disk
+ *
+ * @param[in] start_sector  Start disk sector to write to
+ * @param[in] sg            Buffers, written in order
+ * @param[in] sg_cnt        Number of buffers
+ *
+ * @return 0 on success, negative errno code on fail
+ */
+int disk_access_di_writev(struct disk_info *disk, uint32_t start_sector,
+			  const struct disk_access_sg *sg, size_t sg_cnt);
+
+/*
+ * @brief Submit an asynchronous request
+ *
+ * The request is queued, or started by the driver, and the function returns
+ * without waiting for it. The callback of the request is called when it is
+ * done. Requests of a disk are completed in their submission order, except
+ * for drivers which implement submit and document otherwise. The disk must
+ * not be unregistered while requests are pending.
+ *
+ * @param[in] req  Request, with op, start_sector, sg, sg_cnt and cb set
+ *
+ * @return 0 if the request was submitted, negative errno code on fail, in
+ *	   which case the callback is not called
+ */
+int disk_access_submit(struct disk_info *disk, struct disk_access_req *req);
+
+/*
+ * @brief Complete an asynchronous request
+ *
+ * Called by the drivers implementing submit.
+ *
+ * @param[in] result  0 on success, negative errno code on fail
+ */
+void disk_access_complete(struct disk_access_req *req, int result);
+
+/*
+ * @brief Get a registered disk
+ *
+ * @param[in] name  Name of the disk
+ *
+ * The disk information is the handle used by the disk_access_di_* functions,
+ * valid until the disk is unregistered.
+ *
+ * @return Disk information, or NULL if no disk of that name is registered
+ */
+struct disk_info *disk_access_get_di(const char *name);
+
 int disk_access_register(struct disk_info *disk);
 
 int disk_access_unregister(struct disk_info *disk);
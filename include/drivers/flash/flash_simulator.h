@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Flash simulator specific API
+ */
+
+#ifndef ZEPHYR_INCLUDE_DRIVERS_FLASH_FLASH_SIMULATOR_H_
+#define ZEPHYR_INCLUDE_DRIVERS_FLASH_FLASH_SIMULATOR_H_
+
+#include <zephyr/types.h>
+#include <sys/types.h>
+#include <device.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Flash simulator Interface
+ * @defgroup flash_simulator_interface Flash simulator Interface
+ * @ingroup flash_interface
+ * @{
+ */
+
+/**
+ * @brief Wear of the simulated flash.
+ */
+struct flash_simulator_wear {
+	/** Lowest erase cycles count of an erase unit */
+	uint32_t min_erase_cycles;
+	/** Highest erase cycles count of an erase unit */
+	uint32_t max_erase_cycles;
+	/** Erase cycles count of all the erase units */
+	uint32_t total_erase_cycles;
+	/** Number of erase units erased more than the endurance */
+	uint32_t worn_units;
+	/** Number of erase units */
+	uint32_t unit_count;
+};
+
+/**
+ * @brief Get the erase cycles count of an erase unit.
+ *
+ * @param dev flash simulator device.
+ * @param offset offset of any byte of the erase unit.
+ * @param erase_cycles where to store the count.
+ *
+ * @return 0 on success, -EINVAL if the offset is out of the flash.
+ */
+int flash_simulator_erase_cycles_get(const struct device *dev, off_t offset,
+				     uint32_t *erase_cycles);
+
+/**
+ * @brief Get the wear summary of the simulated flash.
+ *
+ * @param dev flash simulator device.
+ * @param wear where to store the summary.
+ */
+void flash_simulator_wear_get(const struct device *dev,
+			      struct flash_simulator_wear *wear);
+
+/**
+ * @brief Reset the statistics and erase cycles counts.
+ *
+ * Resets the flash_sim_stats statistics and the erase cycles count of
+ * every erase unit. The thresholds and the flash content are kept.
+ *
+ * @param dev flash simulator device.
+ */
+void flash_simulator_stats_reset(const struct device *dev);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_DRIVERS_FLASH_FLASH_SIMULATOR_H_ */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief SPI NOR flash specific API
+ */
+
+#ifndef ZEPHYR_INCLUDE_DRIVERS_FLASH_SPI_NOR_H_
+#define ZEPHYR_INCLUDE_DRIVERS_FLASH_SPI_NOR_H_
+
+#include <zephyr/types.h>
+#include <sys/types.h>
+#include <device.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief SPI NOR flash Interface
+ * @defgroup spi_nor_interface SPI NOR flash Interface
+ * @ingroup flash_interface
+ * @{
+ */
+
+/**
+ * @brief Callback called when an asynchronous erase completes.
+ *
+ * Called from the system work queue.
+ *
+ * @param dev SPI NOR flash device.
+ * @param result 0 if the area was erased, negative errno code otherwise.
+ * @param user_data user data given to spi_nor_erase_async().
+ */
+typedef void (*spi_nor_erase_cb_t)(const struct device *dev, int result,
+				   void *user_data);
+
+/**
+ * @brief Start erasing an area of a SPI NOR flash.
+ *
+ * The erase commands are issued and the status is polled from the system
+ * work queue, the device being released in between, so that reads can
+ * proceed meanwhile, suspending the erase when the device supports it.
+ * Writes wait for the erase command executing to complete. Reads and
+ * writes within the area left to erase wait for the whole erase.
+ *
+ * Only one erase can be in progress at a time.
+ *
+ * @param dev SPI NOR flash device.
+ * @param addr offset of the area, a multiple of the sector size.
+ * @param size size of the area, a multiple of the sector size.
+ * @param cb callback called when the erase completes.
+ * @param user_data user data passed to @p cb.
+ *
+ * @retval 0 if the erase was started.
+ * @retval -ENODEV if the area is not within the flash.
+ * @retval -EINVAL if the area is not sector aligned or @p cb is NULL.
+ * @retval -EBUSY if an erase is already in progress.
+ */
+int spi_nor_erase_async(const struct device *dev, off_t addr, size_t size,
+			spi_nor_erase_cb_t cb, void *user_data);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_DRIVERS_FLASH_SPI_NOR_H_ */
@@ -76,6 +76,31 @@ struct fcb_entry_ctx {
 	/**< Flash area where the entry is placed */
 };
 
+/**
+ * @brief FCB sector summary structure
+ * RAM summary of the elements of a sector, kept when
+ * CONFIG_FCB_SECTOR_SUMMARY is enabled and @ref fcb.f_summaries is set.
+ * It is built by @ref fcb_init and updated by appends and rotations.
+ */
+struct fcb_sector_summary {
+	uint32_t fss_first_off;
+	/**< Offset of the first valid element, 0 if there is none */
+
+	uint32_t fss_last_off;
+	/**< Offset of the last valid element, 0 if there is none */
+
+	uint32_t fss_end_off;
+	/**< Offset past the last element, where appends continue */
+
+	uint16_t fss_elem_cnt;
+	/**< Number of elements, valid or not */
+
+	uint16_t fss_bad_cnt;
+	/**< Number of elements which failed the CRC check, or which have been
+	 * appended but not yet finished.
+	 */
+};
+
 /**
  * @brief FCB instance structure
  *
@@ -104,6 +129,16 @@ struct fcb {
 	struct flash_sector *f_sectors;
 	/**< Array of sectors, must be contiguous */
 
+#ifdef CONFIG_FCB_SECTOR_SUMMARY
+	struct fcb_sector_summary *f_summaries;
+	/**< Optional array of f_sector_cnt sector summaries, or NULL.
+	 * Elements of a sector whose summary has no invalid element are
+	 * located by reading their length only, without reading their data
+	 * to check their CRC, and empty sectors are skipped without reading
+	 * the flash.
+	 */
+#endif
+
 	/* Flash circular buffer internal state */
 	struct k_mutex f_mtx;
 	/**< Locking for accessing the FCB data, internal state */
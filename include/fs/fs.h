@@ -138,6 +138,17 @@ struct fs_statvfs {
 	unsigned long f_bfree;
 };
 
+/**
+ * @brief Buffer of a vectored read or write
+ *
+ * @param base Start of the buffer
+ * @param len Length of the buffer in bytes
+ */
+struct fs_iovec {
+	void *base;
+	size_t len;
+};
+
 
 /**
  * @name fs_open open and creation mode flags
@@ -156,8 +167,10 @@ struct fs_statvfs {
 #define FS_O_CREATE     0x10
 /** Open/create file for append */
 #define FS_O_APPEND     0x20
+/** Open/create file as an append stream, implies @c FS_O_APPEND */
+#define FS_O_STREAM     0x40
 /** Bitmask for open/create flags */
-#define FS_O_FLAGS_MASK 0x30
+#define FS_O_FLAGS_MASK 0x70
 
 /** Bitmask for open flags */
 #define FS_O_MASK       (FS_O_MODE_MASK | FS_O_FLAGS_MASK)
@@ -198,6 +211,11 @@ struct fs_statvfs {
  *   - @c FS_O_RDWR open for read/write (<tt>FS_O_READ | FS_O_WRITE</tt>)
  *   - @c FS_O_CREATE create file if it does not exist
  *   - @c FS_O_APPEND move to end of file before each write
+ *   - @c FS_O_STREAM open as an append stream: like @c FS_O_APPEND, and
+ *     file systems supporting it may defer the commit of the file metadata
+ *     requested by fs_sync() until enough data was appended or enough time
+ *     elapsed since the last commit, see the file system documentation.
+ *     Data written since the last commit may be lost on power failure.
  *
  * If @p flags are set to 0 the function will attempt to open an existing file
  * with no read/write access; this may be used to e.g. check if the file exists.
@@ -302,6 +320,42 @@ ssize_t fs_read(struct fs_file_t *zfp, void *ptr, size_t size);
  */
 ssize_t fs_write(struct fs_file_t *zfp, const void *ptr, size_t size);
 
+/**
+ * @brief Read file into several buffers
+ *
+ * Reads consecutive data of the file into the buffers, in order, as
+ * fs_read() would for each of them, and stops at the end of the file. File
+ * systems supporting it do it atomically with respect to the other
+ * operations on the file system.
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Buffers
+ * @param iovcnt Number of buffers
+ *
+ * @retval >=0 a number of bytes read, on success;
+ * @retval <0 a negative errno code on error, if no data was read.
+ */
+ssize_t fs_readv(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		 int iovcnt);
+
+/**
+ * @brief Write several buffers to file
+ *
+ * Writes the buffers, in order, as fs_write() would for each of them, and
+ * stops at the first partial write. File systems supporting it do it
+ * atomically with respect to the other operations on the file system.
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Buffers
+ * @param iovcnt Number of buffers
+ *
+ * @retval >=0 a number of bytes written, on success;
+ * @retval -ENOTSUP when not implemented by underlying file system driver;
+ * @retval <0 an other negative errno code on error, if no data was written.
+ */
+ssize_t fs_writev(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		  int iovcnt);
+
 /**
  * @brief Seek file
  *
@@ -357,6 +411,25 @@ off_t fs_tell(struct fs_file_t *zfp);
  */
 int fs_truncate(struct fs_file_t *zfp, off_t length);
 
+/**
+ * @brief Reserve storage for an open file
+ *
+ * Reserves the storage needed for the file to grow to @p length bytes, so
+ * that writing it up to that size does not fail for lack of space, like
+ * fallocate() with FALLOC_FL_KEEP_SIZE: the size of the file is not
+ * changed. The reservation is released as the file grows, and when the file
+ * is closed. A new call replaces the previous reservation of the file.
+ *
+ * @param zfp Pointer to the file object
+ * @param length Size of the file to reserve storage for
+ *
+ * @retval 0 on success;
+ * @retval -ENOSPC if there is not enough free space;
+ * @retval -ENOTSUP when not implemented by underlying file system driver;
+ * @retval <0 an other negative errno code on error.
+ */
+int fs_fallocate(struct fs_file_t *zfp, off_t length);
+
 /**
  * @brief Flush cached write data buffers of an open file
  *
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_FS_FS_ASYNC_H_
+#define ZEPHYR_INCLUDE_FS_FS_ASYNC_H_
+
+#include <kernel.h>
+#include <fs/fs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Asynchronous file requests
+ * @defgroup file_system_async_api Asynchronous File System APIs
+ * @ingroup file_system_api
+ * @{
+ */
+
+/** @brief Operation of an asynchronous request */
+enum fs_async_op {
+	/** fs_readv() */
+	FS_ASYNC_READ,
+	/** fs_writev() */
+	FS_ASYNC_WRITE,
+	/** fs_sync() */
+	FS_ASYNC_SYNC,
+};
+
+struct fs_async_req;
+
+/**
+ * @brief Completion callback of an asynchronous request
+ *
+ * Called from the worker thread which executed the request. The request can
+ * be reused or freed.
+ *
+ * @param req Request
+ * @param result Result of the operation, see fs_readv(), fs_writev() and
+ *	  fs_sync()
+ */
+typedef void (*fs_async_cb_t)(struct fs_async_req *req, ssize_t result);
+
+/**
+ * @brief Asynchronous request
+ *
+ * The request, its buffers and the file belong to the worker thread from its
+ * submission until its completion.
+ *
+ * @param op Operation
+ * @param zfp Open file
+ * @param iov Buffers of a read or write
+ * @param iovcnt Number of buffers
+ * @param cb Optional, called on completion
+ * @param signal Optional, raised with the result on completion
+ * @param user_data Opaque pointer for the submitter
+ * @param result Result of the operation, set on completion
+ */
+struct fs_async_req {
+	void *fifo_reserved;
+	enum fs_async_op op;
+	struct fs_file_t *zfp;
+	const struct fs_iovec *iov;
+	int iovcnt;
+	fs_async_cb_t cb;
+	struct k_poll_signal *signal;
+	void *user_data;
+	ssize_t result;
+};
+
+/**
+ * @brief Submit an asynchronous request
+ *
+ * Queues the request to a worker thread and returns. The requests of a file
+ * are always executed by the same worker, in submission order, and the
+ * requests of different files may be executed concurrently by the
+ * CONFIG_FILE_SYSTEM_ASYNC_WORKERS workers.
+ *
+ * @param req Request
+ *
+ * @retval 0 if the request was queued;
+ * @retval -EBADF if the file is not open;
+ * @retval -EINVAL if the request is invalid.
+ */
+int fs_async_submit(struct fs_async_req *req);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_FS_FS_ASYNC_H_ */
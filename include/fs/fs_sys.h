@@ -38,6 +38,9 @@ extern "C" {
  * @param stat Checks the status of a file or directory specified by the path
  * @param statvfs Returns the total and available space on the file system
  *        volume
+ * @param readv Optional, reads into several buffers
+ * @param writev Optional, writes several buffers
+ * @param fallocate Optional, reserves storage for a file
  */
 struct fs_file_system_t {
 	/* File operations */
@@ -66,6 +69,12 @@ struct fs_file_system_t {
 					struct fs_dirent *entry);
 	int (*statvfs)(struct fs_mount_t *mountp, const char *path,
 					struct fs_statvfs *stat);
+	/* Vectored file operations */
+	ssize_t (*readv)(struct fs_file_t *filp, const struct fs_iovec *iov,
+			 int iovcnt);
+	ssize_t (*writev)(struct fs_file_t *filp, const struct fs_iovec *iov,
+			  int iovcnt);
+	int (*fallocate)(struct fs_file_t *filp, off_t length);
 };
 
 /**
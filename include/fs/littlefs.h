@@ -37,6 +37,9 @@ struct fs_littlefs {
 	struct lfs lfs;
 	const struct flash_area *area;
 	struct k_mutex mutex;
+
+	/* Blocks reserved by fs_fallocate() for the open files. */
+	lfs_size_t reserved_blocks;
 };
 
 /** @brief Define a littlefs configuration with customized size
@@ -292,6 +292,14 @@ struct k_thread_runtime_stats {
 #else
 	uint64_t execution_cycles;
 #endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+	/* Wait-to-run latencies, bucket N counts 2^N to 2^(N+1) - 1 cycles */
+	uint32_t wait_hist[CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST_BUCKETS];
+
+	/* Longest wait-to-run latency in cycles */
+	uint32_t wait_max_cycles;
+#endif
 };
 
 typedef struct k_thread_runtime_stats k_thread_runtime_stats_t;
@@ -304,10 +312,75 @@ struct _thread_runtime_stats {
 	uint32_t last_switched_in;
 #endif
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+	/* Timestamp when made ready to run, 0 if not waiting */
+#ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
+	timing_t last_ready;
+#else
+	uint32_t last_ready;
+#endif
+#endif
+
 	k_thread_runtime_stats_t stats;
 };
 #endif
 
+#ifdef CONFIG_IRQ_RUNTIME_STATS
+struct k_irq_runtime_stats {
+	/* Number of times the ISR was executed */
+	uint32_t count;
+
+	/* Longest ISR execution in cycles */
+	uint32_t max_cycles;
+
+	/* ISR execution cycles, nested interrupts excluded */
+	uint64_t execution_cycles;
+};
+
+typedef struct k_irq_runtime_stats k_irq_runtime_stats_t;
+#endif
+
+#ifdef CONFIG_LOCK_STATS
+enum k_lock_type {
+	K_LOCK_SPINLOCK,
+	K_LOCK_MUTEX,
+	K_LOCK_SEM,
+};
+
+struct k_lock_stats {
+	/* Object address */
+	const void *obj;
+
+	/* Object name, NULL if none was set */
+	const char *name;
+
+	enum k_lock_type type;
+
+	/* Number of acquisitions */
+	uint32_t count;
+
+	/* Number of attempts which found the object unavailable */
+	uint32_t contended;
+
+	/* Longest wait for the object in cycles */
+	uint32_t wait_max_cycles;
+
+	/* Longest hold of the object in cycles */
+	uint32_t hold_max_cycles;
+
+	/* Total wait for the object in cycles */
+	uint64_t wait_cycles;
+
+	/* Total hold of the object in cycles */
+	uint64_t hold_cycles;
+};
+
+typedef struct k_lock_stats k_lock_stats_t;
+
+typedef void (*k_lock_stats_cb_t)(const k_lock_stats_t *stats,
+				  void *user_data);
+#endif
+
 /**
  * @ingroup thread_apis
  * Thread Structure
@@ -3370,6 +3443,11 @@ struct k_mutex {
 	/** Original thread priority */
 	int owner_orig_prio;
 
+#ifdef CONFIG_LOCK_STATS_MUTEX
+	/** Cycle count when the current owner acquired the mutex */
+	uint32_t stats_start;
+#endif
+
 	_OBJECT_TRACING_NEXT_PTR(k_mutex)
 	_OBJECT_TRACING_LINKED_FLAG
 };
@@ -5169,6 +5247,61 @@ int k_thread_runtime_stats_all_get(k_thread_runtime_stats_t *stats);
 
 #endif
 
+#ifdef CONFIG_IRQ_RUNTIME_STATS
+
+/**
+ * @brief Get the runtime statistics of an IRQ line
+ *
+ * @param irq IRQ line.
+ * @param stats Pointer to struct to copy statistics into.
+ * @return -EINVAL if null pointer or IRQ line is not accounted, otherwise 0
+ */
+int k_irq_runtime_stats_get(unsigned int irq, k_irq_runtime_stats_t *stats);
+
+#endif
+
+#ifdef CONFIG_LOCK_STATS
+
+/**
+ * @brief Iterate over the lock statistics
+ *
+ * Calls the callback once per tracked object, with the statistics of all
+ * CPUs summed. The statistics of each CPU are copied consistently, but they
+ * keep being updated meanwhile, so the statistics of different CPUs may be
+ * copied at slightly different times.
+ *
+ * @param cb Callback.
+ * @param user_data User data passed to the callback.
+ */
+void k_lock_stats_foreach(k_lock_stats_cb_t cb, void *user_data);
+
+/**
+ * @brief Reset the lock statistics
+ *
+ * Forgets all tracked objects, the names are kept. Every CPU clears its
+ * own statistics when it next accounts an object.
+ */
+void k_lock_stats_reset(void);
+
+/**
+ * @brief Name an object in the lock statistics
+ *
+ * @param obj Object address.
+ * @param name Name, must stay valid.
+ * @return -ENOMEM if the name table is full, otherwise 0
+ */
+int k_lock_stats_name_set(const void *obj, const char *name);
+
+/**
+ * @brief Get the number of acquisitions which could not be tracked
+ *
+ * @return Number of acquisitions of objects which did not fit in the
+ *         object table of a CPU.
+ */
+uint32_t k_lock_stats_untracked_get(void);
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
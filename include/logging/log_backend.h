@@ -37,6 +37,10 @@ struct log_backend_api {
 	void (*put_sync_hexdump)(const struct log_backend *const backend,
 			 struct log_msg_ids src_level, uint32_t timestamp,
 			 const char *metadata, const uint8_t *data, uint32_t len);
+	void (*put_package)(const struct log_backend *const backend,
+			 struct log_msg_ids src_level, uint32_t timestamp,
+			 const void *package, const uint8_t *data,
+			 uint32_t len);
 
 	void (*dropped)(const struct log_backend *const backend, uint32_t cnt);
 	void (*panic)(const struct log_backend *const backend);
@@ -102,6 +106,34 @@ static inline void log_backend_put(const struct log_backend *const backend,
 	backend->api->put(backend, msg);
 }
 
+/**
+ * @brief Put packaged log message to the backend.
+ *
+ * Backends which don't implement put_package cannot be used with
+ * CONFIG_LOG_PACKAGED, which depends on them being disabled.
+ *
+ * @param[in] backend   Pointer to the backend instance.
+ * @param[in] src_level Message details.
+ * @param[in] timestamp Timestamp.
+ * @param[in] package   Message created with cbprintf_package().
+ * @param[in] data      Hexdump data, NULL if not a hexdump message.
+ * @param[in] len       Hexdump data length.
+ */
+static inline void log_backend_put_package(
+					const struct log_backend *const backend,
+					struct log_msg_ids src_level,
+					uint32_t timestamp, const void *package,
+					const uint8_t *data, uint32_t len)
+{
+	__ASSERT_NO_MSG(backend != NULL);
+	__ASSERT_NO_MSG(package != NULL);
+
+	if (backend->api->put_package) {
+		backend->api->put_package(backend, src_level, timestamp,
+					  package, data, len);
+	}
+}
+
 /**
  * @brief Synchronously process log message.
  *
@@ -48,6 +48,36 @@ log_backend_std_put(const struct log_output *const log_output, uint32_t flags,
 	log_msg_put(msg);
 }
 
+/** @brief Put packaged log message to a standard logger backend.
+ *
+ * @param log_output	Log output instance.
+ * @param flags		Formatting flags.
+ * @param src_level	Log message source and level.
+ * @param timestamp	Timestamp.
+ * @param package	Message created with cbprintf_package().
+ * @param data		Hexdump data, NULL if not a hexdump message.
+ * @param length	Length of the hexdump data.
+ */
+static inline void
+log_backend_std_put_package(const struct log_output *const log_output,
+			    uint32_t flags, struct log_msg_ids src_level,
+			    uint32_t timestamp, const void *package,
+			    const uint8_t *data, uint32_t length)
+{
+	flags |= (LOG_OUTPUT_FLAG_LEVEL | LOG_OUTPUT_FLAG_TIMESTAMP);
+
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_SHOW_COLOR)) {
+		flags |= LOG_OUTPUT_FLAG_COLORS;
+	}
+
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_FORMAT_TIMESTAMP)) {
+		flags |= LOG_OUTPUT_FLAG_FORMAT_TIMESTAMP;
+	}
+
+	log_output_package(log_output, src_level, timestamp, package, data,
+			   length, flags);
+}
+
 /** @brief Put a standard logger backend into panic mode.
  *
  * @param log_output	Log output instance.
@@ -188,6 +188,8 @@ extern "C" {
 			log_from_user(_src_level, __VA_ARGS__);		 \
 		} else if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {		 \
 			log_string_sync(_src_level, __VA_ARGS__);	 \
+		} else if (IS_ENABLED(CONFIG_LOG_PACKAGED)) {		 \
+			log_packaged(_src_level, __VA_ARGS__);		 \
 		} else {						 \
 			Z_LOG_INTERNAL_X(Z_LOG_NARGS_POSTFIX(__VA_ARGS__), \
 						_src_level, __VA_ARGS__);\
@@ -576,6 +578,17 @@ void log_n(const char *str,
 void log_hexdump(const char *str, const void *data, uint32_t length,
 		 struct log_msg_ids src_level);
 
+/** @brief Standard log stored as a cbprintf package.
+ *
+ * Used instead of log_0..log_n when CONFIG_LOG_PACKAGED is enabled.
+ *
+ * @param src_level	Log identification.
+ * @param fmt		String to format.
+ * @param ...		Variable list of arguments.
+ */
+__printf_like(2, 3)
+void log_packaged(struct log_msg_ids src_level, const char *fmt, ...);
+
 /** @brief Process log message synchronously.
  *
  * @param src_level	Log message details.
@@ -784,7 +797,8 @@ static inline log_arg_t z_log_do_strdup(uint32_t msk, uint32_t idx,
 do {									       \
 	if (is_user_context) {						       \
 		log_generic_from_user(_src_level, _str, _valist);	       \
-	} else if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {			       \
+	} else if (IS_ENABLED(CONFIG_LOG_IMMEDIATE) ||			       \
+		   IS_ENABLED(CONFIG_LOG_PACKAGED)) {			       \
 		log_generic(_src_level, _str, _valist, _strdup_action);        \
 	} else if (_argnum == 0) {					       \
 		_LOG_INTERNAL_0(_src_level, _str);			       \
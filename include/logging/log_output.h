@@ -50,6 +50,11 @@ extern "C" {
  */
 #define LOG_OUTPUT_FLAG_FORMAT_SYST		BIT(7)
 
+/** @brief Flag forcing dictionary based binary output. Only packaged messages
+ *         and dropped messages indications are supported.
+ */
+#define LOG_OUTPUT_FLAG_FORMAT_DICTIONARY	BIT(8)
+
 /**
  * @brief Prototype of the function processing output data.
  *
@@ -145,6 +150,25 @@ void log_output_hexdump(const struct log_output *log_output,
 			     const char *metadata, const uint8_t *data,
 			     uint32_t length, uint32_t flags);
 
+/** @brief Process packaged log message
+ *
+ * Function is formatting a message created with cbprintf_package() adding
+ * optional prefixes and postfixes.
+ *
+ * @param log_output Pointer to log_output instance.
+ * @param src_level  Log source and level structure.
+ * @param timestamp  Timestamp.
+ * @param package    Package.
+ * @param data       Hexdump data, NULL if not a hexdump message.
+ * @param length     Hexdump data length.
+ * @param flags      Optional flags.
+ *
+ */
+void log_output_package(const struct log_output *log_output,
+			struct log_msg_ids src_level, uint32_t timestamp,
+			const void *package, const uint8_t *data,
+			uint32_t length, uint32_t flags);
+
 /** @brief Process dropped messages indication.
  *
  * Function prints error message indicating lost log messages.
@@ -154,6 +178,16 @@ void log_output_hexdump(const struct log_output *log_output,
  */
 void log_output_dropped_process(const struct log_output *log_output, uint32_t cnt);
 
+/** @brief Process dropped messages indication in dictionary based format.
+ *
+ * Function emits a binary record reporting lost log messages.
+ *
+ * @param log_output Pointer to the log output instance.
+ * @param cnt        Number of dropped messages.
+ */
+void log_output_dict_dropped_process(const struct log_output *log_output,
+				     uint32_t cnt);
+
 /** @brief Flush output buffer.
  *
  * @param log_output Pointer to the log output instance.
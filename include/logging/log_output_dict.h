@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_LOGGING_LOG_OUTPUT_DICT_H_
+#define ZEPHYR_INCLUDE_LOGGING_LOG_OUTPUT_DICT_H_
+
+#include <stdint.h>
+#include <toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Dictionary based log output records
+ * @defgroup log_output_dict Dictionary based log output records
+ * @ingroup log_output
+ * @{
+ */
+
+/** @brief Record with a standard log message. */
+#define LOG_DICT_MSG_TYPE_STD		0U
+
+/** @brief Record with a hexdump log message. */
+#define LOG_DICT_MSG_TYPE_HEXDUMP	1U
+
+/** @brief Record with a dropped messages indication. */
+#define LOG_DICT_MSG_TYPE_DROPPED	2U
+
+/** @brief Encode severity and domain into the ids field of a record. */
+#define LOG_DICT_MSG_IDS(_level, _domain_id) \
+	((uint8_t)(((_level) & 0x7) | (((_domain_id) & 0x7) << 3)))
+
+/** @brief Header of a log message record.
+ *
+ * The header is followed by @p pkg_len bytes of the package created with
+ * cbprintf_package() and @p data_len bytes of hexdump data. All fields are
+ * in the byte order of the target.
+ */
+struct log_dict_msg_hdr {
+	uint8_t type;		/*!< LOG_DICT_MSG_TYPE_STD or _HEXDUMP. */
+	uint8_t ids;		/*!< Severity in bits 0-2, domain in 3-5. */
+	uint16_t source_id;	/*!< Source ID. */
+	uint32_t timestamp;	/*!< Timestamp. */
+	uint16_t pkg_len;	/*!< Length of the package. */
+	uint16_t data_len;	/*!< Length of the hexdump data. */
+} __packed;
+
+/** @brief Dropped messages indication record. */
+struct log_dict_dropped_hdr {
+	uint8_t type;		/*!< LOG_DICT_MSG_TYPE_DROPPED. */
+	uint8_t reserved[3];
+	uint32_t count;		/*!< Number of dropped messages. */
+} __packed;
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_LOGGING_LOG_OUTPUT_DICT_H_ */
@@ -23,6 +23,7 @@
 #include <kernel.h>
 #include <net/net_ip.h>
 #include <net/http_parser.h>
+#include <net/tls_credentials.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -62,6 +63,29 @@ typedef int (*http_payload_cb_t)(int sock,
 				 struct http_request *req,
 				 void *user_data);
 
+/**
+ * @typedef http_chunk_cb_t
+ * @brief Callback used when the payload is sent with chunked transfer
+ * encoding. The callback is called repeatedly, and each piece of data it
+ * provides is sent to the server as one chunk, without copying it.
+ *
+ * @param sock Socket id of the connection
+ * @param req HTTP request information
+ * @param data Pointer to the next chunk of data, set by the callback. The
+ *        data must stay valid until the callback is called again.
+ * @param user_data User specified data specified in http_client_req()
+ *
+ * @return >0 length of the chunk, in this case http_client_req() should
+ *             send it and call the callback again,
+ *         0   if there is no more data to send,
+ *         <0  if http_client_req() should return the error code to the
+ *             caller.
+ */
+typedef int (*http_chunk_cb_t)(int sock,
+			       struct http_request *req,
+			       const uint8_t **data,
+			       void *user_data);
+
 /**
  * @typedef http_header_cb_t
  * @brief Callback can be used if application wants to construct additional
@@ -239,6 +263,14 @@ struct http_request {
 	 */
 	http_payload_cb_t payload_cb;
 
+	/** User supplied callback function to call when payload needs to be
+	 * sent with chunked transfer encoding. If set, the request is sent
+	 * with "Transfer-Encoding: chunked" header, and the payload and
+	 * payload_cb fields are ignored. This allows streaming data of
+	 * unknown length to the server.
+	 */
+	http_chunk_cb_t payload_chunk_cb;
+
 	/** Payload, may be NULL */
 	const char *payload;
 
@@ -285,6 +317,83 @@ struct http_request {
 int http_client_req(int sock, struct http_request *req,
 		    int32_t timeout, void *user_data);
 
+/**
+ * HTTP server endpoint for the connection pool. Connections in the pool are
+ * shared between requests with the same host, port and TLS setting.
+ */
+struct http_client_endpoint {
+	/** Address of the server, the port is taken from here */
+	const struct sockaddr *addr;
+
+	/** Length of the server address */
+	socklen_t addrlen;
+
+	/** Hostname of the server. It is used to identify the endpoint, and
+	 * as the TLS hostname.
+	 */
+	const char *host;
+
+	/** TLS security tags used for the connection, if TLS is used */
+	const sec_tag_t *sec_tag_list;
+
+	/** Number of entries in sec_tag_list */
+	size_t sec_tag_count;
+
+	/** Is the connection secured with TLS */
+	bool tls;
+};
+
+/**
+ * @brief Do a HTTP request over a pooled keep-alive connection.
+ *
+ * @details An idle connection to the same endpoint is reused if there is
+ * one, otherwise a new connection is established. After the response has
+ * been received, the connection is returned to the pool unless the server
+ * asked to close it. If a reused connection turns out to be closed by the
+ * server before any response data was received, the request is retried once
+ * on a new connection.
+ *
+ * @param ep Server endpoint.
+ * @param req HTTP request information. The protocol should be "HTTP/1.1"
+ *        for the connection to be kept alive.
+ * @param timeout Max timeout to wait for the data, in milliseconds.
+ * @param user_data User specified data that is passed to the callback.
+ *
+ * @return <0 if error, >=0 amount of data sent to the server
+ */
+int http_client_pool_req(const struct http_client_endpoint *ep,
+			 struct http_request *req,
+			 int32_t timeout, void *user_data);
+
+/**
+ * @brief Do pipelined HTTP requests over a pooled keep-alive connection.
+ *
+ * @details All requests are sent back to back on one connection, and then
+ * responses are received in the same order. Only requests that are safe to
+ * repeat (e.g. GET or HEAD) should be pipelined, as the server may close the
+ * connection after any response. Data received past the end of a response
+ * is moved to the receive buffer of the next request, so each receive buffer
+ * must be at least as long as the one of the previous request.
+ *
+ * @param ep Server endpoint.
+ * @param reqs Array of HTTP requests.
+ * @param count Number of requests.
+ * @param timeout Max timeout to wait for each response, in milliseconds.
+ * @param user_data User specified data that is passed to the callbacks.
+ *
+ * @return <0 if error, otherwise the number of requests that received a
+ *         complete response. Requests that were not completed may be
+ *         resubmitted.
+ */
+int http_client_pool_pipeline(const struct http_client_endpoint *ep,
+			      struct http_request **reqs, size_t count,
+			      int32_t timeout, void *user_data);
+
+/**
+ * @brief Close all idle connections in the HTTP client connection pool.
+ */
+void http_client_pool_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -450,6 +450,16 @@ struct mqtt_internal {
 
 	/** Internal. Remaining payload length to read. */
 	uint32_t remaining_payload;
+
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW)
+	/** Internal. Message IDs of publish messages awaiting
+	 *  acknowledgment.
+	 */
+	uint16_t inflight[CONFIG_MQTT_INFLIGHT_WINDOW_SIZE];
+
+	/** Internal. Number of publish messages awaiting acknowledgment. */
+	uint16_t inflight_count;
+#endif /* CONFIG_MQTT_INFLIGHT_WINDOW */
 };
 
 /**
@@ -584,7 +594,17 @@ int mqtt_connect(struct mqtt_client *client);
  * @param[in] param Parameters to be used for the publish message.
  *                  Shall not be NULL.
  *
+ * @note The payload is sent directly from the memory pointed to by
+ *       param->message.payload.data, only the fixed and variable headers are
+ *       encoded in the client TX buffer. The payload size is therefore not
+ *       limited by the TX buffer size.
+ * @note With @option{CONFIG_MQTT_INFLIGHT_WINDOW} enabled, QoS 1 and QoS 2
+ *       messages can be published without waiting for the acknowledgment of
+ *       previous ones, as long as the number of unacknowledged messages does
+ *       not exceed @option{CONFIG_MQTT_INFLIGHT_WINDOW_SIZE}.
+ *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ *         -EBUSY if the in-flight window is full.
  */
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param);
@@ -125,6 +125,48 @@ struct zsock_pollfd {
  *  the TLS handshake.
  */
 #define TLS_ALPN_LIST 7
+/** Socket option to enable TLS session caching on a socket. It accepts and
+ *  returns an integer with a session cache mode:
+ *    - 0 - disabled
+ *    - 1 - enabled
+ *
+ *  For clients, the session negotiated during handshake is stored in a
+ *  cache keyed by the peer address, hostname and security tags, and is
+ *  offered to the server on subsequent connections (session ID or session
+ *  ticket resumption). For servers, enabling the cache on a listening
+ *  socket allows accepted connections to resume sessions negotiated
+ *  earlier. Session caching is disabled by default.
+ */
+#define TLS_SESSION_CACHE 8
+/** Write-only socket option to purge the client session cache. It does not
+ *  require any value to be set.
+ */
+#define TLS_SESSION_CACHE_PURGE 9
+/** Socket option to configure DTLS Connection ID (RFC 9146) usage. It
+ *  accepts and returns an integer with a Connection ID mode:
+ *    - 0 - disabled, Connection ID extension is not negotiated
+ *    - 1 - supported, peer may ask to use a Connection ID in the records
+ *          sent to it, but no Connection ID is requested for incoming records
+ *    - 2 - enabled, a random Connection ID is requested for incoming records
+ *
+ *  With Connection ID in use on incoming records, the DTLS session is not
+ *  bound to the peer address, so the peer may change its address (e.g. due
+ *  to NAT rebinding) without a new handshake. A DTLS client behind NAT
+ *  needs at least the supported mode, the server needs the enabled mode.
+ *  The option has to be set before the DTLS handshake. Requires
+ *  MBEDTLS_SSL_DTLS_CONNECTION_ID to be enabled in the mbedTLS config.
+ */
+#define TLS_DTLS_CID 10
+/** Read-only socket option to read the DTLS Connection ID status of an
+ *  established DTLS session. It returns an integer being a bitmask of
+ *  TLS_DTLS_CID_STATUS_* flags.
+ */
+#define TLS_DTLS_CID_STATUS 11
+/** Read-only socket option to check whether the handshake of a TLS client
+ *  socket resumed a session from the session cache. It returns an integer,
+ *  1 if the session was resumed, 0 if a full handshake was performed.
+ */
+#define TLS_SESSION_RESUMED 12
 
 /** @} */
 
@@ -137,6 +179,20 @@ struct zsock_pollfd {
 #define TLS_DTLS_ROLE_CLIENT 0 /**< Client role in a DTLS session. */
 #define TLS_DTLS_ROLE_SERVER 1 /**< Server role in a DTLS session. */
 
+/* Valid values for TLS_SESSION_CACHE option */
+#define TLS_SESSION_CACHE_DISABLED 0 /**< Disable TLS session caching. */
+#define TLS_SESSION_CACHE_ENABLED 1 /**< Enable TLS session caching. */
+
+/* Valid values for TLS_DTLS_CID option */
+#define TLS_DTLS_CID_DISABLED 0 /**< Connection ID is not used. */
+#define TLS_DTLS_CID_SUPPORTED 1 /**< Peer may use Connection ID. */
+#define TLS_DTLS_CID_ENABLED 2 /**< Own Connection ID is requested. */
+
+/* Flags returned by TLS_DTLS_CID_STATUS option */
+#define TLS_DTLS_CID_STATUS_DISABLED 0 /**< Connection ID not in use. */
+#define TLS_DTLS_CID_STATUS_DOWNLINK 1 /**< Incoming records use CID. */
+#define TLS_DTLS_CID_STATUS_UPLINK 2 /**< Outgoing records use CID. */
+
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
 	int ai_flags;
@@ -300,6 +300,26 @@ int settings_load_subtree_direct(
 	settings_load_direct_cb cb,
 	void                   *param);
 
+/**
+ * Read the value of a single setting from the persistence sources.
+ *
+ * Only the newest value of the given setting is read from the backend,
+ * without loading the other settings and without calling any handler. When
+ * the setting is stored in more than one source, the value of the last
+ * registered source is returned, as @ref settings_load would set it.
+ *
+ * @note
+ * This function does not call commit function.
+ *
+ * @param[in]  name    Name/key of the settings item.
+ * @param[out] buf     Buffer for the value.
+ * @param[in]  buf_len Size of the buffer, a longer value is truncated.
+ *
+ * @return length of the value read on success, -ENOENT when the setting
+ *         is not stored or is deleted, other negative on failure.
+ */
+int settings_get_val(const char *name, void *buf, size_t buf_len);
+
 /**
  * Save currently running serialized items. All serialized items which are
  * different from currently persisted values will be saved.
@@ -425,6 +445,21 @@ struct settings_store_itf {
 	 * load callback only on the final entity.
 	 */
 
+	int (*csi_get_val)(struct settings_store *cs, const char *name,
+			   void *buf, size_t buf_len);
+	/**< Reads the newest value of a single setting, optional.
+	 *
+	 * Parameters:
+	 *  - cs - Corresponding backend handler node
+	 *  - name - Key in string format
+	 *  - buf - Buffer for the value
+	 *  - buf_len - Size of the buffer
+	 *
+	 * Return: length of the value read, -ENOENT when the setting is not
+	 * stored or is deleted, other negative on failure. Without this
+	 * handler @ref settings_get_val loads the setting through csi_load.
+	 */
+
 	int (*csi_save_start)(struct settings_store *cs);
 	/**< Handler called before an export operation.
 	 *
@@ -594,6 +629,57 @@ int settings_runtime_commit(const char *name);
 
 #endif /* CONFIG_SETTINGS_RUNTIME */
 
+#ifdef CONFIG_SETTINGS_TXN
+
+/**
+ * @defgroup settings_txn Settings subsystem transactions
+ * @brief API for batched settings saves
+ * @ingroup settings
+ * @{
+ */
+
+/**
+ * Begin a settings transaction.
+ *
+ * Until the commit or the abort of the transaction, the settings saved with
+ * @ref settings_save_one or deleted with @ref settings_delete by the calling
+ * thread are kept in RAM, a setting saved twice once. Other threads using
+ * the settings wait for the end of the transaction. Settings loaded or read
+ * with @ref settings_get_val in between are the stored ones.
+ *
+ * @return 0 on success, -EBUSY if a transaction is in progress.
+ */
+int settings_txn_begin(void);
+
+/**
+ * Commit a settings transaction.
+ *
+ * Write the settings saved since @ref settings_txn_begin, called by the
+ * same thread. Either all or none of them are stored if the write is
+ * interrupted by a power loss, the transaction being completed on the next
+ * @ref settings_subsys_init. Several settings are written with one journal
+ * record more, and its deletion, than when saved individually.
+ *
+ * @return 0 on success, -EINVAL if no transaction is in progress, other
+ * negative on failure.
+ */
+int settings_txn_commit(void);
+
+/**
+ * Abort a settings transaction.
+ *
+ * Drop the settings saved since @ref settings_txn_begin, called by the
+ * same thread.
+ *
+ * @return 0 on success, -EINVAL if no transaction is in progress.
+ */
+int settings_txn_abort(void);
+/**
+ * @}
+ */
+
+#endif /* CONFIG_SETTINGS_TXN */
+
 
 #ifdef __cplusplus
 }
@@ -588,6 +588,7 @@ struct shell_transport {
  */
 struct shell_stats {
 	atomic_t log_lost_cnt; /*!< Lost log counter.*/
+	atomic_t tx_stall_cnt; /*!< Transport full, output blocked counter.*/
 };
 
 #ifdef CONFIG_SHELL_STATS
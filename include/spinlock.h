@@ -34,8 +34,13 @@ struct k_spinlock {
 	uintptr_t thread_cpu;
 #endif
 
+#ifdef CONFIG_LOCK_STATS_SPINLOCK
+	/* Cycle count when the lock was acquired */
+	uint32_t stats_start;
+#endif
+
 #if defined(CONFIG_CPLUSPLUS) && !defined(CONFIG_SMP) && \
-	!defined(CONFIG_SPIN_VALIDATE)
+	!defined(CONFIG_SPIN_VALIDATE) && !defined(CONFIG_LOCK_STATS_SPINLOCK)
 	/* If CONFIG_SMP and CONFIG_SPIN_VALIDATE are both not defined
 	 * the k_spinlock struct will have no members. The result
 	 * is that in C sizeof(k_spinlock) is 0 and in C++ it is 1.
@@ -64,6 +69,14 @@ void z_spin_lock_set_owner(struct k_spinlock *l);
 BUILD_ASSERT(CONFIG_MP_NUM_CPUS < 4, "Too many CPUs for mask");
 #endif /* CONFIG_SPIN_VALIDATE */
 
+/* Lock contention statistics, see CONFIG_LOCK_STATS. Called with the local
+ * interrupts locked, the acquire hook does the actual locking.
+ */
+#ifdef CONFIG_LOCK_STATS_SPINLOCK
+void z_spin_lock_stats_acquire(struct k_spinlock *l);
+void z_spin_lock_stats_release(struct k_spinlock *l);
+#endif /* CONFIG_LOCK_STATS_SPINLOCK */
+
 /**
  * @brief Spinlock key type
  *
@@ -123,7 +136,9 @@ static ALWAYS_INLINE k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
 # endif
 #endif
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_LOCK_STATS_SPINLOCK)
+	z_spin_lock_stats_acquire(l);
+#elif defined(CONFIG_SMP)
 	while (!atomic_cas(&l->locked, 0, 1)) {
 	}
 #endif
@@ -163,6 +178,10 @@ static ALWAYS_INLINE void k_spin_unlock(struct k_spinlock *l,
 	__ASSERT(z_spin_unlock_valid(l), "Not my spinlock %p", l);
 #endif
 
+#ifdef CONFIG_LOCK_STATS_SPINLOCK
+	z_spin_lock_stats_release(l);
+#endif
+
 #ifdef CONFIG_SMP
 	/* Strictly we don't need atomic_clear() here (which is an
 	 * exchange operation that returns the old value).  We are always
@@ -185,6 +204,9 @@ static ALWAYS_INLINE void k_spin_release(struct k_spinlock *l)
 #ifdef CONFIG_SPIN_VALIDATE
 	__ASSERT(z_spin_unlock_valid(l), "Not my spinlock %p", l);
 #endif
+#ifdef CONFIG_LOCK_STATS_SPINLOCK
+	z_spin_lock_stats_release(l);
+#endif
 #ifdef CONFIG_SMP
 	atomic_clear(&l->locked);
 #endif
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Binary statistics snapshots.
+ *
+ * A snapshot serialises the values of all registered statistics groups, and
+ * optionally of the network statistics and of the memory slab usage, into a
+ * CBOR map in one pass. Values are sent without their names, in the order
+ * of the schema: collectors fetch the names once, with
+ * stats_snapshot_schema_encode(), and identify them afterwards by the schema
+ * hash sent with every snapshot.
+ *
+ * A snapshot is a CBOR map with the following unsigned integer keys:
+ *
+ * - STATS_SNAPSHOT_KEY_SCHEMA: schema hash.
+ * - STATS_SNAPSHOT_KEY_SEQ: sequence number of the snapshot.
+ * - STATS_SNAPSHOT_KEY_VALUES: array of all values (full snapshot).
+ * - STATS_SNAPSHOT_KEY_BASE: sequence number of the snapshot a delta
+ *   snapshot is relative to.
+ * - STATS_SNAPSHOT_KEY_DELTA: array of index, value pairs of the values
+ *   which changed since the base snapshot (delta snapshot).
+ *
+ * A delta snapshot is only encoded if the previous snapshot of the same
+ * context was encoded successfully and the schema did not change, otherwise
+ * a full snapshot is encoded. A collector which missed a snapshot, i.e. sees
+ * a base which is not the last sequence number it received, has to request a
+ * full snapshot.
+ *
+ * The schema is a CBOR map with the STATS_SNAPSHOT_KEY_SCHEMA key and the
+ * STATS_SNAPSHOT_KEY_GROUPS key, an array with, for each group, an array of
+ * its name, its value count and the names of its values. The network
+ * statistics group ("net") holds the counters of struct net_stats, in the
+ * structure order, and the memory slab group ("slab") the number of used
+ * blocks of each statically defined slab, in the linker order, and their
+ * values are not named.
+ */
+
+#ifndef ZEPHYR_INCLUDE_STATS_STATS_SNAPSHOT_H_
+#define ZEPHYR_INCLUDE_STATS_STATS_SNAPSHOT_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Keys of the snapshot and schema CBOR maps. */
+enum stats_snapshot_key {
+	STATS_SNAPSHOT_KEY_SCHEMA = 0,
+	STATS_SNAPSHOT_KEY_SEQ = 1,
+	STATS_SNAPSHOT_KEY_VALUES = 2,
+	STATS_SNAPSHOT_KEY_BASE = 3,
+	STATS_SNAPSHOT_KEY_DELTA = 4,
+	STATS_SNAPSHOT_KEY_GROUPS = 5,
+};
+
+/**
+ * @brief Snapshot context of a collector.
+ *
+ * Holds the values of the last snapshot, the base of the next delta
+ * snapshot. Define it with STATS_SNAPSHOT_CTX_DEFINE().
+ */
+struct stats_snapshot_ctx {
+	uint64_t *values;
+	uint16_t max_values;
+	uint16_t cnt;
+	uint32_t schema;
+	uint32_t seq;
+	bool valid;
+};
+
+/**
+ * @brief Define a snapshot context.
+ *
+ * @param _name Name of the context.
+ * @param _max_values Maximum number of values of a snapshot.
+ */
+#define STATS_SNAPSHOT_CTX_DEFINE(_name, _max_values)			\
+	static uint64_t _name##_values[_max_values];			\
+	static struct stats_snapshot_ctx _name = {			\
+		.values = _name##_values,				\
+		.max_values = (_max_values),				\
+	}
+
+/**
+ * @brief Get the schema hash.
+ *
+ * The hash covers the names, entry sizes and value counts of all groups,
+ * and the names of their values. It is cached and only computed again
+ * after a statistics group has been registered.
+ *
+ * @param cnt If not NULL, set to the number of values of a snapshot.
+ *
+ * @return Schema hash.
+ */
+uint32_t stats_snapshot_schema(uint16_t *cnt);
+
+/**
+ * @brief Encode the schema.
+ *
+ * @param buf Output buffer.
+ * @param size Size of the output buffer.
+ *
+ * @return Length of the encoded schema, or -ENOMEM if the buffer is too
+ *	   small.
+ */
+int stats_snapshot_schema_encode(uint8_t *buf, size_t size);
+
+/**
+ * @brief Encode a snapshot.
+ *
+ * A context must not be used by several threads at the same time.
+ *
+ * @param ctx Snapshot context.
+ * @param delta Encode a delta snapshot if possible.
+ * @param buf Output buffer.
+ * @param size Size of the output buffer.
+ *
+ * @return Length of the encoded snapshot, -ENOMEM if the buffer is too small
+ *	   or -E2BIG if the context cannot hold all values. A delta snapshot
+ *	   is not encoded after an error.
+ */
+int stats_snapshot_encode(struct stats_snapshot_ctx *ctx, bool delta,
+			  uint8_t *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_STATS_STATS_SNAPSHOT_H_ */
@@ -21,6 +21,7 @@
  */
 
 #include <stdbool.h>
+#include <kernel.h>
 #include <drivers/flash.h>
 
 #ifdef __cplusplus
@@ -44,6 +45,42 @@ extern "C" {
  */
 typedef int (*stream_flash_callback_t)(uint8_t *buf, size_t len, size_t offset);
 
+struct stream_flash_ctx;
+
+/**
+ * @typedef stream_flash_progress_callback_t
+ *
+ * @brief Signature for callback invoked after each buffer is written.
+ *
+ * @details Functions of this type are invoked after a write buffer has been
+ * written to flash, and verified if a stream_flash_callback_t is set. With
+ * double buffered writes they are invoked from the stream flash thread.
+ *
+ * @param ctx The stream flash context.
+ * @param bytes_written Number of bytes written to flash so far.
+ */
+typedef void (*stream_flash_progress_callback_t)(struct stream_flash_ctx *ctx,
+						 size_t bytes_written);
+
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+/* State of double buffered writes, see stream_flash_async_enable() */
+struct stream_flash_async {
+	void *fifo_reserved; /* Used by the stream flash thread queue */
+	struct k_sem idle; /* Available when no buffer is being written */
+	uint8_t *buf; /* Buffer being written */
+	size_t len; /* Length of the buffer being written */
+	size_t addr; /* Offset the buffer is written to */
+	size_t queued; /* Number of bytes handed to the stream flash thread */
+	int rc; /* Result of the last buffer write */
+	bool enabled;
+#ifdef CONFIG_STREAM_FLASH_ERASE
+	uint32_t erase_ahead; /* Number of pages to erase ahead */
+	off_t erase_end; /* End of the area erased so far */
+	off_t ahead_end; /* End of the area to erase ahead */
+#endif
+};
+#endif /* CONFIG_STREAM_FLASH_ASYNC */
+
 /**
  * @brief Structure for stream flash context
  *
@@ -59,9 +96,13 @@ struct stream_flash_ctx {
 	size_t offset; /* Offset from base of flash device to write area */
 	size_t available; /* Available bytes in write area */
 	stream_flash_callback_t callback; /* Callback invoked after write op */
+	stream_flash_progress_callback_t progress; /* Invoked after write op */
 #ifdef CONFIG_STREAM_FLASH_ERASE
 	off_t last_erased_page_start_offset; /* Last erased offset */
 #endif
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	struct stream_flash_async async; /* Double buffered writes */
+#endif
 };
 
 /**
@@ -128,6 +169,52 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
  */
 int stream_flash_erase_page(struct stream_flash_ctx *ctx, off_t off);
 
+/**
+ * @brief Set the callback invoked after each buffer is written to flash.
+ *
+ * @param ctx context
+ * @param cb Callback to be invoked, NULL to disable.
+ */
+void stream_flash_progress_cb_set(struct stream_flash_ctx *ctx,
+				  stream_flash_progress_callback_t cb);
+
+#if defined(CONFIG_STREAM_FLASH_ASYNC) || defined(__DOXYGEN__)
+/**
+ * @brief Enable double buffered writes.
+ *
+ * The write buffer given to stream_flash_init() is split in two halves. When
+ * one half is full, it is erased if needed, written and verified by the
+ * stream flash thread, while stream_flash_buffered_write() returns and fills
+ * the other half. stream_flash_buffered_write() only waits for the flash
+ * when both halves are full. An error of the stream flash thread is returned
+ * by the next call to stream_flash_buffered_write(). A flush waits for all
+ * the data to be written, stream_flash_bytes_written() returns the number of
+ * bytes written so far.
+ *
+ * When the thread has no buffer to write, it erases up to @p erase_ahead
+ * pages following the written data, within the area given to
+ * stream_flash_init(), so that the next buffers are written without waiting
+ * for an erase. It erases one page each
+ * CONFIG_STREAM_FLASH_ASYNC_ERASE_AHEAD_PERIOD milliseconds. Erasing ahead
+ * stops with the flush.
+ *
+ * Must be called after stream_flash_init() and before writing any data.
+ * The context must be flushed before it is initialized again.
+ * stream_flash_erase_page() must not be called while data is being written.
+ *
+ * @param ctx context
+ * @param erase_ahead Number of pages to erase ahead of the written data,
+ *		      0 to only erase pages when they are written to.
+ *
+ * @return 0 on success, -EINVAL if the write buffer can not be split in two
+ * halves of a multiple of the flash device write-block-size or data is
+ * buffered, -ENOTSUP if @p erase_ahead is not 0 and CONFIG_STREAM_FLASH_ERASE
+ * is disabled.
+ */
+int stream_flash_async_enable(struct stream_flash_ctx *ctx,
+			      uint32_t erase_ahead);
+#endif /* CONFIG_STREAM_FLASH_ASYNC */
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,7 +9,9 @@
 
 #include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <toolchain.h>
+#include <sys/util.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -166,6 +168,102 @@ int snprintfcb(char *str, size_t size, const char *format, ...);
  */
 int vsnprintfcb(char *str, size_t size, const char *format, va_list ap);
 
+/** @brief Copy all string arguments into the package.
+ *
+ * By default only the pointer of a @c %s argument is stored, which requires
+ * the string to remain valid until the package is formatted.
+ */
+#define CBPRINTF_PACKAGE_COPY_STR BIT(0)
+
+/** @brief Copy string arguments which are not in read-only memory into the
+ * package.
+ *
+ * Strings in read-only memory are stored as pointers.
+ */
+#define CBPRINTF_PACKAGE_COPY_RW_STR BIT(1)
+
+/** @brief Header at the start of each package.
+ *
+ * The arguments follow the header, packed at their promoted sizes without
+ * padding. Copied strings are stored in place of their pointer, including
+ * the terminating null byte.
+ */
+struct cbprintf_package_hdr {
+	/** Length of the whole package, including this header. */
+	uint16_t len;
+
+	/** Format string. */
+	const char *fmt;
+};
+
+/** @brief Capture a format string and its arguments into a package.
+ *
+ * The package is a self-contained byte buffer which can be stored or
+ * passed to another context and formatted later with cbpprintf().
+ *
+ * @note The format string is always stored as a pointer and must remain
+ * valid until the package is formatted.
+ *
+ * @param packaged buffer where the package is stored, or NULL to only
+ * calculate the length of the package.
+ *
+ * @param len length of @p packaged.
+ *
+ * @param flags @c CBPRINTF_PACKAGE_ flags controlling how string arguments
+ * are stored.
+ *
+ * @param format a standard ISO C format string with characters and conversion
+ * specifications.
+ *
+ * @param ... arguments corresponding to the conversion specifications found
+ * within @p format.
+ *
+ * @return the length of the package in bytes, -ENOSPC if it does not fit
+ * in @p len bytes, or -EINVAL if it is too long to be represented.
+ */
+__printf_like(4, 5)
+int cbprintf_package(void *packaged, size_t len, uint32_t flags,
+		     const char *format, ...);
+
+/** @brief Capture a format string and a va_list of arguments into a
+ * package.
+ *
+ * See cbprintf_package() for details.
+ *
+ * @param packaged buffer where the package is stored, or NULL to only
+ * calculate the length of the package.
+ *
+ * @param len length of @p packaged.
+ *
+ * @param flags @c CBPRINTF_PACKAGE_ flags controlling how string arguments
+ * are stored.
+ *
+ * @param format a standard ISO C format string with characters and conversion
+ * specifications.
+ *
+ * @param ap a reference to the values to be captured.
+ *
+ * @return the length of the package in bytes, -ENOSPC if it does not fit
+ * in @p len bytes, or -EINVAL if it is too long to be represented.
+ */
+int cbvprintf_package(void *packaged, size_t len, uint32_t flags,
+		      const char *format, va_list ap);
+
+/** @brief Generate the output for a package created by cbprintf_package().
+ *
+ * @note The package must be aligned to a pointer.
+ *
+ * @param out the function used to emit each generated character.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param packaged the package.
+ *
+ * @return the number of characters printed, or a negative error value
+ * returned from invoking @p out.
+ */
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged);
+
 /**
  * @}
  */
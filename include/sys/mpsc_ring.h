@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/** @file */
+
+#ifndef ZEPHYR_INCLUDE_SYS_MPSC_RING_H_
+#define ZEPHYR_INCLUDE_SYS_MPSC_RING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Lock-free multiple producer, single consumer ring
+ * @defgroup mpsc_ring_apis MPSC ring APIs
+ * @ingroup datastructure_apis
+ *
+ * A ring of variable-length entries which can be written concurrently by
+ * multiple contexts, including interrupts and other CPUs, without locking.
+ *
+ * A producer claims space for an entry, writes it and commits it. The
+ * consumer sees entries in the order in which they were claimed, and an
+ * entry which is claimed but not committed blocks the entries after it.
+ *
+ * When a producer is allowed to overwrite, it makes room by dropping the
+ * oldest committed entries. The consumer therefore copies an entry out and
+ * then consumes it with mpsc_ring_consume(), which fails if the entry was
+ * dropped meanwhile, in which case the copy must be discarded.
+ *
+ * @{
+ */
+
+/** @brief Bytes used in the ring by each entry in addition to its data. */
+#define MPSC_RING_ENTRY_OVERHEAD 8
+
+/** @brief Ring instance. */
+struct mpsc_ring {
+	atomic_t wr;   /**< Free running position of the next claim. */
+	atomic_t rd;   /**< Free running position of the oldest entry. */
+	atomic_t claiming; /**< Number of claims in progress. */
+	uint8_t *buf;  /**< Ring memory. */
+	uint32_t size; /**< Size of the ring memory, a power of two. */
+};
+
+/** @brief Location of an entry in the ring. */
+struct mpsc_ring_entry {
+	uint32_t pos;  /**< Position of the entry. */
+	uint32_t len;  /**< Length of the entry data. */
+};
+
+/**
+ * @brief Initialize a ring.
+ *
+ * @param ring Ring.
+ * @param buf  Ring memory, aligned to 4 bytes.
+ * @param size Size of the ring memory. Must be a power of two.
+ */
+void mpsc_ring_init(struct mpsc_ring *ring, void *buf, uint32_t size);
+
+/**
+ * @brief Claim space for an entry.
+ *
+ * @param ring      Ring.
+ * @param len       Length of the entry data.
+ * @param overwrite If true, the oldest entries are dropped when there is not
+ *		    enough space.
+ * @param dropped   Location for the number of entries dropped to make room,
+ *		    set also when the claim fails.
+ * @param entry     Location for the claimed entry.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if there is not enough space, or in overwrite mode, the
+ *	   oldest entry is not committed yet.
+ */
+int mpsc_ring_claim(struct mpsc_ring *ring, uint32_t len, bool overwrite,
+		    uint32_t *dropped, struct mpsc_ring_entry *entry);
+
+/**
+ * @brief Write data of a claimed entry.
+ *
+ * @param ring   Ring.
+ * @param entry  Claimed entry.
+ * @param offset Offset in the entry data.
+ * @param data   Data to write.
+ * @param len    Length of the data.
+ */
+void mpsc_ring_write(struct mpsc_ring *ring,
+		     const struct mpsc_ring_entry *entry, uint32_t offset,
+		     const void *data, uint32_t len);
+
+/**
+ * @brief Commit a claimed entry, making it visible to the consumer.
+ *
+ * @param ring  Ring.
+ * @param entry Claimed entry.
+ */
+void mpsc_ring_commit(struct mpsc_ring *ring,
+		      const struct mpsc_ring_entry *entry);
+
+/**
+ * @brief Get the oldest entry without consuming it.
+ *
+ * @param ring  Ring.
+ * @param entry Location for the entry.
+ *
+ * @return True if the oldest entry is committed.
+ */
+bool mpsc_ring_peek(struct mpsc_ring *ring, struct mpsc_ring_entry *entry);
+
+/**
+ * @brief Read data of an entry.
+ *
+ * The data is only valid if the entry is then consumed successfully.
+ *
+ * @param ring   Ring.
+ * @param entry  Entry returned by mpsc_ring_peek().
+ * @param offset Offset in the entry data.
+ * @param data   Location for the data.
+ * @param len    Length of the data.
+ */
+void mpsc_ring_read(struct mpsc_ring *ring,
+		    const struct mpsc_ring_entry *entry, uint32_t offset,
+		    void *data, uint32_t len);
+
+/**
+ * @brief Consume an entry.
+ *
+ * @param ring  Ring.
+ * @param entry Entry returned by mpsc_ring_peek().
+ *
+ * @return True if the entry was consumed, false if it was dropped by a
+ *	   producer or consumed by another context since it was peeked.
+ */
+bool mpsc_ring_consume(struct mpsc_ring *ring,
+		       const struct mpsc_ring_entry *entry);
+
+/**
+ * @brief Check if a ring is empty.
+ *
+ * @param ring Ring.
+ *
+ * @return True if there are no entries, committed or not, in the ring.
+ */
+static inline bool mpsc_ring_is_empty(struct mpsc_ring *ring)
+{
+	return atomic_get(&ring->rd) == atomic_get(&ring->wr);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_MPSC_RING_H_ */
@@ -173,6 +173,34 @@ void z_thread_mark_switched_out(void);
 
 #endif /* CONFIG_INSTRUMENT_THREAD_SWITCHING */
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+void z_thread_mark_ready(struct k_thread *thread);
+#else
+
+/**
+ * @brief Called when a thread is added to the run queue
+ */
+#define z_thread_mark_ready(thread)
+
+#endif /* CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST */
+
+#ifdef CONFIG_IRQ_RUNTIME_STATS
+/* Called by the architecture before and after the ISR of an IRQ line */
+void z_irq_runtime_stats_enter(unsigned int irq);
+void z_irq_runtime_stats_exit(unsigned int irq);
+#endif
+
+#ifdef CONFIG_LOCK_STATS
+/* Called by the kernel objects when they are acquired, when an attempt to
+ * acquire them fails, and when their owner releases them.
+ */
+void z_lock_stats_acquired(const void *obj, enum k_lock_type type,
+			   bool contended, uint32_t wait);
+void z_lock_stats_failed(const void *obj, enum k_lock_type type);
+void z_lock_stats_released(const void *obj, enum k_lock_type type,
+			   uint32_t hold);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Per IRQ line runtime statistics. The architecture calls the enter and exit
+ * hooks around every ISR it dispatches. The time spent in nested interrupts
+ * is subtracted from the interrupted ISR, so each line is only charged for
+ * its own execution.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <kernel_internal.h>
+#include <string.h>
+
+/* Deeper nesting is counted but not timed. */
+#define NESTING_MAX 8
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
+typedef timing_t irq_time_t;
+#define irq_time_get() timing_counter_get()
+#else
+typedef uint32_t irq_time_t;
+#define irq_time_get() k_cycle_get_32()
+#endif /* CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS */
+
+struct irq_frame {
+	irq_time_t start;
+
+	/* Cycles spent in interrupts nested in this one */
+	uint32_t nested;
+};
+
+struct irq_cpu_state {
+	struct irq_frame frames[NESTING_MAX];
+	unsigned int depth;
+};
+
+static struct irq_cpu_state irq_cpu_states[CONFIG_MP_NUM_CPUS];
+static k_irq_runtime_stats_t irq_stats[CONFIG_IRQ_RUNTIME_STATS_NUM_IRQS];
+
+static uint32_t irq_cycles_get(irq_time_t *start, irq_time_t *end)
+{
+#ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
+	return (uint32_t)MIN(timing_cycles_get(start, end), UINT32_MAX);
+#else
+	return *end - *start;
+#endif /* CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS */
+}
+
+void z_irq_runtime_stats_enter(unsigned int irq)
+{
+	unsigned int key = arch_irq_lock();
+	struct irq_cpu_state *state = &irq_cpu_states[_current_cpu->id];
+
+	ARG_UNUSED(irq);
+
+	if (state->depth < NESTING_MAX) {
+		state->frames[state->depth].nested = 0U;
+		state->frames[state->depth].start = irq_time_get();
+	}
+
+	state->depth++;
+
+	arch_irq_unlock(key);
+}
+
+void z_irq_runtime_stats_exit(unsigned int irq)
+{
+	unsigned int key = arch_irq_lock();
+	struct irq_cpu_state *state = &irq_cpu_states[_current_cpu->id];
+	struct irq_frame *frame;
+	k_irq_runtime_stats_t *stats;
+	uint32_t total, cycles;
+	irq_time_t now;
+
+	if (state->depth == 0U) {
+		/* Exit without enter, e.g. stats enabled from an ISR */
+		arch_irq_unlock(key);
+		return;
+	}
+
+	state->depth--;
+
+	if (irq < ARRAY_SIZE(irq_stats)) {
+		irq_stats[irq].count++;
+	}
+
+	if (state->depth >= NESTING_MAX) {
+		arch_irq_unlock(key);
+		return;
+	}
+
+	now = irq_time_get();
+	frame = &state->frames[state->depth];
+	total = irq_cycles_get(&frame->start, &now);
+	cycles = total - MIN(frame->nested, total);
+
+	if (state->depth > 0U) {
+		state->frames[state->depth - 1].nested += total;
+	}
+
+	if (irq < ARRAY_SIZE(irq_stats)) {
+		stats = &irq_stats[irq];
+		stats->execution_cycles += cycles;
+
+		if (cycles > stats->max_cycles) {
+			stats->max_cycles = cycles;
+		}
+	}
+
+	arch_irq_unlock(key);
+}
+
+int k_irq_runtime_stats_get(unsigned int irq, k_irq_runtime_stats_t *stats)
+{
+	unsigned int key;
+
+	if ((stats == NULL) || (irq >= ARRAY_SIZE(irq_stats))) {
+		return -EINVAL;
+	}
+
+	/* The statistics are only updated with interrupts locked. */
+	key = irq_lock();
+	(void)memcpy(stats, &irq_stats[irq], sizeof(*stats));
+	irq_unlock(key);
+
+	return 0;
+}
@@ -0,0 +1,386 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Lock contention statistics. Every CPU accounts the objects it acquires in
+ * its own open addressing table, keyed by the object address, with its
+ * local interrupts locked, so the hooks need no lock of their own: they are
+ * called from k_spin_lock() itself. Reading the cycle counter may take a
+ * driver spinlock, so the hooks are not reentered from within themselves.
+ *
+ * The hooks make the sequence number of the table odd while they update
+ * it, so readers on other CPUs retry until they copied an entry while the
+ * number was even and unchanged. Atomic operations are not used for it, as
+ * they may be implemented with a spinlock. A reset only bumps the
+ * generation, every CPU clears its own table when it next enters the
+ * hooks, and tables of an older generation are read as empty meanwhile.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <kernel_internal.h>
+#include <string.h>
+
+#define TABLE_SIZE CONFIG_LOCK_STATS_TABLE_SIZE
+
+BUILD_ASSERT((TABLE_SIZE & (TABLE_SIZE - 1)) == 0,
+	     "Lock statistics table size must be a power of two");
+
+struct lock_name {
+	const void *obj;
+	const char *name;
+};
+
+struct lock_cpu {
+	k_lock_stats_t entries[TABLE_SIZE];
+	uint32_t untracked;
+	uint32_t gen;
+	volatile uint32_t seq;
+};
+
+static struct lock_cpu lock_cpus[CONFIG_MP_NUM_CPUS];
+static struct lock_name lock_names[CONFIG_LOCK_STATS_NAMES];
+static atomic_t lock_names_cnt;
+static volatile uint32_t lock_gen;
+
+#define seq_barrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+static inline uint32_t hash(const void *obj)
+{
+	/* Fibonacci hashing, objects are at least 4 bytes aligned */
+	return ((uint32_t)((uintptr_t)obj >> 2) * 2654435761U) &
+	       (TABLE_SIZE - 1U);
+}
+
+static k_lock_stats_t *entry_get(struct lock_cpu *cpu, const void *obj,
+				 enum k_lock_type type)
+{
+	uint32_t idx = hash(obj);
+
+	for (uint32_t i = 0; i < TABLE_SIZE; i++) {
+		k_lock_stats_t *entry = &cpu->entries[idx];
+
+		if (entry->obj == obj) {
+			return entry;
+		}
+
+		if (entry->obj == NULL) {
+			entry->obj = obj;
+			entry->type = type;
+
+			return entry;
+		}
+
+		idx = (idx + 1U) & (TABLE_SIZE - 1U);
+	}
+
+	cpu->untracked++;
+
+	return NULL;
+}
+
+/* Must be called with the local interrupts locked. Returns NULL if the
+ * hooks are reentered.
+ */
+static struct lock_cpu *cpu_enter(void)
+{
+	struct lock_cpu *cpu = &lock_cpus[_current_cpu->id];
+	uint32_t gen = lock_gen;
+
+	if (cpu->seq & 1U) {
+		return NULL;
+	}
+
+	cpu->seq++;
+	seq_barrier();
+
+	if (cpu->gen != gen) {
+		(void)memset(cpu->entries, 0, sizeof(cpu->entries));
+		cpu->untracked = 0U;
+		cpu->gen = gen;
+	}
+
+	return cpu;
+}
+
+static void cpu_exit(struct lock_cpu *cpu)
+{
+	seq_barrier();
+	cpu->seq++;
+}
+
+/* Copy an entry of a table, which may be updated meanwhile. Returns false
+ * if the entry is not in use.
+ */
+static bool entry_read(struct lock_cpu *cpu, uint32_t idx,
+		       k_lock_stats_t *out)
+{
+	uint32_t seq;
+	bool current;
+
+	do {
+		seq = cpu->seq;
+		seq_barrier();
+
+		current = (cpu->gen == lock_gen);
+		*out = cpu->entries[idx];
+
+		seq_barrier();
+	} while ((seq & 1U) || cpu->seq != seq);
+
+	return current && out->obj != NULL;
+}
+
+static bool entry_find(struct lock_cpu *cpu, const void *obj,
+		       k_lock_stats_t *out)
+{
+	uint32_t idx = hash(obj);
+
+	for (uint32_t i = 0; i < TABLE_SIZE; i++) {
+		if (!entry_read(cpu, idx, out)) {
+			return false;
+		}
+
+		if (out->obj == obj) {
+			return true;
+		}
+
+		idx = (idx + 1U) & (TABLE_SIZE - 1U);
+	}
+
+	return false;
+}
+
+static void record_acquired(struct lock_cpu *cpu, const void *obj,
+			    enum k_lock_type type, bool contended,
+			    uint32_t wait)
+{
+	k_lock_stats_t *entry = entry_get(cpu, obj, type);
+
+	if (entry == NULL) {
+		return;
+	}
+
+	entry->count++;
+
+	if (contended) {
+		entry->contended++;
+		entry->wait_cycles += wait;
+		entry->wait_max_cycles = MAX(entry->wait_max_cycles, wait);
+	}
+}
+
+static void record_released(struct lock_cpu *cpu, const void *obj,
+			    enum k_lock_type type, uint32_t hold)
+{
+	k_lock_stats_t *entry = entry_get(cpu, obj, type);
+
+	if (entry == NULL) {
+		return;
+	}
+
+	entry->hold_cycles += hold;
+	entry->hold_max_cycles = MAX(entry->hold_max_cycles, hold);
+}
+
+#ifdef CONFIG_LOCK_STATS_SPINLOCK
+void z_spin_lock_stats_acquire(struct k_spinlock *l)
+{
+	struct lock_cpu *cpu = cpu_enter();
+	bool contended = false;
+	uint32_t wait = 0U;
+
+	if (cpu == NULL) {
+#ifdef CONFIG_SMP
+		while (!atomic_cas(&l->locked, 0, 1)) {
+		}
+#endif
+		return;
+	}
+
+#ifdef CONFIG_SMP
+	if (!atomic_cas(&l->locked, 0, 1)) {
+		uint32_t start = k_cycle_get_32();
+
+		while (!atomic_cas(&l->locked, 0, 1)) {
+		}
+
+		contended = true;
+		wait = k_cycle_get_32() - start;
+	}
+#endif
+
+	record_acquired(cpu, l, K_LOCK_SPINLOCK, contended, wait);
+	l->stats_start = k_cycle_get_32();
+
+	cpu_exit(cpu);
+}
+
+void z_spin_lock_stats_release(struct k_spinlock *l)
+{
+	struct lock_cpu *cpu = cpu_enter();
+
+	if (cpu == NULL) {
+		return;
+	}
+
+	record_released(cpu, l, K_LOCK_SPINLOCK,
+			k_cycle_get_32() - l->stats_start);
+
+	cpu_exit(cpu);
+}
+#endif /* CONFIG_LOCK_STATS_SPINLOCK */
+
+void z_lock_stats_acquired(const void *obj, enum k_lock_type type,
+			   bool contended, uint32_t wait)
+{
+	unsigned int key = arch_irq_lock();
+	struct lock_cpu *cpu = cpu_enter();
+
+	if (cpu != NULL) {
+		record_acquired(cpu, obj, type, contended, wait);
+		cpu_exit(cpu);
+	}
+
+	arch_irq_unlock(key);
+}
+
+void z_lock_stats_failed(const void *obj, enum k_lock_type type)
+{
+	unsigned int key = arch_irq_lock();
+	struct lock_cpu *cpu = cpu_enter();
+	k_lock_stats_t *entry;
+
+	if (cpu != NULL) {
+		entry = entry_get(cpu, obj, type);
+		if (entry != NULL) {
+			entry->contended++;
+		}
+		cpu_exit(cpu);
+	}
+
+	arch_irq_unlock(key);
+}
+
+void z_lock_stats_released(const void *obj, enum k_lock_type type,
+			   uint32_t hold)
+{
+	unsigned int key = arch_irq_lock();
+	struct lock_cpu *cpu = cpu_enter();
+
+	if (cpu != NULL) {
+		record_released(cpu, obj, type, hold);
+		cpu_exit(cpu);
+	}
+
+	arch_irq_unlock(key);
+}
+
+static const char *name_get(const void *obj)
+{
+	int cnt = MIN(atomic_get(&lock_names_cnt), ARRAY_SIZE(lock_names));
+
+	for (int i = 0; i < cnt; i++) {
+		if (lock_names[i].obj == obj) {
+			return lock_names[i].name;
+		}
+	}
+
+	return NULL;
+}
+
+int k_lock_stats_name_set(const void *obj, const char *name)
+{
+	int idx = atomic_inc(&lock_names_cnt);
+
+	if (idx >= ARRAY_SIZE(lock_names)) {
+		atomic_dec(&lock_names_cnt);
+		return -ENOMEM;
+	}
+
+	lock_names[idx].name = name;
+	lock_names[idx].obj = obj;
+
+	return 0;
+}
+
+void k_lock_stats_foreach(k_lock_stats_cb_t cb, void *user_data)
+{
+	k_lock_stats_t sum, other;
+
+	for (int i = 0; i < ARRAY_SIZE(lock_cpus); i++) {
+		for (uint32_t j = 0; j < TABLE_SIZE; j++) {
+			bool seen = false;
+
+			if (!entry_read(&lock_cpus[i], j, &sum)) {
+				continue;
+			}
+
+			/* Report each object once, from the first CPU which
+			 * tracks it.
+			 */
+			for (int k = 0; k < i; k++) {
+				if (entry_find(&lock_cpus[k], sum.obj,
+					       &other)) {
+					seen = true;
+					break;
+				}
+			}
+
+			if (seen) {
+				continue;
+			}
+
+			sum.name = name_get(sum.obj);
+
+			for (int k = i + 1; k < ARRAY_SIZE(lock_cpus); k++) {
+				if (!entry_find(&lock_cpus[k], sum.obj,
+						&other)) {
+					continue;
+				}
+
+				sum.count += other.count;
+				sum.contended += other.contended;
+				sum.wait_cycles += other.wait_cycles;
+				sum.hold_cycles += other.hold_cycles;
+				sum.wait_max_cycles = MAX(sum.wait_max_cycles,
+							  other.wait_max_cycles);
+				sum.hold_max_cycles = MAX(sum.hold_max_cycles,
+							  other.hold_max_cycles);
+			}
+
+			cb(&sum, user_data);
+		}
+	}
+}
+
+void k_lock_stats_reset(void)
+{
+	lock_gen++;
+	seq_barrier();
+}
+
+uint32_t k_lock_stats_untracked_get(void)
+{
+	uint32_t untracked = 0U;
+
+	for (int i = 0; i < ARRAY_SIZE(lock_cpus); i++) {
+		struct lock_cpu *cpu = &lock_cpus[i];
+		uint32_t seq, cnt;
+
+		do {
+			seq = cpu->seq;
+			seq_barrier();
+
+			cnt = (cpu->gen == lock_gen) ? cpu->untracked : 0U;
+
+			seq_barrier();
+		} while ((seq & 1U) || cpu->seq != seq);
+
+		untracked += cnt;
+	}
+
+	return untracked;
+}
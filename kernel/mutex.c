@@ -31,6 +31,7 @@
 #include <toolchain.h>
 #include <ksched.h>
 #include <wait_q.h>
+#include <kernel_internal.h>
 #include <errno.h>
 #include <init.h>
 #include <syscall_handler.h>
@@ -47,6 +48,40 @@ LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
  */
 static struct k_spinlock lock;
 
+static inline uint32_t stats_now(void)
+{
+#ifdef CONFIG_LOCK_STATS_MUTEX
+	return k_cycle_get_32();
+#else
+	return 0U;
+#endif
+}
+
+static inline void stats_acquired(struct k_mutex *mutex, bool contended,
+				  uint32_t wait_start)
+{
+#ifdef CONFIG_LOCK_STATS_MUTEX
+	mutex->stats_start = k_cycle_get_32();
+	z_lock_stats_acquired(mutex, K_LOCK_MUTEX, contended,
+			      mutex->stats_start - wait_start);
+#endif
+}
+
+static inline void stats_failed(struct k_mutex *mutex)
+{
+#ifdef CONFIG_LOCK_STATS_MUTEX
+	z_lock_stats_failed(mutex, K_LOCK_MUTEX);
+#endif
+}
+
+static inline void stats_released(struct k_mutex *mutex)
+{
+#ifdef CONFIG_LOCK_STATS_MUTEX
+	z_lock_stats_released(mutex, K_LOCK_MUTEX,
+			      k_cycle_get_32() - mutex->stats_start);
+#endif
+}
+
 #ifdef CONFIG_OBJECT_TRACING
 
 struct k_mutex *_trace_list_k_mutex;
@@ -121,6 +156,7 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 	int new_prio;
 	k_spinlock_key_t key;
 	bool resched = false;
+	uint32_t wait_start;
 
 	__ASSERT(!arch_is_in_isr(), "mutexes cannot be used inside ISRs");
 
@@ -133,6 +169,10 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 					_current->base.prio :
 					mutex->owner_orig_prio;
 
+		if (mutex->lock_count == 0U) {
+			stats_acquired(mutex, false, 0U);
+		}
+
 		mutex->lock_count++;
 		mutex->owner = _current;
 
@@ -147,6 +187,7 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 	}
 
 	if (unlikely(K_TIMEOUT_EQ(timeout, K_NO_WAIT))) {
+		stats_failed(mutex);
 		k_spin_unlock(&lock, key);
 		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
 		return -EBUSY;
@@ -161,6 +202,8 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 		resched = adjust_owner_prio(mutex, new_prio);
 	}
 
+	wait_start = stats_now();
+
 	int got_mutex = z_pend_curr(&lock, key, &mutex->wait_q, timeout);
 
 	LOG_DBG("on mutex %p got_mutex value: %d", mutex, got_mutex);
@@ -169,12 +212,15 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 		got_mutex ? 'y' : 'n');
 
 	if (got_mutex == 0) {
+		stats_acquired(mutex, true, wait_start);
 		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
 		return 0;
 	}
 
 	/* timed out */
 
+	stats_failed(mutex);
+
 	LOG_DBG("%p timeout on mutex %p", _current, mutex);
 
 	key = k_spin_lock(&lock);
@@ -249,6 +295,8 @@ int z_impl_k_mutex_unlock(struct k_mutex *mutex)
 
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
+	stats_released(mutex);
+
 	adjust_owner_prio(mutex, mutex->owner_orig_prio);
 
 	/* Get the new owner, if any */
@@ -422,6 +422,7 @@ static void ready_thread(struct k_thread *thread)
 	 */
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		sys_trace_thread_ready(thread);
+		z_thread_mark_ready(thread);
 		_priq_run_add(&_kernel.ready_q.runq, thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(0);
@@ -1154,6 +1155,10 @@ void z_sched_init(void)
 	k_sched_time_slice_set(CONFIG_TIMESLICE_SIZE,
 		CONFIG_TIMESLICE_PRIORITY);
 #endif
+
+#ifdef CONFIG_LOCK_STATS
+	(void)k_lock_stats_name_set(&sched_spinlock, "sched_spinlock");
+#endif
 }
 
 int z_impl_k_thread_priority_get(k_tid_t thread)
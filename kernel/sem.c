@@ -24,6 +24,7 @@
 #include <wait_q.h>
 #include <sys/dlist.h>
 #include <ksched.h>
+#include <kernel_internal.h>
 #include <init.h>
 #include <syscall_handler.h>
 #include <tracing/tracing.h>
@@ -38,6 +39,31 @@
  */
 static struct k_spinlock lock;
 
+static inline uint32_t stats_now(void)
+{
+#ifdef CONFIG_LOCK_STATS_SEM
+	return k_cycle_get_32();
+#else
+	return 0U;
+#endif
+}
+
+static inline void stats_acquired(struct k_sem *sem, bool contended,
+				  uint32_t wait_start)
+{
+#ifdef CONFIG_LOCK_STATS_SEM
+	z_lock_stats_acquired(sem, K_LOCK_SEM, contended,
+			      k_cycle_get_32() - wait_start);
+#endif
+}
+
+static inline void stats_failed(struct k_sem *sem)
+{
+#ifdef CONFIG_LOCK_STATS_SEM
+	z_lock_stats_failed(sem, K_LOCK_SEM);
+#endif
+}
+
 #ifdef CONFIG_OBJECT_TRACING
 
 struct k_sem *_trace_list_k_sem;
@@ -136,6 +162,7 @@ static inline void z_vrfy_k_sem_give(struct k_sem *sem)
 int z_impl_k_sem_take(struct k_sem *sem, k_timeout_t timeout)
 {
 	int ret = 0;
+	uint32_t wait_start;
 
 	__ASSERT(((arch_is_in_isr() == false) ||
 		  K_TIMEOUT_EQ(timeout, K_NO_WAIT)), "");
@@ -146,18 +173,28 @@ int z_impl_k_sem_take(struct k_sem *sem, k_timeout_t timeout)
 	if (likely(sem->count > 0U)) {
 		sem->count--;
 		k_spin_unlock(&lock, key);
+		stats_acquired(sem, false, 0U);
 		ret = 0;
 		goto out;
 	}
 
 	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
 		k_spin_unlock(&lock, key);
+		stats_failed(sem);
 		ret = -EBUSY;
 		goto out;
 	}
 
+	wait_start = stats_now();
+
 	ret = z_pend_curr(&lock, key, &sem->wait_q, timeout);
 
+	if (ret == 0) {
+		stats_acquired(sem, true, wait_start);
+	} else {
+		stats_failed(sem);
+	}
+
 out:
 	sys_trace_end_call(SYS_TRACE_ID_SEMA_TAKE);
 	return ret;
@@ -1023,6 +1023,63 @@ static inline k_ticks_t z_vrfy_k_thread_timeout_expires_ticks(
 #include <syscalls/k_thread_timeout_expires_ticks_mrsh.c>
 #endif
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+static void wait_hist_add(k_thread_runtime_stats_t *stats, uint64_t wait)
+{
+	uint32_t cycles = (uint32_t)MIN(wait, UINT32_MAX);
+	unsigned int bucket = MAX(find_msb_set(cycles), 1U) - 1U;
+
+	bucket = MIN(bucket, CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST_BUCKETS - 1);
+	stats->wait_hist[bucket]++;
+
+	if (cycles > stats->wait_max_cycles) {
+		stats->wait_max_cycles = cycles;
+	}
+}
+
+static void wait_hist_update(struct k_thread *thread)
+{
+	uint64_t wait;
+
+	if (thread->rt_stats.last_ready == 0) {
+		/* Not made ready since last switched in */
+		return;
+	}
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
+	wait = timing_cycles_get(&thread->rt_stats.last_ready,
+				 &thread->rt_stats.last_switched_in);
+#else
+	wait = (uint32_t)(thread->rt_stats.last_switched_in -
+			  thread->rt_stats.last_ready);
+#endif /* CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS */
+
+	thread->rt_stats.last_ready = 0;
+
+	/* The idle thread is always ready, its latency is meaningless. */
+	if (z_is_idle_thread_object(thread)) {
+		return;
+	}
+
+	wait_hist_add(&thread->rt_stats.stats, wait);
+	wait_hist_add(&threads_runtime_stats, wait);
+}
+
+void z_thread_mark_ready(struct k_thread *thread)
+{
+#ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
+	thread->rt_stats.last_ready = timing_counter_get();
+#else
+	thread->rt_stats.last_ready = k_cycle_get_32();
+#endif /* CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS */
+
+	/* 0 means not waiting */
+	if (unlikely(thread->rt_stats.last_ready == 0)) {
+		thread->rt_stats.last_ready = 1;
+	}
+}
+#endif /* CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST */
+
 #ifdef CONFIG_INSTRUMENT_THREAD_SWITCHING
 void z_thread_mark_switched_in(void)
 {
@@ -1040,6 +1097,10 @@ void z_thread_mark_switched_in(void)
 	thread->rt_stats.last_switched_in = k_cycle_get_32();
 #endif /* CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS */
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+	wait_hist_update(thread);
+#endif
+
 #endif /* CONFIG_THREAD_RUNTIME_STATS */
 }
 
@@ -1079,6 +1140,13 @@ void z_thread_mark_switched_out(void)
 	thread->rt_stats.stats.execution_cycles += diff;
 
 	threads_runtime_stats.execution_cycles += diff;
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+	/* A preempted thread starts waiting to run again. */
+	if (z_is_thread_ready(thread)) {
+		z_thread_mark_ready(thread);
+	}
+#endif
 #endif /* CONFIG_THREAD_RUNTIME_STATS */
 
 #ifdef CONFIG_TRACING
@@ -11,6 +11,7 @@
 #include <syscall_handler.h>
 #include <drivers/timer/system_timer.h>
 #include <sys_clock.h>
+#include <init.h>
 
 #define LOCKED(lck) for (k_spinlock_key_t __i = {},			\
 					  __key = k_spin_lock(lck);	\
@@ -23,6 +24,18 @@ static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
 
 static struct k_spinlock timeout_lock;
 
+#ifdef CONFIG_LOCK_STATS
+static int timeout_lock_stats_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return k_lock_stats_name_set(&timeout_lock, "timeout_lock");
+}
+
+SYS_INIT(timeout_lock_stats_init, PRE_KERNEL_1,
+	 CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+#endif
+
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
 		  ? K_TICKS_FOREVER : INT_MAX)
 
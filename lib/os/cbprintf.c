@@ -6,6 +6,10 @@
 
 #include <stdarg.h>
 #include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
 #include <sys/cbprintf.h>
 
 int cbprintf(cbprintf_cb out, void *ctx, const char *format, ...)
@@ -76,3 +80,487 @@ int vsnprintfcb(char *str, size_t size, const char *format, va_list ap)
 }
 
 #endif /* CONFIG_CBPRINTF_LIBC_SUBSTS */
+
+/* Class of the value consumed by a conversion specification. */
+enum pkg_arg {
+	PKG_ARG_NONE,
+	PKG_ARG_INT,
+	PKG_ARG_LONG,
+	PKG_ARG_LLONG,
+	PKG_ARG_INTMAX,
+	PKG_ARG_SIZE,
+	PKG_ARG_PTRDIFF,
+	PKG_ARG_PTR,
+	PKG_ARG_COUNT,
+	PKG_ARG_DOUBLE,
+	PKG_ARG_LDOUBLE,
+	PKG_ARG_STR,
+};
+
+/* Tags preceding a string argument in the package. */
+#define PKG_STR_PTR 0
+#define PKG_STR_COPY 1
+
+/* Longest conversion specification that can be formatted from a package. */
+#define PKG_SPEC_MAX_LEN 24
+
+struct pkg_spec {
+	/* First character of the specification, a '%'. */
+	const char *start;
+
+	/* Character following the specification. */
+	const char *end;
+
+	/* Number of int arguments consumed by '*' width and precision. */
+	uint8_t star_cnt;
+
+	/* Class of the converted value, enum pkg_arg. */
+	uint8_t arg;
+};
+
+static bool is_digit(char c)
+{
+	return (c >= '0') && (c <= '9');
+}
+
+/* Parse the conversion specification starting at the '%' in fp. Only what
+ * is needed to know the arguments is extracted, validation is left to the
+ * formatter.
+ */
+static const char *pkg_spec_parse(const char *fp, struct pkg_spec *spec)
+{
+	enum {
+		LEN_NONE, LEN_L, LEN_LL, LEN_J, LEN_Z, LEN_T, LEN_UPPER_L,
+	} length = LEN_NONE;
+
+	spec->start = fp++;
+	spec->star_cnt = 0U;
+	spec->arg = PKG_ARG_NONE;
+
+	/* Flags */
+	while ((*fp == '-') || (*fp == '+') || (*fp == ' ') ||
+	       (*fp == '#') || (*fp == '0')) {
+		fp++;
+	}
+
+	/* Width */
+	if (*fp == '*') {
+		spec->star_cnt++;
+		fp++;
+	} else {
+		while (is_digit(*fp)) {
+			fp++;
+		}
+	}
+
+	/* Precision */
+	if (*fp == '.') {
+		fp++;
+		if (*fp == '*') {
+			spec->star_cnt++;
+			fp++;
+		} else {
+			while (is_digit(*fp)) {
+				fp++;
+			}
+		}
+	}
+
+	/* Length, hh and h arguments are promoted to int. */
+	switch (*fp) {
+	case 'h':
+		fp += (fp[1] == 'h') ? 2 : 1;
+		break;
+	case 'l':
+		if (fp[1] == 'l') {
+			length = LEN_LL;
+			fp++;
+		} else {
+			length = LEN_L;
+		}
+		fp++;
+		break;
+	case 'j':
+		length = LEN_J;
+		fp++;
+		break;
+	case 'z':
+		length = LEN_Z;
+		fp++;
+		break;
+	case 't':
+		length = LEN_T;
+		fp++;
+		break;
+	case 'L':
+		length = LEN_UPPER_L;
+		fp++;
+		break;
+	default:
+		break;
+	}
+
+	switch (*fp) {
+	case 'd':
+	case 'i':
+	case 'o':
+	case 'u':
+	case 'x':
+	case 'X':
+		spec->arg = (length == LEN_L) ? PKG_ARG_LONG :
+			    (length == LEN_LL) ? PKG_ARG_LLONG :
+			    (length == LEN_J) ? PKG_ARG_INTMAX :
+			    (length == LEN_Z) ? PKG_ARG_SIZE :
+			    (length == LEN_T) ? PKG_ARG_PTRDIFF : PKG_ARG_INT;
+		break;
+	case 'c':
+		spec->arg = PKG_ARG_INT;
+		break;
+	case 'a':
+	case 'A':
+	case 'e':
+	case 'E':
+	case 'f':
+	case 'F':
+	case 'g':
+	case 'G':
+		spec->arg = (length == LEN_UPPER_L) ?
+			    PKG_ARG_LDOUBLE : PKG_ARG_DOUBLE;
+		break;
+	case 's':
+		spec->arg = PKG_ARG_STR;
+		break;
+	case 'p':
+		spec->arg = PKG_ARG_PTR;
+		break;
+	case 'n':
+		spec->arg = PKG_ARG_COUNT;
+		break;
+	default:
+		/* '%%' or an invalid conversion, nothing is consumed. */
+		break;
+	}
+
+	if (*fp != '\0') {
+		fp++;
+	}
+
+	spec->end = fp;
+
+	return fp;
+}
+
+static void pkg_put(uint8_t *buf, size_t len, size_t *offset,
+		    const void *src, size_t size)
+{
+	if ((buf != NULL) && (*offset + size <= len)) {
+		memcpy(&buf[*offset], src, size);
+	}
+
+	*offset += size;
+}
+
+#define PKG_PUT_ARG(type) do {						\
+		type v = va_arg(ap, type);				\
+									\
+		pkg_put(buf, len, &offset, &v, sizeof(v));		\
+	} while (false)
+
+static bool is_ro_str(const char *str)
+{
+#if defined(CONFIG_ARM) || defined(CONFIG_ARC) || defined(CONFIG_X86)
+	extern const char _image_rodata_start[];
+	extern const char _image_rodata_end[];
+
+	return (str >= _image_rodata_start) && (str < _image_rodata_end);
+#elif defined(CONFIG_NIOS2) || defined(CONFIG_RISCV)
+	extern const char _image_rom_start[];
+	extern const char _image_rom_end[];
+
+	return (str >= _image_rom_start) && (str < _image_rom_end);
+#elif defined(CONFIG_XTENSA)
+	extern const char _rodata_start[];
+	extern const char _rodata_end[];
+
+	return (str >= _rodata_start) && (str < _rodata_end);
+#else
+	return false;
+#endif
+}
+
+static bool str_copy_required(const char *str, uint32_t flags)
+{
+	if ((flags & CBPRINTF_PACKAGE_COPY_STR) != 0U) {
+		return true;
+	}
+
+	return ((flags & CBPRINTF_PACKAGE_COPY_RW_STR) != 0U) &&
+	       !is_ro_str(str);
+}
+
+int cbvprintf_package(void *packaged, size_t len, uint32_t flags,
+		      const char *format, va_list ap)
+{
+	struct cbprintf_package_hdr hdr = {
+		.fmt = format,
+	};
+	uint8_t *buf = packaged;
+	size_t offset = sizeof(hdr);
+	const char *fp = format;
+	struct pkg_spec spec;
+
+	while (*fp != '\0') {
+		if (*fp != '%') {
+			fp++;
+			continue;
+		}
+
+		fp = pkg_spec_parse(fp, &spec);
+
+		for (int i = 0; i < spec.star_cnt; i++) {
+			PKG_PUT_ARG(int);
+		}
+
+		switch (spec.arg) {
+		case PKG_ARG_INT:
+			PKG_PUT_ARG(int);
+			break;
+		case PKG_ARG_LONG:
+			PKG_PUT_ARG(long);
+			break;
+		case PKG_ARG_LLONG:
+			PKG_PUT_ARG(long long);
+			break;
+		case PKG_ARG_INTMAX:
+			PKG_PUT_ARG(intmax_t);
+			break;
+		case PKG_ARG_SIZE:
+			PKG_PUT_ARG(size_t);
+			break;
+		case PKG_ARG_PTRDIFF:
+			PKG_PUT_ARG(ptrdiff_t);
+			break;
+		case PKG_ARG_PTR:
+			PKG_PUT_ARG(void *);
+			break;
+		case PKG_ARG_COUNT:
+			/* Writing the count from another context is not
+			 * meaningful, the pointer is dropped.
+			 */
+			(void)va_arg(ap, void *);
+			break;
+		case PKG_ARG_DOUBLE:
+			PKG_PUT_ARG(double);
+			break;
+		case PKG_ARG_LDOUBLE:
+			PKG_PUT_ARG(long double);
+			break;
+		case PKG_ARG_STR: {
+			const char *str = va_arg(ap, const char *);
+			uint8_t tag;
+
+			if ((str != NULL) && str_copy_required(str, flags)) {
+				tag = PKG_STR_COPY;
+				pkg_put(buf, len, &offset, &tag, sizeof(tag));
+				pkg_put(buf, len, &offset, str,
+					strlen(str) + 1);
+			} else {
+				tag = PKG_STR_PTR;
+				pkg_put(buf, len, &offset, &tag, sizeof(tag));
+				pkg_put(buf, len, &offset, &str, sizeof(str));
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	if (offset > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	if (buf == NULL) {
+		return offset;
+	}
+
+	if (offset > len) {
+		return -ENOSPC;
+	}
+
+	hdr.len = offset;
+	memcpy(buf, &hdr, sizeof(hdr));
+
+	return offset;
+}
+
+int cbprintf_package(void *packaged, size_t len, uint32_t flags,
+		     const char *format, ...)
+{
+	va_list ap;
+	int rc;
+
+	va_start(ap, format);
+	rc = cbvprintf_package(packaged, len, flags, format, ap);
+	va_end(ap);
+
+	return rc;
+}
+
+static int pkg_outs(cbprintf_cb out, void *ctx, const char *sp,
+		    const char *ep)
+{
+	int count = 0;
+
+	while (sp < ep) {
+		int rc = out((int)*sp++, ctx);
+
+		if (rc < 0) {
+			return rc;
+		}
+		++count;
+	}
+
+	return count;
+}
+
+static void pkg_get(const uint8_t *buf, size_t *offset, void *dst,
+		    size_t size)
+{
+	memcpy(dst, &buf[*offset], size);
+	*offset += size;
+}
+
+/* Format one value with the star arguments that precede it. */
+#define PKG_PRINT_ARG(type) do {					\
+		type v;							\
+									\
+		pkg_get(buf, offset, &v, sizeof(v));			\
+		rc = (spec->star_cnt == 0U) ?				\
+			cbprintf(out, ctx, fmt, v) :			\
+		     (spec->star_cnt == 1U) ?				\
+			cbprintf(out, ctx, fmt, star[0], v) :		\
+			cbprintf(out, ctx, fmt, star[0], star[1], v);	\
+	} while (false)
+
+static int pkg_spec_print(cbprintf_cb out, void *ctx,
+			  const struct pkg_spec *spec, const uint8_t *buf,
+			  size_t *offset)
+{
+	size_t spec_len = spec->end - spec->start;
+	char fmt[PKG_SPEC_MAX_LEN];
+	int star[2];
+	int rc;
+
+	for (int i = 0; i < spec->star_cnt; i++) {
+		pkg_get(buf, offset, &star[i], sizeof(star[i]));
+	}
+
+	if (spec_len >= sizeof(fmt)) {
+		return -EINVAL;
+	}
+
+	memcpy(fmt, spec->start, spec_len);
+	fmt[spec_len] = '\0';
+
+	switch (spec->arg) {
+	case PKG_ARG_INT:
+		PKG_PRINT_ARG(int);
+		break;
+	case PKG_ARG_LONG:
+		PKG_PRINT_ARG(long);
+		break;
+	case PKG_ARG_LLONG:
+		PKG_PRINT_ARG(long long);
+		break;
+	case PKG_ARG_INTMAX:
+		PKG_PRINT_ARG(intmax_t);
+		break;
+	case PKG_ARG_SIZE:
+		PKG_PRINT_ARG(size_t);
+		break;
+	case PKG_ARG_PTRDIFF:
+		PKG_PRINT_ARG(ptrdiff_t);
+		break;
+	case PKG_ARG_PTR:
+		PKG_PRINT_ARG(void *);
+		break;
+	case PKG_ARG_DOUBLE:
+		PKG_PRINT_ARG(double);
+		break;
+	case PKG_ARG_LDOUBLE:
+		PKG_PRINT_ARG(long double);
+		break;
+	case PKG_ARG_STR: {
+		const char *v;
+		uint8_t tag;
+
+		pkg_get(buf, offset, &tag, sizeof(tag));
+		if (tag == PKG_STR_COPY) {
+			v = (const char *)&buf[*offset];
+			*offset += strlen(v) + 1;
+		} else {
+			pkg_get(buf, offset, &v, sizeof(v));
+		}
+
+		rc = (spec->star_cnt == 0U) ?
+			cbprintf(out, ctx, fmt, v) :
+		     (spec->star_cnt == 1U) ?
+			cbprintf(out, ctx, fmt, star[0], v) :
+			cbprintf(out, ctx, fmt, star[0], star[1], v);
+		break;
+	}
+	case PKG_ARG_COUNT:
+		rc = 0;
+		break;
+	default:
+		/* Invalid specifications are emitted as they are. */
+		if ((spec_len == 2U) && (spec->start[1] == '%')) {
+			rc = pkg_outs(out, ctx, spec->start + 1, spec->end);
+		} else {
+			rc = pkg_outs(out, ctx, spec->start, spec->end);
+		}
+		break;
+	}
+
+	return rc;
+}
+
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged)
+{
+	const struct cbprintf_package_hdr *hdr = packaged;
+	const uint8_t *buf = packaged;
+	size_t offset = sizeof(*hdr);
+	const char *fp = hdr->fmt;
+	struct pkg_spec spec;
+	int count = 0;
+	int rc;
+
+	while (*fp != '\0') {
+		const char *sp = fp;
+
+		while ((*fp != '\0') && (*fp != '%')) {
+			fp++;
+		}
+
+		rc = pkg_outs(out, ctx, sp, fp);
+		if (rc < 0) {
+			return rc;
+		}
+		count += rc;
+
+		if (*fp == '\0') {
+			break;
+		}
+
+		fp = pkg_spec_parse(fp, &spec);
+
+		rc = pkg_spec_print(out, ctx, &spec, buf, &offset);
+		if (rc < 0) {
+			return rc;
+		}
+		count += rc;
+	}
+
+	return count;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Each entry starts with a tag word followed by the length of the data.
+ * Producers claim space by advancing the write position with a
+ * compare-and-swap. On a single CPU, a claim is only retried when the
+ * producer is interrupted by another producer, so the number of retries is
+ * bounded by the interrupt nesting depth. An entry is committed by writing
+ * its position with TAG_COMMITTED set into the tag. Positions are free
+ * running and masked to get the index in the ring memory.
+ *
+ * Until the producer writes the tag of a claimed entry, the tag word holds
+ * stale data of a previous lap, which may look like a committed tag. The
+ * producer therefore counts itself in the claiming counter from before
+ * the claim until it has cleared the tag, and the consumer doesn't trust
+ * a tag while the counter isn't zero.
+ */
+
+#include <sys/mpsc_ring.h>
+#include <sys/util.h>
+#include <sys/__assert.h>
+#include <string.h>
+#include <errno.h>
+
+/* Bit set in the tag of a committed entry, positions are word aligned. */
+#define TAG_COMMITTED BIT(0)
+
+#define TAG_OFFSET 0
+#define LEN_OFFSET 4
+
+BUILD_ASSERT(sizeof(atomic_t) == 4, "Unexpected atomic_t size");
+
+static inline uint32_t entry_size(uint32_t len)
+{
+	return ROUND_UP(MPSC_RING_ENTRY_OVERHEAD + len, sizeof(uint32_t));
+}
+
+static inline atomic_t *tag_get(struct mpsc_ring *ring, uint32_t pos)
+{
+	return (atomic_t *)&ring->buf[pos & (ring->size - 1)];
+}
+
+static void ring_write(struct mpsc_ring *ring, uint32_t pos,
+		       const void *src, uint32_t len)
+{
+	uint32_t idx = pos & (ring->size - 1);
+	uint32_t part = MIN(len, ring->size - idx);
+
+	memcpy(&ring->buf[idx], src, part);
+	memcpy(ring->buf, (const uint8_t *)src + part, len - part);
+}
+
+static void ring_read(struct mpsc_ring *ring, uint32_t pos,
+		      void *dst, uint32_t len)
+{
+	uint32_t idx = pos & (ring->size - 1);
+	uint32_t part = MIN(len, ring->size - idx);
+
+	memcpy(dst, &ring->buf[idx], part);
+	memcpy((uint8_t *)dst + part, ring->buf, len - part);
+}
+
+void mpsc_ring_init(struct mpsc_ring *ring, void *buf, uint32_t size)
+{
+	__ASSERT((size & (size - 1)) == 0, "Size must be a power of two");
+	__ASSERT(((uintptr_t)buf & (sizeof(uint32_t) - 1)) == 0,
+		 "Buffer must be word aligned");
+
+	ring->buf = buf;
+	ring->size = size;
+	atomic_set(&ring->rd, 0);
+	atomic_set(&ring->wr, 0);
+	atomic_set(&ring->claiming, 0);
+}
+
+bool mpsc_ring_peek(struct mpsc_ring *ring, struct mpsc_ring_entry *entry)
+{
+	uint32_t rd = atomic_get(&ring->rd);
+
+	if (rd == (uint32_t)atomic_get(&ring->wr)) {
+		return false;
+	}
+
+	/* The entry at rd is claimed, but its tag may not be cleared yet. */
+	if (atomic_get(&ring->claiming) != 0) {
+		return false;
+	}
+
+	if ((uint32_t)atomic_get(tag_get(ring, rd)) != (rd | TAG_COMMITTED)) {
+		return false;
+	}
+
+	entry->pos = rd;
+	ring_read(ring, rd + LEN_OFFSET, &entry->len, sizeof(entry->len));
+
+	/* The entry may be overwritten while being read in overwrite mode. */
+	return entry->len <= ring->size - MPSC_RING_ENTRY_OVERHEAD;
+}
+
+static int drop_oldest(struct mpsc_ring *ring)
+{
+	struct mpsc_ring_entry entry;
+
+	if (mpsc_ring_is_empty(ring)) {
+		return 0;
+	}
+
+	if (!mpsc_ring_peek(ring, &entry)) {
+		return -EAGAIN;
+	}
+
+	/* The entry may have been consumed or dropped by another context
+	 * meanwhile, which made room as well.
+	 */
+	return mpsc_ring_consume(ring, &entry) ? 1 : 0;
+}
+
+int mpsc_ring_claim(struct mpsc_ring *ring, uint32_t len, bool overwrite,
+		    uint32_t *dropped, struct mpsc_ring_entry *entry)
+{
+	uint32_t size = entry_size(len);
+	uint32_t wr, used;
+	int ret;
+
+	*dropped = 0;
+
+	if (len > ring->size - MPSC_RING_ENTRY_OVERHEAD) {
+		return -ENOMEM;
+	}
+
+	for (;;) {
+		wr = atomic_get(&ring->wr);
+		used = wr - (uint32_t)atomic_get(&ring->rd);
+
+		if (used > ring->size) {
+			/* Positions moved while being read. */
+			continue;
+		}
+
+		if (ring->size - used >= size) {
+			atomic_inc(&ring->claiming);
+
+			if (atomic_cas(&ring->wr, wr, wr + size)) {
+				break;
+			}
+
+			atomic_dec(&ring->claiming);
+			continue;
+		}
+
+		if (!overwrite) {
+			return -ENOMEM;
+		}
+
+		ret = drop_oldest(ring);
+		if (ret < 0) {
+			return -ENOMEM;
+		}
+
+		*dropped += ret;
+	}
+
+	entry->pos = wr;
+	entry->len = len;
+
+	(void)atomic_set(tag_get(ring, wr + TAG_OFFSET), wr);
+	atomic_dec(&ring->claiming);
+
+	ring_write(ring, wr + LEN_OFFSET, &len, sizeof(len));
+
+	return 0;
+}
+
+void mpsc_ring_write(struct mpsc_ring *ring,
+		     const struct mpsc_ring_entry *entry, uint32_t offset,
+		     const void *data, uint32_t len)
+{
+	__ASSERT_NO_MSG(offset + len <= entry->len);
+
+	ring_write(ring, entry->pos + MPSC_RING_ENTRY_OVERHEAD + offset,
+		   data, len);
+}
+
+void mpsc_ring_commit(struct mpsc_ring *ring,
+		      const struct mpsc_ring_entry *entry)
+{
+	/* The atomic store orders the writes of the entry before it. */
+	(void)atomic_set(tag_get(ring, entry->pos + TAG_OFFSET),
+			 entry->pos | TAG_COMMITTED);
+}
+
+void mpsc_ring_read(struct mpsc_ring *ring,
+		    const struct mpsc_ring_entry *entry, uint32_t offset,
+		    void *data, uint32_t len)
+{
+	if (offset >= entry->len) {
+		return;
+	}
+
+	ring_read(ring, entry->pos + MPSC_RING_ENTRY_OVERHEAD + offset,
+		  data, MIN(len, entry->len - offset));
+}
+
+bool mpsc_ring_consume(struct mpsc_ring *ring,
+		       const struct mpsc_ring_entry *entry)
+{
+	return atomic_cas(&ring->rd, entry->pos,
+			  entry->pos + entry_size(entry->len));
+}
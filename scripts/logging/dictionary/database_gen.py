@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Generate the database used to decode dictionary based log output.
+
+The database is a JSON file which maps addresses of constant strings in the
+ELF file to the strings themselves, together with the list of log sources
+(in source ID order) and the properties of the target needed to decode the
+argument packages.
+"""
+
+import argparse
+import json
+import string
+import sys
+
+from elftools.elf.constants import SH_FLAGS
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+DB_VERSION = 1
+
+# Size of long double for the architectures where it is not 8 bytes
+LONG_DOUBLE_SIZE = {
+    'EM_386': 12,
+    'EM_X86_64': 16,
+    'EM_AARCH64': 16,
+}
+
+PRINTABLE = set(string.printable.encode())
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+
+    parser.add_argument("elffile", help="Zephyr ELF binary")
+    parser.add_argument("dbfile", help="Output database file")
+    parser.add_argument("-v", "--verbose", action="store_true",
+                        help="Print more information")
+
+    return parser.parse_args()
+
+
+def is_rodata(section):
+    flags = section['sh_flags']
+
+    return (section['sh_type'] == 'SHT_PROGBITS' and
+            flags & SH_FLAGS.SHF_ALLOC and
+            not flags & SH_FLAGS.SHF_WRITE and
+            not flags & SH_FLAGS.SHF_EXECINSTR)
+
+
+def extract_strings(elf):
+    """Return a dictionary of all strings in read-only data by address."""
+    strings = {}
+
+    for section in elf.iter_sections():
+        if not is_rodata(section):
+            continue
+
+        data = section.data()
+        base = section['sh_addr']
+        start = 0
+
+        for i, byte in enumerate(data):
+            if byte == 0:
+                if i > start:
+                    strings[base + start] = data[start:i].decode('ascii')
+                start = i + 1
+            elif byte not in PRINTABLE:
+                start = i + 1
+
+    return strings
+
+
+def find_symbols(elf):
+    symbols = {}
+
+    for section in elf.iter_sections():
+        if isinstance(section, SymbolTableSection):
+            for sym in section.iter_symbols():
+                if sym.name:
+                    symbols[sym.name] = sym
+
+    return symbols
+
+
+def read_bytes(elf, addr, size):
+    for section in elf.iter_sections():
+        start = section['sh_addr']
+
+        if (section['sh_type'] == 'SHT_PROGBITS' and
+                start <= addr < start + section['sh_size']):
+            offset = addr - start
+            return section.data()[offset:offset + size]
+
+    return None
+
+
+def extract_sources(elf, symbols, strings):
+    """Return the names of the log sources in source ID order.
+
+    Each source is a struct log_source_const_data instance placed between
+    __log_const_start and __log_const_end, so the source ID is the index of
+    the instance in that array.
+    """
+    if '__log_const_start' not in symbols:
+        return []
+
+    start = symbols['__log_const_start']['st_value']
+    end = symbols['__log_const_end']['st_value']
+
+    items = sorted((sym for sym in symbols.values()
+                    if sym['st_info']['type'] == 'STT_OBJECT' and
+                    start <= sym['st_value'] < end and sym['st_size']),
+                   key=lambda sym: sym['st_value'])
+    if not items:
+        return []
+
+    stride = items[0]['st_size']
+    ptr_size = elf.elfclass // 8
+    byteorder = 'little' if elf.little_endian else 'big'
+    sources = [None] * ((end - start) // stride)
+
+    for sym in items:
+        data = read_bytes(elf, sym['st_value'], ptr_size)
+        name_addr = int.from_bytes(data, byteorder)
+        sources[(sym['st_value'] - start) // stride] = \
+            strings.get(name_addr, sym.name)
+
+    return sources
+
+
+def main():
+    args = parse_args()
+
+    with open(args.elffile, 'rb') as f:
+        elf = ELFFile(f)
+
+        strings = extract_strings(elf)
+        symbols = find_symbols(elf)
+        sources = extract_sources(elf, symbols, strings)
+
+        target = {
+            'bits': elf.elfclass,
+            'little_endian': elf.little_endian,
+            'long_double_size':
+                LONG_DOUBLE_SIZE.get(elf['e_machine'], 8),
+        }
+
+    if args.verbose:
+        print("Found {} strings and {} log sources".format(len(strings),
+                                                           len(sources)))
+
+    database = {
+        'version': DB_VERSION,
+        'target': target,
+        'sources': sources,
+        'strings': {str(addr): s for addr, s in strings.items()},
+    }
+
+    with open(args.dbfile, 'w') as f:
+        json.dump(database, f, indent=1)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,307 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Decode binary output of a dictionary based logging backend.
+
+The log data is a stream of records written by log_output_dict.c. Format
+strings and strings which were not copied into the records are looked up
+in the database generated by database_gen.py for the same ELF file.
+"""
+
+import argparse
+import bisect
+import collections
+import json
+import re
+import struct
+import sys
+
+LOG_DICT_MSG_TYPE_STD = 0
+LOG_DICT_MSG_TYPE_HEXDUMP = 1
+LOG_DICT_MSG_TYPE_DROPPED = 2
+
+# See struct log_dict_msg_hdr and struct log_dict_dropped_hdr
+MSG_HDR_FMT = "BBHIHH"
+DROPPED_HDR_FMT = "B3xI"
+
+# Must match the string tags in lib/os/cbprintf.c
+PKG_STR_PTR = 0
+PKG_STR_COPY = 1
+
+LEVELS = ["", "err", "wrn", "inf", "dbg"]
+
+HEXDUMP_BYTES_IN_LINE = 16
+
+SPEC_RE = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?"
+                     r"(hh|h|ll|l|j|z|t|L)?([diouxXcaAeEfFgGspn%])")
+
+
+class Database():
+    def __init__(self, path):
+        with open(path, 'r') as f:
+            db = json.load(f)
+
+        target = db['target']
+
+        self.ptr_size = target['bits'] // 8
+        self.endian = '<' if target['little_endian'] else '>'
+        self.ldouble_size = target['long_double_size']
+        self.sources = db['sources']
+
+        strings = {int(addr): s for addr, s in db['strings'].items()}
+        self.addrs = sorted(strings)
+        self.strings = [strings[addr] for addr in self.addrs]
+
+    def string(self, addr):
+        """Look up a string, the address may point into a string."""
+        idx = bisect.bisect_right(self.addrs, addr) - 1
+        if idx < 0:
+            return None
+
+        offset = addr - self.addrs[idx]
+        if offset > len(self.strings[idx]):
+            return None
+
+        return self.strings[idx][offset:]
+
+    def source(self, source_id):
+        if source_id < len(self.sources) and self.sources[source_id]:
+            return self.sources[source_id]
+
+        return "<source {}>".format(source_id)
+
+
+class Package():
+    """Reader of the arguments of a cbprintf package."""
+
+    def __init__(self, db, data):
+        self.db = db
+        self.data = data
+        self.offset = 0
+
+    def _unpack(self, fmt, size):
+        fmt = self.db.endian + fmt
+        value = struct.unpack_from(fmt, self.data, self.offset)[0]
+        self.offset += size
+
+        return value
+
+    def _int(self, size, signed):
+        fmt = {1: 'b', 2: 'h', 4: 'i', 8: 'q'}[size]
+
+        return self._unpack(fmt if signed else fmt.upper(), size)
+
+    def header(self):
+        length = self._int(2, False)
+        self.offset = self.db.ptr_size
+        fmt = self._int(self.db.ptr_size, False)
+
+        return length, fmt
+
+    def int_arg(self, length, signed):
+        size = {
+            None: 4, 'hh': 4, 'h': 4,
+            'l': self.db.ptr_size, 'll': 8, 'j': 8,
+            'z': self.db.ptr_size, 't': self.db.ptr_size,
+        }[length]
+
+        return self._int(size, signed)
+
+    def double_arg(self, length):
+        if length == 'L' and self.db.ldouble_size != 8:
+            # Only x87 extended precision is expected here.
+            raw = self.data[self.offset:self.offset + 10]
+            self.offset += self.db.ldouble_size
+            if self.db.endian == '>':
+                raw = raw[::-1]
+            mantissa = int.from_bytes(raw[:8], 'little')
+            exp = int.from_bytes(raw[8:10], 'little')
+            sign = -1.0 if exp & 0x8000 else 1.0
+            exp &= 0x7fff
+            if exp == 0 and mantissa == 0:
+                return sign * 0.0
+            return sign * mantissa * 2.0 ** (exp - 16383 - 63)
+
+        return self._unpack('d', 8)
+
+    def str_arg(self):
+        tag = self._int(1, False)
+
+        if tag == PKG_STR_COPY:
+            end = self.data.index(b'\0', self.offset)
+            value = self.data[self.offset:end].decode('utf-8', 'replace')
+            self.offset = end + 1
+            return value
+
+        addr = self._int(self.db.ptr_size, False)
+        if addr == 0:
+            return "(null)"
+
+        value = self.db.string(addr)
+        if value is None:
+            return "<string 0x{:x}>".format(addr)
+
+        return value
+
+
+def format_package(db, data):
+    """Return the format string and the formatted output of a package."""
+    pkg = Package(db, data)
+    _, fmt_addr = pkg.header()
+    fmt = db.string(fmt_addr)
+
+    if fmt is None:
+        return None, "<unknown format 0x{:x}>".format(fmt_addr)
+
+    out = []
+    pos = 0
+
+    for m in SPEC_RE.finditer(fmt):
+        flags, width, prec, length, conv = m.groups()
+
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+
+        if conv == '%':
+            out.append('%')
+            continue
+
+        if width == '*':
+            width = str(pkg.int_arg(None, True))
+        if prec == '*':
+            prec = str(pkg.int_arg(None, True))
+
+        spec = '%' + flags + (width or '')
+        if prec is not None:
+            spec += '.' + prec
+
+        if conv in 'di':
+            out.append((spec + 'd') % pkg.int_arg(length, True))
+        elif conv in 'ouxX':
+            out.append((spec + conv.replace('u', 'd')) %
+                       pkg.int_arg(length, False))
+        elif conv == 'c':
+            out.append((spec + 'c') % chr(pkg.int_arg(None, False) & 0xff))
+        elif conv in 'aAeEfFgG':
+            value = pkg.double_arg(length)
+            if conv in 'aA':
+                value = value.hex()
+                conv = 's'
+            out.append((spec + conv) % value)
+        elif conv == 's':
+            out.append((spec + 's') % pkg.str_arg())
+        elif conv == 'p':
+            out.append("0x%x" % pkg.int_arg('z', False))
+        # %n is not stored in the package
+
+    out.append(fmt[pos:])
+
+    return fmt, "".join(out)
+
+
+def hexdump(data, indent):
+    lines = []
+
+    for i in range(0, len(data), HEXDUMP_BYTES_IN_LINE):
+        chunk = data[i:i + HEXDUMP_BYTES_IN_LINE]
+        hexs = " ".join("{:02x}".format(b) for b in chunk)
+        chars = "".join(chr(b) if 32 <= b < 127 else '.' for b in chunk)
+
+        lines.append("{}{:<48}|{}".format(indent, hexs, chars))
+
+    return lines
+
+
+def parse_log(db, data, args):
+    msg_hdr = struct.Struct(db.endian + MSG_HDR_FMT)
+    dropped_hdr = struct.Struct(db.endian + DROPPED_HDR_FMT)
+    freq = collections.Counter()
+    offset = 0
+
+    while offset < len(data):
+        rec_type = data[offset]
+
+        if rec_type == LOG_DICT_MSG_TYPE_DROPPED:
+            _, count = dropped_hdr.unpack_from(data, offset)
+            offset += dropped_hdr.size
+            print("--- {} messages dropped ---".format(count))
+            continue
+
+        if rec_type not in (LOG_DICT_MSG_TYPE_STD, LOG_DICT_MSG_TYPE_HEXDUMP):
+            print("Unknown record type {} at offset {}".format(rec_type,
+                                                                offset),
+                  file=sys.stderr)
+            return 1
+
+        (_, ids, source_id, timestamp,
+         pkg_len, data_len) = msg_hdr.unpack_from(data, offset)
+        offset += msg_hdr.size
+
+        if offset + pkg_len + data_len > len(data):
+            print("Truncated record at offset {}".format(offset),
+                  file=sys.stderr)
+            return 1
+
+        pkg = data[offset:offset + pkg_len]
+        offset += pkg_len
+        hexdata = data[offset:offset + data_len]
+        offset += data_len
+
+        level = ids & 0x7
+        fmt, text = format_package(db, pkg)
+        freq[fmt] += 1
+
+        if level == 0:
+            # Raw string, e.g. printk output
+            print(text, end='')
+            continue
+
+        prefix = "[{:08d}] <{}> {}: ".format(timestamp, LEVELS[level],
+                                            db.source(source_id))
+        print(prefix + text)
+
+        if rec_type == LOG_DICT_MSG_TYPE_HEXDUMP:
+            for line in hexdump(hexdata, " " * len(prefix)):
+                print(line)
+
+    if args.freq:
+        print("\n{:>8}  format".format("count"))
+        for fmt, count in freq.most_common():
+            print("{:>8}  {!r}".format(count, fmt))
+
+    return 0
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+
+    parser.add_argument("dbfile", help="Dictionary database file")
+    parser.add_argument("logfile", help="Binary log data file")
+    parser.add_argument("--hex", action="store_true",
+                        help="Log data file contains hexadecimal text")
+    parser.add_argument("--freq", action="store_true",
+                        help="Print number of messages per format string")
+
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    db = Database(args.dbfile)
+
+    if args.hex:
+        with open(args.logfile, 'r') as f:
+            data = bytes.fromhex("".join(f.read().split()))
+    else:
+        with open(args.logfile, 'rb') as f:
+            data = f.read()
+
+    return parse_log(db, data, args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Convert the samples printed by the sampling profiler (CONFIG_PROFILER) into
+folded stacks, one "thread;outermost;...;innermost count" line per distinct
+stack, as consumed by flame graph tools such as flamegraph.pl or speedscope.
+
+The addresses are symbolized against the ELF file of the image, zephyr.elf,
+or zephyr.exe for native_posix.
+"""
+
+import argparse
+import bisect
+import collections
+import re
+import sys
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+
+THREAD_RE = re.compile(r"PROF-THREAD (0x[0-9a-fA-F]+) (.*)$")
+SAMPLE_RE = re.compile(r"PROF (0x[0-9a-fA-F]+) ((?:0x[0-9a-fA-F]+;?)+|isr)\s*$")
+END_RE = re.compile(r"PROF-END (\d+) (\d+)")
+
+
+class Symbolizer:
+    def __init__(self, elf_path):
+        functions = []
+
+        with open(elf_path, "rb") as f:
+            elf = ELFFile(f)
+            thumb = elf["e_machine"] == "EM_ARM"
+
+            for section in elf.iter_sections():
+                if not isinstance(section, SymbolTableSection):
+                    continue
+
+                for sym in section.iter_symbols():
+                    if (sym["st_info"]["type"] != "STT_FUNC" or
+                            sym["st_size"] == 0):
+                        continue
+
+                    addr = sym["st_value"]
+                    if thumb:
+                        addr &= ~1
+                    functions.append((addr, sym["st_size"], sym.name))
+
+        functions.sort()
+        self.starts = [f[0] for f in functions]
+        self.functions = functions
+
+    def name(self, addr):
+        i = bisect.bisect_right(self.starts, addr) - 1
+        if i >= 0:
+            start, size, name = self.functions[i]
+            if addr < start + size:
+                return name
+
+        return hex(addr)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+
+    parser.add_argument("elffile", help="ELF file of the profiled image")
+    parser.add_argument("logfile", nargs="?", default="-",
+                        help="Log with the profiler output, stdin if omitted")
+    parser.add_argument("-o", "--output", default="-",
+                        help="Output file, stdout if omitted")
+    parser.add_argument("--no-threads", action="store_true",
+                        help="Do not prefix the stacks with the thread")
+
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    symbolizer = Symbolizer(args.elffile)
+    threads = {}
+    stacks = collections.Counter()
+    samples = 0
+    dropped = 0
+
+    infile = sys.stdin if args.logfile == "-" else open(args.logfile, "r")
+
+    for line in infile:
+        match = THREAD_RE.search(line)
+        if match:
+            threads[match.group(1)] = match.group(2).strip()
+            continue
+
+        match = END_RE.search(line)
+        if match:
+            # The statistics are cumulative, keep the latest.
+            samples = int(match.group(1))
+            dropped = int(match.group(2))
+            continue
+
+        match = SAMPLE_RE.search(line)
+        if not match:
+            continue
+
+        if match.group(2) == "isr":
+            frames = ["[isr]"]
+        else:
+            addrs = [int(a, 16) for a in match.group(2).split(";") if a]
+            # Return addresses point after the call, which may be past the
+            # end of a function calling a no return function.
+            frames = [symbolizer.name(addrs[0])]
+            frames += [symbolizer.name(a - 1) for a in addrs[1:]]
+            frames.reverse()
+
+        if not args.no_threads:
+            thread = match.group(1)
+            frames.insert(0, threads.get(thread, thread))
+
+        stacks[";".join(frames)] += 1
+
+    if infile is not sys.stdin:
+        infile.close()
+
+    outfile = sys.stdout if args.output == "-" else open(args.output, "w")
+
+    for stack, count in sorted(stacks.items()):
+        outfile.write(f"{stack} {count}\n")
+
+    if outfile is not sys.stdout:
+        outfile.close()
+
+    print(f"{sum(stacks.values())} samples folded, {samples} taken, "
+          f"{dropped} dropped", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Sampling profiler implementation
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <init.h>
+#include <debug/profiler.h>
+#include <sys/mpsc_ring.h>
+#include <sys/printk.h>
+#include <errno.h>
+#include "profiler_arch.h"
+
+#define BUF_SIZE CONFIG_PROFILER_BUFFER_SIZE
+
+BUILD_ASSERT((BUF_SIZE & (BUF_SIZE - 1)) == 0,
+	     "Per CPU profiler buffer size must be a power of two");
+
+#define SAMPLE_PERIOD K_USEC(USEC_PER_SEC / CONFIG_PROFILER_SAMPLE_RATE)
+
+/* Longest text line: "PROF <thread> " followed by the addresses. */
+#define PTR_STR_MAXLEN (sizeof(void *) * 2 + 2)
+#define LINE_MAXLEN (sizeof("PROF ") + (PTR_STR_MAXLEN + 1) * \
+		     (PROFILER_STACK_DEPTH + 1) + 1)
+
+/* Sample as stored in the buffers, followed by the addresses. */
+struct sample_hdr {
+	const struct k_thread *thread;
+	uint32_t depth;
+};
+
+static uint8_t __aligned(sizeof(uint32_t))
+		profiler_buffers[CONFIG_MP_NUM_CPUS][BUF_SIZE];
+static struct mpsc_ring profiler_rings[CONFIG_MP_NUM_CPUS];
+
+static atomic_t samples;
+static atomic_t dropped;
+static bool running;
+
+static inline struct mpsc_ring *curr_ring(void)
+{
+#ifdef CONFIG_SMP
+	return &profiler_rings[arch_curr_cpu()->id];
+#else
+	return &profiler_rings[0];
+#endif
+}
+
+static void sample_take(struct k_timer *timer)
+{
+	struct mpsc_ring *ring = curr_ring();
+	struct mpsc_ring_entry entry;
+	struct profiler_sample sample;
+	struct sample_hdr hdr;
+	uint32_t ring_dropped;
+	uint32_t pc_size;
+
+	sample.depth = profiler_arch_sample(sample.pc, ARRAY_SIZE(sample.pc));
+	pc_size = sample.depth * sizeof(sample.pc[0]);
+
+	hdr.thread = _current;
+	hdr.depth = sample.depth;
+
+	atomic_inc(&samples);
+
+	if (mpsc_ring_claim(ring, sizeof(hdr) + pc_size, false,
+			    &ring_dropped, &entry) != 0) {
+		atomic_inc(&dropped);
+		return;
+	}
+
+	mpsc_ring_write(ring, &entry, 0, &hdr, sizeof(hdr));
+	if (pc_size != 0U) {
+		mpsc_ring_write(ring, &entry, sizeof(hdr), sample.pc, pc_size);
+	}
+	mpsc_ring_commit(ring, &entry);
+}
+
+K_TIMER_DEFINE(profiler_timer, sample_take, NULL);
+
+int profiler_start(void)
+{
+	if (running) {
+		return -EALREADY;
+	}
+
+	running = true;
+	k_timer_start(&profiler_timer, SAMPLE_PERIOD, SAMPLE_PERIOD);
+
+	return 0;
+}
+
+int profiler_stop(void)
+{
+	if (!running) {
+		return -EALREADY;
+	}
+
+	k_timer_stop(&profiler_timer);
+	running = false;
+
+	return 0;
+}
+
+bool profiler_is_running(void)
+{
+	return running;
+}
+
+void profiler_stats_get(struct profiler_stats *stats)
+{
+	stats->samples = (uint32_t)atomic_get(&samples);
+	stats->dropped = (uint32_t)atomic_get(&dropped);
+}
+
+uint32_t profiler_drain(profiler_sample_cb_t cb, void *user_data)
+{
+	struct mpsc_ring_entry entry;
+	struct profiler_sample sample;
+	struct sample_hdr hdr;
+	uint32_t cnt = 0U;
+
+	for (int i = 0; i < ARRAY_SIZE(profiler_rings); i++) {
+		struct mpsc_ring *ring = &profiler_rings[i];
+
+		while (mpsc_ring_peek(ring, &entry)) {
+			mpsc_ring_read(ring, &entry, 0, &hdr, sizeof(hdr));
+			sample.thread = hdr.thread;
+			sample.depth = MIN(hdr.depth, ARRAY_SIZE(sample.pc));
+			mpsc_ring_read(ring, &entry, sizeof(hdr), sample.pc,
+				       sample.depth * sizeof(sample.pc[0]));
+
+			if (mpsc_ring_consume(ring, &entry)) {
+				cb(&sample, user_data);
+				cnt++;
+			}
+		}
+	}
+
+	return cnt;
+}
+
+struct line_ctx {
+	profiler_line_cb_t cb;
+	void *user_data;
+};
+
+#if defined(CONFIG_THREAD_MONITOR) && defined(CONFIG_THREAD_NAME)
+static void thread_line(const struct k_thread *cthread, void *user_data)
+{
+	struct line_ctx *ctx = user_data;
+	char line[sizeof("PROF-THREAD ") + PTR_STR_MAXLEN + 1 +
+		  CONFIG_THREAD_MAX_NAME_LEN];
+	const char *name = k_thread_name_get((k_tid_t)cthread);
+
+	if (name == NULL || name[0] == '\0') {
+		return;
+	}
+
+	snprintk(line, sizeof(line), "PROF-THREAD %p %s",
+		 (void *)cthread, name);
+	ctx->cb(line, ctx->user_data);
+}
+#endif /* CONFIG_THREAD_MONITOR && CONFIG_THREAD_NAME */
+
+static void sample_line(const struct profiler_sample *sample,
+			void *user_data)
+{
+	struct line_ctx *ctx = user_data;
+	char line[LINE_MAXLEN];
+	int pos;
+
+	pos = snprintk(line, sizeof(line), "PROF %p ",
+		       (void *)sample->thread);
+
+	if (sample->depth == 0U) {
+		snprintk(&line[pos], sizeof(line) - pos, "isr");
+	}
+
+	for (uint32_t i = 0; i < sample->depth; i++) {
+		pos += snprintk(&line[pos], sizeof(line) - pos, "%s%p",
+				(i == 0U) ? "" : ";",
+				(void *)sample->pc[i]);
+	}
+
+	ctx->cb(line, ctx->user_data);
+}
+
+uint32_t profiler_dump(profiler_line_cb_t cb, void *user_data)
+{
+	struct line_ctx ctx = {
+		.cb = cb,
+		.user_data = user_data,
+	};
+	struct profiler_stats stats;
+	char line[LINE_MAXLEN];
+	uint32_t cnt;
+
+#if defined(CONFIG_THREAD_MONITOR) && defined(CONFIG_THREAD_NAME)
+	k_thread_foreach_unlocked(thread_line, &ctx);
+#endif
+
+	cnt = profiler_drain(sample_line, &ctx);
+
+	profiler_stats_get(&stats);
+	snprintk(line, sizeof(line), "PROF-END %u %u",
+		 stats.samples, stats.dropped);
+	cb(line, user_data);
+
+	return cnt;
+}
+
+static void print_line(const char *line, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	printk("%s\n", line);
+}
+
+uint32_t profiler_print(void)
+{
+	return profiler_dump(print_line, NULL);
+}
+
+#ifdef CONFIG_PROFILER_AUTO
+static void profiler_auto(void *p1, void *p2, void *p3)
+{
+	for (;;) {
+		k_msleep(CONFIG_PROFILER_AUTO_INTERVAL);
+		(void)profiler_print();
+	}
+}
+
+K_THREAD_DEFINE(profiler_thread, CONFIG_PROFILER_AUTO_STACK_SIZE,
+		profiler_auto, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+#endif /* CONFIG_PROFILER_AUTO */
+
+static int profiler_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	for (int i = 0; i < ARRAY_SIZE(profiler_rings); i++) {
+		mpsc_ring_init(&profiler_rings[i], profiler_buffers[i],
+			       BUF_SIZE);
+	}
+
+	if (IS_ENABLED(CONFIG_PROFILER_AUTO)) {
+		(void)profiler_start();
+	}
+
+	return 0;
+}
+
+SYS_INIT(profiler_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_SUBSYS_DEBUG_PROFILER_PROFILER_ARCH_H_
+#define ZEPHYR_SUBSYS_DEBUG_PROFILER_PROFILER_ARCH_H_
+
+#include <zephyr/types.h>
+
+/* Frame record pushed by a function prologue when frame pointers are used. */
+struct profiler_frame {
+	struct profiler_frame *next;
+	uintptr_t ret_addr;
+};
+
+/**
+ * @brief Capture the context interrupted by the system timer.
+ *
+ * Called from the system timer interrupt. Stores the interrupted program
+ * counter, followed with CONFIG_PROFILER_STACK_TRACE by the return
+ * addresses of the interrupted call stack.
+ *
+ * @param pc  Location for the addresses.
+ * @param max Maximum number of addresses.
+ *
+ * @return Number of stored addresses, 0 if the interrupted context is
+ *         another interrupt.
+ */
+uint32_t profiler_arch_sample(uintptr_t *pc, uint32_t max);
+
+#endif /* ZEPHYR_SUBSYS_DEBUG_PROFILER_PROFILER_ARCH_H_ */
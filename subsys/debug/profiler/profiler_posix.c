@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <irq_handler.h>
+#include "profiler_arch.h"
+
+/* The threads run on host stacks which bounds are not known. A walk
+ * reaching host library code compiled without frame pointers is stopped
+ * by bounding the span of the walked frames.
+ */
+#define STACK_SPAN_MAX 0x10000
+
+uint32_t profiler_arch_sample(uintptr_t *pc, uint32_t max)
+{
+	struct profiler_frame *frame;
+	uintptr_t start, addr;
+	uint32_t depth = 0U;
+
+	/* A nested interrupt interrupted another interrupt handler. */
+	if (_kernel.cpus[0].nested != 1U) {
+		return 0;
+	}
+
+	/* The interrupts are only taken when the CPU is halted or unlocks
+	 * interrupts, so the interrupted code is the caller of the interrupt
+	 * handler: its return address stands for the interrupted PC.
+	 */
+	frame = posix_irq_interrupted_frame();
+	start = (uintptr_t)frame;
+
+#ifndef CONFIG_PROFILER_STACK_TRACE
+	max = 1U;
+#endif
+
+	while (depth < max) {
+		addr = (uintptr_t)frame;
+
+		if ((addr == 0U) || (addr < start) ||
+		    (addr - start >= STACK_SPAN_MAX) ||
+		    ((addr & (sizeof(uintptr_t) - 1)) != 0U) ||
+		    (frame->ret_addr == 0U)) {
+			break;
+		}
+
+		pc[depth++] = frame->ret_addr;
+
+		if ((uintptr_t)frame->next <= addr) {
+			break;
+		}
+
+		frame = frame->next;
+	}
+
+	return depth;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <shell/shell.h>
+#include <debug/profiler.h>
+
+static int cmd_profiler_start(const struct shell *shell,
+			      size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (profiler_start() != 0) {
+		shell_error(shell, "Profiler already running");
+		return -ENOEXEC;
+	}
+
+	shell_print(shell, "Sampling at %u Hz", CONFIG_PROFILER_SAMPLE_RATE);
+
+	return 0;
+}
+
+static int cmd_profiler_stop(const struct shell *shell,
+			     size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (profiler_stop() != 0) {
+		shell_error(shell, "Profiler not running");
+		return -ENOEXEC;
+	}
+
+	return 0;
+}
+
+static void shell_line(const char *line, void *user_data)
+{
+	const struct shell *shell = user_data;
+
+	shell_print(shell, "%s", line);
+}
+
+static int cmd_profiler_dump(const struct shell *shell,
+			     size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	(void)profiler_dump(shell_line, (void *)shell);
+
+	return 0;
+}
+
+static int cmd_profiler_status(const struct shell *shell,
+			       size_t argc, char **argv)
+{
+	struct profiler_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	profiler_stats_get(&stats);
+
+	shell_print(shell, "%s, %u Hz, samples %u, dropped %u",
+		    profiler_is_running() ? "running" : "stopped",
+		    CONFIG_PROFILER_SAMPLE_RATE, stats.samples, stats.dropped);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_profiler,
+	SHELL_CMD(dump, NULL, "Drain the samples.", cmd_profiler_dump),
+	SHELL_CMD(start, NULL, "Start sampling.", cmd_profiler_start),
+	SHELL_CMD(status, NULL, "Sampling status.", cmd_profiler_status),
+	SHELL_CMD(stop, NULL, "Stop sampling.", cmd_profiler_stop),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+
+SHELL_CMD_REGISTER(profiler, &sub_profiler, "Sampling profiler commands",
+		   NULL);
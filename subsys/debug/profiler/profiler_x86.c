@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include "profiler_arch.h"
+
+/* _interrupt_enter pushes EDI, ECX, EDX and EAX on the interrupted stack,
+ * below the EIP, CS and EFLAGS pushed by the CPU, and saves the resulting
+ * stack pointer at the base of the interrupt stack.
+ */
+#define ESF_EIP 4
+
+#ifdef CONFIG_PROFILER_STACK_TRACE
+static inline bool in_irq_stack(uintptr_t addr)
+{
+	uintptr_t top = (uintptr_t)_kernel.cpus[0].irq_stack;
+
+	return (addr < top) && (addr >= top - CONFIG_ISR_STACK_SIZE);
+}
+
+static uint32_t unwind(struct profiler_frame *frame, uintptr_t *pc,
+		       uint32_t max)
+{
+	uintptr_t start = _current->stack_info.start;
+	uintptr_t end = start + _current->stack_info.size;
+	uint32_t depth = 0U;
+
+	while (depth < max) {
+		uintptr_t addr = (uintptr_t)frame;
+
+		if ((addr < start) || (addr + sizeof(*frame) > end) ||
+		    ((addr & (sizeof(uintptr_t) - 1)) != 0U) ||
+		    (frame->ret_addr == 0U)) {
+			break;
+		}
+
+		pc[depth++] = frame->ret_addr;
+
+		/* Frames are pushed downwards, a caller frame is above. */
+		if ((uintptr_t)frame->next <= addr) {
+			break;
+		}
+
+		frame = frame->next;
+	}
+
+	return depth;
+}
+#endif /* CONFIG_PROFILER_STACK_TRACE */
+
+uint32_t profiler_arch_sample(uintptr_t *pc, uint32_t max)
+{
+	struct profiler_frame *frame = __builtin_frame_address(0);
+	uintptr_t *esf;
+
+	/* A nested interrupt saves the interrupted context on the interrupt
+	 * stack itself, at a location which is not recorded.
+	 */
+	if (_kernel.cpus[0].nested != 1U) {
+		return 0;
+	}
+
+	esf = *((uintptr_t **)_kernel.cpus[0].irq_stack - 1);
+	pc[0] = esf[ESF_EIP];
+
+#ifdef CONFIG_PROFILER_STACK_TRACE
+	/* The interrupt entry does not change EBP, so the outermost frame
+	 * of the interrupt stack links to the interrupted frame.
+	 */
+	for (int i = 0; in_irq_stack((uintptr_t)frame) &&
+			i < CONFIG_ISR_STACK_SIZE / sizeof(*frame); i++) {
+		frame = frame->next;
+	}
+
+	return 1U + unwind(frame, &pc[1], max - 1U);
+#else
+	ARG_UNUSED(frame);
+	ARG_UNUSED(max);
+
+	return 1U;
+#endif
+}
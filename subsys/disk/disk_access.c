@@ -12,6 +12,7 @@
 #include <disk/disk_access.h>
 #include <errno.h>
 #include <device.h>
+#include "disk_cache.h"
 
 #define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
 #include <logging/log.h>
@@ -53,22 +54,25 @@ struct disk_info *disk_access_get_di(const char *name)
 	return disk;
 }
 
-int disk_access_init(const char *pdrv)
+int disk_access_di_init(struct disk_info *disk)
 {
-	struct disk_info *disk = disk_access_get_di(pdrv);
 	int rc = -EINVAL;
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->init != NULL)) {
+		if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+			/* The medium may have changed. */
+			(void)disk_cache_release(disk);
+		}
+
 		rc = disk->ops->init(disk);
 	}
 
 	return rc;
 }
 
-int disk_access_status(const char *pdrv)
+int disk_access_di_status(struct disk_info *disk)
 {
-	struct disk_info *disk = disk_access_get_di(pdrv);
 	int rc = -EINVAL;
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
@@ -79,47 +83,121 @@ int disk_access_status(const char *pdrv)
 	return rc;
 }
 
-int disk_access_read(const char *pdrv, uint8_t *data_buf,
-		     uint32_t start_sector, uint32_t num_sector)
+int disk_access_di_read(struct disk_info *disk, uint8_t *data_buf,
+			uint32_t start_sector, uint32_t num_sector)
 {
-	struct disk_info *disk = disk_access_get_di(pdrv);
 	int rc = -EINVAL;
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->read != NULL)) {
-		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+		if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+			rc = disk_cache_read(disk, data_buf, start_sector,
+					     num_sector);
+		} else {
+			rc = disk->ops->read(disk, data_buf, start_sector,
+					     num_sector);
+		}
 	}
 
 	return rc;
 }
 
-int disk_access_write(const char *pdrv, const uint8_t *data_buf,
-		      uint32_t start_sector, uint32_t num_sector)
+int disk_access_di_write(struct disk_info *disk, const uint8_t *data_buf,
+			 uint32_t start_sector, uint32_t num_sector)
 {
-	struct disk_info *disk = disk_access_get_di(pdrv);
 	int rc = -EINVAL;
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->write != NULL)) {
-		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+		if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+			rc = disk_cache_write(disk, data_buf, start_sector,
+					      num_sector);
+		} else {
+			rc = disk->ops->write(disk, data_buf, start_sector,
+					      num_sector);
+		}
 	}
 
 	return rc;
 }
 
-int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buf)
+int disk_access_di_ioctl(struct disk_info *disk, uint8_t cmd, void *buf)
 {
-	struct disk_info *disk = disk_access_get_di(pdrv);
 	int rc = -EINVAL;
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->ioctl != NULL)) {
+		if (IS_ENABLED(CONFIG_DISK_CACHE) &&
+		    (cmd == DISK_IOCTL_CTRL_SYNC)) {
+			rc = disk_cache_sync(disk);
+			if (rc != 0) {
+				return rc;
+			}
+		}
+
 		rc = disk->ops->ioctl(disk, cmd, buf);
 	}
 
 	return rc;
 }
 
+int disk_access_di_readv(struct disk_info *disk, uint32_t start_sector,
+			 const struct disk_access_sg *sg, size_t sg_cnt)
+{
+	int rc = 0;
+
+	for (size_t i = 0; (i < sg_cnt) && (rc == 0); i++) {
+		rc = disk_access_di_read(disk, sg[i].buf, start_sector,
+					 sg[i].num_sector);
+		start_sector += sg[i].num_sector;
+	}
+
+	return rc;
+}
+
+int disk_access_di_writev(struct disk_info *disk, uint32_t start_sector,
+			  const struct disk_access_sg *sg, size_t sg_cnt)
+{
+	int rc = 0;
+
+	for (size_t i = 0; (i < sg_cnt) && (rc == 0); i++) {
+		rc = disk_access_di_write(disk, sg[i].buf, start_sector,
+					  sg[i].num_sector);
+		start_sector += sg[i].num_sector;
+	}
+
+	return rc;
+}
+
+int disk_access_init(const char *pdrv)
+{
+	return disk_access_di_init(disk_access_get_di(pdrv));
+}
+
+int disk_access_status(const char *pdrv)
+{
+	return disk_access_di_status(disk_access_get_di(pdrv));
+}
+
+int disk_access_read(const char *pdrv, uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	return disk_access_di_read(disk_access_get_di(pdrv), data_buf,
+				   start_sector, num_sector);
+}
+
+int disk_access_write(const char *pdrv, const uint8_t *data_buf,
+		      uint32_t start_sector, uint32_t num_sector)
+{
+	return disk_access_di_write(disk_access_get_di(pdrv), data_buf,
+				    start_sector, num_sector);
+}
+
+int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buf)
+{
+	return disk_access_di_ioctl(disk_access_get_di(pdrv), cmd, buf);
+}
+
 int disk_access_register(struct disk_info *disk)
 {
 	int rc = 0;
@@ -161,6 +239,10 @@ int disk_access_unregister(struct disk_info *disk)
 		rc = -EINVAL;
 		goto unreg_err;
 	}
+	if (IS_ENABLED(CONFIG_DISK_CACHE)) {
+		(void)disk_cache_release(disk);
+	}
+
 	/* remove disk node from the list */
 	sys_dlist_remove(&disk->node);
 	LOG_DBG("disk interface(%s) unregistred", disk->name);
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <kernel.h>
+#include <disk/disk_access.h>
+
+#define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_DECLARE(disk);
+
+/* Requests executed by the disk access thread, in submission order. */
+static K_FIFO_DEFINE(req_fifo);
+
+static int req_execute(struct disk_access_req *req)
+{
+	if (req->op == DISK_ACCESS_OP_READ) {
+		return disk_access_di_readv(req->disk, req->start_sector,
+					    req->sg, req->sg_cnt);
+	}
+
+	return disk_access_di_writev(req->disk, req->start_sector, req->sg,
+				     req->sg_cnt);
+}
+
+static void disk_access_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		struct disk_access_req *req = k_fifo_get(&req_fifo, K_FOREVER);
+
+		disk_access_complete(req, req_execute(req));
+	}
+}
+
+K_THREAD_DEFINE(disk_access_tid, CONFIG_DISK_ACCESS_ASYNC_STACK_SIZE,
+		disk_access_thread, NULL, NULL, NULL,
+		CONFIG_DISK_ACCESS_ASYNC_THREAD_PRIO, 0, 0);
+
+int disk_access_submit(struct disk_info *disk, struct disk_access_req *req)
+{
+	if ((disk == NULL) || (disk->ops == NULL) || (req->cb == NULL) ||
+	    ((req->op != DISK_ACCESS_OP_READ) &&
+	     (req->op != DISK_ACCESS_OP_WRITE))) {
+		return -EINVAL;
+	}
+
+	req->disk = disk;
+
+	/* Cached disks are accessed through the cache only. */
+	if (!IS_ENABLED(CONFIG_DISK_CACHE) && (disk->ops->submit != NULL)) {
+		return disk->ops->submit(disk, req);
+	}
+
+	k_fifo_put(&req_fifo, req);
+
+	return 0;
+}
+
+void disk_access_complete(struct disk_access_req *req, int result)
+{
+	if (result != 0) {
+		LOG_DBG("%s: request at sector %u failed (%d)",
+			req->disk->name, req->start_sector, result);
+	}
+
+	req->cb(req, result);
+}
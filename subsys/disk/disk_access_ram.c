@@ -72,12 +72,44 @@ static int disk_ram_access_ioctl(struct disk_info *disk, uint8_t cmd, void *buff
 	return 0;
 }
 
+#ifdef CONFIG_DISK_ACCESS_ASYNC
+/* Requests are copied at once, without going through the disk access
+ * thread.
+ */
+static int disk_ram_access_submit(struct disk_info *disk,
+				  struct disk_access_req *req)
+{
+	uint32_t sector = req->start_sector;
+
+	for (size_t i = 0; i < req->sg_cnt; i++) {
+		const struct disk_access_sg *sg = &req->sg[i];
+
+		if (req->op == DISK_ACCESS_OP_READ) {
+			(void)disk_ram_access_read(disk, sg->buf, sector,
+						   sg->num_sector);
+		} else {
+			(void)disk_ram_access_write(disk, sg->buf, sector,
+						    sg->num_sector);
+		}
+
+		sector += sg->num_sector;
+	}
+
+	disk_access_complete(req, 0);
+
+	return 0;
+}
+#endif
+
 static const struct disk_operations ram_disk_ops = {
 	.init = disk_ram_access_init,
 	.status = disk_ram_access_status,
 	.read = disk_ram_access_read,
 	.write = disk_ram_access_write,
 	.ioctl = disk_ram_access_ioctl,
+#ifdef CONFIG_DISK_ACCESS_ASYNC
+	.submit = disk_ram_access_submit,
+#endif
 };
 
 static struct disk_info ram_disk = {
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Write-back block cache of the disk access layer.
+ *
+ * The cache holds DISK_CACHE_SETS sets of DISK_CACHE_WAYS blocks of
+ * DISK_CACHE_BLOCK_SIZE bytes, a block being a run of consecutive sectors
+ * aligned to its size. Only partial block writes allocate blocks: the block
+ * is read in, updated, and written back as a whole when it is evicted or
+ * synced. Whole block writes, and reads of blocks which are not cached, are
+ * passed to the driver, merged into as few requests as possible.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <kernel.h>
+#include <disk/disk_access.h>
+#include "disk_cache.h"
+
+#define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_DECLARE(disk);
+
+#define BLOCK_SIZE CONFIG_DISK_CACHE_BLOCK_SIZE
+#define WAYS CONFIG_DISK_CACHE_WAYS
+#define SETS CONFIG_DISK_CACHE_SETS
+
+struct cache_block {
+	struct disk_info *disk; /* NULL if the block is not valid */
+	uint32_t num;
+	uint32_t last_use;
+	bool dirty;
+};
+
+/* Geometry of a cached disk. */
+struct geometry {
+	uint32_t sector_size;
+	uint32_t block_sectors;
+	/* Number of the first block which is not entirely on the disk */
+	uint32_t block_cnt;
+};
+
+static struct cache_block blocks[SETS][WAYS];
+static uint8_t __aligned(4) block_bufs[SETS][WAYS][BLOCK_SIZE];
+static uint32_t use_cnt;
+
+static K_MUTEX_DEFINE(cache_mutex);
+
+static inline uint8_t *block_buf(struct cache_block *block)
+{
+	size_t idx = block - &blocks[0][0];
+
+	return block_bufs[idx / WAYS][idx % WAYS];
+}
+
+/* Returns false if the disk cannot be cached. */
+static bool geometry_get(struct disk_info *disk, struct geometry *geo)
+{
+	if (disk->cache_sector_size == 0U) {
+		uint32_t size, cnt;
+
+		if ((disk->ops->ioctl == NULL) ||
+		    (disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE,
+				      &size) != 0) ||
+		    (disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_COUNT,
+				      &cnt) != 0)) {
+			return false;
+		}
+
+		if ((size == 0U) || (size > BLOCK_SIZE) ||
+		    (BLOCK_SIZE % size != 0U)) {
+			LOG_WRN("%s: sector size %u not cacheable", disk->name,
+				size);
+			/* Do not query it again. */
+			size = UINT32_MAX;
+		}
+
+		disk->cache_sector_size = size;
+		disk->cache_sector_count = cnt;
+	}
+
+	if (disk->cache_sector_size == UINT32_MAX) {
+		return false;
+	}
+
+	geo->sector_size = disk->cache_sector_size;
+	geo->block_sectors = BLOCK_SIZE / geo->sector_size;
+	geo->block_cnt = disk->cache_sector_count / geo->block_sectors;
+
+	return true;
+}
+
+static struct cache_block *block_find(struct disk_info *disk, uint32_t num)
+{
+	struct cache_block *set = blocks[num % SETS];
+
+	for (int i = 0; i < WAYS; i++) {
+		if ((set[i].disk == disk) && (set[i].num == num)) {
+			return &set[i];
+		}
+	}
+
+	return NULL;
+}
+
+static inline void block_touch(struct cache_block *block)
+{
+	block->last_use = ++use_cnt;
+}
+
+static int block_write_back(struct cache_block *block,
+			    const struct geometry *geo)
+{
+	struct disk_info *disk = block->disk;
+	int rc;
+
+	if (!block->dirty) {
+		return 0;
+	}
+
+	rc = disk->ops->write(disk, block_buf(block),
+			      block->num * geo->block_sectors,
+			      geo->block_sectors);
+	if (rc != 0) {
+		LOG_ERR("%s: block %u write back failed (%d)", disk->name,
+			block->num, rc);
+		return rc;
+	}
+
+	block->dirty = false;
+
+	return 0;
+}
+
+/* Allocates the least recently used block of the set, written back first if
+ * needed, and reads the disk block in.
+ */
+static int block_alloc(struct disk_info *disk, uint32_t num,
+		       const struct geometry *geo, struct cache_block **out)
+{
+	struct cache_block *set = blocks[num % SETS];
+	struct cache_block *victim = &set[0];
+	int rc;
+
+	for (int i = 0; i < WAYS; i++) {
+		if (set[i].disk == NULL) {
+			victim = &set[i];
+			break;
+		}
+
+		if ((int32_t)(set[i].last_use - victim->last_use) < 0) {
+			victim = &set[i];
+		}
+	}
+
+	if (victim->disk != NULL) {
+		struct geometry victim_geo;
+
+		if (victim->disk == disk) {
+			victim_geo = *geo;
+		} else {
+			(void)geometry_get(victim->disk, &victim_geo);
+		}
+
+		rc = block_write_back(victim, &victim_geo);
+		if (rc != 0) {
+			return rc;
+		}
+
+		victim->disk = NULL;
+	}
+
+	rc = disk->ops->read(disk, block_buf(victim), num * geo->block_sectors,
+			     geo->block_sectors);
+	if (rc != 0) {
+		return rc;
+	}
+
+	victim->disk = disk;
+	victim->num = num;
+	victim->dirty = false;
+	*out = victim;
+
+	return 0;
+}
+
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	uint32_t end = start_sector + num_sector;
+	uint32_t sector = start_sector;
+	/* Start of the run of sectors to read from the disk */
+	uint32_t direct = start_sector;
+	struct geometry geo;
+	int rc = 0;
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	if (!geometry_get(disk, &geo)) {
+		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+		goto out;
+	}
+
+	while (sector < end) {
+		uint32_t offset = sector % geo.block_sectors;
+		uint32_t cnt = MIN(geo.block_sectors - offset, end - sector);
+		struct cache_block *block;
+
+		block = block_find(disk, sector / geo.block_sectors);
+		if (block != NULL) {
+			if (sector > direct) {
+				rc = disk->ops->read(disk, data_buf +
+					(direct - start_sector) *
+					geo.sector_size,
+					direct, sector - direct);
+				if (rc != 0) {
+					goto out;
+				}
+			}
+
+			memcpy(data_buf + (sector - start_sector) *
+			       geo.sector_size,
+			       block_buf(block) + offset * geo.sector_size,
+			       cnt * geo.sector_size);
+			block_touch(block);
+			direct = sector + cnt;
+		}
+
+		sector += cnt;
+	}
+
+	if (end > direct) {
+		rc = disk->ops->read(disk, data_buf +
+				     (direct - start_sector) * geo.sector_size,
+				     direct, end - direct);
+	}
+
+out:
+	k_mutex_unlock(&cache_mutex);
+
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	uint32_t end = start_sector + num_sector;
+	uint32_t sector = start_sector;
+	/* Start of the run of sectors to write to the disk */
+	uint32_t direct = start_sector;
+	struct geometry geo;
+	int rc = 0;
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	if (!geometry_get(disk, &geo)) {
+		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+		goto out;
+	}
+
+	while (sector < end) {
+		uint32_t num = sector / geo.block_sectors;
+		uint32_t offset = sector % geo.block_sectors;
+		uint32_t cnt = MIN(geo.block_sectors - offset, end - sector);
+		struct cache_block *block = block_find(disk, num);
+
+		if ((cnt == geo.block_sectors) || (num >= geo.block_cnt)) {
+			/* Whole block, or block not entirely on the disk,
+			 * written directly. A cached copy is obsolete.
+			 */
+			if (block != NULL) {
+				block->disk = NULL;
+			}
+
+			sector += cnt;
+			continue;
+		}
+
+		if (sector > direct) {
+			rc = disk->ops->write(disk, data_buf +
+					      (direct - start_sector) *
+					      geo.sector_size,
+					      direct, sector - direct);
+			if (rc != 0) {
+				goto out;
+			}
+		}
+
+		if (block == NULL) {
+			rc = block_alloc(disk, num, &geo, &block);
+			if (rc != 0) {
+				goto out;
+			}
+		}
+
+		memcpy(block_buf(block) + offset * geo.sector_size,
+		       data_buf + (sector - start_sector) * geo.sector_size,
+		       cnt * geo.sector_size);
+		block->dirty = true;
+		block_touch(block);
+
+		sector += cnt;
+		direct = sector;
+	}
+
+	if (end > direct) {
+		rc = disk->ops->write(disk, data_buf +
+				      (direct - start_sector) * geo.sector_size,
+				      direct, end - direct);
+	}
+
+out:
+	k_mutex_unlock(&cache_mutex);
+
+	return rc;
+}
+
+static int blocks_write_back(struct disk_info *disk, bool drop)
+{
+	struct geometry geo;
+	int rc = 0;
+
+	if ((disk->cache_sector_size == 0U) || !geometry_get(disk, &geo)) {
+		return 0;
+	}
+
+	for (int i = 0; i < SETS; i++) {
+		for (int j = 0; j < WAYS; j++) {
+			struct cache_block *block = &blocks[i][j];
+			int err;
+
+			if (block->disk != disk) {
+				continue;
+			}
+
+			err = block_write_back(block, &geo);
+			if (err != 0) {
+				rc = (rc == 0) ? err : rc;
+			} else if (drop) {
+				block->disk = NULL;
+			}
+		}
+	}
+
+	return rc;
+}
+
+int disk_cache_sync(struct disk_info *disk)
+{
+	int rc;
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+	rc = blocks_write_back(disk, false);
+	k_mutex_unlock(&cache_mutex);
+
+	return rc;
+}
+
+int disk_cache_release(struct disk_info *disk)
+{
+	int rc;
+
+	k_mutex_lock(&cache_mutex, K_FOREVER);
+
+	rc = blocks_write_back(disk, true);
+	if (rc == 0) {
+		disk->cache_sector_size = 0U;
+		disk->cache_sector_count = 0U;
+	}
+
+	k_mutex_unlock(&cache_mutex);
+
+	return rc;
+}
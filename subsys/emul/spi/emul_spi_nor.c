@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Emulator for a JEDEC SPI NOR flash using the standard M25P80-based
+ * command set: identification, SFDP, read, fast read, page program,
+ * 4 KiBy / 32 KiBy / 64 KiBy / chip erase and erase suspend / resume.
+ *
+ * Erases take time: the status register reports the device busy until
+ * the erase completes, and protocol violations (accessing the device
+ * while busy, programming or erasing without write enable) fail the
+ * transfer with -EIO so that tests catch them.
+ */
+
+#define DT_DRV_COMPAT jedec_spi_nor
+
+#define LOG_LEVEL CONFIG_SPI_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_REGISTER(emul_spi_nor);
+
+#include <string.h>
+#include <device.h>
+#include <emul.h>
+#include <drivers/spi.h>
+#include <drivers/spi_emul.h>
+#include <sys/byteorder.h>
+
+#define CMD_WRSR	0x01
+#define CMD_PP		0x02
+#define CMD_READ	0x03
+#define CMD_WRDI	0x04
+#define CMD_RDSR	0x05
+#define CMD_WREN	0x06
+#define CMD_READ_FAST	0x0B
+#define CMD_SE		0x20
+#define CMD_BE_32K	0x52
+#define CMD_SFDP	0x5A
+#define CMD_CE		0x60
+#define CMD_SUSPEND	0x75
+#define CMD_RESUME	0x7A
+#define CMD_RDID	0x9F
+#define CMD_RDPD	0xAB
+#define CMD_DPD		0xB9
+#define CMD_CE_ALT	0xC7
+#define CMD_BE		0xD8
+
+#define SR_WIP		BIT(0)
+#define SR_WEL		BIT(1)
+
+#define PAGE_SIZE	256
+
+/* Erase durations, in milliseconds */
+#define SE_TIME_MS	45
+#define BE_32K_TIME_MS	120
+#define BE_TIME_MS	150
+#define CE_TIME_MS	2000
+
+/* Address of the BFP table in the synthesized SFDP */
+#define SFDP_BFP_ADDR	0x10
+
+/** Run-time data used by the emulator */
+struct spi_nor_emul_data {
+	/** SPI emulator detail */
+	struct spi_emul emul_spi;
+	/** Configuration information */
+	const struct spi_nor_emul_cfg *cfg;
+	/** Write enable latch */
+	bool wel;
+	/** The executing erase is suspended */
+	bool suspended;
+	/** Area being erased */
+	uint32_t erase_addr;
+	uint32_t erase_size;
+	/** Uptime at which the executing erase completes */
+	int64_t erase_end;
+	/** Time left to the suspended erase */
+	int64_t erase_left;
+};
+
+/** Static configuration for the emulator */
+struct spi_nor_emul_cfg {
+	/** Label of the SPI bus this emulator connects to */
+	const char *bus_label;
+	/** Pointer to run-time data */
+	struct spi_nor_emul_data *data;
+	/** Flash contents */
+	uint8_t *mem;
+	/** Size of the flash in bytes */
+	uint32_t size;
+	/** JEDEC ID */
+	const uint8_t *jedec_id;
+	/** Basic Flash Parameters table, NULL if none */
+	const uint8_t *bfp;
+	/** Size of the BFP table in bytes */
+	uint32_t bfp_len;
+	/** Unit address (chip select ordinal) of emulator */
+	uint16_t chipsel;
+};
+
+static bool erase_busy(struct spi_nor_emul_data *data)
+{
+	return (data->erase_size != 0) && !data->suspended
+		&& (k_uptime_get() < data->erase_end);
+}
+
+static bool erase_overlaps(struct spi_nor_emul_data *data, uint32_t addr,
+			   size_t len)
+{
+	return (data->erase_size != 0)
+		&& (addr < (data->erase_addr + data->erase_size))
+		&& ((addr + len) > data->erase_addr);
+}
+
+static void sfdp_read(const struct spi_nor_emul_cfg *cfg, uint32_t addr,
+		      uint8_t *buf, size_t len)
+{
+	uint8_t hdr[SFDP_BFP_ADDR] = {
+		'S', 'F', 'D', 'P',
+		6, 1,		/* revision 1.6 */
+		0,		/* one parameter header */
+		0xFF,		/* legacy access protocol */
+		0x00, 6, 1,	/* BFP 1.6 */
+		cfg->bfp_len / sizeof(uint32_t),
+		SFDP_BFP_ADDR, 0, 0,
+		0xFF,
+	};
+
+	for (size_t i = 0; i < len; ++i, ++addr) {
+		if (addr < sizeof(hdr)) {
+			buf[i] = hdr[addr];
+		} else if ((addr - SFDP_BFP_ADDR) < cfg->bfp_len) {
+			buf[i] = cfg->bfp[addr - SFDP_BFP_ADDR];
+		} else {
+			buf[i] = 0xFF;
+		}
+	}
+}
+
+static int erase_start(const struct spi_nor_emul_cfg *cfg, uint8_t cmd,
+		       uint32_t addr)
+{
+	struct spi_nor_emul_data *data = cfg->data;
+	uint32_t size;
+	uint32_t time_ms;
+
+	switch (cmd) {
+	case CMD_SE:
+		size = KB(4);
+		time_ms = SE_TIME_MS;
+		break;
+	case CMD_BE_32K:
+		size = KB(32);
+		time_ms = BE_32K_TIME_MS;
+		break;
+	case CMD_BE:
+		size = KB(64);
+		time_ms = BE_TIME_MS;
+		break;
+	default:
+		addr = 0;
+		size = cfg->size;
+		time_ms = CE_TIME_MS;
+		break;
+	}
+
+	if (data->erase_size != 0) {
+		LOG_ERR("Erase while an erase is suspended");
+		return -EIO;
+	}
+
+	addr = ROUND_DOWN(addr, size);
+	if ((addr + size) > cfg->size) {
+		LOG_ERR("Erase out of the flash at 0x%x", addr);
+		return -EIO;
+	}
+
+	LOG_DBG("Erase %u at 0x%x", size, addr);
+
+	/* The content is undefined until the erase completes, reading
+	 * the area meanwhile is an error.
+	 */
+	memset(&cfg->mem[addr], 0xFF, size);
+	data->erase_addr = addr;
+	data->erase_size = size;
+	data->erase_end = k_uptime_get() + time_ms;
+	data->suspended = false;
+
+	return 0;
+}
+
+static int spi_nor_emul_io(struct spi_emul *emul,
+			   const struct spi_config *config,
+			   const struct spi_buf_set *tx_bufs,
+			   const struct spi_buf_set *rx_bufs)
+{
+	struct spi_nor_emul_data *data;
+	const struct spi_nor_emul_cfg *cfg;
+	const uint8_t *hdr;
+	const uint8_t *in = NULL;
+	uint8_t *out = NULL;
+	size_t hdr_len;
+	size_t len = 0;
+	uint32_t addr = 0;
+	uint8_t cmd;
+
+	data = CONTAINER_OF(emul, struct spi_nor_emul_data, emul_spi);
+	cfg = data->cfg;
+
+	__ASSERT_NO_MSG(tx_bufs && (tx_bufs->count > 0));
+
+	/* The driver sends the instruction, address and wait states in
+	 * the first buffer, and the data in the second one.
+	 */
+	hdr = tx_bufs->buffers[0].buf;
+	hdr_len = tx_bufs->buffers[0].len;
+	cmd = hdr[0];
+	if (hdr_len >= 4) {
+		addr = sys_get_be24(&hdr[1]);
+	}
+
+	if (tx_bufs->count > 1) {
+		in = tx_bufs->buffers[1].buf;
+		len = tx_bufs->buffers[1].len;
+	}
+	if (rx_bufs && (rx_bufs->count > 1)) {
+		out = rx_bufs->buffers[1].buf;
+		len = rx_bufs->buffers[1].len;
+	}
+
+	if (data->erase_size && !data->suspended
+	    && (k_uptime_get() >= data->erase_end)) {
+		data->erase_size = 0;
+	}
+
+	if (erase_busy(data) && (cmd != CMD_RDSR) && (cmd != CMD_SUSPEND)) {
+		LOG_ERR("Instruction %02x while busy", cmd);
+		return -EIO;
+	}
+
+	switch (cmd) {
+	case CMD_RDSR:
+		if (out && len) {
+			out[0] = (erase_busy(data) ? SR_WIP : 0)
+				 | (data->wel ? SR_WEL : 0);
+		}
+		break;
+	case CMD_RDID:
+		if (out) {
+			memcpy(out, cfg->jedec_id, MIN(len, 3));
+		}
+		break;
+	case CMD_SFDP:
+		if (!cfg->bfp || (hdr_len != 5) || !out) {
+			return -EIO;
+		}
+		sfdp_read(cfg, addr, out, len);
+		break;
+	case CMD_READ:
+	case CMD_READ_FAST:
+		if ((hdr_len != ((cmd == CMD_READ) ? 4 : 5)) || !out
+		    || ((addr + len) > cfg->size)) {
+			return -EIO;
+		}
+		if (erase_overlaps(data, addr, len)) {
+			LOG_ERR("Read of 0x%x in the suspended erase", addr);
+			return -EIO;
+		}
+		memcpy(out, &cfg->mem[addr], len);
+		break;
+	case CMD_WREN:
+		data->wel = true;
+		break;
+	case CMD_WRDI:
+		data->wel = false;
+		break;
+	case CMD_PP:
+		if (!data->wel || !in || (hdr_len != 4)
+		    || (((addr % PAGE_SIZE) + len) > PAGE_SIZE)
+		    || ((addr + len) > cfg->size)
+		    || erase_overlaps(data, addr, len)) {
+			LOG_ERR("Invalid program of %zu at 0x%x", len, addr);
+			return -EIO;
+		}
+		for (size_t i = 0; i < len; ++i) {
+			cfg->mem[addr + i] &= in[i];
+		}
+		data->wel = false;
+		break;
+	case CMD_SE:
+	case CMD_BE_32K:
+	case CMD_BE:
+	case CMD_CE:
+	case CMD_CE_ALT:
+		if (!data->wel) {
+			LOG_ERR("Erase without write enable");
+			return -EIO;
+		}
+		data->wel = false;
+		return erase_start(cfg, cmd, addr);
+	case CMD_SUSPEND:
+		if (erase_busy(data) && (data->erase_size != cfg->size)) {
+			data->erase_left = data->erase_end - k_uptime_get();
+			data->suspended = true;
+		}
+		break;
+	case CMD_RESUME:
+		if (data->suspended) {
+			data->erase_end = k_uptime_get() + data->erase_left;
+			data->suspended = false;
+		}
+		break;
+	case CMD_DPD:
+	case CMD_RDPD:
+	case CMD_WRSR:
+		break;
+	default:
+		LOG_ERR("Unsupported instruction %02x", cmd);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Device instantiation */
+
+static struct spi_emul_api spi_nor_emul_api = {
+	.io = spi_nor_emul_io,
+};
+
+/**
+ * Set up a new SPI NOR flash emulator
+ *
+ * @param emul Emulation information
+ * @param parent Device to emulate (must use the spi_nor driver)
+ * @return 0 indicating success (always)
+ */
+static int emul_spi_nor_init(const struct emul *emul,
+			     const struct device *parent)
+{
+	const struct spi_nor_emul_cfg *cfg = emul->cfg;
+	struct spi_nor_emul_data *data = cfg->data;
+
+	data->cfg = cfg;
+	data->emul_spi.api = &spi_nor_emul_api;
+	data->emul_spi.chipsel = cfg->chipsel;
+
+	/* Start with an erased flash */
+	memset(cfg->mem, 0xff, cfg->size);
+
+	int rc = spi_emul_register(parent, emul->dev_label, &data->emul_spi);
+
+	return rc;
+}
+
+#define SPI_NOR_EMUL_BFP(n) \
+	static const __aligned(4) uint8_t spi_nor_emul_bfp_##n[] = \
+		DT_INST_PROP(n, sfdp_bfp);
+
+#define SPI_NOR_EMUL(n) \
+	static uint8_t spi_nor_emul_mem_##n[DT_INST_PROP(n, size) / 8]; \
+	static const uint8_t spi_nor_emul_id_##n[] = \
+		DT_INST_PROP(n, jedec_id); \
+	COND_CODE_1(DT_INST_NODE_HAS_PROP(n, sfdp_bfp), \
+		    (SPI_NOR_EMUL_BFP(n)), ()) \
+	static struct spi_nor_emul_data spi_nor_emul_data_##n; \
+	static const struct spi_nor_emul_cfg spi_nor_emul_cfg_##n = { \
+		.bus_label = DT_INST_BUS_LABEL(n), \
+		.data = &spi_nor_emul_data_##n, \
+		.mem = spi_nor_emul_mem_##n, \
+		.size = DT_INST_PROP(n, size) / 8, \
+		.jedec_id = spi_nor_emul_id_##n, \
+		COND_CODE_1(DT_INST_NODE_HAS_PROP(n, sfdp_bfp), \
+			    (.bfp = spi_nor_emul_bfp_##n, \
+			     .bfp_len = sizeof(spi_nor_emul_bfp_##n),), ()) \
+		.chipsel = DT_INST_REG_ADDR(n), \
+	}; \
+	EMUL_DEFINE(emul_spi_nor_init, DT_DRV_INST(n), &spi_nor_emul_cfg_##n)
+
+DT_INST_FOREACH_STATUS_OKAY(SPI_NOR_EMUL)
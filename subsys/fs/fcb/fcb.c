@@ -103,6 +103,7 @@ fcb_init(int f_area_id, struct fcb *fcb)
 	struct fcb_disk_area fda;
 	const struct device *dev = NULL;
 	const struct flash_parameters *fparam;
+	struct fcb_sector_summary *sum;
 
 	if (!fcb->f_sectors || fcb->f_sector_cnt - fcb->f_scratch_cnt < 1) {
 		return -EINVAL;
@@ -162,14 +163,25 @@ fcb_init(int f_area_id, struct fcb *fcb)
 	fcb->f_active.fe_elem_off = sizeof(struct fcb_disk_area);
 	fcb->f_active_id = newest;
 
-	while (1) {
-		rc = fcb_getnext_in_sector(fcb, &fcb->f_active);
-		if (rc == -ENOTSUP) {
-			rc = 0;
-			break;
-		}
-		if (rc != 0) {
-			break;
+	rc = fcb_summary_init(fcb);
+	if (rc) {
+		return rc;
+	}
+
+	sum = fcb_summary_get(fcb, newest_sector);
+	if (sum != NULL) {
+		fcb->f_active.fe_elem_off = sum->fss_end_off;
+		rc = 0;
+	} else {
+		while (1) {
+			rc = fcb_getnext_in_sector(fcb, &fcb->f_active);
+			if (rc == -ENOTSUP) {
+				rc = 0;
+				break;
+			}
+			if (rc != 0) {
+				break;
+			}
 		}
 	}
 	k_mutex_init(&fcb->f_mtx);
@@ -273,6 +285,7 @@ fcb_sector_hdr_init(struct fcb *fcb, struct flash_sector *sector, uint16_t id)
 	if (rc != 0) {
 		return -EIO;
 	}
+	fcb_summary_reset(fcb, sector);
 	return 0;
 }
 
@@ -61,6 +61,7 @@ fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *append_loc)
 {
 	struct flash_sector *sector;
 	struct fcb_entry *active;
+	struct fcb_sector_summary *sum;
 	int cnt;
 	int rc;
 	uint8_t tmp_str[8];
@@ -106,6 +107,14 @@ fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *append_loc)
 
 	active->fe_elem_off = append_loc->fe_data_off + len;
 
+	/* The element is invalid until fcb_append_finish() writes its CRC. */
+	sum = fcb_summary_get(fcb, active->fe_sector);
+	if (sum != NULL) {
+		sum->fss_elem_cnt++;
+		sum->fss_bad_cnt++;
+		sum->fss_end_off = active->fe_elem_off;
+	}
+
 	k_mutex_unlock(&fcb->f_mtx);
 
 	return 0;
@@ -120,6 +129,7 @@ fcb_append_finish(struct fcb *fcb, struct fcb_entry *loc)
 	int rc;
 	uint8_t crc8[fcb->f_align];
 	off_t off;
+	struct fcb_sector_summary *sum;
 
 	(void)memset(crc8, 0xFF, sizeof(crc8));
 
@@ -133,5 +143,18 @@ fcb_append_finish(struct fcb *fcb, struct fcb_entry *loc)
 	if (rc) {
 		return -EIO;
 	}
+
+	sum = fcb_summary_get(fcb, loc->fe_sector);
+	if (sum != NULL) {
+		k_mutex_lock(&fcb->f_mtx, K_FOREVER);
+		if (sum->fss_bad_cnt > 0U) {
+			sum->fss_bad_cnt--;
+		}
+		if (sum->fss_first_off == 0U) {
+			sum->fss_first_off = loc->fe_elem_off;
+		}
+		sum->fss_last_off = MAX(sum->fss_last_off, loc->fe_elem_off);
+		k_mutex_unlock(&fcb->f_mtx);
+	}
 	return 0;
 }
@@ -14,33 +14,49 @@
  * Given offset in flash sector, fill in rest of the fcb_entry, and crc8 over
  * the data.
  */
-int
-fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *c8p)
+static int
+fcb_elem_len_read(struct fcb *fcb, struct fcb_entry *loc, uint8_t *buf)
 {
-	uint8_t tmp_str[FCB_TMP_BUF_SZ];
 	int cnt;
-	int blk_sz;
-	uint8_t crc8;
 	uint16_t len;
-	uint32_t off;
-	uint32_t end;
 	int rc;
 
 	if (loc->fe_elem_off + 2 > loc->fe_sector->fs_size) {
 		return -ENOTSUP;
 	}
-	rc = fcb_flash_read(fcb, loc->fe_sector, loc->fe_elem_off, tmp_str, 2);
+	rc = fcb_flash_read(fcb, loc->fe_sector, loc->fe_elem_off, buf, 2);
 	if (rc) {
 		return -EIO;
 	}
 
-	cnt = fcb_get_len(fcb, tmp_str, &len);
+	cnt = fcb_get_len(fcb, buf, &len);
 	if (cnt < 0) {
 		return cnt;
 	}
 	loc->fe_data_off = loc->fe_elem_off + fcb_len_in_flash(fcb, cnt);
 	loc->fe_data_len = len;
 
+	return cnt;
+}
+
+int
+fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *c8p)
+{
+	uint8_t tmp_str[FCB_TMP_BUF_SZ];
+	int cnt;
+	int blk_sz;
+	uint8_t crc8;
+	uint16_t len;
+	uint32_t off;
+	uint32_t end;
+	int rc;
+
+	cnt = fcb_elem_len_read(fcb, loc, tmp_str);
+	if (cnt < 0) {
+		return cnt;
+	}
+	len = loc->fe_data_len;
+
 	crc8 = CRC8_CCITT_INITIAL_VALUE;
 	crc8 = crc8_ccitt(crc8, tmp_str, cnt);
 
@@ -63,7 +79,7 @@ fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *c8p)
 	return 0;
 }
 
-int fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc)
+int fcb_elem_info_crc(struct fcb *fcb, struct fcb_entry *loc)
 {
 	int rc;
 	uint8_t crc8;
@@ -86,3 +102,27 @@ int fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc)
 	}
 	return 0;
 }
+
+/*
+ * Elements of a sector whose summary has no invalid element are known to be
+ * valid, only their length is read.
+ */
+int fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc)
+{
+	const struct fcb_sector_summary *sum;
+	uint8_t tmp_str[2];
+	int rc;
+
+	sum = fcb_summary_get(fcb, loc->fe_sector);
+	if ((sum == NULL) || (sum->fss_bad_cnt != 0U)) {
+		return fcb_elem_info_crc(fcb, loc);
+	}
+
+	if (loc->fe_elem_off >= sum->fss_end_off) {
+		return -ENOTSUP;
+	}
+
+	rc = fcb_elem_len_read(fcb, loc, tmp_str);
+
+	return (rc < 0) ? rc : 0;
+}
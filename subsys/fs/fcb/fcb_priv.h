@@ -70,12 +70,36 @@ struct flash_sector *fcb_getnext_sector(struct fcb *fcb,
 int fcb_getnext_nolock(struct fcb *fcb, struct fcb_entry *loc);
 
 int fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc);
+int fcb_elem_info_crc(struct fcb *fcb, struct fcb_entry *loc);
 int fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *crc8p);
 
 int fcb_sector_hdr_init(struct fcb *fcb, struct flash_sector *sector, uint16_t id);
 int fcb_sector_hdr_read(struct fcb *fcb, struct flash_sector *sector,
 			struct fcb_disk_area *fdap);
 
+#ifdef CONFIG_FCB_SECTOR_SUMMARY
+struct fcb_sector_summary *fcb_summary_get(const struct fcb *fcb,
+					   const struct flash_sector *sector);
+void fcb_summary_reset(struct fcb *fcb, const struct flash_sector *sector);
+int fcb_summary_init(struct fcb *fcb);
+#else
+static inline struct fcb_sector_summary *
+fcb_summary_get(const struct fcb *fcb, const struct flash_sector *sector)
+{
+	return NULL;
+}
+
+static inline void fcb_summary_reset(struct fcb *fcb,
+				     const struct flash_sector *sector)
+{
+}
+
+static inline int fcb_summary_init(struct fcb *fcb)
+{
+	return 0;
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <fs/fcb.h>
+#include "fcb_priv.h"
+
+struct fcb_sector_summary *
+fcb_summary_get(const struct fcb *fcb, const struct flash_sector *sector)
+{
+	if (fcb->f_summaries == NULL) {
+		return NULL;
+	}
+
+	return &fcb->f_summaries[sector - fcb->f_sectors];
+}
+
+/*
+ * Summary of an erased sector, or of a sector whose header was just written.
+ */
+void
+fcb_summary_reset(struct fcb *fcb, const struct flash_sector *sector)
+{
+	struct fcb_sector_summary *sum = fcb_summary_get(fcb, sector);
+
+	if (sum == NULL) {
+		return;
+	}
+
+	(void)memset(sum, 0, sizeof(*sum));
+	sum->fss_end_off = sizeof(struct fcb_disk_area);
+}
+
+/*
+ * Read every element of a sector, checking their CRC, to summarize it.
+ */
+static int
+fcb_summary_build(struct fcb *fcb, struct flash_sector *sector)
+{
+	struct fcb_sector_summary *sum = fcb_summary_get(fcb, sector);
+	struct fcb_entry loc;
+	int rc;
+
+	if (sum == NULL) {
+		return 0;
+	}
+
+	fcb_summary_reset(fcb, sector);
+
+	loc.fe_sector = sector;
+	loc.fe_elem_off = sizeof(struct fcb_disk_area);
+
+	while (1) {
+		rc = fcb_elem_info_crc(fcb, &loc);
+		if (rc == 0) {
+			if (sum->fss_first_off == 0U) {
+				sum->fss_first_off = loc.fe_elem_off;
+			}
+			sum->fss_last_off = loc.fe_elem_off;
+		} else if (rc == -EBADMSG) {
+			sum->fss_bad_cnt++;
+		} else {
+			break;
+		}
+		sum->fss_elem_cnt++;
+		loc.fe_elem_off = loc.fe_data_off +
+		  fcb_len_in_flash(fcb, loc.fe_data_len) +
+		  fcb_len_in_flash(fcb, FCB_CRC_SZ);
+	}
+	sum->fss_end_off = loc.fe_elem_off;
+
+	return (rc == -ENOTSUP) ? 0 : rc;
+}
+
+/*
+ * Summarize the sectors in use, the others are erased.
+ */
+int
+fcb_summary_init(struct fcb *fcb)
+{
+	struct flash_sector *sector;
+	int rc;
+	int i;
+
+	if (fcb->f_summaries == NULL) {
+		return 0;
+	}
+
+	for (i = 0; i < fcb->f_sector_cnt; i++) {
+		sector = &fcb->f_sectors[i];
+		rc = fcb_sector_hdr_read(fcb, sector, NULL);
+		if (rc == 1) {
+			rc = fcb_summary_build(fcb, sector);
+		} else if (rc == 0) {
+			fcb_summary_reset(fcb, sector);
+		}
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
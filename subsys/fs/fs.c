@@ -159,6 +159,10 @@ int fs_open(struct fs_file_t *zfp, const char *file_name, fs_mode_t flags)
 		return -ENOTSUP;
 	}
 
+	if ((flags & FS_O_STREAM) != 0) {
+		flags |= FS_O_APPEND;
+	}
+
 	rc = zfp->mp->fs->open(zfp, file_name, flags);
 	if (rc < 0) {
 		LOG_ERR("file open error (%d)", rc);
@@ -231,6 +235,86 @@ ssize_t fs_write(struct fs_file_t *zfp, const void *ptr, size_t size)
 	return rc;
 }
 
+/* Transfers the buffers one by one, up to the first partial transfer. */
+static ssize_t iov_transfer(struct fs_file_t *zfp, const struct fs_iovec *iov,
+			    int iovcnt, bool write)
+{
+	ssize_t total = 0;
+
+	for (int i = 0; i < iovcnt; i++) {
+		ssize_t rc;
+
+		if (write) {
+			rc = zfp->mp->fs->write(zfp, iov[i].base, iov[i].len);
+		} else {
+			rc = zfp->mp->fs->read(zfp, iov[i].base, iov[i].len);
+		}
+
+		if (rc < 0) {
+			return (total > 0) ? total : rc;
+		}
+
+		total += rc;
+		if ((size_t)rc < iov[i].len) {
+			break;
+		}
+	}
+
+	return total;
+}
+
+ssize_t fs_readv(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		 int iovcnt)
+{
+	ssize_t rc;
+
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	if (zfp->mp->fs->readv != NULL) {
+		rc = zfp->mp->fs->readv(zfp, iov, iovcnt);
+	} else {
+		CHECKIF(zfp->mp->fs->read == NULL) {
+			return -ENOTSUP;
+		}
+
+		rc = iov_transfer(zfp, iov, iovcnt, false);
+	}
+
+	if (rc < 0) {
+		LOG_ERR("file read error (%d)", (int)rc);
+	}
+
+	return rc;
+}
+
+ssize_t fs_writev(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		  int iovcnt)
+{
+	ssize_t rc;
+
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	if (zfp->mp->fs->writev != NULL) {
+		rc = zfp->mp->fs->writev(zfp, iov, iovcnt);
+	} else {
+		CHECKIF(zfp->mp->fs->write == NULL) {
+			return -ENOTSUP;
+		}
+
+		rc = iov_transfer(zfp, iov, iovcnt, true);
+	}
+
+	if (rc < 0) {
+		LOG_ERR("file write error (%d)", (int)rc);
+	}
+
+	return rc;
+}
+
 int fs_seek(struct fs_file_t *zfp, off_t offset, int whence)
 {
 	int rc = -ENOTSUP;
@@ -291,6 +375,30 @@ int fs_truncate(struct fs_file_t *zfp, off_t length)
 	return rc;
 }
 
+int fs_fallocate(struct fs_file_t *zfp, off_t length)
+{
+	int rc;
+
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	if (length < 0) {
+		return -EINVAL;
+	}
+
+	if (zfp->mp->fs->fallocate == NULL) {
+		return -ENOTSUP;
+	}
+
+	rc = zfp->mp->fs->fallocate(zfp, length);
+	if (rc < 0) {
+		LOG_ERR("file fallocate error (%d)", rc);
+	}
+
+	return rc;
+}
+
 int fs_sync(struct fs_file_t *zfp)
 {
 	int rc = -EINVAL;
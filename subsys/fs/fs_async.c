@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <kernel.h>
+#include <init.h>
+#include <fs/fs.h>
+#include <fs/fs_async.h>
+
+#define WORKERS CONFIG_FILE_SYSTEM_ASYNC_WORKERS
+
+struct worker {
+	struct k_fifo fifo;
+	struct k_thread thread;
+};
+
+static struct worker workers[WORKERS];
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, WORKERS,
+				   CONFIG_FILE_SYSTEM_ASYNC_STACK_SIZE);
+
+static ssize_t req_execute(struct fs_async_req *req)
+{
+	switch (req->op) {
+	case FS_ASYNC_READ:
+		return fs_readv(req->zfp, req->iov, req->iovcnt);
+	case FS_ASYNC_WRITE:
+		return fs_writev(req->zfp, req->iov, req->iovcnt);
+	default:
+		return fs_sync(req->zfp);
+	}
+}
+
+static void worker_thread(void *p1, void *p2, void *p3)
+{
+	struct worker *worker = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		struct fs_async_req *req = k_fifo_get(&worker->fifo,
+						      K_FOREVER);
+
+		req->result = req_execute(req);
+
+		if (req->signal != NULL) {
+			k_poll_signal_raise(req->signal, (int)req->result);
+		}
+
+		if (req->cb != NULL) {
+			req->cb(req, req->result);
+		}
+	}
+}
+
+int fs_async_submit(struct fs_async_req *req)
+{
+	size_t idx;
+
+	if ((req->zfp == NULL) || (req->op > FS_ASYNC_SYNC) ||
+	    ((req->op != FS_ASYNC_SYNC) && (req->iovcnt < 0))) {
+		return -EINVAL;
+	}
+
+	if (req->zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	/* Keep the requests of a file in order on one worker. */
+	idx = ((uintptr_t)req->zfp / sizeof(struct fs_file_t)) % WORKERS;
+	k_fifo_put(&workers[idx].fifo, req);
+
+	return 0;
+}
+
+static int fs_async_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	for (int i = 0; i < WORKERS; i++) {
+		k_fifo_init(&workers[i].fifo);
+		k_thread_create(&workers[i].thread, worker_stacks[i],
+				K_THREAD_STACK_SIZEOF(worker_stacks[i]),
+				worker_thread, &workers[i], NULL, NULL,
+				CONFIG_FILE_SYSTEM_ASYNC_THREAD_PRIO, 0,
+				K_NO_WAIT);
+		k_thread_name_set(&workers[i].thread, "fs_async");
+	}
+
+	return 0;
+}
+
+SYS_INIT(fs_async_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
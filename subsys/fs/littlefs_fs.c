@@ -27,6 +27,15 @@ struct lfs_file_data {
 	struct lfs_file file;
 	struct lfs_file_config config;
 	struct k_mem_block cache_block;
+
+	/* Opened with FS_O_STREAM: size and time of the last commit. */
+	bool stream;
+	lfs_soff_t commit_size;
+	uint32_t commit_time;
+
+	/* Size set by fs_fallocate(), and blocks still reserved for it. */
+	lfs_off_t reserve_size;
+	lfs_size_t reserved_blocks;
 };
 
 #define LFS_FILEP(fp) (&((struct lfs_file_data *)(fp->filep))->file)
@@ -182,6 +191,144 @@ static void release_file_data(struct fs_file_t *fp)
 	fp->filep = NULL;
 }
 
+/* Upper bound of the blocks used by the data of a file of size bytes: each
+ * block of the CTZ skip-list starts with at most as many pointers as there
+ * are bits in the block count.
+ */
+static lfs_size_t data_blocks(const struct lfs *lfs, lfs_off_t size)
+{
+	const struct lfs_config *cfg = lfs->cfg;
+	lfs_size_t per_block = cfg->block_size -
+		4U * (32U - __builtin_clz(cfg->block_count));
+
+	return (size + per_block - 1U) / per_block;
+}
+
+/* Blocks needed for a file to grow from size to end bytes, the partially
+ * filled last block being copied on append.
+ */
+static lfs_size_t grow_blocks(const struct lfs *lfs, lfs_off_t size,
+			      lfs_off_t end)
+{
+	if (end <= size) {
+		return 0;
+	}
+
+	return data_blocks(lfs, end) - data_blocks(lfs, size) + 1U;
+}
+
+/* Must be called with the file system locked. */
+static int reservation_update(struct fs_littlefs *fs,
+			      struct lfs_file_data *fdp)
+{
+	lfs_soff_t size;
+	lfs_size_t need;
+
+	if (fdp->reserve_size == 0U) {
+		return 0;
+	}
+
+	size = lfs_file_size(&fs->lfs, &fdp->file);
+	if (size < 0) {
+		return size;
+	}
+
+	need = grow_blocks(&fs->lfs, size, fdp->reserve_size);
+	fs->reserved_blocks = fs->reserved_blocks - fdp->reserved_blocks + need;
+	fdp->reserved_blocks = need;
+
+	return 0;
+}
+
+/* Fail a write growing a file beyond its own reservation into blocks
+ * reserved for other files. The blocks in use are only counted when other
+ * files hold reservations, as it takes a traversal of the file system.
+ *
+ * Must be called with the file system locked.
+ */
+static int reservation_check(struct fs_littlefs *fs,
+			     struct lfs_file_data *fdp, size_t len)
+{
+	lfs_size_t others = fs->reserved_blocks - fdp->reserved_blocks;
+	lfs_soff_t size, pos;
+	lfs_ssize_t used;
+	lfs_off_t end;
+
+	if (others == 0U) {
+		return 0;
+	}
+
+	size = lfs_file_size(&fs->lfs, &fdp->file);
+	pos = lfs_file_tell(&fs->lfs, &fdp->file);
+	if ((size < 0) || (pos < 0)) {
+		return (size < 0) ? size : pos;
+	}
+
+	if ((fdp->file.flags & LFS_O_APPEND) != 0) {
+		pos = size;
+	}
+
+	end = MAX((lfs_off_t)size, (lfs_off_t)pos + len);
+	if (end <= fdp->reserve_size) {
+		return 0;
+	}
+
+	used = lfs_fs_size(&fs->lfs);
+	if (used < 0) {
+		return used;
+	}
+
+	if ((used + others + grow_blocks(&fs->lfs, size, end)) >
+	    fs->lfs.cfg->block_count) {
+		return LFS_ERR_NOSPC;
+	}
+
+	return 0;
+}
+
+/* Commit the metadata of a stream if enough data was appended or enough
+ * time elapsed since the last commit.
+ *
+ * Must be called with the file system locked.
+ */
+static int stream_commit(struct fs_littlefs *fs, struct lfs_file_data *fdp)
+{
+	uint32_t now = k_uptime_get_32();
+	lfs_soff_t size = lfs_file_size(&fs->lfs, &fdp->file);
+	int ret;
+
+	if (size < 0) {
+		return size;
+	}
+
+	if (((size - fdp->commit_size) <
+	     CONFIG_FS_LITTLEFS_STREAM_COMMIT_SIZE) &&
+	    ((now - fdp->commit_time) <
+	     CONFIG_FS_LITTLEFS_STREAM_COMMIT_INTERVAL_MS)) {
+		return 0;
+	}
+
+	ret = lfs_file_sync(&fs->lfs, &fdp->file);
+	if (ret == 0) {
+		fdp->commit_size = size;
+		fdp->commit_time = now;
+	}
+
+	return ret;
+}
+
+/* Must be called with the file system locked. */
+static int write_done(struct fs_littlefs *fs, struct lfs_file_data *fdp)
+{
+	int ret = reservation_update(fs, fdp);
+
+	if ((ret == 0) && fdp->stream) {
+		ret = stream_commit(fs, fdp);
+	}
+
+	return ret;
+}
+
 static int lfs_flags_from_zephyr(unsigned int zflags)
 {
 	int flags = (zflags & FS_O_CREATE) ? LFS_O_CREAT : 0;
@@ -228,6 +375,12 @@ static int littlefs_open(struct fs_file_t *fp, const char *path,
 	ret = lfs_file_opencfg(&fs->lfs, &fdp->file,
 			       path, flags, &fdp->config);
 
+	if ((ret == 0) && ((zflags & FS_O_STREAM) != 0)) {
+		fdp->stream = true;
+		fdp->commit_size = lfs_file_size(&fs->lfs, &fdp->file);
+		fdp->commit_time = k_uptime_get_32();
+	}
+
 	fs_unlock(fs);
 out:
 	if (ret < 0) {
@@ -240,11 +393,14 @@ out:
 static int littlefs_close(struct fs_file_t *fp)
 {
 	struct fs_littlefs *fs = fp->mp->fs_data;
+	struct lfs_file_data *fdp = fp->filep;
 
 	fs_lock(fs);
 
 	int ret = lfs_file_close(&fs->lfs, LFS_FILEP(fp));
 
+	fs->reserved_blocks -= fdp->reserved_blocks;
+
 	fs_unlock(fs);
 
 	release_file_data(fp);
@@ -297,15 +453,105 @@ static ssize_t littlefs_read(struct fs_file_t *fp, void *ptr, size_t len)
 static ssize_t littlefs_write(struct fs_file_t *fp, const void *ptr, size_t len)
 {
 	struct fs_littlefs *fs = fp->mp->fs_data;
+	struct lfs_file_data *fdp = fp->filep;
 
 	fs_lock(fs);
 
-	ssize_t ret = lfs_file_write(&fs->lfs, LFS_FILEP(fp), ptr, len);
+	ssize_t ret = reservation_check(fs, fdp, len);
+
+	if (ret == 0) {
+		ret = lfs_file_write(&fs->lfs, &fdp->file, ptr, len);
+	}
+
+	if (ret > 0) {
+		int rc = write_done(fs, fdp);
+
+		if (rc < 0) {
+			ret = rc;
+		}
+	}
 
 	fs_unlock(fs);
 	return lfs_to_errno(ret);
 }
 
+/* The buffers are transferred under one lock, so that no other operation
+ * comes in between.
+ */
+static ssize_t littlefs_iov_transfer(struct fs_file_t *fp,
+				     const struct fs_iovec *iov, int iovcnt,
+				     bool write)
+{
+	struct fs_littlefs *fs = fp->mp->fs_data;
+	struct lfs_file_data *fdp = fp->filep;
+	ssize_t total = 0;
+
+	fs_lock(fs);
+
+	if (write) {
+		size_t len = 0;
+		int ret;
+
+		for (int i = 0; i < iovcnt; i++) {
+			len += iov[i].len;
+		}
+
+		ret = reservation_check(fs, fdp, len);
+		if (ret < 0) {
+			fs_unlock(fs);
+			return lfs_to_errno(ret);
+		}
+	}
+
+	for (int i = 0; i < iovcnt; i++) {
+		lfs_ssize_t ret;
+
+		if (write) {
+			ret = lfs_file_write(&fs->lfs, LFS_FILEP(fp),
+					     iov[i].base, iov[i].len);
+		} else {
+			ret = lfs_file_read(&fs->lfs, LFS_FILEP(fp),
+					    iov[i].base, iov[i].len);
+		}
+
+		if (ret < 0) {
+			if (total == 0) {
+				total = lfs_to_errno(ret);
+			}
+			break;
+		}
+
+		total += ret;
+		if ((size_t)ret < iov[i].len) {
+			break;
+		}
+	}
+
+	if (write && (total > 0)) {
+		int ret = write_done(fs, fdp);
+
+		if (ret < 0) {
+			total = lfs_to_errno(ret);
+		}
+	}
+
+	fs_unlock(fs);
+
+	return total;
+}
+
+static ssize_t littlefs_readv(struct fs_file_t *fp, const struct fs_iovec *iov,
+			      int iovcnt)
+{
+	return littlefs_iov_transfer(fp, iov, iovcnt, false);
+}
+
+static ssize_t littlefs_writev(struct fs_file_t *fp,
+			       const struct fs_iovec *iov, int iovcnt)
+{
+	return littlefs_iov_transfer(fp, iov, iovcnt, true);
+}
+
 BUILD_ASSERT((FS_SEEK_SET == LFS_SEEK_SET)
 	     && (FS_SEEK_CUR == LFS_SEEK_CUR)
 	     && (FS_SEEK_END == LFS_SEEK_END));
@@ -347,6 +593,10 @@ static int littlefs_truncate(struct fs_file_t *fp, off_t length)
 
 	int ret = lfs_file_truncate(&fs->lfs, LFS_FILEP(fp), length);
 
+	if (ret == 0) {
+		ret = reservation_update(fs, fp->filep);
+	}
+
 	fs_unlock(fs);
 	return lfs_to_errno(ret);
 }
@@ -354,15 +604,60 @@ static int littlefs_truncate(struct fs_file_t *fp, off_t length)
 static int littlefs_sync(struct fs_file_t *fp)
 {
 	struct fs_littlefs *fs = fp->mp->fs_data;
+	struct lfs_file_data *fdp = fp->filep;
+	int ret;
 
 	fs_lock(fs);
 
-	int ret = lfs_file_sync(&fs->lfs, LFS_FILEP(fp));
+	if (fdp->stream) {
+		ret = stream_commit(fs, fdp);
+	} else {
+		ret = lfs_file_sync(&fs->lfs, &fdp->file);
+	}
 
 	fs_unlock(fs);
 	return lfs_to_errno(ret);
 }
 
+/* littlefs allocates blocks as data is written, so the storage can not be
+ * placed ahead. Instead the blocks the file needs to grow to length are
+ * accounted as reserved, and writes of other files which would use them
+ * fail with -ENOSPC.
+ */
+static int littlefs_fallocate(struct fs_file_t *fp, off_t length)
+{
+	struct fs_littlefs *fs = fp->mp->fs_data;
+	struct lfs_file_data *fdp = fp->filep;
+	lfs_size_t others, need;
+	lfs_ssize_t used;
+	lfs_soff_t size;
+	int ret = 0;
+
+	fs_lock(fs);
+
+	size = lfs_file_size(&fs->lfs, &fdp->file);
+	used = lfs_fs_size(&fs->lfs);
+	if ((size < 0) || (used < 0)) {
+		ret = (size < 0) ? size : used;
+		goto out;
+	}
+
+	others = fs->reserved_blocks - fdp->reserved_blocks;
+	need = grow_blocks(&fs->lfs, size, length);
+	if ((used + others + need) > fs->lfs.cfg->block_count) {
+		ret = LFS_ERR_NOSPC;
+		goto out;
+	}
+
+	fs->reserved_blocks = others + need;
+	fdp->reserved_blocks = need;
+	fdp->reserve_size = length;
+
+out:
+	fs_unlock(fs);
+	return lfs_to_errno(ret);
+}
+
 static int littlefs_mkdir(struct fs_mount_t *mountp, const char *path)
 {
 	struct fs_littlefs *fs = mountp->fs_data;
@@ -563,6 +858,8 @@ static int littlefs_mount(struct fs_mount_t *mountp)
 	k_mutex_init(&fs->mutex);
 	fs_lock(fs);
 
+	fs->reserved_blocks = 0;
+
 	/* Open flash area */
 	ret = flash_area_open(area_id, &fs->area);
 	if ((ret < 0) || (fs->area == NULL)) {
@@ -750,6 +1047,9 @@ static const struct fs_file_system_t littlefs_fs = {
 	.mkdir = littlefs_mkdir,
 	.stat = littlefs_stat,
 	.statvfs = littlefs_statvfs,
+	.readv = littlefs_readv,
+	.writev = littlefs_writev,
+	.fallocate = littlefs_fallocate,
 };
 
 static int littlefs_init(const struct device *dev)
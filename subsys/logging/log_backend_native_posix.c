@@ -80,6 +80,27 @@ static void put(const struct log_backend *const backend,
 
 }
 
+static void put_package(const struct log_backend *const backend,
+			struct log_msg_ids src_level, uint32_t timestamp,
+			const void *package, const uint8_t *data,
+			uint32_t length)
+{
+	uint32_t flags = LOG_OUTPUT_FLAG_LEVEL | LOG_OUTPUT_FLAG_TIMESTAMP;
+
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_SHOW_COLOR)) {
+		if (posix_trace_over_tty(0)) {
+			flags |= LOG_OUTPUT_FLAG_COLORS;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_FORMAT_TIMESTAMP)) {
+		flags |= LOG_OUTPUT_FLAG_FORMAT_TIMESTAMP;
+	}
+
+	log_output_package(&log_output_posix, src_level, timestamp, package,
+			   data, length, flags);
+}
+
 static void panic(struct log_backend const *const backend)
 {
 	log_output_flush(&log_output_posix);
@@ -140,6 +161,7 @@ const struct log_backend_api log_backend_native_posix_api = {
 			sync_string : NULL,
 	.put_sync_hexdump = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ?
 			sync_hexdump : NULL,
+	.put_package = IS_ENABLED(CONFIG_LOG_PACKAGED) ? put_package : NULL,
 	.panic = panic,
 	.dropped = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ? NULL : dropped,
 };
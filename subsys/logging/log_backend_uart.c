@@ -39,6 +39,18 @@ static void put(const struct log_backend *const backend,
 	log_backend_std_put(&log_output_uart, flag, msg);
 }
 
+static void put_package(const struct log_backend *const backend,
+			struct log_msg_ids src_level, uint32_t timestamp,
+			const void *package, const uint8_t *data,
+			uint32_t length)
+{
+	uint32_t flag = IS_ENABLED(CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY) ?
+		LOG_OUTPUT_FLAG_FORMAT_DICTIONARY : 0;
+
+	log_backend_std_put_package(&log_output_uart, flag, src_level,
+				    timestamp, package, data, length);
+}
+
 static void log_backend_uart_init(void)
 {
 	uart_dev = device_get_binding(CONFIG_UART_CONSOLE_ON_DEV_NAME);
@@ -54,7 +66,11 @@ static void dropped(const struct log_backend *const backend, uint32_t cnt)
 {
 	ARG_UNUSED(backend);
 
-	log_backend_std_dropped(&log_output_uart, cnt);
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY)) {
+		log_output_dict_dropped_process(&log_output_uart, cnt);
+	} else {
+		log_backend_std_dropped(&log_output_uart, cnt);
+	}
 }
 
 static void sync_string(const struct log_backend *const backend,
@@ -85,6 +101,7 @@ const struct log_backend_api log_backend_uart_api = {
 			sync_string : NULL,
 	.put_sync_hexdump = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ?
 			sync_hexdump : NULL,
+	.put_package = IS_ENABLED(CONFIG_LOG_PACKAGED) ? put_package : NULL,
 	.panic = panic,
 	.init = log_backend_uart_init,
 	.dropped = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ? NULL : dropped,
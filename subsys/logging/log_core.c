@@ -5,6 +5,7 @@
  */
 #include <logging/log_msg.h>
 #include "log_list.h"
+#include "log_pkg.h"
 #include <logging/log.h>
 #include <logging/log_backend.h>
 #include <logging/log_ctrl.h>
@@ -13,6 +14,7 @@
 #include <init.h>
 #include <sys/__assert.h>
 #include <sys/atomic.h>
+#include <sys/cbprintf.h>
 #include <ctype.h>
 #include <logging/log_frontend.h>
 #include <syscall_handler.h>
@@ -43,6 +45,10 @@ LOG_MODULE_REGISTER(log);
 #define CONFIG_LOG_STRDUP_BUF_COUNT 0
 #endif
 
+#ifndef CONFIG_LOG_PACKAGE_MAX_SIZE
+#define CONFIG_LOG_PACKAGE_MAX_SIZE 0
+#endif
+
 struct log_strdup_buf {
 	atomic_t refcount;
 	char buf[CONFIG_LOG_STRDUP_MAX_STRING + 1]; /* for termination */
@@ -182,6 +188,28 @@ static void detect_missed_strdup(struct log_msg *msg)
 #undef ERR_MSG
 }
 
+/* Trigger processing of a newly buffered message. */
+static void msg_commit_notify(void)
+{
+	unsigned int key;
+
+	if (panic_mode) {
+		key = irq_lock();
+		(void)log_process(false);
+		irq_unlock(key);
+	} else if (proc_tid != NULL && buffered_cnt == 1) {
+		k_timer_start(&log_process_thread_timer,
+			K_MSEC(CONFIG_LOG_PROCESS_THREAD_SLEEP_MS), K_NO_WAIT);
+	} else if (CONFIG_LOG_PROCESS_TRIGGER_THRESHOLD) {
+		if ((buffered_cnt == CONFIG_LOG_PROCESS_TRIGGER_THRESHOLD) &&
+		    (proc_tid != NULL)) {
+			k_timer_stop(&log_process_thread_timer);
+			k_sem_give(&log_process_thread_sem);
+		}
+	} else {
+	}
+}
+
 static inline void msg_finalize(struct log_msg *msg,
 				struct log_msg_ids src_level)
 {
@@ -198,21 +226,98 @@ static inline void msg_finalize(struct log_msg *msg,
 
 	irq_unlock(key);
 
-	if (panic_mode) {
+	msg_commit_notify();
+}
+
+static void pkg_finalize(struct log_pkg_hdr *hdr, const void *payload,
+			 struct log_msg_ids src_level)
+{
+	uint32_t dropped;
+	unsigned int key;
+	int err;
+
+	hdr->ids = src_level;
+	hdr->timestamp = timestamp_func();
+
+	/* Counted before the message is visible to the processing side,
+	 * which may run on another CPU without taking the lock.
+	 */
+	atomic_inc(&buffered_cnt);
+
+	if (IS_ENABLED(CONFIG_LOG_PER_CPU_BUFFERS)) {
+		err = log_pkg_put(hdr, payload,
+				  IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW),
+				  &dropped);
+	} else {
 		key = irq_lock();
-		(void)log_process(false);
+		err = log_pkg_put(hdr, payload,
+				  IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW),
+				  &dropped);
 		irq_unlock(key);
-	} else if (proc_tid != NULL && buffered_cnt == 1) {
-		k_timer_start(&log_process_thread_timer,
-			K_MSEC(CONFIG_LOG_PROCESS_THREAD_SLEEP_MS), K_NO_WAIT);
-	} else if (CONFIG_LOG_PROCESS_TRIGGER_THRESHOLD) {
-		if ((buffered_cnt == CONFIG_LOG_PROCESS_TRIGGER_THRESHOLD) &&
-		    (proc_tid != NULL)) {
-			k_timer_stop(&log_process_thread_timer);
-			k_sem_give(&log_process_thread_sem);
-		}
-	} else {
 	}
+
+	/* Oldest messages may have been discarded to make room. */
+	atomic_sub(&buffered_cnt, dropped);
+	atomic_add(&dropped_cnt, dropped);
+
+	if (err < 0) {
+		atomic_dec(&buffered_cnt);
+		log_dropped();
+		return;
+	}
+
+	msg_commit_notify();
+}
+
+static void log_packaged_va(struct log_msg_ids src_level, const char *fmt,
+			    va_list ap)
+{
+	uint8_t pkg[CONFIG_LOG_PACKAGE_MAX_SIZE] __aligned(sizeof(void *));
+	struct log_pkg_hdr hdr = { 0 };
+	int len;
+
+	len = cbvprintf_package(pkg, sizeof(pkg), CBPRINTF_PACKAGE_COPY_RW_STR,
+				fmt, ap);
+	if (len < 0) {
+		log_dropped();
+		return;
+	}
+
+	hdr.len = len;
+	pkg_finalize(&hdr, pkg, src_level);
+}
+
+void log_packaged(struct log_msg_ids src_level, const char *fmt, ...)
+{
+	if (IS_ENABLED(CONFIG_LOG_PACKAGED)) {
+		va_list ap;
+
+		va_start(ap, fmt);
+		log_packaged_va(src_level, fmt, ap);
+		va_end(ap);
+	}
+}
+
+static void log_packaged_hexdump(const char *str, const uint8_t *data,
+				 uint32_t length, struct log_msg_ids src_level)
+{
+	uint8_t pkg[CONFIG_LOG_PACKAGE_MAX_SIZE] __aligned(sizeof(void *));
+	struct log_pkg_hdr hdr = { .hexdump = 1 };
+	int len;
+
+	len = cbprintf_package(pkg, sizeof(pkg), CBPRINTF_PACKAGE_COPY_RW_STR,
+			       "%s", str);
+	if (len < 0) {
+		log_dropped();
+		return;
+	}
+
+	/* Data which does not fit is truncated. */
+	length = MIN(length, sizeof(pkg) - len);
+	memcpy(&pkg[len], data, length);
+
+	hdr.len = len + length;
+	pkg_finalize(&hdr, pkg, src_level);
 }
 
 void log_0(const char *str, struct log_msg_ids src_level)
@@ -306,6 +411,9 @@ void log_hexdump(const char *str, const void *data, uint32_t length,
 	if (IS_ENABLED(CONFIG_LOG_FRONTEND)) {
 		log_frontend_hexdump(str, (const uint8_t *)data, length,
 				     src_level);
+	} else if (IS_ENABLED(CONFIG_LOG_PACKAGED)) {
+		log_packaged_hexdump(str, (const uint8_t *)data, length,
+				     src_level);
 	} else {
 		struct log_msg *msg =
 			log_msg_hexdump_create(str, (const uint8_t *)data, length);
@@ -339,6 +447,8 @@ void log_printk(const char *fmt, va_list ap)
 		} else if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
 			log_generic(src_level_union.structure, fmt, ap,
 							LOG_STRDUP_SKIP);
+		} else if (IS_ENABLED(CONFIG_LOG_PACKAGED)) {
+			log_packaged_va(src_level_union.structure, fmt, ap);
 		} else {
 			uint8_t str[CONFIG_LOG_PRINTK_MAX_STRING_LENGTH + 1];
 			struct log_msg *msg;
@@ -402,6 +512,9 @@ void log_generic(struct log_msg_ids src_level, const char *fmt, va_list ap,
 				va_end(ap_tmp);
 			}
 		}
+	} else if (IS_ENABLED(CONFIG_LOG_PACKAGED)) {
+		/* Strings are copied into the package as needed. */
+		log_packaged_va(src_level, fmt, ap);
 	} else {
 		log_arg_t args[LOG_MAX_NARGS];
 		uint32_t nargs = log_count_args(fmt);
@@ -480,7 +593,9 @@ void log_core_init(void)
 {
 	uint32_t freq;
 
-	if (!IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
+	if (IS_ENABLED(CONFIG_LOG_PACKAGED)) {
+		log_pkg_init();
+	} else if (!IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
 		log_msg_pool_init();
 		log_list_init(&list);
 
@@ -622,25 +737,28 @@ void z_vrfy_log_panic(void)
 #include <syscalls/log_panic_mrsh.c>
 #endif
 
-static bool msg_filter_check(struct log_backend const *backend,
-			     struct log_msg *msg)
+static bool ids_filter_check(struct log_backend const *backend,
+			     struct log_msg_ids ids)
 {
 	if (IS_ENABLED(CONFIG_LOG_RUNTIME_FILTERING)) {
 		uint32_t backend_level;
-		uint32_t msg_level;
 
-		backend_level = log_filter_get(backend,
-					       log_msg_domain_id_get(msg),
-					       log_msg_source_id_get(msg),
+		backend_level = log_filter_get(backend, ids.domain_id,
+					       ids.source_id,
 					       true /*enum RUNTIME, COMPILETIME*/);
-		msg_level = log_msg_level_get(msg);
 
-		return (msg_level <= backend_level);
+		return (ids.level <= backend_level);
 	} else {
 		return true;
 	}
 }
 
+static bool msg_filter_check(struct log_backend const *backend,
+			     struct log_msg *msg)
+{
+	return ids_filter_check(backend, msg->hdr.ids);
+}
+
 static void msg_process(struct log_msg *msg, bool bypass)
 {
 	struct log_backend const *backend;
@@ -664,6 +782,26 @@ static void msg_process(struct log_msg *msg, bool bypass)
 	log_msg_put(msg);
 }
 
+static void pkg_process(struct log_pkg_hdr *hdr, const uint8_t *payload)
+{
+	const struct cbprintf_package_hdr *pkg =
+		(const struct cbprintf_package_hdr *)payload;
+	const uint8_t *data = hdr->hexdump ? &payload[pkg->len] : NULL;
+	uint32_t data_len = hdr->len - pkg->len;
+	struct log_backend const *backend;
+
+	for (int i = 0; i < log_backend_count_get(); i++) {
+		backend = log_backend_get(i);
+
+		if (log_backend_is_active(backend) &&
+		    ids_filter_check(backend, hdr->ids)) {
+			log_backend_put_package(backend, hdr->ids,
+						hdr->timestamp, payload,
+						data, data_len);
+		}
+	}
+}
+
 void dropped_notify(void)
 {
 	uint32_t dropped = atomic_set(&dropped_cnt, 0);
@@ -677,6 +815,38 @@ void dropped_notify(void)
 	}
 }
 
+static bool pkg_log_process(bool bypass)
+{
+	uint8_t payload[CONFIG_LOG_PACKAGE_MAX_SIZE] __aligned(sizeof(void *));
+	struct log_pkg_hdr hdr;
+	unsigned int key;
+	bool pending;
+	bool got;
+
+	if (IS_ENABLED(CONFIG_LOG_PER_CPU_BUFFERS)) {
+		got = log_pkg_get(&hdr, payload, sizeof(payload));
+		pending = !log_pkg_is_empty();
+	} else {
+		key = irq_lock();
+		got = log_pkg_get(&hdr, payload, sizeof(payload));
+		pending = !log_pkg_is_empty();
+		irq_unlock(key);
+	}
+
+	if (got) {
+		atomic_dec(&buffered_cnt);
+		if (!bypass) {
+			pkg_process(&hdr, payload);
+		}
+	}
+
+	if (!bypass && dropped_cnt) {
+		dropped_notify();
+	}
+
+	return pending;
+}
+
 bool z_impl_log_process(bool bypass)
 {
 	struct log_msg *msg;
@@ -684,6 +854,11 @@ bool z_impl_log_process(bool bypass)
 	if (!backend_attached && !bypass) {
 		return false;
 	}
+
+	if (IS_ENABLED(CONFIG_LOG_PACKAGED)) {
+		return pkg_log_process(bypass);
+	}
+
 	unsigned int key = irq_lock();
 
 	msg = log_list_head_get(&list);
@@ -887,6 +1062,7 @@ char *log_strdup(const char *str)
 	int err;
 
 	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE) ||
+	    IS_ENABLED(CONFIG_LOG_PACKAGED) ||
 	    is_rodata(str) || _is_user_context()) {
 		return (char *)str;
 	}
@@ -1005,6 +1181,9 @@ void z_vrfy_z_log_string_from_user(uint32_t src_level_val, const char *str)
 
 	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
 		log_string_sync(src_level_union.structure, "%s", str);
+	} else if (IS_ENABLED(CONFIG_LOG_PACKAGED)) {
+		/* String is copied into the package. */
+		log_packaged(src_level_union.structure, "%s", str);
 	} else if (IS_ENABLED(CONFIG_LOG_PRINTK) &&
 		   (level == LOG_LEVEL_INTERNAL_RAW_STRING)) {
 		struct log_msg *msg;
@@ -53,6 +53,10 @@ extern void log_output_string_syst_process(const struct log_output *log_output,
 extern void log_output_hexdump_syst_process(const struct log_output *log_output,
 				struct log_msg_ids src_level,
 				const uint8_t *data, uint32_t length, uint32_t flag);
+extern void log_output_dict_package_process(const struct log_output *log_output,
+				struct log_msg_ids src_level, uint32_t timestamp,
+				const void *package, const uint8_t *data,
+				uint32_t length);
 
 /* The RFC 5424 allows very flexible mapping and suggest the value 0 being the
  * highest severity and 7 to be the lowest (debugging level) severity.
@@ -636,6 +640,58 @@ void log_output_hexdump(const struct log_output *log_output,
 	log_output_flush(log_output);
 }
 
+void log_output_package(const struct log_output *log_output,
+			struct log_msg_ids src_level, uint32_t timestamp,
+			const void *package, const uint8_t *data,
+			uint32_t length, uint32_t flags)
+{
+	uint32_t prefix_offset = 0;
+	uint8_t level = (uint8_t)src_level.level;
+	uint8_t domain_id = (uint8_t)src_level.domain_id;
+	uint16_t source_id = (uint16_t)src_level.source_id;
+	bool raw_string = (level == LOG_LEVEL_INTERNAL_RAW_STRING);
+
+	if (IS_ENABLED(CONFIG_LOG_DICTIONARY) &&
+	    flags & LOG_OUTPUT_FLAG_FORMAT_DICTIONARY) {
+		log_output_dict_package_process(log_output, src_level,
+						timestamp, package, data,
+						length);
+		return;
+	}
+
+	if (!raw_string) {
+		prefix_offset = prefix_print(log_output, flags, data == NULL,
+					     timestamp, level, domain_id,
+					     source_id);
+	}
+
+	(void)cbpprintf(out_func, (void *)log_output, package);
+
+	while (length) {
+		uint32_t part_len = length > HEXDUMP_BYTES_IN_LINE ?
+				HEXDUMP_BYTES_IN_LINE : length;
+
+		hexdump_line_print(log_output, data, part_len,
+				   prefix_offset, flags);
+
+		data += part_len;
+		length -= part_len;
+	}
+
+	if (raw_string) {
+		/* add \r if string ends with newline. */
+		uint32_t offset = log_output->control_block->offset;
+
+		if (offset > 0 && log_output->buf[offset - 1] == '\n') {
+			print_formatted(log_output, "\r");
+		}
+	} else {
+		postfix_print(log_output, flags, level);
+	}
+
+	log_output_flush(log_output);
+}
+
 void log_output_dropped_process(const struct log_output *log_output, uint32_t cnt)
 {
 	char buf[5];
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log_output.h>
+#include <logging/log_output_dict.h>
+#include <logging/log_msg.h>
+#include <sys/cbprintf.h>
+
+static void dict_write(const struct log_output *log_output,
+		       const void *data, size_t len)
+{
+	uint8_t *buf = (uint8_t *)data;
+	int processed;
+
+	while (len != 0) {
+		processed = log_output->func(buf, len,
+					     log_output->control_block->ctx);
+		len -= processed;
+		buf += processed;
+	}
+}
+
+void log_output_dict_package_process(const struct log_output *log_output,
+				     struct log_msg_ids src_level,
+				     uint32_t timestamp, const void *package,
+				     const uint8_t *data, uint32_t length)
+{
+	const struct cbprintf_package_hdr *pkg = package;
+	struct log_dict_msg_hdr hdr = {
+		.type = (data != NULL) ?
+			LOG_DICT_MSG_TYPE_HEXDUMP : LOG_DICT_MSG_TYPE_STD,
+		.ids = LOG_DICT_MSG_IDS(src_level.level, src_level.domain_id),
+		.source_id = src_level.source_id,
+		.timestamp = timestamp,
+		.pkg_len = pkg->len,
+		.data_len = length,
+	};
+
+	dict_write(log_output, &hdr, sizeof(hdr));
+	dict_write(log_output, package, pkg->len);
+
+	if (length != 0) {
+		dict_write(log_output, data, length);
+	}
+}
+
+void log_output_dict_dropped_process(const struct log_output *log_output,
+				     uint32_t cnt)
+{
+	struct log_dict_dropped_hdr hdr = {
+		.type = LOG_DICT_MSG_TYPE_DROPPED,
+		.count = cnt,
+	};
+
+	dict_write(log_output, &hdr, sizeof(hdr));
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "log_pkg.h"
+#include <sys/ring_buffer.h>
+#include <sys/__assert.h>
+#include <errno.h>
+
+static uint8_t __noinit __aligned(sizeof(uint32_t))
+		log_pkg_buf[CONFIG_LOG_BUFFER_SIZE];
+static struct ring_buf log_pkg_ring;
+
+BUILD_ASSERT(sizeof(struct log_pkg_hdr) == 8,
+	     "Unexpected packaged message header size");
+
+void log_pkg_init(void)
+{
+	ring_buf_init(&log_pkg_ring, sizeof(log_pkg_buf), log_pkg_buf);
+}
+
+static void skip(uint32_t len)
+{
+	uint8_t *data;
+	uint32_t part;
+	int err;
+
+	while (len > 0) {
+		part = ring_buf_get_claim(&log_pkg_ring, &data, len);
+		err = ring_buf_get_finish(&log_pkg_ring, part);
+		__ASSERT_NO_MSG(err == 0);
+		len -= part;
+	}
+}
+
+static void drop_oldest(void)
+{
+	struct log_pkg_hdr hdr;
+
+	(void)ring_buf_get(&log_pkg_ring, (uint8_t *)&hdr, sizeof(hdr));
+	skip(hdr.len);
+}
+
+int log_pkg_put(const struct log_pkg_hdr *hdr, const void *payload,
+		bool overwrite, uint32_t *dropped)
+{
+	uint32_t size = sizeof(*hdr) + hdr->len;
+
+	*dropped = 0;
+
+	if (size > ring_buf_capacity_get(&log_pkg_ring)) {
+		return -ENOMEM;
+	}
+
+	while (overwrite && (ring_buf_space_get(&log_pkg_ring) < size)) {
+		drop_oldest();
+		(*dropped)++;
+	}
+
+	if (ring_buf_space_get(&log_pkg_ring) < size) {
+		return -ENOMEM;
+	}
+
+	(void)ring_buf_put(&log_pkg_ring, (const uint8_t *)hdr, sizeof(*hdr));
+	(void)ring_buf_put(&log_pkg_ring, payload, hdr->len);
+
+	return 0;
+}
+
+bool log_pkg_get(struct log_pkg_hdr *hdr, void *payload, size_t len)
+{
+	uint32_t copied;
+
+	if (ring_buf_is_empty(&log_pkg_ring)) {
+		return false;
+	}
+
+	(void)ring_buf_get(&log_pkg_ring, (uint8_t *)hdr, sizeof(*hdr));
+
+	__ASSERT_NO_MSG(hdr->len <= len);
+	copied = ring_buf_get(&log_pkg_ring, payload, MIN(hdr->len, len));
+	skip(hdr->len - copied);
+
+	return true;
+}
+
+bool log_pkg_is_empty(void)
+{
+	return ring_buf_is_empty(&log_pkg_ring);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef LOG_PKG_H_
+#define LOG_PKG_H_
+
+#include <logging/log_msg.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Header of a packaged log message.
+ *
+ * The header is followed by a cbprintf package and, for hexdump messages,
+ * by the data.
+ */
+struct log_pkg_hdr {
+	struct log_msg_ids ids;    /*!< Source and level. */
+	uint16_t hexdump : 1;      /*!< Data follows the package. */
+	uint16_t len     : 15;     /*!< Length of the payload. */
+	uint32_t timestamp;        /*!< Timestamp. */
+};
+
+/** @brief Initialize the packaged message buffer. */
+void log_pkg_init(void);
+
+/** @brief Store a message in the buffer.
+ *
+ * Must be called with interrupts locked, unless
+ * CONFIG_LOG_PER_CPU_BUFFERS is enabled.
+ *
+ * @param hdr       Message header.
+ * @param payload   Message payload of hdr->len bytes.
+ * @param overwrite If true the oldest messages are dropped when there is not
+ *		    enough space.
+ * @param dropped   Location for the number of messages dropped to make
+ *		    room, set also when the message is not stored.
+ *
+ * @return 0 on success, or -ENOMEM if the message was not stored.
+ */
+int log_pkg_put(const struct log_pkg_hdr *hdr, const void *payload,
+		bool overwrite, uint32_t *dropped);
+
+/** @brief Remove the oldest message from the buffer.
+ *
+ * With CONFIG_LOG_PER_CPU_BUFFERS the message with the oldest timestamp
+ * among the heads of the CPU buffers is removed, without locking.
+ * Otherwise it must be called with interrupts locked.
+ *
+ * @param hdr     Location for the message header.
+ * @param payload Location for the message payload.
+ * @param len     Size of the payload location.
+ *
+ * @return True if a message was removed.
+ */
+bool log_pkg_get(struct log_pkg_hdr *hdr, void *payload, size_t len);
+
+/** @brief Check if the buffer is empty.
+ *
+ * @return True if there are no messages in the buffer.
+ */
+bool log_pkg_is_empty(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOG_PKG_H_ */
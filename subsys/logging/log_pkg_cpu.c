@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Packaged message buffers, one lock-free ring per CPU. Each entry holds
+ * the message header followed by the payload. Processing merges the rings
+ * by taking the committed head with the oldest timestamp.
+ */
+
+#include "log_pkg.h"
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <sys/mpsc_ring.h>
+#include <sys/__assert.h>
+
+#define BUF_SIZE CONFIG_LOG_PER_CPU_BUFFER_SIZE
+
+BUILD_ASSERT((BUF_SIZE & (BUF_SIZE - 1)) == 0,
+	     "Per CPU log buffer size must be a power of two");
+
+static uint8_t __aligned(sizeof(uint32_t))
+		cpu_bufs[CONFIG_MP_NUM_CPUS][BUF_SIZE];
+static struct mpsc_ring cpu_rings[CONFIG_MP_NUM_CPUS];
+
+void log_pkg_init(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(cpu_rings); i++) {
+		mpsc_ring_init(&cpu_rings[i], cpu_bufs[i], BUF_SIZE);
+	}
+}
+
+static inline struct mpsc_ring *curr_ring(void)
+{
+#ifdef CONFIG_SMP
+	/* The context may migrate after reading the ID, which is harmless
+	 * since the rings accept producers from any CPU.
+	 */
+	return &cpu_rings[arch_curr_cpu()->id];
+#else
+	return &cpu_rings[0];
+#endif
+}
+
+int log_pkg_put(const struct log_pkg_hdr *hdr, const void *payload,
+		bool overwrite, uint32_t *dropped)
+{
+	struct mpsc_ring *ring = curr_ring();
+	struct mpsc_ring_entry entry;
+	int err;
+
+	err = mpsc_ring_claim(ring, sizeof(*hdr) + hdr->len, overwrite,
+			      dropped, &entry);
+	if (err < 0) {
+		return err;
+	}
+
+	mpsc_ring_write(ring, &entry, 0, hdr, sizeof(*hdr));
+	mpsc_ring_write(ring, &entry, sizeof(*hdr), payload, hdr->len);
+	mpsc_ring_commit(ring, &entry);
+
+	return 0;
+}
+
+static bool ts_before(uint32_t a, uint32_t b)
+{
+	return (int32_t)(a - b) < 0;
+}
+
+bool log_pkg_get(struct log_pkg_hdr *hdr, void *payload, size_t len)
+{
+	struct mpsc_ring_entry entry;
+	struct log_pkg_hdr head;
+	struct mpsc_ring *oldest;
+
+	for (;;) {
+		oldest = NULL;
+
+		/* Merge the rings, taking the oldest head first. */
+		for (int i = 0; i < ARRAY_SIZE(cpu_rings); i++) {
+			if (!mpsc_ring_peek(&cpu_rings[i], &entry)) {
+				continue;
+			}
+
+			mpsc_ring_read(&cpu_rings[i], &entry, 0, &head,
+				       sizeof(head));
+
+			if (oldest == NULL ||
+			    ts_before(head.timestamp, hdr->timestamp)) {
+				oldest = &cpu_rings[i];
+				*hdr = head;
+			}
+		}
+
+		if (oldest == NULL) {
+			return false;
+		}
+
+		/* The head may have been dropped since it was peeked. The copy
+		 * is only valid if it can be consumed afterwards.
+		 */
+		if (!mpsc_ring_peek(oldest, &entry)) {
+			continue;
+		}
+
+		mpsc_ring_read(oldest, &entry, 0, hdr, sizeof(*hdr));
+		mpsc_ring_read(oldest, &entry, sizeof(*hdr), payload,
+			       MIN(hdr->len, len));
+
+		if (mpsc_ring_consume(oldest, &entry)) {
+			break;
+		}
+	}
+
+	__ASSERT_NO_MSG(hdr->len <= len);
+
+	return true;
+}
+
+bool log_pkg_is_empty(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(cpu_rings); i++) {
+		if (!mpsc_ring_is_empty(&cpu_rings[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -1215,7 +1215,8 @@ static int get_context_txtime(struct net_context *context,
 }
 
 /* If buf is not NULL, then use it. Otherwise read the data to be written
- * to net_pkt from msghdr.
+ * to net_pkt from msghdr. At most buf_len bytes are written, as the caller
+ * may have trimmed the length to the space available in the packet.
  */
 static int context_write_data(struct net_pkt *pkt, const void *buf,
 			      int buf_len, const struct msghdr *msghdr)
@@ -1225,12 +1226,16 @@ static int context_write_data(struct net_pkt *pkt, const void *buf,
 	if (msghdr) {
 		int i;
 
-		for (i = 0; i < msghdr->msg_iovlen; i++) {
+		for (i = 0; i < msghdr->msg_iovlen && buf_len > 0; i++) {
+			int len = MIN(msghdr->msg_iov[i].iov_len, buf_len);
+
 			ret = net_pkt_write(pkt, msghdr->msg_iov[i].iov_base,
-					    msghdr->msg_iov[i].iov_len);
+					    len);
 			if (ret < 0) {
 				break;
 			}
+
+			buf_len -= len;
 		}
 	} else {
 		ret = net_pkt_write(pkt, buf, buf_len);
@@ -25,8 +25,10 @@ LOG_MODULE_REGISTER(net_http, CONFIG_NET_HTTP_LOG_LEVEL);
 #include <net/http_client.h>
 
 #include "net_private.h"
+#include "http_client_internal.h"
 
 #define HTTP_CONTENT_LEN_SIZE 6
+#define HTTP_CHUNK_HDR_SIZE 11
 #define MAX_SEND_BUF_LEN 192
 
 static ssize_t sendall(int sock, const void *buf, size_t len)
@@ -45,6 +47,37 @@ static ssize_t sendall(int sock, const void *buf, size_t len)
 	return 0;
 }
 
+static int sendmsg_all(int sock, struct iovec *iov, size_t iovlen)
+{
+	struct msghdr msg = {
+		.msg_iov = iov,
+		.msg_iovlen = iovlen,
+	};
+	ssize_t out_len;
+
+	while (msg.msg_iovlen > 0) {
+		out_len = sendmsg(sock, &msg, 0);
+		if (out_len < 0) {
+			return -errno;
+		}
+
+		/* Skip what was sent, including any empty vectors */
+		while (msg.msg_iovlen > 0 && out_len >= msg.msg_iov->iov_len) {
+			out_len -= msg.msg_iov->iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		}
+
+		if (out_len > 0) {
+			msg.msg_iov->iov_base =
+				(uint8_t *)msg.msg_iov->iov_base + out_len;
+			msg.msg_iov->iov_len -= out_len;
+		}
+	}
+
+	return 0;
+}
+
 static int http_send_data(int sock, char *send_buf,
 			  size_t send_buf_max_len, size_t *send_buf_pos,
 			  ...)
@@ -125,6 +158,54 @@ static int http_flush_data(int sock, const char *send_buf, size_t send_buf_len)
 	return sendall(sock, send_buf, send_buf_len);
 }
 
+/* Send the payload provided by the chunk callback with chunked transfer
+ * encoding. Any buffered header data is sent together with the first chunk.
+ * Each chunk is sent in one call with its framing, straight from the
+ * callback's buffer. The zero-length last chunk terminates the payload.
+ */
+static int http_send_chunks(int sock, struct http_request *req,
+			    const char *send_buf, size_t send_buf_pos,
+			    void *user_data)
+{
+	char chunk_hdr[HTTP_CHUNK_HDR_SIZE];
+	struct iovec iov[4];
+	const uint8_t *data;
+	int total_sent = 0;
+	int len, ret;
+
+	do {
+		data = NULL;
+
+		len = req->payload_chunk_cb(sock, req, &data, user_data);
+		if (len < 0) {
+			return len;
+		}
+
+		ret = snprintk(chunk_hdr, sizeof(chunk_hdr), "%x" HTTP_CRLF,
+			       len);
+
+		iov[0].iov_base = (void *)send_buf;
+		iov[0].iov_len = send_buf_pos;
+		iov[1].iov_base = chunk_hdr;
+		iov[1].iov_len = ret;
+		iov[2].iov_base = (void *)data;
+		iov[2].iov_len = len;
+		iov[3].iov_base = HTTP_CRLF;
+		iov[3].iov_len = sizeof(HTTP_CRLF) - 1;
+
+		ret = sendmsg_all(sock, iov, ARRAY_SIZE(iov));
+		if (ret < 0) {
+			NET_DBG("Cannot send chunk of %d bytes (%d)", len, ret);
+			return ret;
+		}
+
+		send_buf_pos = 0;
+		total_sent += len;
+	} while (len > 0);
+
+	return total_sent;
+}
+
 static void print_header_field(size_t len, const char *str)
 {
 	if (IS_ENABLED(CONFIG_NET_HTTP_LOG_LEVEL_DBG)) {
@@ -352,6 +433,11 @@ static int on_message_complete(struct http_parser *parser)
 
 	req->internal.response.message_complete = 1;
 
+	/* Stop parsing here, any following data belongs to the next
+	 * response on the same connection.
+	 */
+	http_parser_pause(parser, 1);
+
 	if (req->internal.response.cb) {
 		req->internal.response.cb(&req->internal.response,
 					  HTTP_DATA_FINAL,
@@ -406,19 +492,54 @@ static void http_client_init_parser(struct http_parser *parser,
 	settings->on_url = on_url;
 }
 
-static int http_wait_data(int sock, struct http_request *req)
+static int http_wait_data(int sock, struct http_request *req, size_t pending,
+			  uint8_t **extra, size_t *extra_len, int64_t deadline)
 {
 	int total_received = 0;
 	size_t offset = 0;
+	size_t parsed = 0;
 	int received, ret;
 
 	do {
-		received = recv(sock, req->internal.response.recv_buf + offset,
-				req->internal.response.recv_buf_len - offset,
-				0);
+		if (pending > 0) {
+			/* Data of this response that was received together
+			 * with the previous response.
+			 */
+			received = pending;
+			pending = 0;
+		} else {
+			if (deadline > 0) {
+				struct zsock_pollfd fds = {
+					.fd = sock,
+					.events = ZSOCK_POLLIN,
+				};
+				int64_t remaining = deadline - k_uptime_get();
+
+				if (remaining <= 0 ||
+				    zsock_poll(&fds, 1, (int)remaining) == 0) {
+					LOG_DBG("Receive timeout");
+					ret = -ETIMEDOUT;
+					break;
+				}
+			}
+
+			received = recv(sock,
+					req->internal.response.recv_buf + offset,
+					req->internal.response.recv_buf_len -
+									offset,
+					0);
+		}
+
 		if (received == 0) {
 			/* Connection closed */
 			LOG_DBG("Connection closed");
+
+			/* Let the parser know, the end of connection may also
+			 * mark the end of the body.
+			 */
+			(void)http_parser_execute(&req->internal.parser,
+						  &req->internal.parser_settings,
+						  NULL, 0);
 			ret = total_received;
 			break;
 		} else if (received < 0) {
@@ -429,7 +550,7 @@ static int http_wait_data(int sock, struct http_request *req)
 		} else {
 			req->internal.response.data_len += received;
 
-			(void)http_parser_execute(
+			parsed = http_parser_execute(
 				&req->internal.parser,
 				&req->internal.parser_settings,
 				req->internal.response.recv_buf + offset,
@@ -437,17 +558,31 @@ static int http_wait_data(int sock, struct http_request *req)
 		}
 
 		total_received += received;
-		offset += received;
-
-		if (offset >= req->internal.response.recv_buf_len) {
-			offset = 0;
-		}
 
 		if (req->internal.response.message_complete) {
+			if (extra != NULL) {
+				*extra = req->internal.response.recv_buf +
+					 offset + parsed;
+				*extra_len = received - parsed;
+			}
+
 			ret = total_received;
 			break;
 		}
 
+		if (HTTP_PARSER_ERRNO(&req->internal.parser) != HPE_OK) {
+			LOG_DBG("Parse error (%s)",
+				http_errno_name(HTTP_PARSER_ERRNO(
+						&req->internal.parser)));
+			ret = -EBADMSG;
+			break;
+		}
+
+		offset += received;
+
+		if (offset >= req->internal.response.recv_buf_len) {
+			offset = 0;
+		}
 	} while (true);
 
 	return ret;
@@ -461,15 +596,15 @@ static void http_timeout(struct k_work *work)
 	(void)close(data->sock);
 }
 
-int http_client_req(int sock, struct http_request *req,
-		    int32_t timeout, void *user_data)
+int http_client_send(int sock, struct http_request *req,
+		     int32_t timeout, void *user_data)
 {
 	/* Utilize the network usage by sending data in bigger blocks */
 	char send_buf[MAX_SEND_BUF_LEN];
 	const size_t send_buf_max_len = sizeof(send_buf);
 	size_t send_buf_pos = 0;
 	int total_sent = 0;
-	int ret, total_recv, i;
+	int ret, i;
 	const char *method;
 
 	if (sock < 0 || req == NULL || req->response == NULL ||
@@ -571,7 +706,25 @@ int http_client_req(int sock, struct http_request *req,
 		total_sent += ret;
 	}
 
-	if (req->payload || req->payload_cb) {
+	if (req->payload_chunk_cb) {
+		ret = http_send_data(sock, send_buf, send_buf_max_len,
+				     &send_buf_pos, "Transfer-Encoding", ": ",
+				     "chunked", HTTP_CRLF, HTTP_CRLF, NULL);
+		if (ret < 0) {
+			goto out;
+		}
+
+		total_sent += ret;
+
+		ret = http_send_chunks(sock, req, send_buf, send_buf_pos,
+				       user_data);
+		if (ret < 0) {
+			goto out;
+		}
+
+		send_buf_pos = 0;
+		total_sent += ret;
+	} else if (req->payload || req->payload_cb) {
 		if (req->payload_len) {
 			char content_len_str[HTTP_CONTENT_LEN_SIZE];
 
@@ -650,28 +803,59 @@ int http_client_req(int sock, struct http_request *req,
 	http_client_init_parser(&req->internal.parser,
 				&req->internal.parser_settings);
 
-	if (!K_TIMEOUT_EQ(req->internal.timeout, K_FOREVER) &&
-	    !K_TIMEOUT_EQ(req->internal.timeout, K_NO_WAIT)) {
+	return total_sent;
+
+out:
+	return ret;
+}
+
+int http_client_recv(int sock, struct http_request *req, size_t pending,
+		     uint8_t **extra, size_t *extra_len, bool pooled)
+{
+	bool timed = !K_TIMEOUT_EQ(req->internal.timeout, K_FOREVER) &&
+		     !K_TIMEOUT_EQ(req->internal.timeout, K_NO_WAIT);
+	int64_t deadline = 0;
+	int total_recv;
+
+	if (timed && pooled) {
+		/* The pool closes the socket of a failed connection itself,
+		 * so wait with a deadline instead of closing it on timeout.
+		 */
+		deadline = k_uptime_get() +
+			   k_ticks_to_ms_ceil64(req->internal.timeout.ticks);
+	} else if (timed) {
 		k_delayed_work_init(&req->internal.work, http_timeout);
 		(void)k_delayed_work_submit(&req->internal.work,
 					    req->internal.timeout);
 	}
 
 	/* Request is sent, now wait data to be received */
-	total_recv = http_wait_data(sock, req);
+	total_recv = http_wait_data(sock, req, pending, extra, extra_len,
+				    deadline);
 	if (total_recv < 0) {
 		NET_DBG("Wait data failure (%d)", total_recv);
 	} else {
 		NET_DBG("Received %d bytes", total_recv);
 	}
 
-	if (!K_TIMEOUT_EQ(req->internal.timeout, K_FOREVER) &&
-	    !K_TIMEOUT_EQ(req->internal.timeout, K_NO_WAIT)) {
+	if (timed && !pooled) {
 		(void)k_delayed_work_cancel(&req->internal.work);
 	}
 
-	return total_sent;
+	return total_recv;
+}
 
-out:
-	return ret;
+int http_client_req(int sock, struct http_request *req,
+		    int32_t timeout, void *user_data)
+{
+	int total_sent;
+
+	total_sent = http_client_send(sock, req, timeout, user_data);
+	if (total_sent < 0) {
+		return total_sent;
+	}
+
+	(void)http_client_recv(sock, req, 0, NULL, NULL, false);
+
+	return total_sent;
 }
@@ -0,0 +1,46 @@
+/** @file
+ @brief HTTP client private header
+
+ This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __HTTP_CLIENT_INTERNAL_H__
+#define __HTTP_CLIENT_INTERNAL_H__
+
+#include <net/http_client.h>
+
+/**
+ * @brief Send a HTTP request, without waiting for the response.
+ *
+ * @return <0 if error, >=0 amount of data sent to the server
+ */
+int http_client_send(int sock, struct http_request *req,
+		     int32_t timeout, void *user_data);
+
+/**
+ * @brief Receive the response to a HTTP request sent with
+ * http_client_send().
+ *
+ * @param sock Socket id of the connection.
+ * @param req HTTP request information.
+ * @param pending Amount of response data already placed at the start of
+ *        the receive buffer of the request.
+ * @param extra If not NULL, set to point to any data received past the end
+ *        of the response, i.e. the start of the next response.
+ * @param extra_len Length of the data pointed to by extra.
+ * @param pooled True if the socket is owned by the connection pool. On
+ *        timeout, the socket is then left open and -ETIMEDOUT is returned,
+ *        instead of closing the socket.
+ *
+ * @return <0 if error, >=0 amount of data received
+ */
+int http_client_recv(int sock, struct http_request *req, size_t pending,
+		     uint8_t **extra, size_t *extra_len, bool pooled);
+
+#endif /* __HTTP_CLIENT_INTERNAL_H__ */
@@ -0,0 +1,435 @@
+/** @file
+ * @brief HTTP client connection pool
+ *
+ * Keep-alive connections that are shared between HTTP requests to the same
+ * server, with optional request pipelining.
+ */
+
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_http, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <net/net_ip.h>
+#include <net/socket.h>
+#include <net/http_client.h>
+
+#include "net_private.h"
+#include "http_client_internal.h"
+
+struct http_client_conn {
+	/** Hostname of the endpoint */
+	char host[CONFIG_HTTP_CLIENT_POOL_HOST_LEN];
+
+	/** Uptime when the connection was last released */
+	int64_t last_used;
+
+	/** Socket of the connection, valid if the connection is open */
+	int sock;
+
+	/** Port of the endpoint, in network byte order */
+	uint16_t port;
+
+	/** Is the connection secured with TLS */
+	bool tls;
+
+	/** Is the socket connected */
+	bool open;
+
+	/** Is the slot in use by a request */
+	bool busy;
+};
+
+static struct http_client_conn conns[CONFIG_HTTP_CLIENT_POOL_SIZE];
+static K_MUTEX_DEFINE(conns_lock);
+
+static uint16_t endpoint_port(const struct http_client_endpoint *ep)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV6) && ep->addr->sa_family == AF_INET6) {
+		return net_sin6(ep->addr)->sin6_port;
+	}
+
+	return net_sin(ep->addr)->sin_port;
+}
+
+static bool conn_matches(struct http_client_conn *conn,
+			 const struct http_client_endpoint *ep)
+{
+	return conn->tls == ep->tls && conn->port == endpoint_port(ep) &&
+	       strcmp(conn->host, ep->host) == 0;
+}
+
+/* Must be called with conns_lock held, or by the owner of a busy slot */
+static void conn_close(struct http_client_conn *conn)
+{
+	if (conn->open) {
+		NET_DBG("[%p] Closing connection to %s", conn,
+			log_strdup(conn->host));
+
+		(void)close(conn->sock);
+		conn->open = false;
+	}
+}
+
+static int conn_tls_setup(int sock, const struct http_client_endpoint *ep)
+{
+#if defined(CONFIG_NET_SOCKETS_SOCKOPT_TLS)
+	int cache = TLS_SESSION_CACHE_ENABLED;
+	int ret;
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, ep->sec_tag_list,
+			 ep->sec_tag_count * sizeof(sec_tag_t));
+	if (ret < 0) {
+		return -errno;
+	}
+
+	ret = setsockopt(sock, SOL_TLS, TLS_HOSTNAME, ep->host,
+			 strlen(ep->host));
+	if (ret < 0) {
+		return -errno;
+	}
+
+	/* New connections to the same server can then resume the TLS session
+	 * instead of doing a full handshake. Not supported in all builds, so
+	 * the result is ignored.
+	 */
+	(void)setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache,
+			 sizeof(cache));
+
+	return 0;
+#else
+	return -EPROTONOSUPPORT;
+#endif
+}
+
+static int conn_connect(struct http_client_conn *conn,
+			const struct http_client_endpoint *ep)
+{
+	int sock, ret;
+
+	sock = socket(ep->addr->sa_family, SOCK_STREAM,
+		      ep->tls ? IPPROTO_TLS_1_2 : IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (ep->tls) {
+		ret = conn_tls_setup(sock, ep);
+		if (ret < 0) {
+			goto fail;
+		}
+	}
+
+	if (connect(sock, ep->addr, ep->addrlen) < 0) {
+		ret = -errno;
+		goto fail;
+	}
+
+	conn->sock = sock;
+	conn->open = true;
+
+	NET_DBG("[%p] New connection to %s", conn, log_strdup(conn->host));
+
+	return 0;
+
+fail:
+	(void)close(sock);
+
+	return ret;
+}
+
+/* Get a connection to the endpoint. Returns 1 if an idle connection was
+ * reused, 0 if a new connection was established.
+ */
+static int conn_acquire(const struct http_client_endpoint *ep, bool reuse,
+			struct http_client_conn **conn_out)
+{
+	struct http_client_conn *conn = NULL;
+	struct http_client_conn *free_slot = NULL;
+	struct http_client_conn *lru = NULL;
+	int64_t now = k_uptime_get();
+	int i, ret;
+
+	k_mutex_lock(&conns_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(conns); i++) {
+		struct http_client_conn *c = &conns[i];
+
+		if (c->busy) {
+			continue;
+		}
+
+		if (c->open &&
+		    now - c->last_used > CONFIG_HTTP_CLIENT_POOL_IDLE_TIMEOUT) {
+			conn_close(c);
+		}
+
+		if (!c->open) {
+			if (free_slot == NULL) {
+				free_slot = c;
+			}
+
+			continue;
+		}
+
+		if (reuse && conn == NULL && conn_matches(c, ep)) {
+			conn = c;
+		}
+
+		if (lru == NULL || c->last_used < lru->last_used) {
+			lru = c;
+		}
+	}
+
+	if (conn != NULL) {
+		conn->busy = true;
+		k_mutex_unlock(&conns_lock);
+
+		NET_DBG("[%p] Reusing connection to %s", conn,
+			log_strdup(conn->host));
+
+		*conn_out = conn;
+		return 1;
+	}
+
+	if (free_slot == NULL && lru != NULL) {
+		/* Make room by dropping the least recently used idle
+		 * connection.
+		 */
+		conn_close(lru);
+		free_slot = lru;
+	}
+
+	if (free_slot == NULL) {
+		k_mutex_unlock(&conns_lock);
+		return -ENOMEM;
+	}
+
+	conn = free_slot;
+	conn->busy = true;
+	conn->tls = ep->tls;
+	conn->port = endpoint_port(ep);
+	strcpy(conn->host, ep->host);
+
+	k_mutex_unlock(&conns_lock);
+
+	/* Connecting is done without holding the lock, the slot is reserved
+	 * by the busy flag.
+	 */
+	ret = conn_connect(conn, ep);
+	if (ret < 0) {
+		k_mutex_lock(&conns_lock, K_FOREVER);
+		conn->busy = false;
+		k_mutex_unlock(&conns_lock);
+
+		return ret;
+	}
+
+	*conn_out = conn;
+	return 0;
+}
+
+static void conn_release(struct http_client_conn *conn, bool keep)
+{
+	k_mutex_lock(&conns_lock, K_FOREVER);
+
+	if (keep) {
+		conn->last_used = k_uptime_get();
+	} else {
+		conn_close(conn);
+	}
+
+	conn->busy = false;
+
+	k_mutex_unlock(&conns_lock);
+}
+
+/* Send the requests back to back on the connection and receive the
+ * responses. Returns the number of completed requests, or a negative error
+ * if none was completed.
+ */
+static int pool_run(struct http_client_conn *conn, struct http_request **reqs,
+		    size_t count, int32_t timeout, void *user_data,
+		    int *total_sent)
+{
+	uint8_t *extra = NULL;
+	size_t extra_len = 0;
+	size_t sent, done;
+	bool keep = false;
+	int ret = 0;
+
+	*total_sent = 0;
+
+	for (sent = 0; sent < count; sent++) {
+		ret = http_client_send(conn->sock, reqs[sent], timeout,
+				       user_data);
+		if (ret < 0) {
+			break;
+		}
+
+		*total_sent += ret;
+	}
+
+	for (done = 0; done < sent; done++) {
+		struct http_request *req = reqs[done];
+		size_t pending = extra_len;
+
+		/* Start of this response may have been received together
+		 * with the previous one.
+		 */
+		if (pending > req->recv_buf_len) {
+			ret = -EMSGSIZE;
+			break;
+		}
+
+		if (pending > 0) {
+			memmove(req->recv_buf, extra, pending);
+		}
+
+		extra_len = 0;
+
+		ret = http_client_recv(conn->sock, req, pending, &extra,
+				       &extra_len, true);
+		if (ret < 0) {
+			break;
+		}
+
+		if (!req->internal.response.message_complete) {
+			ret = -ECONNRESET;
+			break;
+		}
+
+		keep = http_should_keep_alive(&req->internal.parser);
+		if (!keep) {
+			done++;
+			break;
+		}
+	}
+
+	conn_release(conn, keep && done == count && extra_len == 0);
+
+	if (done == 0 && ret < 0) {
+		return ret;
+	}
+
+	return done;
+}
+
+/* Requests with payload callbacks cannot be sent again transparently, as
+ * the callbacks may not be able to provide the same data twice.
+ */
+static bool reqs_can_retry(struct http_request **reqs, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		if (reqs[i]->payload_cb || reqs[i]->payload_chunk_cb) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int pool_req(const struct http_client_endpoint *ep,
+		    struct http_request **reqs, size_t count,
+		    int32_t timeout, void *user_data, int *total_sent)
+{
+	struct http_client_conn *conn;
+	int reused, ret;
+
+	if (ep == NULL || ep->addr == NULL || ep->host == NULL ||
+	    reqs == NULL) {
+		return -EINVAL;
+	}
+
+	if (strlen(ep->host) >= CONFIG_HTTP_CLIENT_POOL_HOST_LEN) {
+		return -ENAMETOOLONG;
+	}
+
+	reused = conn_acquire(ep, true, &conn);
+	if (reused < 0) {
+		return reused;
+	}
+
+	ret = pool_run(conn, reqs, count, timeout, user_data, total_sent);
+
+	/* The server may have closed an idle connection just before it
+	 * was reused. If not even a status line was received, send the
+	 * requests again on a new connection.
+	 */
+	if (ret <= 0 && reused &&
+	    reqs[0]->internal.response.http_status[0] == '\0' &&
+	    reqs_can_retry(reqs, count)) {
+		NET_DBG("Reused connection failed (%d), retrying", ret);
+
+		ret = conn_acquire(ep, false, &conn);
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = pool_run(conn, reqs, count, timeout, user_data,
+			       total_sent);
+	}
+
+	return ret;
+}
+
+int http_client_pool_req(const struct http_client_endpoint *ep,
+			 struct http_request *req,
+			 int32_t timeout, void *user_data)
+{
+	int total_sent, ret;
+
+	if (req == NULL) {
+		return -EINVAL;
+	}
+
+	ret = pool_req(ep, &req, 1, timeout, user_data, &total_sent);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (ret == 0) {
+		return -ECONNRESET;
+	}
+
+	return total_sent;
+}
+
+int http_client_pool_pipeline(const struct http_client_endpoint *ep,
+			      struct http_request **reqs, size_t count,
+			      int32_t timeout, void *user_data)
+{
+	int total_sent;
+
+	if (count == 0) {
+		return 0;
+	}
+
+	return pool_req(ep, reqs, count, timeout, user_data, &total_sent);
+}
+
+void http_client_pool_flush(void)
+{
+	int i;
+
+	k_mutex_lock(&conns_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(conns); i++) {
+		if (!conns[i].busy) {
+			conn_close(&conns[i]);
+		}
+	}
+
+	k_mutex_unlock(&conns_lock);
+}
@@ -4509,6 +4509,19 @@ int lwm2m_socket_start(struct lwm2m_ctx *client_ctx)
 			lwm2m_engine_context_close(client_ctx);
 			return -errno;
 		}
+
+#if defined(CONFIG_LWM2M_DTLS_CID)
+		int cid = TLS_DTLS_CID_SUPPORTED;
+
+		ret = setsockopt(client_ctx->sock_fd, SOL_TLS, TLS_DTLS_CID,
+				 &cid, sizeof(cid));
+		if (ret < 0) {
+			LOG_ERR("Failed to set TLS_DTLS_CID option: %d",
+				errno);
+			lwm2m_engine_context_close(client_ctx);
+			return -errno;
+		}
+#endif /* CONFIG_LWM2M_DTLS_CID */
 	}
 #endif /* CONFIG_LWM2M_DTLS_SUPPORT */
 
@@ -25,8 +25,69 @@ static void client_reset(struct mqtt_client *client)
 	client->internal.last_activity = 0U;
 	client->internal.rx_buf_datalen = 0U;
 	client->internal.remaining_payload = 0U;
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW)
+	client->internal.inflight_count = 0U;
+#endif
 }
 
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW)
+static int inflight_find(struct mqtt_client *client, uint16_t message_id)
+{
+	int i;
+
+	for (i = 0; i < client->internal.inflight_count; i++) {
+		if (client->internal.inflight[i] == message_id) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static int inflight_acquire(struct mqtt_client *client,
+			    const struct mqtt_publish_param *param)
+{
+	if (param->message.topic.qos == MQTT_QOS_0_AT_MOST_ONCE) {
+		return 0;
+	}
+
+	/* Retransmission of a message already in flight. */
+	if (inflight_find(client, param->message_id) >= 0) {
+		return param->dup_flag ? 0 : -EINVAL;
+	}
+
+	if (client->internal.inflight_count >=
+	    ARRAY_SIZE(client->internal.inflight)) {
+		return -EBUSY;
+	}
+
+	client->internal.inflight[client->internal.inflight_count++] =
+		param->message_id;
+
+	return 0;
+}
+
+void mqtt_inflight_release(struct mqtt_client *client, uint16_t message_id)
+{
+	int i = inflight_find(client, message_id);
+
+	if (i < 0) {
+		return;
+	}
+
+	/* Order of messages in flight is irrelevant, move the last one. */
+	client->internal.inflight_count--;
+	client->internal.inflight[i] =
+		client->internal.inflight[client->internal.inflight_count];
+}
+#else
+static int inflight_acquire(struct mqtt_client *client,
+			    const struct mqtt_publish_param *param)
+{
+	return 0;
+}
+#endif /* CONFIG_MQTT_INFLIGHT_WINDOW */
+
 /** @brief Initialize tx buffer. */
 static void tx_buf_init(struct mqtt_client *client, struct buf_ctx *buf)
 {
@@ -266,6 +327,14 @@ int mqtt_publish(struct mqtt_client *client,
 		goto error;
 	}
 
+	err_code = inflight_acquire(client, param);
+	if (err_code < 0) {
+		goto error;
+	}
+
+	/* Header is encoded in the TX buffer, payload is sent directly from
+	 * the application buffer.
+	 */
 	io_vector[0].iov_base = packet.cur;
 	io_vector[0].iov_len = packet.end - packet.cur;
 	io_vector[1].iov_base = param->message.payload.data;
@@ -277,6 +346,11 @@ int mqtt_publish(struct mqtt_client *client,
 	msg.msg_iovlen = ARRAY_SIZE(io_vector);
 
 	err_code = client_write_msg(client, &msg);
+	if (err_code < 0 &&
+	    param->message.topic.qos != MQTT_QOS_0_AT_MOST_ONCE) {
+		/* Message was not sent, it is no longer in flight. */
+		mqtt_inflight_release(client, param->message_id);
+	}
 
 error:
 	MQTT_TRC("[CID %p]:[State 0x%02x]: << result 0x%08x",
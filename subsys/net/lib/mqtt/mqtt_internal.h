@@ -154,6 +154,24 @@ enum mqtt_state {
  */
 void event_notify(struct mqtt_client *client, const struct mqtt_evt *evt);
 
+#if defined(CONFIG_MQTT_INFLIGHT_WINDOW)
+/**@brief Releases the in-flight window slot of an acknowledged publish
+ *        message.
+ *
+ * @param[in] client Identifies the client for which the message was
+ *                   acknowledged.
+ * @param[in] message_id Message id of the acknowledged message.
+ */
+void mqtt_inflight_release(struct mqtt_client *client, uint16_t message_id);
+#else
+static inline void mqtt_inflight_release(struct mqtt_client *client,
+					 uint16_t message_id)
+{
+	ARG_UNUSED(client);
+	ARG_UNUSED(message_id);
+}
+#endif /* CONFIG_MQTT_INFLIGHT_WINDOW */
+
 /**@brief Handles MQTT messages received from the peer.
  *
  * @param[in] client Identifies the client for which the data was received.
@@ -9,6 +9,9 @@
  * @brief Internal functions to handle transport in MQTT module.
  */
 
+#include <errno.h>
+#include <net/socket.h>
+
 #include "mqtt_transport.h"
 
 /**@brief Function pointer array for TCP/TLS transport handlers. */
@@ -78,3 +81,53 @@ int mqtt_transport_disconnect(struct mqtt_client *client)
 {
 	return transport_fn[client->transport.type].disconnect(client);
 }
+
+int mqtt_transport_sock_sendmsg(int sock, const struct msghdr *message)
+{
+	struct msghdr msg = *message;
+	const uint8_t *data;
+	size_t len;
+	int ret;
+
+	/* Socket may accept only part of the message, e.g. with a large
+	 * payload. Skip the data already sent and retry, without modifying
+	 * the caller's I/O vector.
+	 */
+	while (msg.msg_iovlen > 0) {
+		ret = zsock_sendmsg(sock, &msg, 0);
+		if (ret < 0) {
+			return -errno;
+		}
+
+		len = ret;
+
+		while (msg.msg_iovlen > 0 && len >= msg.msg_iov[0].iov_len) {
+			len -= msg.msg_iov[0].iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		}
+
+		if (len == 0) {
+			continue;
+		}
+
+		/* Complete the partially sent entry on its own. */
+		data = (const uint8_t *)msg.msg_iov[0].iov_base + len;
+		len = msg.msg_iov[0].iov_len - len;
+
+		while (len > 0) {
+			ret = zsock_send(sock, data, len, 0);
+			if (ret < 0) {
+				return -errno;
+			}
+
+			data += ret;
+			len -= ret;
+		}
+
+		msg.msg_iov++;
+		msg.msg_iovlen--;
+	}
+
+	return 0;
+}
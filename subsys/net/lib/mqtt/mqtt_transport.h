@@ -115,6 +115,17 @@ int mqtt_transport_read(struct mqtt_client *client, uint8_t *data, uint32_t bufl
  */
 int mqtt_transport_disconnect(struct mqtt_client *client);
 
+/**@brief Writes a whole message on a socket, similar to POSIX sendmsg
+ *        function, retrying until the socket has accepted all of the data.
+ *
+ * @param[in] sock Socket to write the message on.
+ * @param[in] message Pointer to the `struct msghdr` structure, containing data
+ *            to be written on the socket. It is not modified.
+ *
+ * @retval 0 or an error code indicating reason for failure.
+ */
+int mqtt_transport_sock_sendmsg(int sock, const struct msghdr *message);
+
 /* Transport handler functions for TCP socket transport. */
 int mqtt_client_tcp_connect(struct mqtt_client *client);
 int mqtt_client_tcp_write(struct mqtt_client *client, const uint8_t *data,
@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_mqtt_sock_tls, CONFIG_MQTT_LOG_LEVEL);
 #include <net/socket.h>
 #include <net/mqtt.h>
 
+#include "mqtt_transport.h"
 #include "mqtt_os.h"
 
 int mqtt_client_tls_connect(struct mqtt_client *client)
@@ -120,14 +121,7 @@ int mqtt_client_tls_write(struct mqtt_client *client, const uint8_t *data,
 int mqtt_client_tls_write_msg(struct mqtt_client *client,
 			      const struct msghdr *message)
 {
-	int ret;
-
-	ret = zsock_sendmsg(client->transport.tls.sock, message, 0);
-	if (ret < 0) {
-		return -errno;
-	}
-
-	return 0;
+	return mqtt_transport_sock_sendmsg(client->transport.tls.sock, message);
 }
 
 int mqtt_client_tls_read(struct mqtt_client *client, uint8_t *data, uint32_t buflen,
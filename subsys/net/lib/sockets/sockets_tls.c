@@ -34,6 +34,12 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <mbedtls/ssl_cookie.h>
 #include <mbedtls/error.h>
 #include <mbedtls/debug.h>
+#if defined(MBEDTLS_SSL_CACHE_C)
+#include <mbedtls/ssl_cache.h>
+#endif
+#if defined(MBEDTLS_SSL_TICKET_C)
+#include <mbedtls/ssl_ticket.h>
+#endif
 #endif /* CONFIG_MBEDTLS */
 
 #include "sockets_internal.h"
@@ -45,6 +51,11 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #define ALPN_MAX_PROTOCOLS 0
 #endif /* CONFIG_NET_SOCKETS_TLS_MAX_APP_PROTOCOLS */
 
+/* Longest hostname that can be used as a session cache key. Sessions
+ * negotiated with longer hostnames are not cached.
+ */
+#define TLS_SESSION_HOSTNAME_MAX_LEN 64
+
 static const struct socket_op_vtable tls_sock_fd_op_vtable;
 
 /** A list of secure tags that TLS context should use. */
@@ -95,6 +106,9 @@ struct tls_context {
 	/** Information whether underlying socket is listening. */
 	bool is_listening;
 
+	/** Information whether the last handshake resumed a cached session. */
+	bool session_resumed;
+
 	/** Information whether TLS handshake is complete or not. */
 	struct k_sem tls_established;
 
@@ -120,6 +134,12 @@ struct tls_context {
 		 * protocols.
 		 */
 		const char *alpn_list[ALPN_MAX_PROTOCOLS];
+
+		/** Session cache mode. */
+		int8_t cache_enabled;
+
+		/** DTLS Connection ID mode. */
+		int8_t dtls_cid;
 	} options;
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
@@ -134,6 +154,14 @@ struct tls_context {
 
 	/** DTLS peer address length. */
 	socklen_t dtls_peer_addrlen;
+
+	/** Source address of a datagram received from a new peer address,
+	 *  accepted due to DTLS Connection ID and pending authentication.
+	 */
+	struct sockaddr dtls_pending_addr;
+
+	/** Pending DTLS peer address length. */
+	socklen_t dtls_pending_addrlen;
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
 #if defined(CONFIG_MBEDTLS)
@@ -157,6 +185,48 @@ struct tls_context {
 #endif /* CONFIG_MBEDTLS */
 };
 
+#if CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_SESSION_COUNT > 0
+/** Client session cache entry. */
+struct tls_session_cache {
+	/** Information whether the entry holds a stored session. */
+	bool is_used;
+
+	/** Timestamp of the last use, used for LRU replacement. */
+	uint32_t timestamp;
+
+	/** Address of the peer the session was established with. */
+	struct sockaddr peer_addr;
+
+	/** Peer address length. */
+	socklen_t peer_addrlen;
+
+	/** Credentials used to establish the session. */
+	struct sec_tag_list sec_tag_list;
+
+	/** Hostname the peer was verified against. */
+	char hostname[TLS_SESSION_HOSTNAME_MAX_LEN + 1];
+
+	/** mbedTLS session data (including session ticket, if any). */
+	mbedtls_ssl_session session;
+};
+
+static struct tls_session_cache client_cache[
+				CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_SESSION_COUNT];
+#endif /* CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_SESSION_COUNT > 0 */
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+/* Server side session cache, shared between listening sockets. */
+static mbedtls_ssl_cache_context server_cache;
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+/* Server side session ticket keys, shared between listening sockets. */
+static mbedtls_ssl_ticket_context server_ticket;
+#endif
+
+/* A mutex for protecting session caches. */
+static struct k_mutex session_cache_lock;
+
 #if defined(CONFIG_ENTROPY_HAS_DRIVER)
 static const struct device *entropy_dev;
 #endif
@@ -309,6 +379,27 @@ static int tls_init(const struct device *unused)
 		return -EFAULT;
 	}
 
+	k_mutex_init(&session_cache_lock);
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_init(&server_cache);
+	mbedtls_ssl_cache_set_max_entries(
+		&server_cache, CONFIG_NET_SOCKETS_TLS_MAX_SERVER_SESSION_COUNT);
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_ticket_init(&server_ticket);
+
+	ret = mbedtls_ssl_ticket_setup(&server_ticket, mbedtls_ctr_drbg_random,
+				       &tls_ctr_drbg, MBEDTLS_CIPHER_AES_256_GCM,
+				       CONFIG_NET_SOCKETS_TLS_SESSION_TICKET_LIFETIME);
+	if (ret != 0) {
+		mbedtls_ssl_ticket_free(&server_ticket);
+		NET_ERR("TLS session ticket initialization failed");
+		return -EFAULT;
+	}
+#endif
+
 #if defined(MBEDTLS_DEBUG_C) && (CONFIG_NET_SOCKETS_LOG_LEVEL >= LOG_LEVEL_DBG)
 	mbedtls_debug_set_threshold(CONFIG_MBEDTLS_DEBUG_LEVEL);
 #endif
@@ -480,35 +571,345 @@ static inline int time_left(uint32_t start, uint32_t timeout)
 	return timeout - elapsed;
 }
 
-#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
-static bool dtls_is_peer_addr_valid(struct tls_context *context,
-				    const struct sockaddr *peer_addr,
-				    socklen_t addrlen)
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS) || \
+	CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_SESSION_COUNT > 0
+static bool peer_addr_cmp(const struct sockaddr *addr1, socklen_t addrlen1,
+			  const struct sockaddr *addr2, socklen_t addrlen2)
 {
-	if (context->dtls_peer_addrlen != addrlen ||
-	    context->dtls_peer_addr.sa_family != peer_addr->sa_family) {
+	if (addrlen1 != addrlen2 || addr1->sa_family != addr2->sa_family) {
 		return false;
 	}
 
-	if (IS_ENABLED(CONFIG_NET_IPV6) && peer_addr->sa_family == AF_INET6) {
-		struct sockaddr_in6 *addr1 = net_sin6(peer_addr);
-		struct sockaddr_in6 *addr2 =
-				net_sin6(&context->dtls_peer_addr);
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr1->sa_family == AF_INET6) {
+		struct sockaddr_in6 *addr1_in6 = net_sin6(addr1);
+		struct sockaddr_in6 *addr2_in6 = net_sin6(addr2);
 
-		return (addr1->sin6_port == addr2->sin6_port) &&
-			net_ipv6_addr_cmp(&addr1->sin6_addr, &addr2->sin6_addr);
+		return (addr1_in6->sin6_port == addr2_in6->sin6_port) &&
+			net_ipv6_addr_cmp(&addr1_in6->sin6_addr,
+					  &addr2_in6->sin6_addr);
 	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
-		   peer_addr->sa_family == AF_INET) {
-		struct sockaddr_in *addr1 = net_sin(peer_addr);
-		struct sockaddr_in *addr2 =
-				net_sin(&context->dtls_peer_addr);
+		   addr1->sa_family == AF_INET) {
+		struct sockaddr_in *addr1_in = net_sin(addr1);
+		struct sockaddr_in *addr2_in = net_sin(addr2);
 
-		return (addr1->sin_port == addr2->sin_port) &&
-			net_ipv4_addr_cmp(&addr1->sin_addr, &addr2->sin_addr);
+		return (addr1_in->sin_port == addr2_in->sin_port) &&
+			net_ipv4_addr_cmp(&addr1_in->sin_addr,
+					  &addr2_in->sin_addr);
 	}
 
 	return false;
 }
+#endif
+
+#if CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_SESSION_COUNT > 0
+static const char *tls_session_hostname(struct tls_context *tls)
+{
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	if (tls->ssl.hostname != NULL) {
+		return tls->ssl.hostname;
+	}
+#endif
+
+	return "";
+}
+
+/* Find client session cache entry matching the context. Shall be called with
+ * session_cache_lock held.
+ */
+static struct tls_session_cache *tls_session_find(struct tls_context *tls,
+						  const struct sockaddr *addr,
+						  socklen_t addrlen)
+{
+	struct tls_session_cache *entry;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(client_cache); i++) {
+		entry = &client_cache[i];
+
+		if (!entry->is_used) {
+			continue;
+		}
+
+		if (!peer_addr_cmp(&entry->peer_addr, entry->peer_addrlen,
+				   addr, addrlen)) {
+			continue;
+		}
+
+		if (entry->sec_tag_list.sec_tag_count !=
+		    tls->options.sec_tag_list.sec_tag_count ||
+		    memcmp(entry->sec_tag_list.sec_tags,
+			   tls->options.sec_tag_list.sec_tags,
+			   entry->sec_tag_list.sec_tag_count *
+			   sizeof(sec_tag_t)) != 0) {
+			continue;
+		}
+
+		if (strcmp(entry->hostname, tls_session_hostname(tls)) != 0) {
+			continue;
+		}
+
+		return entry;
+	}
+
+	return NULL;
+}
+
+static void tls_session_entry_free(struct tls_session_cache *entry)
+{
+	mbedtls_ssl_session_free(&entry->session);
+	entry->is_used = false;
+}
+
+/* Store the session negotiated on the context in the client cache. */
+static void tls_session_store(struct tls_context *tls,
+			      const struct sockaddr *addr,
+			      socklen_t addrlen)
+{
+	struct tls_session_cache *entry;
+	const char *hostname = tls_session_hostname(tls);
+	int i, ret;
+
+	tls->session_resumed = false;
+
+	if (tls->options.cache_enabled != TLS_SESSION_CACHE_ENABLED) {
+		return;
+	}
+
+	if (strlen(hostname) > TLS_SESSION_HOSTNAME_MAX_LEN ||
+	    addrlen > sizeof(entry->peer_addr)) {
+		NET_DBG("Session not cached, key too long");
+		return;
+	}
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+
+	entry = tls_session_find(tls, addr, addrlen);
+	if (entry != NULL) {
+		/* A full handshake negotiates a new master secret, it is only
+		 * kept when the offered session was resumed.
+		 */
+		tls->session_resumed =
+			memcmp(entry->session.master, tls->ssl.session->master,
+			       sizeof(entry->session.master)) == 0;
+	} else {
+		/* Take a free entry, or replace the least recently used. */
+		entry = &client_cache[0];
+
+		for (i = 0; i < ARRAY_SIZE(client_cache); i++) {
+			if (!client_cache[i].is_used) {
+				entry = &client_cache[i];
+				break;
+			}
+
+			if ((int32_t)(client_cache[i].timestamp -
+				      entry->timestamp) < 0) {
+				entry = &client_cache[i];
+			}
+		}
+	}
+
+	if (entry->is_used) {
+		tls_session_entry_free(entry);
+	}
+
+	mbedtls_ssl_session_init(&entry->session);
+
+	ret = mbedtls_ssl_get_session(&tls->ssl, &entry->session);
+	if (ret != 0) {
+		NET_DBG("Failed to obtain session: -%x", -ret);
+		mbedtls_ssl_session_free(&entry->session);
+		goto exit;
+	}
+
+	memcpy(&entry->peer_addr, addr, addrlen);
+	entry->peer_addrlen = addrlen;
+	memcpy(&entry->sec_tag_list, &tls->options.sec_tag_list,
+	       sizeof(entry->sec_tag_list));
+	strcpy(entry->hostname, hostname);
+	entry->timestamp = k_uptime_get_32();
+	entry->is_used = true;
+
+	NET_DBG("Stored TLS session in cache entry %p", entry);
+
+exit:
+	k_mutex_unlock(&session_cache_lock);
+}
+
+/* Offer a cached session (if any) in the next client handshake. */
+static void tls_session_restore(struct tls_context *tls,
+				const struct sockaddr *addr,
+				socklen_t addrlen)
+{
+	struct tls_session_cache *entry;
+	int ret;
+
+	if (tls->options.cache_enabled != TLS_SESSION_CACHE_ENABLED) {
+		return;
+	}
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+
+	entry = tls_session_find(tls, addr, addrlen);
+	if (entry == NULL) {
+		goto exit;
+	}
+
+	ret = mbedtls_ssl_set_session(&tls->ssl, &entry->session);
+	if (ret != 0) {
+		NET_DBG("Failed to restore session: -%x", -ret);
+		tls_session_entry_free(entry);
+		goto exit;
+	}
+
+	entry->timestamp = k_uptime_get_32();
+
+	NET_DBG("Restored TLS session from cache entry %p", entry);
+
+exit:
+	k_mutex_unlock(&session_cache_lock);
+}
+
+/* Drop a cached session, e.g. after a failed handshake. */
+static void tls_session_drop(struct tls_context *tls,
+			     const struct sockaddr *addr,
+			     socklen_t addrlen)
+{
+	struct tls_session_cache *entry;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+
+	entry = tls_session_find(tls, addr, addrlen);
+	if (entry != NULL) {
+		tls_session_entry_free(entry);
+	}
+
+	k_mutex_unlock(&session_cache_lock);
+}
+
+static void tls_session_purge(void)
+{
+	int i;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(client_cache); i++) {
+		if (client_cache[i].is_used) {
+			tls_session_entry_free(&client_cache[i]);
+		}
+	}
+
+	k_mutex_unlock(&session_cache_lock);
+}
+#else
+static void tls_session_store(struct tls_context *tls,
+			      const struct sockaddr *addr,
+			      socklen_t addrlen)
+{
+}
+
+static void tls_session_restore(struct tls_context *tls,
+				const struct sockaddr *addr,
+				socklen_t addrlen)
+{
+}
+
+static void tls_session_drop(struct tls_context *tls,
+			     const struct sockaddr *addr,
+			     socklen_t addrlen)
+{
+}
+
+static void tls_session_purge(void)
+{
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_SESSION_COUNT > 0 */
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+/* mbedTLS cache context is not thread safe without MBEDTLS_THREADING_C,
+ * serialize access from concurrent server handshakes.
+ */
+static int tls_server_cache_get(void *data, mbedtls_ssl_session *session)
+{
+	int ret;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+	ret = mbedtls_ssl_cache_get(data, session);
+	k_mutex_unlock(&session_cache_lock);
+
+	return ret;
+}
+
+static int tls_server_cache_set(void *data, const mbedtls_ssl_session *session)
+{
+	int ret;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+	ret = mbedtls_ssl_cache_set(data, session);
+	k_mutex_unlock(&session_cache_lock);
+
+	return ret;
+}
+#endif /* MBEDTLS_SSL_CACHE_C */
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+static int tls_server_ticket_write(void *data,
+				   const mbedtls_ssl_session *session,
+				   unsigned char *start,
+				   const unsigned char *end,
+				   size_t *tlen, uint32_t *lifetime)
+{
+	int ret;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+	ret = mbedtls_ssl_ticket_write(data, session, start, end, tlen,
+				       lifetime);
+	k_mutex_unlock(&session_cache_lock);
+
+	return ret;
+}
+
+static int tls_server_ticket_parse(void *data, mbedtls_ssl_session *session,
+				   unsigned char *buf, size_t len)
+{
+	int ret;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+	ret = mbedtls_ssl_ticket_parse(data, session, buf, len);
+	k_mutex_unlock(&session_cache_lock);
+
+	return ret;
+}
+#endif /* MBEDTLS_SSL_TICKET_C */
+
+static void tls_server_session_cache_conf(struct tls_context *tls)
+{
+	if (tls->options.cache_enabled != TLS_SESSION_CACHE_ENABLED) {
+		return;
+	}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_conf_session_cache(&tls->config, &server_cache,
+				       tls_server_cache_get,
+				       tls_server_cache_set);
+#endif
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_conf_session_tickets_cb(&tls->config,
+					    tls_server_ticket_write,
+					    tls_server_ticket_parse,
+					    &server_ticket);
+#endif
+}
+
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
+static bool dtls_is_peer_addr_valid(struct tls_context *context,
+				    const struct sockaddr *peer_addr,
+				    socklen_t addrlen)
+{
+	return peer_addr_cmp(&context->dtls_peer_addr,
+			     context->dtls_peer_addrlen,
+			     peer_addr, addrlen);
+}
 
 static void dtls_peer_address_set(struct tls_context *context,
 				  const struct sockaddr *peer_addr,
@@ -520,6 +921,51 @@ static void dtls_peer_address_set(struct tls_context *context,
 	}
 }
 
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+/* Check if records received on the context carry own Connection ID, so that
+ * the session is not bound to the peer address.
+ */
+static bool dtls_cid_is_active(struct tls_context *context)
+{
+	unsigned char peer_cid[MBEDTLS_SSL_CID_OUT_LEN_MAX];
+	size_t peer_cid_len;
+	int enabled;
+
+	if (context->options.dtls_cid != TLS_DTLS_CID_ENABLED ||
+	    !is_handshake_complete(context)) {
+		return false;
+	}
+
+	if (mbedtls_ssl_get_peer_cid(&context->ssl, &enabled, peer_cid,
+				     &peer_cid_len) != 0) {
+		return false;
+	}
+
+	return enabled == MBEDTLS_SSL_CID_ENABLED;
+}
+#else
+static bool dtls_cid_is_active(struct tls_context *context)
+{
+	return false;
+}
+#endif /* MBEDTLS_SSL_DTLS_CONNECTION_ID */
+
+/* Switch to the new peer address once a record received from it has been
+ * successfully authenticated.
+ */
+static void dtls_peer_address_update(struct tls_context *context)
+{
+	if (context->dtls_pending_addrlen == 0) {
+		return;
+	}
+
+	NET_DBG("DTLS peer address changed");
+
+	dtls_peer_address_set(context, &context->dtls_pending_addr,
+			      context->dtls_pending_addrlen);
+	context->dtls_pending_addrlen = 0;
+}
+
 static void dtls_peer_address_get(struct tls_context *context,
 				  struct sockaddr *peer_addr,
 				  socklen_t *addrlen)
@@ -609,6 +1055,18 @@ static int dtls_rx(void *ctx, unsigned char *buf, size_t len,
 				return MBEDTLS_ERR_SSL_PEER_VERIFY_FAILED;
 			}
 		} else if (!dtls_is_peer_addr_valid(tls_ctx, &addr, addrlen)) {
+			if (dtls_cid_is_active(tls_ctx)) {
+				/* With Connection ID, the peer address may
+				 * change (e.g. due to NAT rebinding). Pass the
+				 * datagram to mbedTLS, the address is updated
+				 * only if the record is authenticated.
+				 */
+				memcpy(&tls_ctx->dtls_pending_addr, &addr,
+				       addrlen);
+				tls_ctx->dtls_pending_addrlen = addrlen;
+				break;
+			}
+
 			/* Received data from different peer, ignore it. */
 			retry = true;
 
@@ -620,6 +1078,11 @@ static int dtls_rx(void *ctx, unsigned char *buf, size_t len,
 					return MBEDTLS_ERR_SSL_TIMEOUT;
 				}
 			}
+		} else {
+			/* Datagram from the current peer, drop any pending
+			 * address change that was not authenticated.
+			 */
+			tls_ctx->dtls_pending_addrlen = 0;
 		}
 	} while (retry);
 
@@ -842,6 +1305,7 @@ static int tls_mbedtls_reset(struct tls_context *context)
 	(void)memset(&context->dtls_peer_addr, 0,
 		     sizeof(context->dtls_peer_addr));
 	context->dtls_peer_addrlen = 0;
+	context->dtls_pending_addrlen = 0;
 #endif
 
 	return 0;
@@ -884,6 +1348,67 @@ static int tls_mbedtls_handshake(struct tls_context *context, bool block)
 	return ret;
 }
 
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
+#if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+static int dtls_cid_conf(struct tls_context *context)
+{
+	size_t own_cid_len = 0;
+	int ret;
+
+	if (context->options.dtls_cid == TLS_DTLS_CID_ENABLED) {
+		own_cid_len = CONFIG_NET_SOCKETS_DTLS_CID_LENGTH;
+	}
+
+	ret = mbedtls_ssl_conf_cid(&context->config, own_cid_len,
+				   MBEDTLS_SSL_UNEXPECTED_CID_IGNORE);
+	if (ret != 0) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int dtls_cid_set(struct tls_context *context)
+{
+	unsigned char own_cid[CONFIG_NET_SOCKETS_DTLS_CID_LENGTH];
+	size_t own_cid_len = 0;
+	int ret;
+
+	if (context->options.dtls_cid == TLS_DTLS_CID_DISABLED) {
+		return 0;
+	}
+
+	if (context->options.dtls_cid == TLS_DTLS_CID_ENABLED) {
+		own_cid_len = sizeof(own_cid);
+
+		ret = mbedtls_ctr_drbg_random(&tls_ctr_drbg, own_cid,
+					      own_cid_len);
+		if (ret != 0) {
+			return -EFAULT;
+		}
+	}
+
+	ret = mbedtls_ssl_set_cid(&context->ssl, MBEDTLS_SSL_CID_ENABLED,
+				  own_cid, own_cid_len);
+	if (ret != 0) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+#else
+static int dtls_cid_conf(struct tls_context *context)
+{
+	return 0;
+}
+
+static int dtls_cid_set(struct tls_context *context)
+{
+	return 0;
+}
+#endif /* MBEDTLS_SSL_DTLS_CONNECTION_ID */
+#endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
+
 static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 {
 	int role, type, ret;
@@ -949,6 +1474,11 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 					&context->config,
 					CONFIG_NET_SOCKETS_DTLS_TIMEOUT);
 		}
+
+		ret = dtls_cid_conf(context);
+		if (ret != 0) {
+			return ret;
+		}
 	}
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
@@ -974,6 +1504,10 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 			     mbedtls_ctr_drbg_random,
 			     &tls_ctr_drbg);
 
+	if (is_server) {
+		tls_server_session_cache_conf(context);
+	}
+
 	ret = tls_mbedtls_set_credentials(context);
 	if (ret != 0) {
 		return ret;
@@ -998,6 +1532,15 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 		return -ENOMEM;
 	}
 
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
+	if (type == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
+		ret = dtls_cid_set(context);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+#endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
+
 	context->is_initialized = true;
 
 	return 0;
@@ -1249,6 +1792,172 @@ static int tls_opt_dtls_role_set(struct tls_context *context,
 	return 0;
 }
 
+static int tls_opt_dtls_cid_set(struct tls_context *context,
+				const void *optval, socklen_t optlen)
+{
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS) && \
+	defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+	int *cid;
+
+	if (context->type != SOCK_DGRAM) {
+		return -EINVAL;
+	}
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	cid = (int *)optval;
+	if (*cid != TLS_DTLS_CID_DISABLED &&
+	    *cid != TLS_DTLS_CID_SUPPORTED &&
+	    *cid != TLS_DTLS_CID_ENABLED) {
+		return -EINVAL;
+	}
+
+	/* Connection ID has to be configured before the handshake. */
+	if (context->is_initialized) {
+		return -EALREADY;
+	}
+
+	context->options.dtls_cid = *cid;
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
+static int tls_opt_dtls_cid_get(struct tls_context *context,
+				void *optval, socklen_t *optlen)
+{
+	if (context->type != SOCK_DGRAM) {
+		return -EINVAL;
+	}
+
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->options.dtls_cid;
+
+	return 0;
+}
+
+static int tls_opt_dtls_cid_status_get(struct tls_context *context,
+				       void *optval, socklen_t *optlen)
+{
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS) && \
+	defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+	unsigned char peer_cid[MBEDTLS_SSL_CID_OUT_LEN_MAX];
+	size_t peer_cid_len;
+	int enabled, ret;
+	int status = TLS_DTLS_CID_STATUS_DISABLED;
+
+	if (context->type != SOCK_DGRAM) {
+		return -EINVAL;
+	}
+
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	if (!is_handshake_complete(context)) {
+		return -ENOTCONN;
+	}
+
+	ret = mbedtls_ssl_get_peer_cid(&context->ssl, &enabled, peer_cid,
+				       &peer_cid_len);
+	if (ret != 0) {
+		return -EIO;
+	}
+
+	if (enabled == MBEDTLS_SSL_CID_ENABLED) {
+		if (context->options.dtls_cid == TLS_DTLS_CID_ENABLED) {
+			status |= TLS_DTLS_CID_STATUS_DOWNLINK;
+		}
+
+		if (peer_cid_len > 0) {
+			status |= TLS_DTLS_CID_STATUS_UPLINK;
+		}
+	}
+
+	*(int *)optval = status;
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
+static int tls_opt_session_cache_set(struct tls_context *context,
+				     const void *optval, socklen_t optlen)
+{
+	int *cache;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	cache = (int *)optval;
+	if (*cache != TLS_SESSION_CACHE_DISABLED &&
+	    *cache != TLS_SESSION_CACHE_ENABLED) {
+		return -EINVAL;
+	}
+
+	context->options.cache_enabled = *cache;
+
+	return 0;
+}
+
+static int tls_opt_session_cache_get(struct tls_context *context,
+				     void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->options.cache_enabled;
+
+	return 0;
+}
+
+static int tls_opt_session_resumed_get(struct tls_context *context,
+				       void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	if (!is_handshake_complete(context)) {
+		return -ENOTCONN;
+	}
+
+	*(int *)optval = context->session_resumed;
+
+	return 0;
+}
+
+static int tls_opt_session_cache_purge_set(struct tls_context *context,
+					   const void *optval,
+					   socklen_t optlen)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(optval);
+	ARG_UNUSED(optlen);
+
+	tls_session_purge();
+
+	return 0;
+}
+
 static int protocol_check(int family, int type, int *proto)
 {
 	if (family != AF_INET && family != AF_INET6) {
@@ -1369,13 +2078,18 @@ int ztls_connect_ctx(struct tls_context *ctx, const struct sockaddr *addr,
 		/* Do not use any socket flags during the handshake. */
 		ctx->flags = 0;
 
+		tls_session_restore(ctx, addr, addrlen);
+
 		/* TODO For simplicity, TLS handshake blocks the socket
 		 * even for non-blocking socket.
 		 */
 		ret = tls_mbedtls_handshake(ctx, true);
 		if (ret < 0) {
+			tls_session_drop(ctx, addr, addrlen);
 			goto error;
 		}
+
+		tls_session_store(ctx, addr, addrlen);
 	} else {
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 		/* Just store the address. */
@@ -1509,13 +2223,21 @@ static ssize_t sendto_dtls_client(struct tls_context *ctx, const void *buf,
 	}
 
 	if (!is_handshake_complete(ctx)) {
+		tls_session_restore(ctx, &ctx->dtls_peer_addr,
+				    ctx->dtls_peer_addrlen);
+
 		/* TODO For simplicity, TLS handshake blocks the socket even for
 		 * non-blocking socket.
 		 */
 		ret = tls_mbedtls_handshake(ctx, true);
 		if (ret < 0) {
+			tls_session_drop(ctx, &ctx->dtls_peer_addr,
+					 ctx->dtls_peer_addrlen);
 			goto error;
 		}
+
+		tls_session_store(ctx, &ctx->dtls_peer_addr,
+				  ctx->dtls_peer_addrlen);
 	}
 
 	return send_tls(ctx, buf, len, flags);
@@ -1645,6 +2367,8 @@ static ssize_t recvfrom_dtls_client(struct tls_context *ctx, void *buf,
 
 	ret = mbedtls_ssl_read(&ctx->ssl, buf, max_len);
 	if (ret >= 0) {
+		dtls_peer_address_update(ctx);
+
 		if (src_addr && addrlen) {
 			dtls_peer_address_get(ctx, src_addr, addrlen);
 		}
@@ -1720,6 +2444,8 @@ static ssize_t recvfrom_dtls_server(struct tls_context *ctx, void *buf,
 
 		ret = mbedtls_ssl_read(&ctx->ssl, buf, max_len);
 		if (ret >= 0) {
+			dtls_peer_address_update(ctx);
+
 			if (src_addr && addrlen) {
 				dtls_peer_address_get(ctx, src_addr, addrlen);
 			}
@@ -2056,6 +2782,22 @@ int ztls_getsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_alpn_list_get(ctx, optval, optlen);
 		break;
 
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_get(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION_RESUMED:
+		err = tls_opt_session_resumed_get(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_CID:
+		err = tls_opt_dtls_cid_get(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_CID_STATUS:
+		err = tls_opt_dtls_cid_status_get(ctx, optval, optlen);
+		break;
+
 	default:
 		/* Unknown or write-only option. */
 		err = -ENOPROTOOPT;
@@ -2105,6 +2847,18 @@ int ztls_setsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_alpn_list_set(ctx, optval, optlen);
 		break;
 
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_set(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION_CACHE_PURGE:
+		err = tls_opt_session_cache_purge_set(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_CID:
+		err = tls_opt_dtls_cid_set(ctx, optval, optlen);
+		break;
+
 	default:
 		/* Unknown or read-only option. */
 		err = -ENOPROTOOPT;
@@ -480,13 +480,94 @@ static int websocket_prepare_and_send(struct websocket_context *ctx,
 #endif /* CONFIG_NET_TEST */
 }
 
+/* Send a complete frame header and payload, continuing after partial
+ * writes. Returns the number of payload bytes sent, or a negative error if
+ * nothing could be sent.
+ */
+static int websocket_send_all(struct websocket_context *ctx,
+			      uint8_t *header, size_t header_len,
+			      uint8_t *payload, size_t payload_len,
+			      int32_t timeout)
+{
+	size_t sent = 0;
+	int ret;
+
+	while (header_len > 0 || payload_len > 0) {
+		ret = websocket_prepare_and_send(ctx, header, header_len,
+						 payload, payload_len,
+						 timeout);
+		if (ret < 0) {
+			ret = -errno;
+			NET_DBG("Cannot send ws msg (%d)", ret);
+
+			return sent > 0 ? sent : ret;
+		}
+
+		if (ret < header_len) {
+			header += ret;
+			header_len -= ret;
+			continue;
+		}
+
+		ret -= header_len;
+		header_len = 0;
+
+		payload += ret;
+		payload_len -= ret;
+		sent += ret;
+	}
+
+	return sent;
+}
+
+/* XOR len bytes of src with the masking key into dst. The offset is the
+ * position of src[0] within the frame payload, which selects the key byte
+ * to start with. The bulk of the data is processed one machine word at a
+ * time, dst and src may overlap only if they are equal.
+ */
+static void websocket_mask(uint8_t *dst, const uint8_t *src, size_t len,
+			   uint32_t masking_value, size_t offset)
+{
+	uint8_t key[sizeof(uint32_t)];
+	unsigned long word;
+	int i;
+
+	sys_put_be32(masking_value, key);
+
+	while (len > 0 && ((uintptr_t)dst & (sizeof(word) - 1))) {
+		*dst++ = *src++ ^ key[offset++ % sizeof(key)];
+		len--;
+	}
+
+	/* Word size is a multiple of the key size, so the same word applies
+	 * to every aligned chunk regardless of the CPU endianness.
+	 */
+	for (i = 0; i < sizeof(word); i++) {
+		((uint8_t *)&word)[i] = key[(offset + i) % sizeof(key)];
+	}
+
+	while (len >= sizeof(word)) {
+		*(unsigned long *)dst =
+			UNALIGNED_GET((const unsigned long *)src) ^ word;
+		dst += sizeof(word);
+		src += sizeof(word);
+		len -= sizeof(word);
+	}
+
+	while (len > 0) {
+		*dst++ = *src++ ^ key[offset++ % sizeof(key)];
+		len--;
+	}
+}
+
 int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		       enum websocket_opcode opcode, bool mask, bool final,
 		       int32_t timeout)
 {
 	struct websocket_context *ctx;
 	uint8_t header[MAX_HEADER_LEN], hdr_len = 2;
-	uint8_t *data_to_send = (uint8_t *)payload;
+	uint8_t chunk[CONFIG_WEBSOCKET_MASK_BUF_SIZE];
+	size_t offset, chunk_len;
 	int ret;
 
 	if (opcode != WEBSOCKET_OPCODE_DATA_TEXT &&
@@ -548,43 +629,48 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		hdr_len += 8;
 	}
 
-	/* Add masking value if needed */
-	if (mask) {
-		int i;
+	if (!mask) {
+		/* The payload is passed to the socket as is, without copying */
+		return websocket_send_all(ctx, header, hdr_len,
+					  (uint8_t *)payload, payload_len,
+					  timeout);
+	}
 
-		ctx->masking_value = sys_rand32_get();
+	/* Add masking value */
+	ctx->masking_value = sys_rand32_get();
 
-		header[hdr_len++] |= ctx->masking_value >> 24;
-		header[hdr_len++] |= ctx->masking_value >> 16;
-		header[hdr_len++] |= ctx->masking_value >> 8;
-		header[hdr_len++] |= ctx->masking_value;
+	header[hdr_len++] |= ctx->masking_value >> 24;
+	header[hdr_len++] |= ctx->masking_value >> 16;
+	header[hdr_len++] |= ctx->masking_value >> 8;
+	header[hdr_len++] |= ctx->masking_value;
 
-		data_to_send = k_malloc(payload_len);
-		if (!data_to_send) {
-			return -ENOMEM;
-		}
+	/* The caller's buffer must stay intact, so the payload is masked
+	 * into a bounded scratch buffer and sent chunk by chunk. The header
+	 * goes out together with the first chunk.
+	 */
+	offset = 0;
+
+	do {
+		chunk_len = MIN(payload_len - offset, sizeof(chunk));
 
-		memcpy(data_to_send, payload, payload_len);
+		websocket_mask(chunk, payload + offset, chunk_len,
+			       ctx->masking_value, offset);
 
-		for (i = 0; i < payload_len; i++) {
-			data_to_send[i] ^=
-				ctx->masking_value >> (8 * (3 - i % 4));
+		ret = websocket_send_all(ctx, header, hdr_len,
+					 chunk, chunk_len, timeout);
+		if (ret < 0) {
+			return offset > 0 ? offset : ret;
 		}
-	}
 
-	ret = websocket_prepare_and_send(ctx, header, hdr_len,
-					 data_to_send, payload_len, timeout);
-	if (ret < 0) {
-		NET_DBG("Cannot send ws msg (%d)", -errno);
-		goto quit;
-	}
+		hdr_len = 0;
+		offset += ret;
 
-quit:
-	if (data_to_send != payload) {
-		k_free(data_to_send);
-	}
+		if (ret < chunk_len) {
+			break;
+		}
+	} while (offset < payload_len);
 
-	return ret - hdr_len;
+	return offset;
 }
 
 static bool websocket_parse_header(uint8_t *buf, size_t buf_len, bool *masked,
@@ -831,17 +917,12 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 
 	/* Unmask the data */
 	if (ctx->masked) {
-		/* As we might have less than 4 received bytes, we must select
-		 * which byte from masking value to take. The mask_shift will
-		 * tell that.
+		/* As we might have less than 4 received bytes, the offset
+		 * of this data within the payload selects which byte from
+		 * masking value to start with.
 		 */
-		int mask_shift = (ctx->total_read - recv_len) % sizeof(uint32_t);
-		int i;
-
-		for (i = 0; i < recv_len; i++) {
-			buf[i] ^= ctx->masking_value >>
-				(8 * (3 - (i + mask_shift) % 4));
-		}
+		websocket_mask(buf, buf, recv_len, ctx->masking_value,
+			       ctx->total_read - recv_len);
 	}
 
 #if HEXDUMP_RECV_PACKETS
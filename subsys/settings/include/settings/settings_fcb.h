@@ -15,9 +15,25 @@
 extern "C" {
 #endif
 
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+/* Newest entry of the names with a given hash, fe_sector is NULL once the
+ * entry was erased.
+ */
+struct settings_fcb_index_entry {
+	struct fcb_entry loc;
+	uint32_t hash;
+	bool used;
+};
+#endif
+
 struct settings_fcb {
 	struct settings_store cf_store;
 	struct fcb cf_fcb;
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	struct settings_fcb_index_entry cf_index[CONFIG_SETTINGS_FCB_INDEX_SIZE];
+	bool cf_index_valid;
+	bool cf_index_overflow;
+#endif
 };
 
 extern int settings_fcb_src(struct settings_fcb *cf);
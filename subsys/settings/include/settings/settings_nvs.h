@@ -29,6 +29,10 @@ extern "C" {
  *
  * Deleted records will not be found, only the last record will be
  * read.
+ *
+ * Between csi_save_start and csi_save_end the entry at NVS_NAMECNT_ID is
+ * written once, at the end. Name entries above the stored largest name ID,
+ * left by a power loss in between, are found again on initialization.
  */
 #define NVS_NAMECNT_ID 0x8000
 #define NVS_NAME_ID_OFFSET 0x4000
@@ -37,6 +41,8 @@ struct settings_nvs {
 	struct settings_store cf_store;
 	struct nvs_fs cf_nvs;
 	uint16_t last_name_id;
+	bool batch;
+	bool last_name_id_dirty;
 	const char *flash_dev_name;
 };
 
@@ -24,6 +24,135 @@ sys_slist_t settings_handlers;
 
 K_MUTEX_DEFINE(settings_lock);
 
+#if defined(CONFIG_SETTINGS_HANDLER_LOOKUP)
+#define SETTINGS_LOOKUP_SIZE CONFIG_SETTINGS_HANDLER_LOOKUP_SIZE
+
+struct settings_lookup_entry {
+	uint32_t hash;
+	struct settings_handler_static *handler;
+};
+
+/* Handlers by name hash, with linear probing */
+static struct settings_lookup_entry settings_lookup[SETTINGS_LOOKUP_SIZE];
+static bool settings_lookup_valid;
+
+static void settings_lookup_add(struct settings_handler_static *handler)
+{
+	struct settings_lookup_entry *le;
+	uint32_t hash;
+
+	if (!settings_lookup_valid) {
+		return;
+	}
+
+	hash = settings_name_hash(handler->name, strlen(handler->name));
+
+	for (int i = 0; i < SETTINGS_LOOKUP_SIZE; i++) {
+		le = &settings_lookup[(hash + i) % SETTINGS_LOOKUP_SIZE];
+		/* A later handler of the same name wins, as in the search. */
+		if ((le->handler == NULL) ||
+		    ((le->hash == hash) &&
+		     !strcmp(le->handler->name, handler->name))) {
+			le->hash = hash;
+			le->handler = handler;
+			return;
+		}
+	}
+
+	LOG_WRN("too many settings handlers to look up");
+	settings_lookup_valid = false;
+}
+
+static void settings_lookup_init(void)
+{
+	(void)memset(settings_lookup, 0, sizeof(settings_lookup));
+	settings_lookup_valid = true;
+
+	Z_STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
+		settings_lookup_add(ch);
+	}
+}
+
+/* Handler named by the first len characters of name */
+static struct settings_handler_static *settings_lookup_find(const char *name,
+							    size_t len)
+{
+	struct settings_lookup_entry *le;
+	uint32_t hash = settings_name_hash(name, len);
+
+	for (int i = 0; i < SETTINGS_LOOKUP_SIZE; i++) {
+		le = &settings_lookup[(hash + i) % SETTINGS_LOOKUP_SIZE];
+		if (le->handler == NULL) {
+			break;
+		}
+		if ((le->hash == hash) &&
+		    !strncmp(le->handler->name, name, len) &&
+		    (le->handler->name[len] == '\0')) {
+			return le->handler;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Find the handler of the longest name prefix ending at a separator.
+ *
+ * @retval true  The table answered, handler is NULL when there is none
+ * @retval false The name is too deep, the handlers must be searched
+ */
+static bool settings_lookup_get(const char *name,
+				struct settings_handler_static **handler,
+				const char **next)
+{
+	size_t lens[SETTINGS_MAX_DIR_DEPTH];
+	int cnt = 0;
+	size_t len;
+
+	*handler = NULL;
+
+	if (!name) {
+		return true;
+	}
+
+	/* name might come from flash directly, and end with '=' */
+	for (len = 0; ; len++) {
+		char c = name[len];
+
+		if ((c == SETTINGS_NAME_SEPARATOR) || (c == '\0') ||
+		    (c == SETTINGS_NAME_END)) {
+			if (cnt == ARRAY_SIZE(lens)) {
+				return false;
+			}
+			lens[cnt++] = len;
+			if (c != SETTINGS_NAME_SEPARATOR) {
+				break;
+			}
+		}
+	}
+
+	while (cnt--) {
+		len = lens[cnt];
+		*handler = settings_lookup_find(name, len);
+		if (*handler) {
+			if (next && (name[len] == SETTINGS_NAME_SEPARATOR)) {
+				*next = &name[len + 1];
+			}
+			break;
+		}
+	}
+
+	return true;
+}
+#else
+static inline void settings_lookup_add(struct settings_handler_static *handler)
+{
+}
+
+static inline void settings_lookup_init(void)
+{
+}
+#endif /* CONFIG_SETTINGS_HANDLER_LOOKUP */
 
 void settings_store_init(void);
 
@@ -32,9 +161,21 @@ void settings_init(void)
 #if defined(CONFIG_SETTINGS_DYNAMIC_HANDLERS)
 	sys_slist_init(&settings_handlers);
 #endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
+	settings_lookup_init();
 	settings_store_init();
 }
 
+uint32_t settings_name_hash(const char *name, size_t len)
+{
+	uint32_t hash = 2166136261U;
+
+	while (len--) {
+		hash = (hash ^ (uint8_t)*name++) * 16777619U;
+	}
+
+	return hash;
+}
+
 #if defined(CONFIG_SETTINGS_DYNAMIC_HANDLERS)
 int settings_register(struct settings_handler *handler)
 {
@@ -56,6 +197,7 @@ int settings_register(struct settings_handler *handler)
 		}
 	}
 	sys_slist_append(&settings_handlers, &handler->node);
+	settings_lookup_add((struct settings_handler_static *)handler);
 
 end:
 	k_mutex_unlock(&settings_lock);
@@ -145,6 +287,13 @@ struct settings_handler_static *settings_parse_and_lookup(const char *name,
 		*next = NULL;
 	}
 
+#if defined(CONFIG_SETTINGS_HANDLER_LOOKUP)
+	if (settings_lookup_valid &&
+	    settings_lookup_get(name, &bestmatch, next)) {
+		return bestmatch;
+	}
+#endif /* CONFIG_SETTINGS_HANDLER_LOOKUP */
+
 	Z_STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
 		if (!settings_name_steq(name, ch->name, &tmpnext)) {
 			continue;
@@ -198,6 +347,12 @@ int settings_call_set_handler(const char *name,
 	int rc;
 	const char *name_key = name;
 
+#if defined(CONFIG_SETTINGS_TXN)
+	if (!strcmp(name, SETTINGS_TXN_NAME)) {
+		return 0;
+	}
+#endif /* CONFIG_SETTINGS_TXN */
+
 	if (load_arg && load_arg->subtree &&
 	    !settings_name_steq(name, load_arg->subtree, &name_key)) {
 		return 0;
@@ -24,14 +24,209 @@ void settings_mount_fcb_backend(struct settings_fcb *cf);
 
 static int settings_fcb_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg);
+static int settings_fcb_get_val(struct settings_store *cs, const char *name,
+				void *buf, size_t buf_len);
 static int settings_fcb_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len);
 
 static const struct settings_store_itf settings_fcb_itf = {
 	.csi_load = settings_fcb_load,
+	.csi_get_val = settings_fcb_get_val,
 	.csi_save = settings_fcb_save,
 };
 
+static bool settings_fcb_same_entry(const struct fcb_entry *loc1,
+				    const struct fcb_entry *loc2)
+{
+	return (loc1->fe_sector == loc2->fe_sector) &&
+	       (loc1->fe_elem_off == loc2->fe_elem_off);
+}
+
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+#define SETTINGS_FCB_INDEX_SIZE CONFIG_SETTINGS_FCB_INDEX_SIZE
+
+static uint32_t settings_fcb_hash(const char *name)
+{
+	return settings_name_hash(name, strlen(name));
+}
+
+static void settings_fcb_index_reset(struct settings_fcb *cf)
+{
+	cf->cf_index_valid = false;
+	cf->cf_index_overflow = false;
+}
+
+static struct settings_fcb_index_entry *
+settings_fcb_index_find(struct settings_fcb *cf, uint32_t hash, bool add)
+{
+	struct settings_fcb_index_entry *ie;
+
+	for (int i = 0; i < SETTINGS_FCB_INDEX_SIZE; i++) {
+		ie = &cf->cf_index[(hash + i) % SETTINGS_FCB_INDEX_SIZE];
+		if (!ie->used) {
+			if (!add) {
+				return NULL;
+			}
+			ie->used = true;
+			ie->hash = hash;
+			return ie;
+		}
+		if (ie->hash == hash) {
+			return ie;
+		}
+	}
+
+	return NULL;
+}
+
+static void settings_fcb_index_add(struct settings_fcb *cf, const char *name,
+				   const struct fcb_entry *loc)
+{
+	struct settings_fcb_index_entry *ie;
+
+	ie = settings_fcb_index_find(cf, settings_fcb_hash(name), true);
+	if (ie == NULL) {
+		LOG_WRN("too many settings names to index");
+		cf->cf_index_valid = false;
+		cf->cf_index_overflow = true;
+		return;
+	}
+
+	ie->loc = *loc;
+}
+
+/* Record the newest entry of each name hash. */
+static void settings_fcb_index_build(struct settings_fcb *cf)
+{
+	struct fcb_entry_ctx entry_ctx = {
+		{.fe_sector = NULL, .fe_elem_off = 0},
+		.fap = cf->cf_fcb.fap
+	};
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len;
+
+	if (cf->cf_index_valid || cf->cf_index_overflow) {
+		return;
+	}
+
+	(void)memset(cf->cf_index, 0, sizeof(cf->cf_index));
+
+	while (fcb_getnext(&cf->cf_fcb, &entry_ctx.loc) == 0) {
+		if (settings_line_name_read(name, sizeof(name), &name_len,
+					    &entry_ctx)) {
+			continue;
+		}
+		name[name_len] = '\0';
+
+		settings_fcb_index_add(cf, name, &entry_ctx.loc);
+		if (cf->cf_index_overflow) {
+			return;
+		}
+	}
+
+	cf->cf_index_valid = true;
+}
+
+static void settings_fcb_index_update(struct settings_fcb *cf,
+				      const char *name,
+				      const struct fcb_entry *loc)
+{
+	if (cf->cf_index_valid) {
+		settings_fcb_index_add(cf, name, loc);
+	}
+}
+
+/* Forget the entries of an erased sector, none of the names of the same
+ * hash has an entry left.
+ */
+static void settings_fcb_index_drop(struct settings_fcb *cf,
+				    const struct flash_sector *sector)
+{
+	for (int i = 0; i < SETTINGS_FCB_INDEX_SIZE; i++) {
+		if (cf->cf_index[i].loc.fe_sector == sector) {
+			cf->cf_index[i].loc.fe_sector = NULL;
+		}
+	}
+}
+
+/**
+ * @brief Get the newest entry of a setting from the index
+ *
+ * @param cf     FCB handler
+ * @param name   Name of the setting
+ * @param cur    Optional entry of the setting, which needs no check when it
+ *               is the newest one
+ * @param newest Newest entry of the setting
+ *
+ * @retval 0       Newest entry found
+ * @retval -ENOENT The setting has no entry
+ * @retval <0      The index can not tell, the FCB must be searched
+ */
+static int settings_fcb_newest_get(struct settings_fcb *cf, const char *name,
+				   const struct fcb_entry *cur,
+				   struct fcb_entry_ctx *newest)
+{
+	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	struct settings_fcb_index_entry *ie;
+	size_t name2_len;
+
+	if (!cf->cf_index_valid) {
+		return -EAGAIN;
+	}
+
+	ie = settings_fcb_index_find(cf, settings_fcb_hash(name), false);
+	if ((ie == NULL) || (ie->loc.fe_sector == NULL)) {
+		return -ENOENT;
+	}
+
+	newest->loc = ie->loc;
+	newest->fap = cf->cf_fcb.fap;
+
+	if ((cur != NULL) && settings_fcb_same_entry(cur, &ie->loc)) {
+		return 0;
+	}
+
+	if (settings_line_name_read(name2, sizeof(name2), &name2_len,
+				    newest)) {
+		return -EIO;
+	}
+	name2[name2_len] = '\0';
+
+	/* Another name of the same hash */
+	if (strcmp(name, name2)) {
+		return -EAGAIN;
+	}
+
+	return 0;
+}
+#else
+static void settings_fcb_index_reset(struct settings_fcb *cf)
+{
+}
+
+static void settings_fcb_index_build(struct settings_fcb *cf)
+{
+}
+
+static void settings_fcb_index_update(struct settings_fcb *cf,
+				      const char *name,
+				      const struct fcb_entry *loc)
+{
+}
+
+static void settings_fcb_index_drop(struct settings_fcb *cf,
+				    const struct flash_sector *sector)
+{
+}
+
+static int settings_fcb_newest_get(struct settings_fcb *cf, const char *name,
+				   const struct fcb_entry *cur,
+				   struct fcb_entry_ctx *newest)
+{
+	return -ENOTSUP;
+}
+#endif /* CONFIG_SETTINGS_FCB_INDEX */
+
 int settings_fcb_src(struct settings_fcb *cf)
 {
 	int rc;
@@ -64,6 +259,8 @@ int settings_fcb_src(struct settings_fcb *cf)
 		}
 	}
 
+	settings_fcb_index_reset(cf);
+
 	cf->cf_store.cs_itf = &settings_fcb_itf;
 	settings_src_register(&cf->cf_store);
 
@@ -72,6 +269,8 @@ int settings_fcb_src(struct settings_fcb *cf)
 
 int settings_fcb_dst(struct settings_fcb *cf)
 {
+	settings_fcb_index_reset(cf);
+
 	cf->cf_store.cs_itf = &settings_fcb_itf;
 	settings_dst_register(&cf->cf_store);
 
@@ -113,6 +312,32 @@ static bool settings_fcb_check_duplicate(struct settings_fcb *cf,
 	return false;
 }
 
+/**
+ * @brief Check if the current setting is overridden by a newer entry
+ *
+ * Uses the index when it can tell, otherwise searches the rest of the
+ * buffer.
+ *
+ * @param cf        FCB handler
+ * @param entry_ctx Current entry context
+ * @param name      The name of the current entry
+ *
+ * @retval false The current entry is the newest one
+ * @retval true  Newer entry found
+ */
+static bool settings_fcb_is_overridden(struct settings_fcb *cf,
+				       const struct fcb_entry_ctx *entry_ctx,
+				       const char * const name)
+{
+	struct fcb_entry_ctx newest;
+
+	if (settings_fcb_newest_get(cf, name, &entry_ctx->loc, &newest) == 0) {
+		return !settings_fcb_same_entry(&newest.loc, &entry_ctx->loc);
+	}
+
+	return settings_fcb_check_duplicate(cf, entry_ctx, name);
+}
+
 static int read_entry_len(const struct fcb_entry_ctx *entry_ctx, off_t off)
 {
 	if (off >= entry_ctx->loc.fe_data_len) {
@@ -124,6 +349,7 @@ static int read_entry_len(const struct fcb_entry_ctx *entry_ctx, off_t off)
 static int settings_fcb_load_priv(struct settings_store *cs,
 				  line_load_cb cb,
 				  void *cb_arg,
+				  const char *subtree,
 				  bool filter_duplicates)
 {
 	struct settings_fcb *cf = (struct settings_fcb *)cs;
@@ -133,6 +359,10 @@ static int settings_fcb_load_priv(struct settings_store *cs,
 	};
 	int rc;
 
+	if (filter_duplicates) {
+		settings_fcb_index_build(cf);
+	}
+
 	while ((rc = fcb_getnext(&cf->cf_fcb, &entry_ctx.loc)) == 0) {
 		char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
 		size_t name_len;
@@ -147,9 +377,14 @@ static int settings_fcb_load_priv(struct settings_store *cs,
 		}
 		name[name_len] = '\0';
 
+		/* Skip the other subtrees before searching for duplicates */
+		if (subtree && !settings_name_steq(name, subtree, NULL)) {
+			continue;
+		}
+
 		if (filter_duplicates &&
 		    (!read_entry_len(&entry_ctx, name_len+1) ||
-		     settings_fcb_check_duplicate(cf, &entry_ctx, name))) {
+		     settings_fcb_is_overridden(cf, &entry_ctx, name))) {
 			pass_entry = false;
 		}
 		/*name, val-read_cb-ctx, val-off*/
@@ -171,9 +406,41 @@ static int settings_fcb_load(struct settings_store *cs,
 		cs,
 		settings_line_load_cb,
 		(void *)arg,
+		arg->subtree,
 		true);
 }
 
+/* ::csi_get_val implementation */
+static int settings_fcb_get_val(struct settings_store *cs, const char *name,
+				void *buf, size_t buf_len)
+{
+	struct settings_fcb *cf = (struct settings_fcb *)cs;
+	struct settings_line_get_val_arg gva = {
+		.name = name,
+		.buf = buf,
+		.buf_len = buf_len,
+		.len = -ENOENT
+	};
+	struct fcb_entry_ctx newest;
+	int rc;
+
+	settings_fcb_index_build(cf);
+	rc = settings_fcb_newest_get(cf, name, NULL, &newest);
+	if (rc == -ENOENT) {
+		return rc;
+	}
+
+	if (rc == 0) {
+		settings_line_get_val_cb(name, &newest, strlen(name) + 1, &gva);
+	} else {
+		/* One pass, the newest entry of the name comes last. */
+		settings_fcb_load_priv(cs, settings_line_get_val_cb, &gva,
+				       name, false);
+	}
+
+	return (gva.len == 0) ? -ENOENT : gva.len;
+}
+
 static int read_handler(void *ctx, off_t off, char *buf, size_t *len)
 {
 	struct fcb_entry_ctx *entry_ctx = ctx;
@@ -197,9 +464,8 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 	int rc;
 	struct fcb_entry_ctx loc1;
 	struct fcb_entry_ctx loc2;
-	char name1[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
-	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
-	int copy;
+	struct flash_sector *oldest;
+	char name1[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
 	uint8_t rbs;
 
 	rc = fcb_append_to_scratch(&cf->cf_fcb);
@@ -234,31 +500,15 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 			continue;
 		}
 
-		loc2 = loc1;
-		copy = 1;
-
-		while (fcb_getnext(&cf->cf_fcb, &loc2.loc) == 0) {
-			size_t val2_off;
-
-			rc = settings_line_name_read(name2, sizeof(name2),
-						     &val2_off, &loc2);
-			if (rc) {
-				continue;
-			}
-
-			if ((val1_off == val2_off) &&
-			    !memcmp(name1, name2, val1_off)) {
-				copy = 0;
-				break;
-			}
-		}
-		if (!copy) {
+		name1[val1_off] = '\0';
+		if (settings_fcb_is_overridden(cf, &loc1, name1)) {
 			continue;
 		}
 
 		/*
 		 * Can't find one. Must copy.
 		 */
+		loc2.fap = cf->cf_fcb.fap;
 		rc = fcb_append(&cf->cf_fcb, loc1.loc.fe_data_len, &loc2.loc);
 		if (rc) {
 			continue;
@@ -273,12 +523,18 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 
 		if (rc != 0) {
 			LOG_ERR("Failed to finish fcb_append (%d)", rc);
+		} else {
+			settings_fcb_index_update(cf, name1, &loc2.loc);
 		}
 	}
+	oldest = cf->cf_fcb.f_oldest;
 	rc = fcb_rotate(&cf->cf_fcb);
 
 	if (rc != 0) {
 		LOG_ERR("Failed to fcb rotate (%d)", rc);
+		settings_fcb_index_reset(cf);
+	} else {
+		settings_fcb_index_drop(cf, oldest);
 	}
 }
 
@@ -341,13 +597,19 @@ static int settings_fcb_save_priv(struct settings_store *cs, const char *name,
 			rc = i;
 		}
 	}
+	if (!rc) {
+		settings_fcb_index_update(cf, name, &loc.loc);
+	}
 	return rc;
 }
 
 static int settings_fcb_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len)
 {
+	struct settings_fcb *cf = (struct settings_fcb *)cs;
 	struct settings_line_dup_check_arg cdca;
+	struct fcb_entry_ctx newest;
+	int rc;
 
 	if (val_len > 0 && value == NULL) {
 		return -EINVAL;
@@ -360,7 +622,21 @@ static int settings_fcb_save(struct settings_store *cs, const char *name,
 	cdca.val = (char *)value;
 	cdca.is_dup = 0;
 	cdca.val_len = val_len;
-	settings_fcb_load_priv(cs, settings_line_dup_check_cb, &cdca, false);
+
+	if (name) {
+		settings_fcb_index_build(cf);
+		rc = settings_fcb_newest_get(cf, name, NULL, &newest);
+	} else {
+		rc = -EINVAL;
+	}
+
+	if (rc == 0) {
+		settings_line_dup_check_cb(name, &newest, strlen(name) + 1,
+					   &cdca);
+	} else if (rc != -ENOENT) {
+		settings_fcb_load_priv(cs, settings_line_dup_check_cb, &cdca,
+				       NULL, false);
+	}
 	if (cdca.is_dup == 1) {
 		return 0;
 	}
@@ -380,9 +656,16 @@ int settings_backend_init(void)
 {
 	static struct flash_sector
 		settings_fcb_area[CONFIG_SETTINGS_FCB_NUM_AREAS + 1];
+#ifdef CONFIG_FCB_SECTOR_SUMMARY
+	static struct fcb_sector_summary
+		settings_fcb_summaries[CONFIG_SETTINGS_FCB_NUM_AREAS + 1];
+#endif
 	static struct settings_fcb config_init_settings_fcb = {
 		.cf_fcb.f_magic = CONFIG_SETTINGS_FCB_MAGIC,
 		.cf_fcb.f_sectors = settings_fcb_area,
+#ifdef CONFIG_FCB_SECTOR_SUMMARY
+		.cf_fcb.f_summaries = settings_fcb_summaries,
+#endif
 	};
 	uint32_t cnt = sizeof(settings_fcb_area) /
 		    sizeof(settings_fcb_area[0]);
@@ -24,11 +24,14 @@ void settings_mount_fs_backend(struct settings_file *cf);
 
 static int settings_file_load(struct settings_store *cs,
 			      const struct settings_load_arg *arg);
+static int settings_file_get_val(struct settings_store *cs, const char *name,
+				 void *buf, size_t buf_len);
 static int settings_file_save(struct settings_store *cs, const char *name,
 			      const char *value, size_t val_len);
 
 static const struct settings_store_itf settings_file_itf = {
 	.csi_load = settings_file_load,
+	.csi_get_val = settings_file_get_val,
 	.csi_save = settings_file_save,
 };
 
@@ -108,7 +111,8 @@ static int read_entry_len(const struct line_entry_ctx *entry_ctx, off_t off)
 }
 
 static int settings_file_load_priv(struct settings_store *cs, line_load_cb cb,
-				   void *cb_arg, bool filter_duplicates)
+				   void *cb_arg, const char *subtree,
+				   bool filter_duplicates)
 {
 	struct settings_file *cf = (struct settings_file *)cs;
 	struct fs_file_t file;
@@ -146,9 +150,12 @@ static int settings_file_load_priv(struct settings_store *cs, line_load_cb cb,
 		}
 		name[name_len] = '\0';
 
-		if (filter_duplicates &&
-		    (!read_entry_len(&entry_ctx, name_len+1) ||
-		     settings_file_check_duplicate(&entry_ctx, name))) {
+		/* Skip the other subtrees before searching for duplicates */
+		if (subtree && !settings_name_steq(name, subtree, NULL)) {
+			pass_entry = false;
+		} else if (filter_duplicates &&
+			   (!read_entry_len(&entry_ctx, name_len+1) ||
+			    settings_file_check_duplicate(&entry_ctx, name))) {
 			pass_entry = false;
 		}
 		/*name, val-read_cb-ctx, val-off*/
@@ -174,9 +181,34 @@ static int settings_file_load(struct settings_store *cs,
 	return settings_file_load_priv(cs,
 				       settings_line_load_cb,
 				       (void *)arg,
+				       arg->subtree,
 				       true);
 }
 
+/*
+ * Called to read a single configuration item, the newest line of the name
+ * comes last in the file.
+ */
+static int settings_file_get_val(struct settings_store *cs, const char *name,
+				 void *buf, size_t buf_len)
+{
+	struct settings_line_get_val_arg gva = {
+		.name = name,
+		.buf = buf,
+		.buf_len = buf_len,
+		.len = -ENOENT
+	};
+	int rc;
+
+	rc = settings_file_load_priv(cs, settings_line_get_val_cb, &gva, name,
+				     false);
+	if (rc) {
+		return rc;
+	}
+
+	return (gva.len == 0) ? -ENOENT : gva.len;
+}
+
 static void settings_tmpfile(char *dst, const char *src, char *pfx)
 {
 	int len;
@@ -421,7 +453,8 @@ static int settings_file_save(struct settings_store *cs, const char *name,
 	cdca.val = (char *)value;
 	cdca.is_dup = 0;
 	cdca.val_len = val_len;
-	settings_file_load_priv(cs, settings_line_dup_check_cb, &cdca, false);
+	settings_file_load_priv(cs, settings_line_dup_check_cb, &cdca, NULL,
+				false);
 	if (cdca.is_dup == 1) {
 		return 0;
 	}
@@ -13,6 +13,7 @@
 
 #include "settings/settings.h"
 #include "settings/settings_file.h"
+#include "settings_priv.h"
 #include <zephyr.h>
 
 
@@ -35,6 +36,10 @@ int settings_subsys_init(void)
 
 	err = settings_backend_init(); /* func rises kernel panic once error */
 
+	if (!err) {
+		err = settings_txn_recover();
+	}
+
 	if (!err) {
 		settings_subsys_initialized = true;
 	}
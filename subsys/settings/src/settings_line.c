@@ -417,3 +417,27 @@ int settings_line_load_cb(const char *name, void *val_read_cb_ctx, off_t off,
 	return settings_call_set_handler(name, len, settings_line_read_cb,
 					 &value_ctx, arg);
 }
+
+int settings_line_get_val_cb(const char *name, void *val_read_cb_ctx,
+			     off_t off, void *cb_arg)
+{
+	struct settings_line_get_val_arg *gva = cb_arg;
+	size_t len, len_read;
+	int rc;
+
+	if (strcmp(name, gva->name)) {
+		return 0;
+	}
+
+	len = settings_line_val_get_len(off, val_read_cb_ctx);
+	if (len == 0) {
+		gva->len = 0;
+		return 0;
+	}
+
+	rc = settings_line_val_read(off, 0, gva->buf, MIN(len, gva->buf_len),
+				    &len_read, val_read_cb_ctx);
+	gva->len = rc ? rc : len_read;
+
+	return 0;
+}
@@ -23,12 +23,19 @@ struct settings_nvs_read_fn_arg {
 
 static int settings_nvs_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg);
+static int settings_nvs_get_val(struct settings_store *cs, const char *name,
+				void *buf, size_t buf_len);
+static int settings_nvs_save_start(struct settings_store *cs);
 static int settings_nvs_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len);
+static int settings_nvs_save_end(struct settings_store *cs);
 
 static struct settings_store_itf settings_nvs_itf = {
 	.csi_load = settings_nvs_load,
+	.csi_get_val = settings_nvs_get_val,
+	.csi_save_start = settings_nvs_save_start,
 	.csi_save = settings_nvs_save,
+	.csi_save_end = settings_nvs_save_end,
 };
 
 static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
@@ -128,6 +135,82 @@ static int settings_nvs_load(struct settings_store *cs,
 	return ret;
 }
 
+static int settings_nvs_get_val(struct settings_store *cs, const char *name,
+				void *buf, size_t buf_len)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint16_t name_id;
+	ssize_t rc;
+
+	name_id = cf->last_name_id + 1;
+
+	while (1) {
+		name_id--;
+		if (name_id == NVS_NAMECNT_ID) {
+			break;
+		}
+
+		rc = nvs_read(&cf->cf_nvs, name_id, &rdname, sizeof(rdname));
+		if ((rc <= 0) || (rc >= sizeof(rdname))) {
+			continue;
+		}
+
+		rdname[rc] = '\0';
+
+		if (strcmp(name, rdname)) {
+			continue;
+		}
+
+		/* A name is stored once, its value entry is the setting. */
+		rc = nvs_read(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET, buf,
+			      buf_len);
+		if (rc == 0) {
+			return -ENOENT;
+		}
+
+		return (rc < 0) ? rc : MIN(rc, buf_len);
+	}
+
+	return -ENOENT;
+}
+
+/* Store the largest name ID in use, at the end of a batch of saves. */
+static int settings_nvs_name_cnt_write(struct settings_nvs *cf)
+{
+	if (cf->batch) {
+		cf->last_name_id_dirty = true;
+		return 0;
+	}
+
+	return nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID, &cf->last_name_id,
+			 sizeof(uint16_t));
+}
+
+static int settings_nvs_save_start(struct settings_store *cs)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+
+	cf->batch = true;
+
+	return 0;
+}
+
+static int settings_nvs_save_end(struct settings_store *cs)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+
+	cf->batch = false;
+
+	if (!cf->last_name_id_dirty) {
+		return 0;
+	}
+
+	cf->last_name_id_dirty = false;
+
+	return settings_nvs_name_cnt_write(cf);
+}
+
 static int settings_nvs_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len)
 {
@@ -172,8 +255,7 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 
 		if ((delete) && (name_id == cf->last_name_id)) {
 			cf->last_name_id--;
-			rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
-				       &cf->last_name_id, sizeof(uint16_t));
+			rc = settings_nvs_name_cnt_write(cf);
 			if (rc < 0) {
 				/* Error: can't to store
 				 * the largest name ID in use.
@@ -225,8 +307,7 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	/* update the last_name_id and write to flash if required*/
 	if (write_name_id > cf->last_name_id) {
 		cf->last_name_id = write_name_id;
-		rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID, &cf->last_name_id,
-			       sizeof(uint16_t));
+		rc = settings_nvs_name_cnt_write(cf);
 	}
 
 	if (rc < 0) {
@@ -241,6 +322,7 @@ int settings_nvs_backend_init(struct settings_nvs *cf)
 {
 	int rc;
 	uint16_t last_name_id;
+	char buf;
 
 	rc = nvs_init(&cf->cf_nvs, cf->flash_dev_name);
 	if (rc) {
@@ -255,6 +337,25 @@ int settings_nvs_backend_init(struct settings_nvs *cf)
 		cf->last_name_id = last_name_id;
 	}
 
+	cf->batch = false;
+	cf->last_name_id_dirty = false;
+
+	/* Names written by a batch of saves interrupted before its end */
+	last_name_id = cf->last_name_id;
+	while ((cf->last_name_id < NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET - 1) &&
+	       (nvs_read(&cf->cf_nvs, cf->last_name_id + 1, &buf,
+			 sizeof(buf)) > 0)) {
+		cf->last_name_id++;
+	}
+
+	if (cf->last_name_id != last_name_id) {
+		rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID, &cf->last_name_id,
+			       sizeof(uint16_t));
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
 	LOG_DBG("Initialized");
 	return 0;
 }
@@ -46,6 +46,19 @@ int settings_line_load_cb(const char *name, void *val_read_cb_ctx,
 typedef int (*line_load_cb)(const char *name, void *val_read_cb_ctx,
 			     off_t off, void *cb_arg);
 
+struct settings_line_get_val_arg {
+	const char *name;
+	void *buf;
+	size_t buf_len;
+	int len; /* length read, 0 when deleted, -ENOENT when not found */
+};
+
+/* Read the value of the line when its name is the requested one, a later
+ * line of the same name overwrites the value read.
+ */
+int settings_line_get_val_cb(const char *name, void *val_read_cb_ctx,
+			     off_t off, void *cb_arg);
+
 struct settings_line_read_value_cb_ctx {
 	void *read_cb_ctx;
 	off_t off;
@@ -121,6 +134,34 @@ void settings_line_io_init(int (*read_cb)(void *ctx, off_t off, char *buf,
 			  uint8_t io_rwbs);
 
 
+/* FNV-1a hash of the first len characters of a name */
+uint32_t settings_name_hash(const char *name, size_t len);
+
+/* Name of the journal record of a settings transaction */
+#define SETTINGS_TXN_NAME "settings/txn"
+
+#ifdef CONFIG_SETTINGS_TXN
+bool settings_txn_pending(void);
+int settings_txn_save(const char *name, const void *value, size_t val_len);
+int settings_txn_recover(void);
+#else
+static inline bool settings_txn_pending(void)
+{
+	return false;
+}
+
+static inline int settings_txn_save(const char *name, const void *value,
+				    size_t val_len)
+{
+	return -ENOTSUP;
+}
+
+static inline int settings_txn_recover(void)
+{
+	return 0;
+}
+#endif /* CONFIG_SETTINGS_TXN */
+
 extern sys_slist_t settings_load_srcs;
 extern sys_slist_t settings_handlers;
 extern struct settings_store *settings_save_dst;
@@ -88,6 +88,83 @@ int settings_load_subtree_direct(
 	return 0;
 }
 
+struct settings_get_val_arg {
+	void *buf;
+	size_t buf_len;
+	int len;
+};
+
+static int settings_get_val_cb(const char *key, size_t len,
+			       settings_read_cb read_cb, void *cb_arg,
+			       void *param)
+{
+	struct settings_get_val_arg *gva = param;
+	ssize_t rc;
+
+	/* Only the setting itself, not the ones below it */
+	if (key != NULL) {
+		return 0;
+	}
+
+	if (len == 0) {
+		gva->len = -ENOENT;
+		return 0;
+	}
+
+	rc = read_cb(cb_arg, gva->buf, MIN(len, gva->buf_len));
+	gva->len = (rc < 0) ? -EIO : rc;
+
+	return 0;
+}
+
+/* Read a setting through a load, for the backends without csi_get_val. */
+static int settings_get_val_load(struct settings_store *cs, const char *name,
+				 void *buf, size_t buf_len)
+{
+	struct settings_get_val_arg gva = {
+		.buf = buf,
+		.buf_len = buf_len,
+		.len = -ENOENT
+	};
+	const struct settings_load_arg arg = {
+		.subtree = name,
+		.cb = settings_get_val_cb,
+		.param = &gva
+	};
+
+	cs->cs_itf->csi_load(cs, &arg);
+
+	return (gva.len == 0) ? -ENOENT : gva.len;
+}
+
+int settings_get_val(const char *name, void *buf, size_t buf_len)
+{
+	struct settings_store *cs;
+	int rc = -ENOENT;
+	int rc2;
+
+	if ((name == NULL) || (buf == NULL) || (buf_len == 0)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
+		if (cs->cs_itf->csi_get_val) {
+			rc2 = cs->cs_itf->csi_get_val(cs, name, buf, buf_len);
+		} else {
+			rc2 = settings_get_val_load(cs, name, buf, buf_len);
+		}
+
+		/* The last source holding the setting wins, as on load. */
+		if (rc2 != -ENOENT) {
+			rc = rc2;
+		}
+	}
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
+
 /*
  * Append a single value to persisted config. Don't store duplicate value.
  */
@@ -103,7 +180,12 @@ int settings_save_one(const char *name, const void *value, size_t val_len)
 
 	k_mutex_lock(&settings_lock, K_FOREVER);
 
-	rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+	if (settings_txn_pending()) {
+		/* Written on the commit of the transaction */
+		rc = settings_txn_save(name, value, val_len);
+	} else {
+		rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+	}
 
 	k_mutex_unlock(&settings_lock);
 
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <kernel.h>
+#include <sys/byteorder.h>
+#include <sys/crc.h>
+
+#include "settings/settings.h"
+#include "settings_priv.h"
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
+
+extern struct k_mutex settings_lock;
+
+/*
+ * The settings of a transaction are kept in the journal format:
+ *	<crc16><count>, both little endian, then for each setting
+ *	<name length><value length, little endian><name>'\0'<value>
+ * the CRC covering everything after itself.
+ */
+#define TXN_HDR_LEN 4
+#define TXN_REC_HDR_LEN 3
+
+static uint8_t txn_buf[CONFIG_SETTINGS_TXN_BUF_SIZE];
+static size_t txn_len;
+static bool txn_pending;
+
+struct txn_rec {
+	const char *name;
+	const void *value;
+	size_t name_len; /* including '\0' */
+	size_t val_len;
+};
+
+/* Parse the record at off, return the offset of the next one or 0. */
+static size_t txn_rec_get(const uint8_t *buf, size_t len, size_t off,
+			  struct txn_rec *rec)
+{
+	if (off + TXN_REC_HDR_LEN > len) {
+		return 0;
+	}
+
+	rec->name_len = buf[off];
+	rec->val_len = sys_get_le16(&buf[off + 1]);
+	rec->name = (const char *)&buf[off + TXN_REC_HDR_LEN];
+	rec->value = &buf[off + TXN_REC_HDR_LEN + rec->name_len];
+
+	off += TXN_REC_HDR_LEN + rec->name_len + rec->val_len;
+	if ((rec->name_len == 0) || (off > len) ||
+	    (rec->name[rec->name_len - 1] != '\0')) {
+		return 0;
+	}
+
+	return off;
+}
+
+static uint16_t txn_cnt(void)
+{
+	struct txn_rec rec;
+	uint16_t cnt = 0;
+	size_t off = TXN_HDR_LEN;
+
+	while (off < txn_len) {
+		off = txn_rec_get(txn_buf, txn_len, off, &rec);
+		cnt++;
+	}
+
+	return cnt;
+}
+
+/* Find the pending value of a setting, return its offset or 0. */
+static size_t txn_find(const char *name, size_t *rec_len)
+{
+	struct txn_rec rec;
+	size_t off = TXN_HDR_LEN;
+	size_t next;
+
+	while (off < txn_len) {
+		next = txn_rec_get(txn_buf, txn_len, off, &rec);
+		if (!strcmp(name, rec.name)) {
+			*rec_len = next - off;
+			return off;
+		}
+		off = next;
+	}
+
+	return 0;
+}
+
+/* Drop the pending value of a setting, a later one replaces it. */
+static void txn_remove(size_t off, size_t rec_len)
+{
+	memmove(&txn_buf[off], &txn_buf[off + rec_len],
+		txn_len - off - rec_len);
+	txn_len -= rec_len;
+}
+
+static bool txn_valid(const uint8_t *buf, size_t len)
+{
+	struct txn_rec rec;
+	size_t off = TXN_HDR_LEN;
+	uint16_t cnt = 0;
+
+	if (len < TXN_HDR_LEN) {
+		return false;
+	}
+
+	if (sys_get_le16(buf) != crc16_ccitt(0xffff, &buf[2], len - 2)) {
+		return false;
+	}
+
+	while (off < len) {
+		off = txn_rec_get(buf, len, off, &rec);
+		if (off == 0) {
+			return false;
+		}
+		cnt++;
+	}
+
+	return cnt == sys_get_le16(&buf[2]);
+}
+
+static int txn_apply(struct settings_store *cs, const uint8_t *buf,
+		     size_t len)
+{
+	struct txn_rec rec;
+	size_t off = TXN_HDR_LEN;
+	int rc;
+
+	while (off < len) {
+		off = txn_rec_get(buf, len, off, &rec);
+
+		rc = cs->cs_itf->csi_save(cs, rec.name,
+					  rec.val_len ? rec.value : NULL,
+					  rec.val_len);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * A single setting is written as is. Several settings are first written
+ * as one journal record, which commits the transaction, then each setting
+ * is written and the journal is deleted. A journal left by a power loss is
+ * applied again on the next initialization.
+ */
+static int txn_write(struct settings_store *cs, uint16_t cnt)
+{
+	bool journal = (cnt > 1);
+	int rc = 0;
+
+	if (cs->cs_itf->csi_save_start) {
+		cs->cs_itf->csi_save_start(cs);
+	}
+
+	if (journal) {
+		sys_put_le16(cnt, &txn_buf[2]);
+		sys_put_le16(crc16_ccitt(0xffff, &txn_buf[2], txn_len - 2),
+			     txn_buf);
+
+		rc = cs->cs_itf->csi_save(cs, SETTINGS_TXN_NAME,
+					  (const char *)txn_buf, txn_len);
+	}
+
+	if (!rc) {
+		rc = txn_apply(cs, txn_buf, txn_len);
+	}
+
+	if (cs->cs_itf->csi_save_end) {
+		cs->cs_itf->csi_save_end(cs);
+	}
+
+	if (!rc && journal) {
+		rc = cs->cs_itf->csi_save(cs, SETTINGS_TXN_NAME, NULL, 0);
+	}
+
+	return rc;
+}
+
+int settings_txn_begin(void)
+{
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (txn_pending) {
+		k_mutex_unlock(&settings_lock);
+		return -EBUSY;
+	}
+
+	txn_pending = true;
+	txn_len = TXN_HDR_LEN;
+
+	/* settings_lock is held until the commit or the abort */
+	return 0;
+}
+
+bool settings_txn_pending(void)
+{
+	return txn_pending;
+}
+
+int settings_txn_save(const char *name, const void *value, size_t val_len)
+{
+	size_t name_len;
+	size_t rec_len;
+	size_t old_off;
+	size_t old_len = 0;
+
+	if (!name || (val_len > 0 && value == NULL)) {
+		return -EINVAL;
+	}
+
+	name_len = strlen(name) + 1;
+	if ((name_len > UINT8_MAX) || (val_len > UINT16_MAX)) {
+		return -EINVAL;
+	}
+
+	old_off = txn_find(name, &old_len);
+	rec_len = TXN_REC_HDR_LEN + name_len + val_len;
+	if (txn_len - old_len + rec_len > sizeof(txn_buf)) {
+		return -ENOMEM;
+	}
+
+	if (old_off) {
+		txn_remove(old_off, old_len);
+	}
+
+	txn_buf[txn_len] = name_len;
+	sys_put_le16(val_len, &txn_buf[txn_len + 1]);
+	memcpy(&txn_buf[txn_len + TXN_REC_HDR_LEN], name, name_len);
+	if (val_len) {
+		memcpy(&txn_buf[txn_len + TXN_REC_HDR_LEN + name_len], value,
+		       val_len);
+	}
+	txn_len += rec_len;
+
+	return 0;
+}
+
+int settings_txn_commit(void)
+{
+	struct settings_store *cs = settings_save_dst;
+	uint16_t cnt;
+	int rc;
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (!txn_pending) {
+		k_mutex_unlock(&settings_lock);
+		return -EINVAL;
+	}
+
+	txn_pending = false;
+	cnt = txn_cnt();
+
+	if (!cs) {
+		rc = -ENOENT;
+	} else if (cnt == 0) {
+		rc = 0;
+	} else {
+		rc = txn_write(cs, cnt);
+	}
+
+	txn_len = 0;
+
+	k_mutex_unlock(&settings_lock);
+	/* Taken by settings_txn_begin() */
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
+
+int settings_txn_abort(void)
+{
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (!txn_pending) {
+		k_mutex_unlock(&settings_lock);
+		return -EINVAL;
+	}
+
+	txn_pending = false;
+	txn_len = 0;
+
+	k_mutex_unlock(&settings_lock);
+	/* Taken by settings_txn_begin() */
+	k_mutex_unlock(&settings_lock);
+
+	return 0;
+}
+
+int settings_txn_recover(void)
+{
+	struct settings_store *cs = settings_save_dst;
+	int len;
+	int rc = 0;
+
+	if (!cs) {
+		return 0;
+	}
+
+	len = settings_get_val(SETTINGS_TXN_NAME, txn_buf, sizeof(txn_buf));
+	if (len == -ENOENT) {
+		return 0;
+	} else if (len < 0) {
+		return len;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (txn_valid(txn_buf, len)) {
+		LOG_INF("completing an interrupted settings transaction");
+
+		if (cs->cs_itf->csi_save_start) {
+			cs->cs_itf->csi_save_start(cs);
+		}
+		rc = txn_apply(cs, txn_buf, len);
+		if (cs->cs_itf->csi_save_end) {
+			cs->cs_itf->csi_save_end(cs);
+		}
+	}
+
+	if (!rc) {
+		rc = cs->cs_itf->csi_save(cs, SETTINGS_TXN_NAME, NULL, 0);
+	}
+
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
@@ -214,6 +214,188 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+/* Index of the bucket holding the given percentile of the latencies. */
+static unsigned int wait_hist_percentile(const k_thread_runtime_stats_t *stats,
+					 uint32_t total, unsigned int pct)
+{
+	uint64_t threshold = ((uint64_t)total * pct + 99U) / 100U;
+	uint64_t cnt = 0U;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(stats->wait_hist) - 1; i++) {
+		cnt += stats->wait_hist[i];
+		if (cnt >= threshold) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+static void shell_wait_hist_dump(const struct shell *shell,
+				 const k_thread_runtime_stats_t *stats)
+{
+	static const unsigned int pcts[] = { 50, 90, 99 };
+	unsigned int last = ARRAY_SIZE(stats->wait_hist) - 1;
+	uint32_t total = 0U;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(stats->wait_hist); i++) {
+		total += stats->wait_hist[i];
+	}
+
+	if (total == 0U) {
+		shell_print(shell, "	wait to run: none");
+		return;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "	wait to run: %u times,", total);
+
+	for (i = 0; i < ARRAY_SIZE(pcts); i++) {
+		unsigned int bucket = wait_hist_percentile(stats, total,
+							   pcts[i]);
+
+		/* Latencies of the last bucket have no upper bound. */
+		shell_fprintf(shell, SHELL_NORMAL, " p%u %s 2^%u,", pcts[i],
+			      bucket == last ? ">=" : "<",
+			      bucket == last ? bucket : bucket + 1U);
+	}
+
+	shell_print(shell, " max %u cycles", stats->wait_max_cycles);
+}
+#endif /* CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST */
+
+static void shell_rt_stats_dump(const struct k_thread *cthread,
+				void *user_data)
+{
+	struct k_thread *thread = (struct k_thread *)cthread;
+	const struct shell *shell = (const struct shell *)user_data;
+	k_thread_runtime_stats_t rt_stats_thread;
+	k_thread_runtime_stats_t rt_stats_all;
+	const char *tname;
+	unsigned int pcnt = 0U;
+
+	if ((k_thread_runtime_stats_get(thread, &rt_stats_thread) != 0) ||
+	    (k_thread_runtime_stats_all_get(&rt_stats_all) != 0)) {
+		return;
+	}
+
+	if (rt_stats_all.execution_cycles != 0U) {
+		pcnt = (rt_stats_thread.execution_cycles * 100U) /
+		       rt_stats_all.execution_cycles;
+	}
+
+	tname = k_thread_name_get(thread);
+
+	shell_print(shell, "%p %-10s run time: %u %%", thread,
+		    tname ? tname : "NA", pcnt);
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+	shell_wait_hist_dump(shell, &rt_stats_thread);
+#endif
+}
+
+static int cmd_kernel_stats(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+	k_thread_runtime_stats_t rt_stats_all;
+#endif
+#ifdef CONFIG_IRQ_RUNTIME_STATS
+	k_irq_runtime_stats_t irq_stats;
+#endif
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "Threads:");
+	k_thread_foreach(shell_rt_stats_dump, (void *)shell);
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WAIT_HIST
+	if (k_thread_runtime_stats_all_get(&rt_stats_all) == 0) {
+		shell_print(shell, "All threads:");
+		shell_wait_hist_dump(shell, &rt_stats_all);
+	}
+#endif
+
+#ifdef CONFIG_IRQ_RUNTIME_STATS
+	shell_print(shell, "Interrupts:");
+
+	for (unsigned int irq = 0; irq < CONFIG_IRQ_RUNTIME_STATS_NUM_IRQS;
+	     irq++) {
+		if ((k_irq_runtime_stats_get(irq, &irq_stats) != 0) ||
+		    (irq_stats.count == 0U)) {
+			continue;
+		}
+
+		shell_print(shell,
+			    "IRQ %3u: count %u, average %u, max %u cycles",
+			    irq, irq_stats.count,
+			    (uint32_t)(irq_stats.execution_cycles /
+				       irq_stats.count),
+			    irq_stats.max_cycles);
+	}
+#endif
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_LOCK_STATS)
+static void shell_lock_stats_dump(const k_lock_stats_t *stats,
+				  void *user_data)
+{
+	static const char *const types[] = {
+		[K_LOCK_SPINLOCK] = "spinlock",
+		[K_LOCK_MUTEX] = "mutex",
+		[K_LOCK_SEM] = "sem",
+	};
+	const struct shell *shell = (const struct shell *)user_data;
+	char addr[sizeof(void *) * 2 + 3];
+	const char *name = stats->name;
+	uint32_t wait_avg = 0U;
+	uint32_t hold_avg = 0U;
+
+	if (name == NULL) {
+		snprintk(addr, sizeof(addr), "%p", stats->obj);
+		name = addr;
+	}
+
+	/* Averaged over all the acquisitions, contended or not */
+	if (stats->count != 0U) {
+		wait_avg = (uint32_t)(stats->wait_cycles / stats->count);
+		hold_avg = (uint32_t)(stats->hold_cycles / stats->count);
+	}
+
+	shell_print(shell,
+		    "%-16s %-8s count %u, contended %u, "
+		    "wait avg %u max %u, hold avg %u max %u cycles",
+		    name, types[stats->type], stats->count, stats->contended,
+		    wait_avg, stats->wait_max_cycles,
+		    hold_avg, stats->hold_max_cycles);
+}
+
+static int cmd_kernel_locks(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+		k_lock_stats_reset();
+		return 0;
+	}
+
+	k_lock_stats_foreach(shell_lock_stats_dump, (void *)shell);
+
+	if (k_lock_stats_untracked_get() != 0U) {
+		shell_print(shell, "Untracked acquisitions: %u",
+			    k_lock_stats_untracked_get());
+	}
+
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -242,6 +424,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_reboot,
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 	SHELL_CMD(cycles, NULL, "Kernel cycles.", cmd_kernel_cycles),
+#if defined(CONFIG_LOCK_STATS)
+	SHELL_CMD_ARG(locks, NULL, "Lock contention statistics, "
+		      "\"locks reset\" clears them.", cmd_kernel_locks, 1, 1),
+#endif
 #if defined(CONFIG_REBOOT)
 	SHELL_CMD(reboot, &sub_kernel_reboot, "Reboot.", NULL),
 #endif
@@ -249,6 +435,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 		defined(CONFIG_THREAD_MONITOR)
 	SHELL_CMD(stacks, NULL, "List threads stack usage.", cmd_kernel_stacks),
 	SHELL_CMD(threads, NULL, "List kernel threads.", cmd_kernel_threads),
+#endif
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+	SHELL_CMD(stats, NULL, "Thread and interrupt runtime statistics.",
+		  cmd_kernel_stats),
 #endif
 	SHELL_CMD(uptime, NULL, "Kernel uptime.", cmd_kernel_uptime),
 	SHELL_CMD(version, NULL, "Kernel version.", cmd_kernel_version),
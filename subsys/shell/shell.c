@@ -1159,6 +1159,7 @@ static int instance_init(const struct shell *shell, const void *p_config,
 
 	if (IS_ENABLED(CONFIG_SHELL_STATS)) {
 		shell->stats->log_lost_cnt = 0;
+		shell->stats->tx_stall_cnt = 0;
 	}
 
 	flag_tx_rdy_set(shell, true);
@@ -311,6 +311,7 @@ static int cmd_shell_stats_show(const struct shell *shell, size_t argc,
 	ARG_UNUSED(argv);
 
 	shell_print(shell, "Lost logs: %u", shell->stats->log_lost_cnt);
+	shell_print(shell, "Output stalls: %u", shell->stats->tx_stall_cnt);
 
 	return 0;
 }
@@ -322,6 +323,7 @@ static int cmd_shell_stats_reset(const struct shell *shell,
 	ARG_UNUSED(argv);
 
 	shell->stats->log_lost_cnt = 0;
+	shell->stats->tx_stall_cnt = 0;
 
 	return 0;
 }
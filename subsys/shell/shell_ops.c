@@ -387,6 +387,9 @@ void shell_write(const struct shell *shell, const void *data,
 		length -= tmp_cnt;
 		if (tmp_cnt == 0 &&
 		    (shell->ctx->state != SHELL_STATE_PANIC_MODE_ACTIVE)) {
+			if (IS_ENABLED(CONFIG_SHELL_STATS)) {
+				atomic_inc(&shell->stats->tx_stall_cnt);
+			}
 			shell_pend_on_txdone(shell);
 		}
 	}
@@ -139,6 +139,69 @@ static void uart_callback(const struct device *dev, void *user_data)
 }
 #endif /* CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN */
 
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+/* Must be called with tx_busy set. Starts the transfer of the next chunk of
+ * the TX ring buffer or, if it is empty, clears tx_busy.
+ */
+static void async_tx_start(const struct shell_uart *sh_uart)
+{
+	const struct device *dev = sh_uart->ctrl_blk->dev;
+	uint8_t *data;
+	uint32_t len;
+	int err;
+
+	for (;;) {
+		len = ring_buf_get_claim(sh_uart->tx_ringbuf, &data,
+					 sh_uart->tx_ringbuf->size);
+		if (len) {
+			if (uart_tx(dev, data, len, SYS_FOREVER_MS) == 0) {
+				return;
+			}
+
+			/* Drop the data the UART does not accept. */
+			err = ring_buf_get_finish(sh_uart->tx_ringbuf, len);
+			__ASSERT_NO_MSG(err == 0);
+			continue;
+		}
+
+		sh_uart->ctrl_blk->tx_busy = 0;
+
+		/* Data may have been put after the claim, while tx_busy was
+		 * still set.
+		 */
+		if (ring_buf_is_empty(sh_uart->tx_ringbuf) ||
+		    atomic_set(&sh_uart->ctrl_blk->tx_busy, 1) != 0) {
+			return;
+		}
+	}
+}
+
+static void uart_async_callback(const struct device *dev,
+				struct uart_event *evt, void *user_data)
+{
+	const struct shell_uart *sh_uart = (struct shell_uart *)user_data;
+	int err;
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+		err = ring_buf_get_finish(sh_uart->tx_ringbuf,
+					  evt->data.tx.len);
+		__ASSERT_NO_MSG(err == 0);
+
+		if (!sh_uart->ctrl_blk->blocking_tx) {
+			async_tx_start(sh_uart);
+		}
+
+		sh_uart->ctrl_blk->handler(SHELL_TRANSPORT_EVT_TX_RDY,
+					   sh_uart->ctrl_blk->context);
+		break;
+	default:
+		break;
+	}
+}
+#endif /* CONFIG_SHELL_BACKEND_SERIAL_ASYNC */
+
 static void uart_irq_init(const struct shell_uart *sh_uart)
 {
 #ifdef CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN
@@ -183,6 +246,15 @@ static int init(const struct shell_transport *transport,
 	if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN)) {
 		uart_irq_init(sh_uart);
 	} else {
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+		int err = uart_callback_set(sh_uart->ctrl_blk->dev,
+					    uart_async_callback,
+					    (void *)sh_uart);
+
+		if (err) {
+			return err;
+		}
+#endif
 		k_timer_init(sh_uart->timer, timer_handler, NULL);
 		k_timer_user_data_set(sh_uart->timer, (void *)sh_uart);
 		k_timer_start(sh_uart->timer, RX_POLL_PERIOD, RX_POLL_PERIOD);
@@ -215,6 +287,11 @@ static int enable(const struct shell_transport *transport, bool blocking_tx)
 	if (blocking_tx) {
 #ifdef CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN
 		uart_irq_tx_disable(sh_uart->ctrl_blk->dev);
+#elif defined(CONFIG_SHELL_BACKEND_SERIAL_ASYNC)
+		/* Output is polled from now on, stop the transfer in
+		 * progress.
+		 */
+		(void)uart_tx_abort(sh_uart->ctrl_blk->dev);
 #endif
 	}
 
@@ -229,6 +306,8 @@ static void irq_write(const struct shell_uart *sh_uart, const void *data,
 	if (atomic_set(&sh_uart->ctrl_blk->tx_busy, 1) == 0) {
 #ifdef CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN
 		uart_irq_tx_enable(sh_uart->ctrl_blk->dev);
+#elif defined(CONFIG_SHELL_BACKEND_SERIAL_ASYNC)
+		async_tx_start(sh_uart);
 #endif
 	}
 }
@@ -239,7 +318,8 @@ static int write(const struct shell_transport *transport,
 	const struct shell_uart *sh_uart = (struct shell_uart *)transport->ctx;
 	const uint8_t *data8 = (const uint8_t *)data;
 
-	if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN) &&
+	if ((IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN) ||
+	     IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_ASYNC)) &&
 		!sh_uart->ctrl_blk->blocking_tx) {
 		irq_write(sh_uart, data, length, cnt);
 	} else {
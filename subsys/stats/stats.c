@@ -15,6 +15,11 @@
 /* The global list of registered statistic groups. */
 static struct stats_hdr *stats_list;
 
+#ifdef CONFIG_STATS_SNAPSHOT
+/* Number of registrations, invalidates the cached snapshot schema. */
+uint32_t stats_register_cnt;
+#endif
+
 static const char *
 stats_get_name(const struct stats_hdr *hdr, int idx)
 {
@@ -238,6 +243,10 @@ stats_register(const char *name, struct stats_hdr *hdr)
 	}
 	hdr->s_name = name;
 
+#ifdef CONFIG_STATS_SNAPSHOT
+	stats_register_cnt++;
+#endif
+
 	return 0;
 }
 
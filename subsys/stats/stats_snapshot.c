@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <kernel.h>
+#include <sys/crc.h>
+#include <stats/stats.h>
+#include <stats/stats_snapshot.h>
+#include "tinycbor/cbor.h"
+#include "tinycbor/cbor_buf_writer.h"
+
+#ifdef CONFIG_STATS_SNAPSHOT_NET
+#include <net/net_mgmt.h>
+#include <net/net_stats.h>
+#endif
+
+/* Incremented by stats_register(). */
+extern uint32_t stats_register_cnt;
+
+enum walk_mode {
+	WALK_SCHEMA,	/* Hash the schema and count the values */
+	WALK_NAMES,	/* Encode the schema */
+	WALK_FULL,	/* Encode all values */
+	WALK_DELTA,	/* Encode the changed values */
+};
+
+struct walk {
+	enum walk_mode mode;
+	struct stats_snapshot_ctx *ctx;
+	CborEncoder *enc;
+	CborError err;
+	uint32_t hash;
+	uint16_t idx;
+};
+
+static struct {
+	bool valid;
+	uint32_t register_cnt;
+	uint32_t hash;
+	uint16_t cnt;
+} schema_cache;
+
+static void hash_add(struct walk *w, const void *data, size_t len)
+{
+	w->hash = crc32_ieee_update(w->hash, data, len);
+}
+
+/* Starts a group. Returns true if its values are needed. */
+static bool group_begin(struct walk *w, const char *name, uint16_t cnt)
+{
+	switch (w->mode) {
+	case WALK_SCHEMA:
+		hash_add(w, name, strlen(name) + 1);
+		hash_add(w, &cnt, sizeof(cnt));
+		w->idx += cnt;
+		return false;
+	case WALK_NAMES:
+		w->err |= cbor_encode_text_stringz(w->enc, name);
+		w->err |= cbor_encode_uint(w->enc, cnt);
+		return false;
+	default:
+		return true;
+	}
+}
+
+static void value_add(struct walk *w, uint64_t val)
+{
+	uint16_t idx = w->idx++;
+	uint64_t *prev = &w->ctx->values[idx];
+
+	if (w->mode == WALK_FULL) {
+		w->err |= cbor_encode_uint(w->enc, val);
+	} else if (*prev != val) {
+		w->err |= cbor_encode_uint(w->enc, idx);
+		w->err |= cbor_encode_uint(w->enc, val);
+	}
+
+	*prev = val;
+}
+
+static uint64_t stat_get(const struct stats_hdr *hdr, uint16_t off)
+{
+	const uint8_t *ptr = (const uint8_t *)hdr + off;
+
+	switch (hdr->s_size) {
+	case sizeof(uint16_t):
+		return *(const uint16_t *)ptr;
+	case sizeof(uint32_t):
+		return *(const uint32_t *)ptr;
+	default:
+		return *(const uint64_t *)ptr;
+	}
+}
+
+static int name_walk(struct stats_hdr *hdr, void *arg, const char *name,
+		     uint16_t off)
+{
+	struct walk *w = arg;
+
+	if (w->mode == WALK_SCHEMA) {
+		hash_add(w, name, strlen(name) + 1);
+	} else {
+		w->err |= cbor_encode_text_stringz(w->enc, name);
+	}
+
+	return 0;
+}
+
+static int group_walk(struct stats_hdr *hdr, void *arg)
+{
+	struct walk *w = arg;
+
+	if (group_begin(w, hdr->s_name, hdr->s_cnt)) {
+		for (uint16_t i = 0; i < hdr->s_cnt; i++) {
+			value_add(w, stat_get(hdr, sizeof(*hdr) +
+						   i * hdr->s_size));
+		}
+	} else {
+		hash_add(w, &hdr->s_size, sizeof(hdr->s_size));
+		(void)stats_walk(hdr, name_walk, w);
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_STATS_SNAPSHOT_NET
+/* Counters of struct net_stats, in the structure order. The timing
+ * statistics which may follow them are not counters.
+ */
+#define NET_COUNTERS(stats, _fn)					\
+	_fn(stats.processing_error)					\
+	_fn(stats.bytes)						\
+	_fn(stats.ip_errors)						\
+	IF_ENABLED(CONFIG_NET_STATISTICS_IPV6, (_fn(stats.ipv6)))	\
+	IF_ENABLED(CONFIG_NET_STATISTICS_IPV4, (_fn(stats.ipv4)))	\
+	IF_ENABLED(CONFIG_NET_STATISTICS_ICMP, (_fn(stats.icmp)))	\
+	IF_ENABLED(CONFIG_NET_STATISTICS_TCP, (_fn(stats.tcp)))		\
+	IF_ENABLED(CONFIG_NET_STATISTICS_UDP, (_fn(stats.udp)))		\
+	IF_ENABLED(CONFIG_NET_STATISTICS_IPV6_ND, (_fn(stats.ipv6_nd)))	\
+	IF_ENABLED(CONFIG_NET_STATISTICS_MLD, (_fn(stats.ipv6_mld)))
+
+#define NET_COUNTER_CNT(member) + sizeof(member) / sizeof(net_stats_t)
+#define NET_COUNTER_ADD(member) words_add(w, &member, sizeof(member));
+
+static void words_add(struct walk *w, const void *data, size_t size)
+{
+	const net_stats_t *words = data;
+
+	for (size_t i = 0; i < size / sizeof(net_stats_t); i++) {
+		value_add(w, words[i]);
+	}
+}
+
+static uint16_t net_cnt(void)
+{
+	struct net_stats stats;
+
+	return 0 NET_COUNTERS(stats, NET_COUNTER_CNT);
+}
+
+static void net_walk(struct walk *w)
+{
+	struct net_stats stats;
+
+	if (!group_begin(w, "net", net_cnt())) {
+		return;
+	}
+
+	if (net_mgmt(NET_REQUEST_STATS_GET_ALL, NULL, &stats,
+		     sizeof(stats)) != 0) {
+		(void)memset(&stats, 0, sizeof(stats));
+	}
+
+	NET_COUNTERS(stats, NET_COUNTER_ADD)
+}
+#endif /* CONFIG_STATS_SNAPSHOT_NET */
+
+#ifdef CONFIG_STATS_SNAPSHOT_MEM_SLAB
+static uint16_t slab_cnt(void)
+{
+	uint16_t cnt = 0U;
+
+	Z_STRUCT_SECTION_FOREACH(k_mem_slab, slab) {
+		cnt++;
+	}
+
+	return cnt;
+}
+
+static void slab_walk(struct walk *w)
+{
+	if (!group_begin(w, "slab", slab_cnt())) {
+		return;
+	}
+
+	Z_STRUCT_SECTION_FOREACH(k_mem_slab, slab) {
+		value_add(w, slab->num_used);
+	}
+}
+#endif /* CONFIG_STATS_SNAPSHOT_MEM_SLAB */
+
+static void walk(struct walk *w)
+{
+	(void)stats_group_walk(group_walk, w);
+
+#ifdef CONFIG_STATS_SNAPSHOT_NET
+	net_walk(w);
+#endif
+#ifdef CONFIG_STATS_SNAPSHOT_MEM_SLAB
+	slab_walk(w);
+#endif
+}
+
+uint32_t stats_snapshot_schema(uint16_t *cnt)
+{
+	struct walk w = {
+		.mode = WALK_SCHEMA,
+	};
+
+	if (!schema_cache.valid ||
+	    schema_cache.register_cnt != stats_register_cnt) {
+		schema_cache.register_cnt = stats_register_cnt;
+		walk(&w);
+		schema_cache.hash = w.hash;
+		schema_cache.cnt = w.idx;
+		schema_cache.valid = true;
+	}
+
+	if (cnt != NULL) {
+		*cnt = schema_cache.cnt;
+	}
+
+	return schema_cache.hash;
+}
+
+static int encoded_len(struct cbor_buf_writer *writer, uint8_t *buf,
+		       CborError err)
+{
+	if (err != CborNoError) {
+		return -ENOMEM;
+	}
+
+	return cbor_buf_writer_buffer_size(writer, buf);
+}
+
+static int group_names_walk(struct stats_hdr *hdr, void *arg)
+{
+	struct walk *w = arg;
+	CborEncoder *enc = w->enc;
+	CborEncoder group;
+
+	w->err |= cbor_encoder_create_array(enc, &group, CborIndefiniteLength);
+	w->enc = &group;
+	(void)group_begin(w, hdr->s_name, hdr->s_cnt);
+	(void)stats_walk(hdr, name_walk, w);
+	w->enc = enc;
+	w->err |= cbor_encoder_close_container(enc, &group);
+
+	return 0;
+}
+
+static void extra_names(struct walk *w, const char *name, uint16_t cnt)
+{
+	CborEncoder *enc = w->enc;
+	CborEncoder group;
+
+	w->err |= cbor_encoder_create_array(enc, &group, 2);
+	w->enc = &group;
+	(void)group_begin(w, name, cnt);
+	w->enc = enc;
+	w->err |= cbor_encoder_close_container(enc, &group);
+}
+
+int stats_snapshot_schema_encode(uint8_t *buf, size_t size)
+{
+	struct cbor_buf_writer writer;
+	CborEncoder enc, map, groups;
+	struct walk w = {
+		.mode = WALK_NAMES,
+		.enc = &groups,
+	};
+
+	cbor_buf_writer_init(&writer, buf, size);
+	cbor_encoder_init(&enc, &writer.enc, 0);
+
+	w.err |= cbor_encoder_create_map(&enc, &map, 2);
+	w.err |= cbor_encode_uint(&map, STATS_SNAPSHOT_KEY_SCHEMA);
+	w.err |= cbor_encode_uint(&map, stats_snapshot_schema(NULL));
+	w.err |= cbor_encode_uint(&map, STATS_SNAPSHOT_KEY_GROUPS);
+	w.err |= cbor_encoder_create_array(&map, &groups,
+					   CborIndefiniteLength);
+
+	(void)stats_group_walk(group_names_walk, &w);
+
+#ifdef CONFIG_STATS_SNAPSHOT_NET
+	extra_names(&w, "net", net_cnt());
+#endif
+#ifdef CONFIG_STATS_SNAPSHOT_MEM_SLAB
+	extra_names(&w, "slab", slab_cnt());
+#endif
+
+	w.err |= cbor_encoder_close_container(&map, &groups);
+	w.err |= cbor_encoder_close_container(&enc, &map);
+
+	return encoded_len(&writer, buf, w.err);
+}
+
+int stats_snapshot_encode(struct stats_snapshot_ctx *ctx, bool delta,
+			  uint8_t *buf, size_t size)
+{
+	struct cbor_buf_writer writer;
+	CborEncoder enc, map, values;
+	struct walk w = {
+		.ctx = ctx,
+		.enc = &values,
+	};
+	uint32_t schema;
+	uint16_t cnt;
+	int len;
+
+	schema = stats_snapshot_schema(&cnt);
+	if (cnt > ctx->max_values) {
+		ctx->valid = false;
+		return -E2BIG;
+	}
+
+	delta = delta && ctx->valid && (ctx->schema == schema) &&
+		(ctx->cnt == cnt);
+	w.mode = delta ? WALK_DELTA : WALK_FULL;
+
+	cbor_buf_writer_init(&writer, buf, size);
+	cbor_encoder_init(&enc, &writer.enc, 0);
+
+	w.err |= cbor_encoder_create_map(&enc, &map, delta ? 4 : 3);
+	w.err |= cbor_encode_uint(&map, STATS_SNAPSHOT_KEY_SCHEMA);
+	w.err |= cbor_encode_uint(&map, schema);
+	w.err |= cbor_encode_uint(&map, STATS_SNAPSHOT_KEY_SEQ);
+	w.err |= cbor_encode_uint(&map, ctx->seq + 1U);
+
+	if (delta) {
+		w.err |= cbor_encode_uint(&map, STATS_SNAPSHOT_KEY_BASE);
+		w.err |= cbor_encode_uint(&map, ctx->seq);
+		w.err |= cbor_encode_uint(&map, STATS_SNAPSHOT_KEY_DELTA);
+		w.err |= cbor_encoder_create_array(&map, &values,
+						   CborIndefiniteLength);
+	} else {
+		w.err |= cbor_encode_uint(&map, STATS_SNAPSHOT_KEY_VALUES);
+		w.err |= cbor_encoder_create_array(&map, &values, cnt);
+	}
+
+	walk(&w);
+
+	w.err |= cbor_encoder_close_container(&map, &values);
+	w.err |= cbor_encoder_close_container(&enc, &map);
+
+	len = encoded_len(&writer, buf, w.err);
+
+	/* The values of a failed snapshot are not a base for a delta. */
+	ctx->valid = (len >= 0);
+	ctx->schema = schema;
+	ctx->cnt = cnt;
+	ctx->seq++;
+
+	return len;
+}
@@ -12,6 +12,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME, CONFIG_STREAM_FLASH_LOG_LEVEL);
 
 #include <zephyr/types.h>
 #include <string.h>
+#include <kernel.h>
 #include <drivers/flash.h>
 
 #include <storage/stream_flash.h>
@@ -49,6 +50,43 @@ int stream_flash_erase_page(struct stream_flash_ctx *ctx, off_t off)
 
 #endif /* CONFIG_STREAM_FLASH_ERASE */
 
+static int flash_write_buf(struct stream_flash_ctx *ctx, const uint8_t *buf,
+			   size_t len, size_t write_addr)
+{
+	int rc;
+
+	flash_write_protection_set(ctx->fdev, false);
+	rc = flash_write(ctx->fdev, write_addr, buf, len);
+	flash_write_protection_set(ctx->fdev, true);
+
+	if (rc != 0) {
+		LOG_ERR("flash_write error %d offset=0x%08zx", rc,
+			write_addr);
+	}
+
+	return rc;
+}
+
+static int flash_read_back(struct stream_flash_ctx *ctx, uint8_t *buf,
+			   size_t len, size_t write_addr)
+{
+	int rc;
+
+	/* Invert to ensure that caller is able to discover a faulty
+	 * flash_read() even if no error code is returned.
+	 */
+	for (int i = 0; i < len; i++) {
+		buf[i] = ~buf[i];
+	}
+
+	rc = flash_read(ctx->fdev, write_addr, buf, len);
+	if (rc != 0) {
+		LOG_ERR("flash read failed: %d", rc);
+	}
+
+	return rc;
+}
+
 static int flash_sync(struct stream_flash_ctx *ctx)
 {
 	int rc = 0;
@@ -69,28 +107,14 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 		}
 	}
 
-	flash_write_protection_set(ctx->fdev, false);
-	rc = flash_write(ctx->fdev, write_addr, ctx->buf, ctx->buf_bytes);
-	flash_write_protection_set(ctx->fdev, true);
-
+	rc = flash_write_buf(ctx, ctx->buf, ctx->buf_bytes, write_addr);
 	if (rc != 0) {
-		LOG_ERR("flash_write error %d offset=0x%08zx", rc,
-			write_addr);
 		return rc;
 	}
 
 	if (ctx->callback) {
-		/* Invert to ensure that caller is able to discover a faulty
-		 * flash_read() even if no error code is returned.
-		 */
-		for (int i = 0; i < ctx->buf_bytes; i++) {
-			ctx->buf[i] = ~ctx->buf[i];
-		}
-
-		rc = flash_read(ctx->fdev, write_addr, ctx->buf,
-				ctx->buf_bytes);
+		rc = flash_read_back(ctx, ctx->buf, ctx->buf_bytes, write_addr);
 		if (rc != 0) {
-			LOG_ERR("flash read failed: %d", rc);
 			return rc;
 		}
 
@@ -103,9 +127,372 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 	ctx->bytes_written += ctx->buf_bytes;
 	ctx->buf_bytes = 0U;
 
+	if (ctx->progress) {
+		ctx->progress(ctx, ctx->bytes_written);
+	}
+
+	return rc;
+}
+
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+
+/* Contexts with a buffer to write, in submission order */
+static K_FIFO_DEFINE(stream_flash_fifo);
+
+#ifdef CONFIG_STREAM_FLASH_ERASE
+
+/* Context erased ahead when the thread has no buffer to write */
+static struct stream_flash_ctx *ahead_ctx;
+static K_MUTEX_DEFINE(ahead_lock);
+
+#define ERASE_AHEAD_PERIOD K_MSEC(CONFIG_STREAM_FLASH_ASYNC_ERASE_AHEAD_PERIOD)
+
+/* Erase the pages from the end of the erased area up to end. */
+static int async_erase_to(struct stream_flash_ctx *ctx, off_t end)
+{
+	struct stream_flash_async *async = &ctx->async;
+	struct flash_pages_info page;
+	int rc;
+
+	while (async->erase_end < end) {
+		rc = flash_get_page_info_by_offs(ctx->fdev, async->erase_end,
+						 &page);
+		if (rc != 0) {
+			return rc;
+		}
+
+		rc = stream_flash_erase_page(ctx, async->erase_end);
+		if (rc != 0) {
+			return rc;
+		}
+
+		async->erase_end = page.start_offset + page.size;
+	}
+
+	return 0;
+}
+
+/* Erase the next page ahead, return 1 if a page was erased. */
+static int async_erase_ahead_step(struct stream_flash_ctx *ctx)
+{
+	struct stream_flash_async *async = &ctx->async;
+	off_t area_end = ctx->offset + ctx->available;
+	struct flash_pages_info page;
+	int rc;
+
+	if (async->erase_end >= async->ahead_end) {
+		return 0;
+	}
+
+	rc = flash_get_page_info_by_offs(ctx->fdev, async->erase_end, &page);
+	if (rc != 0) {
+		return rc;
+	}
+
+	/* Never erase data following the write area */
+	if (page.start_offset + page.size > area_end) {
+		return 0;
+	}
+
+	rc = async_erase_to(ctx, page.start_offset + page.size);
+
+	return (rc == 0) ? 1 : rc;
+}
+
+static void async_erase_ahead(void)
+{
+	struct stream_flash_ctx *ctx;
+	int rc;
+
+	k_mutex_lock(&ahead_lock, K_FOREVER);
+
+	ctx = ahead_ctx;
+	if (ctx && (k_sem_take(&ctx->async.idle, K_NO_WAIT) == 0)) {
+		rc = async_erase_ahead_step(ctx);
+		if (rc < 0) {
+			ctx->async.rc = rc;
+		}
+
+		if (rc <= 0) {
+			ahead_ctx = NULL;
+		}
+
+		k_sem_give(&ctx->async.idle);
+	}
+
+	k_mutex_unlock(&ahead_lock);
+}
+
+/* Unlocked, async_erase_ahead() checks again */
+static bool async_erase_ahead_pending(void)
+{
+	return ahead_ctx != NULL;
+}
+
+static void async_erase_ahead_start(struct stream_flash_ctx *ctx)
+{
+	struct stream_flash_async *async = &ctx->async;
+	struct flash_pages_info page;
+
+	if ((async->erase_ahead == 0) ||
+	    flash_get_page_info_by_offs(ctx->fdev, async->erase_end - 1,
+					&page)) {
+		return;
+	}
+
+	async->ahead_end = MIN(async->addr + async->len +
+			       async->erase_ahead * page.size,
+			       ctx->offset + ctx->available);
+
+	k_mutex_lock(&ahead_lock, K_FOREVER);
+	ahead_ctx = ctx;
+	k_mutex_unlock(&ahead_lock);
+}
+
+static void async_erase_ahead_stop(struct stream_flash_ctx *ctx)
+{
+	k_mutex_lock(&ahead_lock, K_FOREVER);
+	if (ahead_ctx == ctx) {
+		ahead_ctx = NULL;
+	}
+	k_mutex_unlock(&ahead_lock);
+}
+
+#else
+
+#define ERASE_AHEAD_PERIOD K_NO_WAIT
+
+static inline int async_erase_to(struct stream_flash_ctx *ctx, off_t end)
+{
+	return 0;
+}
+
+static inline void async_erase_ahead(void)
+{
+}
+
+static inline bool async_erase_ahead_pending(void)
+{
+	return false;
+}
+
+static inline void async_erase_ahead_start(struct stream_flash_ctx *ctx)
+{
+}
+
+static inline void async_erase_ahead_stop(struct stream_flash_ctx *ctx)
+{
+}
+
+#endif /* CONFIG_STREAM_FLASH_ERASE */
+
+/* Erase, write and verify a buffer, in the stream flash thread. */
+static int async_write(struct stream_flash_ctx *ctx)
+{
+	struct stream_flash_async *async = &ctx->async;
+	int rc;
+
+	rc = async_erase_to(ctx, async->addr + async->len);
+	if (rc != 0) {
+		LOG_ERR("erase err %d offset=0x%08zx", rc, async->addr);
+		return rc;
+	}
+
+	rc = flash_write_buf(ctx, async->buf, async->len, async->addr);
+	if (rc != 0) {
+		return rc;
+	}
+
+	if (ctx->callback) {
+		rc = flash_read_back(ctx, async->buf, async->len, async->addr);
+		if (rc != 0) {
+			return rc;
+		}
+
+		rc = ctx->callback(async->buf, async->len, async->addr);
+		if (rc != 0) {
+			LOG_ERR("callback failed: %d", rc);
+			return rc;
+		}
+	}
+
+	ctx->bytes_written += async->len;
+
+	if (ctx->progress) {
+		ctx->progress(ctx, ctx->bytes_written);
+	}
+
+	async_erase_ahead_start(ctx);
+
+	return 0;
+}
+
+static void stream_flash_thread(void *p1, void *p2, void *p3)
+{
+	struct stream_flash_ctx *ctx;
+	k_timeout_t timeout;
+	void *node;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		/* Erase ahead only when there is no buffer to write, one page
+		 * per period so that lower priority threads also run.
+		 */
+		timeout = async_erase_ahead_pending() ? ERASE_AHEAD_PERIOD :
+							K_FOREVER;
+		node = k_fifo_get(&stream_flash_fifo, timeout);
+		if (node == NULL) {
+			async_erase_ahead();
+			continue;
+		}
+
+		ctx = CONTAINER_OF(node, struct stream_flash_ctx,
+				   async.fifo_reserved);
+		ctx->async.rc = async_write(ctx);
+		k_sem_give(&ctx->async.idle);
+	}
+}
+
+K_THREAD_DEFINE(stream_flash_tid, CONFIG_STREAM_FLASH_ASYNC_STACK_SIZE,
+		stream_flash_thread, NULL, NULL, NULL,
+		CONFIG_STREAM_FLASH_ASYNC_THREAD_PRIO, 0, 0);
+
+/* Hand the filled half of the buffer to the thread, fill the other one. */
+static int async_submit(struct stream_flash_ctx *ctx)
+{
+	struct stream_flash_async *async = &ctx->async;
+	uint8_t *buf;
+	int rc;
+
+	k_sem_take(&async->idle, K_FOREVER);
+
+	rc = async->rc;
+	if (rc != 0) {
+		k_sem_give(&async->idle);
+		return rc;
+	}
+
+	buf = async->buf;
+	async->buf = ctx->buf;
+	async->len = ctx->buf_bytes;
+	async->addr = ctx->offset + async->queued;
+	async->queued += ctx->buf_bytes;
+
+	ctx->buf = buf;
+	ctx->buf_bytes = 0U;
+
+	k_fifo_put(&stream_flash_fifo, &async->fifo_reserved);
+
+	return 0;
+}
+
+/* Wait for the thread to write the buffer handed to it. */
+static int async_wait(struct stream_flash_ctx *ctx)
+{
+	int rc;
+
+	k_sem_take(&ctx->async.idle, K_FOREVER);
+	rc = ctx->async.rc;
+	k_sem_give(&ctx->async.idle);
+
 	return rc;
 }
 
+static int async_flush(struct stream_flash_ctx *ctx)
+{
+	const struct flash_parameters *params;
+	size_t fill_length = 0;
+	int rc = 0;
+
+	if (ctx->buf_bytes > 0) {
+		fill_length = flash_get_write_block_size(ctx->fdev);
+		if (ctx->buf_bytes % fill_length) {
+			/* The page may still be being erased, do not read it
+			 * to get the erased byte-value.
+			 */
+			params = flash_get_parameters(ctx->fdev);
+			fill_length -= ctx->buf_bytes % fill_length;
+			memset(ctx->buf + ctx->buf_bytes, params->erase_value,
+			       fill_length);
+			ctx->buf_bytes += fill_length;
+		} else {
+			fill_length = 0;
+		}
+
+		rc = async_submit(ctx);
+	}
+
+	if (rc == 0) {
+		rc = async_wait(ctx);
+	}
+
+	async_erase_ahead_stop(ctx);
+
+	if (rc == 0) {
+		ctx->bytes_written -= fill_length;
+		ctx->async.queued -= fill_length;
+	}
+
+	return rc;
+}
+
+int stream_flash_async_enable(struct stream_flash_ctx *ctx,
+			      uint32_t erase_ahead)
+{
+	struct stream_flash_async *async;
+	size_t half;
+
+	if (!ctx) {
+		return -EFAULT;
+	}
+
+	async = &ctx->async;
+	half = ctx->buf_len / 2;
+
+	if (async->enabled || (ctx->buf_bytes != 0) ||
+	    (ctx->bytes_written != 0) || (half == 0) ||
+	    (half % flash_get_write_block_size(ctx->fdev))) {
+		return -EINVAL;
+	}
+
+	if (!IS_ENABLED(CONFIG_STREAM_FLASH_ERASE) && (erase_ahead != 0)) {
+		return -ENOTSUP;
+	}
+
+	ctx->buf_len = half;
+	async->buf = ctx->buf + half;
+	async->len = 0;
+	async->addr = ctx->offset;
+	async->queued = 0;
+	async->rc = 0;
+	k_sem_init(&async->idle, 1, 1);
+#ifdef CONFIG_STREAM_FLASH_ERASE
+	async->erase_ahead = erase_ahead;
+	async->erase_end = ctx->offset;
+	async->ahead_end = ctx->offset;
+#endif
+	async->enabled = true;
+
+	return 0;
+}
+
+#endif /* CONFIG_STREAM_FLASH_ASYNC */
+
+/* Number of bytes written or being written to flash */
+static size_t bytes_queued(struct stream_flash_ctx *ctx)
+{
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	if (ctx->async.enabled) {
+		return ctx->async.queued;
+	}
+#endif
+
+	return ctx->bytes_written;
+}
+
 int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *data,
 				size_t len, bool flush)
 {
@@ -119,7 +506,7 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 		return -EFAULT;
 	}
 
-	if (ctx->bytes_written + ctx->buf_bytes + len > ctx->available) {
+	if (bytes_queued(ctx) + ctx->buf_bytes + len > ctx->available) {
 		return -ENOMEM;
 	}
 
@@ -129,7 +516,14 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 		       buf_empty_bytes);
 
 		ctx->buf_bytes = ctx->buf_len;
-		rc = flash_sync(ctx);
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+		if (ctx->async.enabled) {
+			rc = async_submit(ctx);
+		} else
+#endif
+		{
+			rc = flash_sync(ctx);
+		}
 
 		if (rc != 0) {
 			return rc;
@@ -145,6 +539,12 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 		ctx->buf_bytes += len - processed;
 	}
 
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	if (ctx->async.enabled) {
+		return flush ? async_flush(ctx) : 0;
+	}
+#endif
+
 	if (flush && ctx->buf_bytes > 0) {
 		fill_length = flash_get_write_block_size(ctx->fdev);
 		if (ctx->buf_bytes % fill_length) {
@@ -181,6 +581,12 @@ size_t stream_flash_bytes_written(struct stream_flash_ctx *ctx)
 	return ctx->bytes_written;
 }
 
+void stream_flash_progress_cb_set(struct stream_flash_ctx *ctx,
+				  stream_flash_progress_callback_t cb)
+{
+	ctx->progress = cb;
+}
+
 struct _inspect_flash {
 	size_t buf_len;
 	size_t total_size;
@@ -243,10 +649,16 @@ int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
 	ctx->available = (size == 0 ? inspect_flash_ctx.total_size - offset :
 				      size);
 	ctx->callback = cb;
+	ctx->progress = NULL;
 
 #ifdef CONFIG_STREAM_FLASH_ERASE
 	ctx->last_erased_page_start_offset = -1;
 #endif
 
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	async_erase_ahead_stop(ctx);
+	ctx->async.enabled = false;
+#endif
+
 	return 0;
 }
@@ -9,6 +9,7 @@
 
 #include <stdbool.h>
 #include <zephyr/types.h>
+#include <tracing/tracing_format.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -104,6 +105,33 @@ int tracing_buffer_get_finish(uint32_t size);
  */
 uint32_t tracing_buffer_get(uint8_t *data, uint32_t size);
 
+/**
+ * @brief Store a tracing packet as a record in the buffer of the current CPU.
+ *
+ * Only available with CONFIG_TRACING_PER_CPU_BUFFERS. The record is
+ * timestamped so that the buffers of all CPUs can be merged.
+ *
+ * @param tracing_data_array Data making up the packet.
+ * @param count Number of items in @a tracing_data_array.
+ *
+ * @return true if the record was stored, false if it was dropped.
+ */
+bool tracing_buffer_record_put(tracing_data_t *tracing_data_array,
+			       uint32_t count);
+
+/**
+ * @brief Remove the oldest record from the buffers of all CPUs.
+ *
+ * Only available with CONFIG_TRACING_PER_CPU_BUFFERS.
+ *
+ * @param data Address of the output buffer.
+ * @param size Size of the output buffer, at least
+ *             CONFIG_TRACING_PACKET_MAX_SIZE bytes.
+ *
+ * @return Length of the record, 0 if there are no records.
+ */
+uint32_t tracing_buffer_record_get(uint8_t *data, uint32_t size);
+
 /**
  * @brief Get buffer from tracing command buffer.
  *
@@ -14,9 +14,16 @@
 extern "C" {
 #endif
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+/* Per CPU buffers are lock-free. */
+#define TRACING_LOCK()		{
+
+#define TRACING_UNLOCK()	}
+#else
 #define TRACING_LOCK()		{ int key; key = irq_lock()
 
 #define TRACING_UNLOCK()	{ irq_unlock(key); } }
+#endif
 
 /**
  * @brief Check tracing enabled or not.
@@ -60,6 +67,16 @@ void tracing_trigger_output(bool before_put_is_empty);
  */
 bool is_tracing_thread(void);
 
+/**
+ * @brief Output all buffered tracing data through the backend.
+ *
+ * Only available with CONFIG_TRACING_PER_CPU_BUFFERS. With
+ * CONFIG_TRACING_OVERWRITE the buffers are not drained in the background
+ * and keep the latest events, which can be dumped with this function, e.g.
+ * from an error handler. Tracing is suspended while the buffers are dumped.
+ */
+void tracing_dump(void);
+
 #ifdef __cplusplus
 }
 #endif
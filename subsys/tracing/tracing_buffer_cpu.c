@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Tracing buffers, one lock-free ring per CPU. Each record holds a cycle
+ * counter timestamp followed by one tracing packet, the records of all CPUs
+ * are merged by timestamp when they are removed.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <sys/mpsc_ring.h>
+#include <sys/__assert.h>
+#include <tracing_buffer.h>
+
+#define BUF_SIZE CONFIG_TRACING_PER_CPU_BUFFER_SIZE
+
+BUILD_ASSERT((BUF_SIZE & (BUF_SIZE - 1)) == 0,
+	     "Per CPU tracing buffer size must be a power of two");
+
+static uint8_t __aligned(sizeof(uint32_t))
+		tracing_buffers[CONFIG_MP_NUM_CPUS][BUF_SIZE];
+static struct mpsc_ring tracing_rings[CONFIG_MP_NUM_CPUS];
+static uint8_t tracing_cmd_buffer[CONFIG_TRACING_CMD_BUFFER_SIZE];
+
+uint32_t tracing_cmd_buffer_alloc(uint8_t **data)
+{
+	*data = &tracing_cmd_buffer[0];
+
+	return sizeof(tracing_cmd_buffer);
+}
+
+void tracing_buffer_init(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(tracing_rings); i++) {
+		mpsc_ring_init(&tracing_rings[i], tracing_buffers[i],
+			       BUF_SIZE);
+	}
+}
+
+bool tracing_buffer_is_empty(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(tracing_rings); i++) {
+		if (!mpsc_ring_is_empty(&tracing_rings[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static inline struct mpsc_ring *curr_ring(void)
+{
+#ifdef CONFIG_SMP
+	/* The context may migrate after reading the ID, which is harmless
+	 * since the rings accept producers from any CPU.
+	 */
+	return &tracing_rings[arch_curr_cpu()->id];
+#else
+	return &tracing_rings[0];
+#endif
+}
+
+bool tracing_buffer_record_put(tracing_data_t *tracing_data_array,
+			       uint32_t count)
+{
+	struct mpsc_ring *ring = curr_ring();
+	struct mpsc_ring_entry entry;
+	uint32_t timestamp = k_cycle_get_32();
+	uint32_t length = 0U;
+	uint32_t offset, dropped;
+
+	for (uint32_t i = 0; i < count; i++) {
+		length += tracing_data_array[i].length;
+	}
+
+	if (length > CONFIG_TRACING_PACKET_MAX_SIZE) {
+		return false;
+	}
+
+	if (mpsc_ring_claim(ring, sizeof(timestamp) + length,
+			    IS_ENABLED(CONFIG_TRACING_OVERWRITE),
+			    &dropped, &entry) < 0) {
+		return false;
+	}
+
+	mpsc_ring_write(ring, &entry, 0, &timestamp, sizeof(timestamp));
+	offset = sizeof(timestamp);
+
+	for (uint32_t i = 0; i < count; i++) {
+		mpsc_ring_write(ring, &entry, offset,
+				tracing_data_array[i].data,
+				tracing_data_array[i].length);
+		offset += tracing_data_array[i].length;
+	}
+
+	mpsc_ring_commit(ring, &entry);
+
+	return true;
+}
+
+uint32_t tracing_buffer_record_get(uint8_t *data, uint32_t size)
+{
+	struct mpsc_ring_entry entry;
+	struct mpsc_ring *oldest;
+	uint32_t timestamp, oldest_ts = 0U;
+
+	for (;;) {
+		oldest = NULL;
+
+		/* Merge the rings, taking the oldest record first. */
+		for (int i = 0; i < ARRAY_SIZE(tracing_rings); i++) {
+			if (!mpsc_ring_peek(&tracing_rings[i], &entry)) {
+				continue;
+			}
+
+			mpsc_ring_read(&tracing_rings[i], &entry, 0,
+				       &timestamp, sizeof(timestamp));
+
+			if (oldest == NULL ||
+			    (int32_t)(timestamp - oldest_ts) < 0) {
+				oldest = &tracing_rings[i];
+				oldest_ts = timestamp;
+			}
+		}
+
+		if (oldest == NULL) {
+			return 0;
+		}
+
+		/* The record may have been overwritten since it was peeked.
+		 * The copy is only valid if it can be consumed afterwards.
+		 */
+		if (!mpsc_ring_peek(oldest, &entry) ||
+		    entry.len < sizeof(timestamp)) {
+			continue;
+		}
+
+		mpsc_ring_read(oldest, &entry, sizeof(timestamp), data, size);
+
+		if (mpsc_ring_consume(oldest, &entry)) {
+			break;
+		}
+	}
+
+	__ASSERT_NO_MSG(entry.len - sizeof(timestamp) <= size);
+
+	return MIN(entry.len - sizeof(timestamp), size);
+}
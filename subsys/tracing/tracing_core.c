@@ -45,6 +45,24 @@ static K_SEM_DEFINE(tracing_thread_sem, 0, 1);
 static K_THREAD_STACK_DEFINE(tracing_thread_stack,
 			CONFIG_TRACING_THREAD_STACK_SIZE);
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
+{
+	uint8_t packet[CONFIG_TRACING_PACKET_MAX_SIZE];
+	uint32_t length;
+
+	tracing_thread_tid = k_current_get();
+
+	while (true) {
+		length = tracing_buffer_record_get(packet, sizeof(packet));
+		if (length == 0) {
+			k_sem_take(&tracing_thread_sem, K_FOREVER);
+		} else {
+			tracing_buffer_handle(packet, length);
+		}
+	}
+}
+#else
 static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 {
 	uint8_t *transferring_buf;
@@ -68,6 +86,7 @@ static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 		}
 	}
 }
+#endif
 
 static void tracing_thread_timer_expiry_fn(struct k_timer *timer)
 {
@@ -116,6 +135,11 @@ SYS_INIT(tracing_init, APPLICATION, 0);
 #ifdef CONFIG_TRACING_ASYNC
 void tracing_trigger_output(bool before_put_is_empty)
 {
+	/* In overwrite mode the buffers are only output by tracing_dump(). */
+	if (IS_ENABLED(CONFIG_TRACING_OVERWRITE)) {
+		return;
+	}
+
 	if (before_put_is_empty) {
 		k_timer_start(&tracing_thread_timer,
 			      K_MSEC(CONFIG_TRACING_THREAD_WAIT_THRESHOLD),
@@ -152,3 +176,26 @@ void tracing_packet_drop_handle(void)
 {
 	atomic_inc(&tracing_packet_drop_num);
 }
+
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+void tracing_dump(void)
+{
+	uint8_t packet[CONFIG_TRACING_PACKET_MAX_SIZE];
+	bool enabled = is_tracing_enabled();
+	uint32_t length;
+
+	/* Events caused by the backend output are not recorded, otherwise
+	 * the dump could go on forever in overwrite mode.
+	 */
+	tracing_set_state(TRACING_DISABLE);
+
+	while ((length = tracing_buffer_record_get(packet,
+						   sizeof(packet))) > 0) {
+		tracing_buffer_handle(packet, length);
+	}
+
+	if (enabled) {
+		tracing_set_state(TRACING_ENABLE);
+	}
+}
+#endif
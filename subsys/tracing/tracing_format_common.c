@@ -9,6 +9,59 @@
 #include <tracing_buffer.h>
 #include <tracing_format_common.h>
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+/* Packets are stored as records, strings are formatted on the stack first.
+ */
+struct str_buf {
+	tracing_ctx_t ctx;
+	uint8_t data[CONFIG_TRACING_PACKET_MAX_SIZE];
+};
+
+static int str_put(int c, void *ctx)
+{
+	struct str_buf *str_buf = (struct str_buf *)ctx;
+
+	if (str_buf->ctx.length < sizeof(str_buf->data)) {
+		str_buf->data[str_buf->ctx.length++] = (uint8_t)c;
+	} else {
+		str_buf->ctx.status = -1;
+	}
+
+	return 0;
+}
+
+bool tracing_format_string_put(const char *str, va_list args)
+{
+	struct str_buf str_buf = {0};
+	tracing_data_t data;
+
+	(void)cbvprintf(str_put, (void *)&str_buf, str, args);
+
+	if (str_buf.ctx.status != 0) {
+		return false;
+	}
+
+	data.data = str_buf.data;
+	data.length = str_buf.ctx.length;
+
+	return tracing_buffer_record_put(&data, 1);
+}
+
+bool tracing_format_raw_data_put(uint8_t *data, uint32_t size)
+{
+	tracing_data_t tracing_data = {
+		.data = data,
+		.length = size,
+	};
+
+	return tracing_buffer_record_put(&tracing_data, 1);
+}
+
+bool tracing_format_data_put(tracing_data_t *tracing_data_array, uint32_t count)
+{
+	return tracing_buffer_record_put(tracing_data_array, count);
+}
+#else
 static int str_put(int c, void *ctx)
 {
 	tracing_ctx_t *str_ctx = (tracing_ctx_t *)ctx;
@@ -83,3 +136,4 @@ bool tracing_format_data_put(tracing_data_t *tracing_data_array, uint32_t count)
 	tracing_buffer_put_finish(total_size);
 	return true;
 }
+#endif
@@ -122,7 +122,7 @@ static uint8_t __aligned(4) page[BLOCK_SIZE + CONFIG_MASS_STORAGE_BULK_EP_MPS];
 /* Initialized during mass_storage_init() */
 static uint32_t memory_size;
 static uint32_t block_count;
-static const char *disk_pdrv = CONFIG_MASS_STORAGE_DISK_NAME;
+static struct disk_info *disk;
 
 #define MSD_OUT_EP_IDX			0
 #define MSD_IN_EP_IDX			1
@@ -637,7 +637,7 @@ static void memoryVerify(uint8_t *buf, uint16_t size)
 	/* beginning of a new block -> load a whole block in RAM */
 	if (!(addr % BLOCK_SIZE)) {
 		LOG_DBG("Disk READ sector %d", addr/BLOCK_SIZE);
-		if (disk_access_read(disk_pdrv, page, addr/BLOCK_SIZE, 1)) {
+		if (disk_access_di_read(disk, page, addr/BLOCK_SIZE, 1)) {
 			LOG_ERR("---- Disk Read Error %d", addr/BLOCK_SIZE);
 		}
 	}
@@ -679,7 +679,7 @@ static void memoryWrite(uint8_t *buf, uint16_t size)
 
 	/* if the array is filled, write it in memory */
 	if ((addr % BLOCK_SIZE) + size >= BLOCK_SIZE) {
-		if (!(disk_access_status(disk_pdrv) &
+		if (!(disk_access_di_status(disk) &
 					DISK_STATUS_WR_PROTECT)) {
 			LOG_DBG("Disk WRITE Qd %d", (addr/BLOCK_SIZE));
 			thread_op = THREAD_OP_WRITE_QUEUED;  /* write_queued */
@@ -913,7 +913,7 @@ static void mass_thread_main(int arg1, int unused)
 
 		switch (thread_op) {
 		case THREAD_OP_READ_QUEUED:
-			if (disk_access_read(disk_pdrv,
+			if (disk_access_di_read(disk,
 						page, (addr/BLOCK_SIZE), 1)) {
 				LOG_ERR("!! Disk Read Error %d !",
 					addr/BLOCK_SIZE);
@@ -922,7 +922,7 @@ static void mass_thread_main(int arg1, int unused)
 			thread_memory_read_done();
 			break;
 		case THREAD_OP_WRITE_QUEUED:
-			if (disk_access_write(disk_pdrv,
+			if (disk_access_di_write(disk,
 						page, (addr/BLOCK_SIZE), 1)) {
 				LOG_ERR("!!!!! Disk Write Error %d !!!!!",
 					addr/BLOCK_SIZE);
@@ -952,18 +952,24 @@ static int mass_storage_init(const struct device *dev)
 
 	ARG_UNUSED(dev);
 
-	if (disk_access_init(disk_pdrv) != 0) {
+	disk = disk_access_get_di(CONFIG_MASS_STORAGE_DISK_NAME);
+	if (disk == NULL) {
+		LOG_ERR("Storage not found - Aborting USB init");
+		return 0;
+	}
+
+	if (disk_access_di_init(disk) != 0) {
 		LOG_ERR("Storage init ERROR !!!! - Aborting USB init");
 		return 0;
 	}
 
-	if (disk_access_ioctl(disk_pdrv,
+	if (disk_access_di_ioctl(disk,
 				DISK_IOCTL_GET_SECTOR_COUNT, &block_count)) {
 		LOG_ERR("Unable to get sector count - Aborting USB init");
 		return 0;
 	}
 
-	if (disk_access_ioctl(disk_pdrv,
+	if (disk_access_di_ioctl(disk,
 				DISK_IOCTL_GET_SECTOR_SIZE, &block_size)) {
 		LOG_ERR("Unable to get sector size - Aborting USB init");
 		return 0;
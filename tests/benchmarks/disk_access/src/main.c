@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the sequential read throughput of the RAM disk through the name
+ * based, handle based, scatter/gather and asynchronous disk access APIs, see
+ * README.rst.
+ */
+
+#include <kernel.h>
+#include <disk/disk_access.h>
+#include <timing/timing.h>
+#include <sys/printk.h>
+
+#define SECTOR_SIZE 512
+#define DISK_SECTORS (CONFIG_DISK_RAM_VOLUME_SIZE * 1024 / SECTOR_SIZE)
+#define REQ_SECTORS CONFIG_BENCHMARK_READ_SECTORS
+#define REQ_CNT (DISK_SECTORS / REQ_SECTORS)
+#define QUEUE_DEPTH CONFIG_BENCHMARK_QUEUE_DEPTH
+
+static uint8_t __aligned(4) bufs[QUEUE_DEPTH][REQ_SECTORS * SECTOR_SIZE];
+
+/* Other disks, registered before the RAM disk is looked up. */
+static const struct disk_operations other_ops;
+static char other_names[CONFIG_BENCHMARK_OTHER_DISKS][sizeof("OTHER00")];
+static struct disk_info other_disks[CONFIG_BENCHMARK_OTHER_DISKS];
+
+static struct disk_access_req reqs[QUEUE_DEPTH];
+static struct disk_access_sg sgs[QUEUE_DEPTH];
+static K_SEM_DEFINE(free_reqs, QUEUE_DEPTH, QUEUE_DEPTH);
+static int async_err;
+
+static struct disk_info *disk;
+
+static void report(const char *api, timing_t *start, timing_t *end)
+{
+	uint64_t ns = timing_cycles_to_ns(timing_cycles_get(start, end));
+	uint32_t bytes = REQ_CNT * REQ_SECTORS * SECTOR_SIZE;
+
+	ns = MAX(ns, 1U);
+	printk("DISK_ACCESS %s: %u B in %u requests, %u us, %u KiB/s, "
+	       "%u ns/request\n",
+	       api, bytes, REQ_CNT, (uint32_t)(ns / NSEC_PER_USEC),
+	       (uint32_t)((uint64_t)bytes * NSEC_PER_SEC / 1024U / ns),
+	       (uint32_t)(ns / REQ_CNT));
+}
+
+static int read_name(void)
+{
+	for (uint32_t i = 0; i < REQ_CNT; i++) {
+		int rc = disk_access_read(CONFIG_DISK_RAM_VOLUME_NAME, bufs[0],
+					  i * REQ_SECTORS, REQ_SECTORS);
+
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+static int read_handle(void)
+{
+	for (uint32_t i = 0; i < REQ_CNT; i++) {
+		int rc = disk_access_di_read(disk, bufs[0], i * REQ_SECTORS,
+					     REQ_SECTORS);
+
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+/* Each request is split over all buffers. */
+static int read_sg(void)
+{
+	struct disk_access_sg sg[QUEUE_DEPTH];
+	uint32_t sector = 0U;
+
+	for (int i = 0; i < QUEUE_DEPTH; i++) {
+		sg[i].buf = bufs[i];
+		sg[i].num_sector = REQ_SECTORS / QUEUE_DEPTH +
+				   ((i < REQ_SECTORS % QUEUE_DEPTH) ? 1 : 0);
+	}
+
+	for (uint32_t i = 0; i < REQ_CNT; i++) {
+		int rc = disk_access_di_readv(disk, sector, sg, QUEUE_DEPTH);
+
+		if (rc != 0) {
+			return rc;
+		}
+
+		sector += REQ_SECTORS;
+	}
+
+	return 0;
+}
+
+static void read_done(struct disk_access_req *req, int result)
+{
+	if (result != 0) {
+		async_err = result;
+	}
+
+	k_sem_give(&free_reqs);
+}
+
+static int read_async(void)
+{
+	async_err = 0;
+
+	for (uint32_t i = 0; i < REQ_CNT; i++) {
+		struct disk_access_req *req = &reqs[i % QUEUE_DEPTH];
+		int rc;
+
+		/* Requests complete in order, the one freed is the one
+		 * submitted QUEUE_DEPTH requests ago.
+		 */
+		k_sem_take(&free_reqs, K_FOREVER);
+
+		req->op = DISK_ACCESS_OP_READ;
+		req->start_sector = i * REQ_SECTORS;
+		req->sg = &sgs[i % QUEUE_DEPTH];
+		req->sg_cnt = 1;
+		req->cb = read_done;
+
+		rc = disk_access_submit(disk, req);
+		if (rc != 0) {
+			k_sem_give(&free_reqs);
+			return rc;
+		}
+	}
+
+	/* Wait for all requests. */
+	for (int i = 0; i < QUEUE_DEPTH; i++) {
+		k_sem_take(&free_reqs, K_FOREVER);
+	}
+
+	for (int i = 0; i < QUEUE_DEPTH; i++) {
+		k_sem_give(&free_reqs);
+	}
+
+	return async_err;
+}
+
+static void run(const char *api, int (*fn)(void))
+{
+	timing_t start, end;
+	int rc;
+
+	start = timing_counter_get();
+	rc = fn();
+	end = timing_counter_get();
+
+	if (rc != 0) {
+		printk("%s read failed (%d)\n", api, rc);
+		return;
+	}
+
+	report(api, &start, &end);
+}
+
+void main(void)
+{
+	printk("Disk access: %u sectors, %u sectors per request, "
+	       "%u other disks, cache %s\n",
+	       DISK_SECTORS, REQ_SECTORS, CONFIG_BENCHMARK_OTHER_DISKS,
+	       IS_ENABLED(CONFIG_DISK_CACHE) ? "on" : "off");
+
+	/* The RAM disk is registered first, register the others and move it
+	 * to the end of the list.
+	 */
+	disk = disk_access_get_di(CONFIG_DISK_RAM_VOLUME_NAME);
+	(void)disk_access_unregister(disk);
+
+	for (int i = 0; i < CONFIG_BENCHMARK_OTHER_DISKS; i++) {
+		snprintk(other_names[i], sizeof(other_names[i]), "OTHER%02d", i);
+		other_disks[i].name = other_names[i];
+		other_disks[i].ops = &other_ops;
+		(void)disk_access_register(&other_disks[i]);
+	}
+
+	(void)disk_access_register(disk);
+
+	if (disk_access_di_init(disk) != 0) {
+		printk("Disk init failed\n");
+		return;
+	}
+
+	for (int i = 0; i < QUEUE_DEPTH; i++) {
+		sgs[i].buf = bufs[i];
+		sgs[i].num_sector = REQ_SECTORS;
+	}
+
+	timing_init();
+	timing_start();
+
+	run("name", read_name);
+	run("handle", read_handle);
+	run("readv", read_sg);
+	run("async", read_async);
+
+	timing_stop();
+
+	printk("fin\n");
+}
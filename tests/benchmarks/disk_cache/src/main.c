@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the disk writes, flash erases and file write throughput of a FAT
+ * workload of small writes, with and without the disk cache, see README.rst.
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <fs/fs.h>
+#include <ff.h>
+#include <disk/disk_access.h>
+#include <stats/stats.h>
+#include <sys/printk.h>
+
+#ifdef CONFIG_DISK_ACCESS_FLASH
+#define DISK_NAME CONFIG_DISK_FLASH_VOLUME_NAME
+#define DISK_TYPE "flash"
+#else
+#define DISK_NAME CONFIG_DISK_RAM_VOLUME_NAME
+#define DISK_TYPE "ram"
+#endif
+
+#define MNT_POINT "/" DISK_NAME ":"
+#define FILE_PATH MNT_POINT "/bench.dat"
+
+#define WRITE_CNT (CONFIG_BENCHMARK_FILE_SIZE / CONFIG_BENCHMARK_WRITE_SIZE)
+
+static FATFS fat_fs;
+static struct fs_mount_t fatfs_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = MNT_POINT,
+	.fs_data = &fat_fs,
+};
+
+static struct fs_file_t file;
+static uint8_t buf[CONFIG_BENCHMARK_WRITE_SIZE];
+
+/* Driver write requests, counted below the cache. */
+static const struct disk_operations *disk_ops;
+static struct disk_operations counting_ops;
+static uint32_t disk_writes;
+static uint32_t disk_sectors;
+
+static int counting_write(struct disk_info *disk, const uint8_t *data_buf,
+			  uint32_t start_sector, uint32_t num_sector)
+{
+	disk_writes++;
+	disk_sectors += num_sector;
+
+	return disk_ops->write(disk, data_buf, start_sector, num_sector);
+}
+
+static int erase_walk(struct stats_hdr *hdr, void *arg, const char *name,
+		      uint16_t off)
+{
+	if (strcmp(name, "flash_erase_calls") == 0) {
+		*(uint32_t *)arg = *(uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static uint32_t flash_erases(void)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+	uint32_t erases = 0U;
+
+	if (hdr != NULL) {
+		(void)stats_walk(hdr, erase_walk, &erases);
+	}
+
+	return erases;
+}
+
+static void fill(uint32_t idx)
+{
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		buf[i] = (uint8_t)(idx * 7U + i);
+	}
+}
+
+static int write_file(void)
+{
+	int rc;
+
+	rc = fs_open(&file, FILE_PATH, FS_O_CREATE | FS_O_WRITE);
+	if (rc != 0) {
+		return rc;
+	}
+
+	for (uint32_t i = 0; i < WRITE_CNT; i++) {
+		fill(i);
+		if (fs_write(&file, buf, sizeof(buf)) != sizeof(buf)) {
+			(void)fs_close(&file);
+			return -EIO;
+		}
+
+		if ((i + 1U) % CONFIG_BENCHMARK_SYNC_INTERVAL == 0U) {
+			rc = fs_sync(&file);
+			if (rc != 0) {
+				(void)fs_close(&file);
+				return rc;
+			}
+		}
+	}
+
+	return fs_close(&file);
+}
+
+static int check_file(void)
+{
+	uint8_t expected[sizeof(buf)];
+	int rc;
+
+	rc = fs_open(&file, FILE_PATH, FS_O_READ);
+	if (rc != 0) {
+		return rc;
+	}
+
+	for (uint32_t i = 0; i < WRITE_CNT; i++) {
+		fill(i);
+		if ((fs_read(&file, expected, sizeof(expected)) !=
+		     sizeof(expected)) ||
+		    (memcmp(expected, buf, sizeof(buf)) != 0)) {
+			rc = -EIO;
+			break;
+		}
+	}
+
+	(void)fs_close(&file);
+
+	return rc;
+}
+
+void main(void)
+{
+	struct disk_info *disk;
+	uint32_t erases;
+	int64_t start, ms;
+	int rc;
+
+	printk("Disk cache: %s disk, %u B file in %u B writes, cache %s\n",
+	       DISK_TYPE, CONFIG_BENCHMARK_FILE_SIZE,
+	       CONFIG_BENCHMARK_WRITE_SIZE,
+	       IS_ENABLED(CONFIG_DISK_CACHE) ? "on" : "off");
+
+	rc = fs_mount(&fatfs_mnt);
+	if (rc != 0) {
+		printk("Mount failed (%d)\n", rc);
+		return;
+	}
+
+	/* Start from an empty volume. */
+	(void)fs_unlink(FILE_PATH);
+
+	disk = disk_access_get_di(DISK_NAME);
+	disk_ops = disk->ops;
+	counting_ops = *disk_ops;
+	counting_ops.write = counting_write;
+	disk->ops = &counting_ops;
+
+	erases = flash_erases();
+	start = k_uptime_get();
+
+	rc = write_file();
+
+	ms = MAX(k_uptime_get() - start, 1);
+	erases = flash_erases() - erases;
+	disk->ops = disk_ops;
+
+	if (rc == 0) {
+		rc = check_file();
+	}
+
+	if (rc != 0) {
+		printk("Benchmark failed (%d)\n", rc);
+		return;
+	}
+
+	printk("DISK_CACHE %s %s: %u B, %u writes %u sectors, %u erases, "
+	       "%u ms, %u B/s\n",
+	       DISK_TYPE, IS_ENABLED(CONFIG_DISK_CACHE) ? "cache" : "nocache",
+	       CONFIG_BENCHMARK_FILE_SIZE, disk_writes, disk_sectors, erases,
+	       (uint32_t)ms,
+	       (uint32_t)(CONFIG_BENCHMARK_FILE_SIZE * MSEC_PER_SEC / ms));
+
+	printk("fin\n");
+}
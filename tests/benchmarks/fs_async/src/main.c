@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure how long a producer writing records at a fixed rate to a file is
+ * stalled, with synchronous and with asynchronous writes, see README.rst.
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <fs/fs.h>
+#include <fs/fs_async.h>
+#include <ff.h>
+#include <sys/printk.h>
+
+#define MNT_POINT "/" CONFIG_DISK_FLASH_VOLUME_NAME ":"
+#define FILE_PATH MNT_POINT "/records.dat"
+
+#define RECORD_SIZE CONFIG_BENCHMARK_RECORD_SIZE
+
+static FATFS fat_fs;
+static struct fs_mount_t fatfs_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = MNT_POINT,
+	.fs_data = &fat_fs,
+};
+
+static struct fs_file_t file;
+static K_TIMER_DEFINE(period_timer, NULL, NULL);
+
+static uint32_t stall_total_us;
+static uint32_t stall_max_us;
+static uint32_t overruns;
+static int write_err;
+
+static void record_fill(uint8_t *buf, uint32_t idx)
+{
+	uint32_t stamp = k_uptime_get_32();
+
+	memcpy(buf, &idx, sizeof(idx));
+	memcpy(buf + sizeof(idx), &stamp, sizeof(stamp));
+	for (size_t i = 2 * sizeof(uint32_t); i < RECORD_SIZE; i++) {
+		buf[i] = (uint8_t)(idx + i);
+	}
+}
+
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+#define MODE "async"
+
+struct slot {
+	struct fs_async_req req;
+	struct fs_iovec iov;
+	uint8_t buf[RECORD_SIZE];
+};
+
+static struct slot slots[CONFIG_BENCHMARK_BUFFERS];
+static K_SEM_DEFINE(free_slots, CONFIG_BENCHMARK_BUFFERS,
+		    CONFIG_BENCHMARK_BUFFERS);
+
+static void record_done(struct fs_async_req *req, ssize_t result)
+{
+	if ((result < 0) ||
+	    ((req->op == FS_ASYNC_WRITE) && (result != RECORD_SIZE))) {
+		write_err = (result < 0) ? (int)result : -ENOSPC;
+	}
+
+	k_sem_give(&free_slots);
+}
+
+/* Slots are used in turn, and requests complete in order, so the slot
+ * taken is the oldest one.
+ */
+static int slot_submit(uint32_t idx, enum fs_async_op op)
+{
+	static uint32_t next;
+	struct slot *slot = &slots[next++ % ARRAY_SIZE(slots)];
+	int rc;
+
+	k_sem_take(&free_slots, K_FOREVER);
+
+	slot->req.op = op;
+	slot->req.zfp = &file;
+	slot->req.cb = record_done;
+	if (op == FS_ASYNC_WRITE) {
+		record_fill(slot->buf, idx);
+		slot->iov.base = slot->buf;
+		slot->iov.len = RECORD_SIZE;
+		slot->req.iov = &slot->iov;
+		slot->req.iovcnt = 1;
+	}
+
+	rc = fs_async_submit(&slot->req);
+	if (rc != 0) {
+		k_sem_give(&free_slots);
+	}
+
+	return rc;
+}
+
+static int record_write(uint32_t idx)
+{
+	int rc = slot_submit(idx, FS_ASYNC_WRITE);
+
+	if ((rc == 0) && ((idx + 1U) % CONFIG_BENCHMARK_SYNC_INTERVAL == 0U)) {
+		rc = slot_submit(idx, FS_ASYNC_SYNC);
+	}
+
+	return rc;
+}
+
+static void records_drain(void)
+{
+	for (int i = 0; i < CONFIG_BENCHMARK_BUFFERS; i++) {
+		k_sem_take(&free_slots, K_FOREVER);
+	}
+}
+#else
+#define MODE "sync"
+
+static uint8_t record_buf[RECORD_SIZE];
+
+static int record_write(uint32_t idx)
+{
+	ssize_t len;
+
+	record_fill(record_buf, idx);
+	len = fs_write(&file, record_buf, RECORD_SIZE);
+	if (len != RECORD_SIZE) {
+		return (len < 0) ? (int)len : -ENOSPC;
+	}
+
+	if ((idx + 1U) % CONFIG_BENCHMARK_SYNC_INTERVAL == 0U) {
+		return fs_sync(&file);
+	}
+
+	return 0;
+}
+
+static void records_drain(void)
+{
+}
+#endif /* CONFIG_FILE_SYSTEM_ASYNC */
+
+static int produce(void)
+{
+	k_timer_start(&period_timer, K_MSEC(CONFIG_BENCHMARK_PERIOD_MS),
+		      K_MSEC(CONFIG_BENCHMARK_PERIOD_MS));
+
+	for (uint32_t i = 0; i < CONFIG_BENCHMARK_RECORDS; i++) {
+		uint32_t start, stall_us;
+		int rc;
+
+		/* More than one expiry means a period was missed. */
+		overruns += k_timer_status_sync(&period_timer) - 1U;
+
+		start = k_cycle_get_32();
+		rc = record_write(i);
+		stall_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+		if (rc != 0) {
+			k_timer_stop(&period_timer);
+			return rc;
+		}
+
+		stall_total_us += stall_us;
+		stall_max_us = MAX(stall_max_us, stall_us);
+	}
+
+	k_timer_stop(&period_timer);
+
+	return 0;
+}
+
+void main(void)
+{
+	int64_t start, ms;
+	int rc;
+
+	printk("File records: %u records of %u B every %u ms, mode: %s\n",
+	       CONFIG_BENCHMARK_RECORDS, RECORD_SIZE,
+	       CONFIG_BENCHMARK_PERIOD_MS, MODE);
+
+	rc = fs_mount(&fatfs_mnt);
+	if (rc != 0) {
+		printk("Mount failed (%d)\n", rc);
+		return;
+	}
+
+	(void)fs_unlink(FILE_PATH);
+
+	rc = fs_open(&file, FILE_PATH, FS_O_CREATE | FS_O_WRITE);
+	if (rc != 0) {
+		printk("Open failed (%d)\n", rc);
+		return;
+	}
+
+	start = k_uptime_get();
+	rc = produce();
+	records_drain();
+	ms = k_uptime_get() - start;
+
+	(void)fs_close(&file);
+
+	if ((rc != 0) || (write_err != 0)) {
+		printk("Write failed (%d)\n", (rc != 0) ? rc : write_err);
+		return;
+	}
+
+	printk("FS_ASYNC %s: %u records %u B, period %u ms, "
+	       "stall total %u us max %u us, overruns %u, written %u ms\n",
+	       MODE, CONFIG_BENCHMARK_RECORDS,
+	       CONFIG_BENCHMARK_RECORDS * RECORD_SIZE,
+	       CONFIG_BENCHMARK_PERIOD_MS, stall_total_us, stall_max_us,
+	       overruns, (uint32_t)ms);
+
+	printk("fin\n");
+}
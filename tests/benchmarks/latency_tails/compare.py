@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Compare two latency_tails recordings made by twister.
+
+Reports the latencies of the new recording which grew by more than the
+threshold compared to the baseline recording, and exits with status 1 if
+there are any.
+"""
+
+import argparse
+import csv
+import sys
+
+VALUES = ['p50', 'p90', 'p99', 'p999', 'max']
+
+
+def load(path):
+    rows = {}
+    with open(path, newline='') as f:
+        for row in csv.DictReader(f):
+            # twister writes the header again before each run
+            if row['load'] == 'load':
+                continue
+            rows[(row['load'], row['metric'])] = row
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='allowed increase in percent (default 10)')
+    parser.add_argument('--values', default=','.join(VALUES),
+                        help='compared values (default %(default)s)')
+    parser.add_argument('baseline', help='baseline recording.csv')
+    parser.add_argument('new', help='new recording.csv')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    new = load(args.new)
+    regressions = 0
+
+    for key, row in sorted(new.items()):
+        if key not in baseline:
+            print('{} {}: no baseline'.format(*key))
+            continue
+
+        for value in args.values.split(','):
+            old = int(baseline[key][value])
+            cur = int(row[value])
+            change = (cur - old) * 100.0 / old if old else 0.0
+            flag = ''
+            if change > args.threshold:
+                flag = ' REGRESSION'
+                regressions += 1
+            print('{} {} {}: {} -> {} ns ({:+.1f}%){}'.format(
+                key[0], key[1], value, old, cur, change, flag))
+
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include "hist.h"
+
+static uint32_t bucket_get(uint32_t value)
+{
+	uint32_t shift;
+
+	if (value < HIST_SUB) {
+		return value;
+	}
+
+	shift = find_msb_set(value) - 1U - HIST_SUB_BITS;
+
+	return HIST_SUB + shift * HIST_SUB + ((value >> shift) - HIST_SUB);
+}
+
+static uint32_t bucket_upper(uint32_t bucket)
+{
+	uint32_t shift, mantissa;
+
+	if (bucket < HIST_SUB) {
+		return bucket;
+	}
+
+	shift = (bucket - HIST_SUB) / HIST_SUB;
+	mantissa = HIST_SUB + (bucket - HIST_SUB) % HIST_SUB;
+
+	return (uint32_t)((((uint64_t)mantissa + 1U) << shift) - 1U);
+}
+
+void hist_init(struct hist *hist)
+{
+	(void)memset(hist, 0, sizeof(*hist));
+	hist->min = UINT32_MAX;
+}
+
+void hist_add(struct hist *hist, uint32_t value)
+{
+	hist->buckets[bucket_get(value)]++;
+	hist->count++;
+	hist->min = MIN(hist->min, value);
+	hist->max = MAX(hist->max, value);
+}
+
+uint32_t hist_percentile(const struct hist *hist, uint32_t per_mille)
+{
+	uint64_t threshold = ((uint64_t)hist->count * per_mille + 999U) / 1000U;
+	uint64_t cnt = 0U;
+
+	for (uint32_t i = 0; i < HIST_BUCKETS; i++) {
+		cnt += hist->buckets[i];
+		if (cnt >= threshold && cnt > 0U) {
+			return MIN(bucket_upper(i), hist->max);
+		}
+	}
+
+	return hist->max;
+}
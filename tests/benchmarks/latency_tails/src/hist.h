@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LATENCY_TAILS_HIST_H_
+#define LATENCY_TAILS_HIST_H_
+
+#include <zephyr/types.h>
+
+/* Log-linear histogram: each power of two range is split in HIST_SUB
+ * buckets, so a value is known with a relative error below 1 / HIST_SUB
+ * whatever its magnitude.
+ */
+#define HIST_SUB_BITS 3
+#define HIST_SUB (1U << HIST_SUB_BITS)
+#define HIST_BUCKETS (HIST_SUB * (32U - HIST_SUB_BITS + 1U))
+
+struct hist {
+	uint32_t buckets[HIST_BUCKETS];
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+};
+
+void hist_init(struct hist *hist);
+
+void hist_add(struct hist *hist, uint32_t value);
+
+/* Upper bound of the bucket holding the given per mille of the values,
+ * clamped to the maximum value.
+ */
+uint32_t hist_percentile(const struct hist *hist, uint32_t per_mille);
+
+#endif /* LATENCY_TAILS_HIST_H_ */
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Background loads. They run at the lowest application priority, below the
+ * measuring threads, and only leave the CPU to the idle thread for short
+ * periods, so the measurements see the interrupt locking and scheduling
+ * activity of the subsystem under load.
+ */
+
+#include <kernel.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <errno.h>
+#include "load.h"
+
+#define LOAD_STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define LOAD_PRIO K_LOWEST_APPLICATION_THREAD_PRIO
+
+#ifdef CONFIG_BENCHMARK_LOAD_LOGGING
+#include <logging/log.h>
+LOG_MODULE_REGISTER(load, LOG_LEVEL_INF);
+
+static void logging_load(void *p1, void *p2, void *p3)
+{
+	for (uint32_t i = 0; ; i++) {
+		LOG_INF("load message %u", i);
+
+		/* Let the logging thread process the messages. */
+		if ((i % 16U) == 0U) {
+			k_msleep(1);
+		}
+	}
+}
+
+K_THREAD_DEFINE(logging_load_id, LOAD_STACK_SIZE, logging_load,
+		NULL, NULL, NULL, LOAD_PRIO, 0, K_TICKS_FOREVER);
+#endif /* CONFIG_BENCHMARK_LOAD_LOGGING */
+
+#ifdef CONFIG_BENCHMARK_LOAD_FLASH
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+
+#define FLASH_CHUNK_SIZE 64
+
+static void flash_load(void *p1, void *p2, void *p3)
+{
+	static uint8_t chunk[FLASH_CHUNK_SIZE];
+	struct flash_pages_info info;
+	const struct flash_area *fa;
+	const struct device *dev;
+	int err;
+
+	err = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	if (err < 0) {
+		printk("Flash load: cannot open storage (err %d)\n", err);
+		return;
+	}
+
+	dev = device_get_binding(fa->fa_dev_name);
+	err = flash_get_page_info_by_offs(dev, fa->fa_off, &info);
+	if (err < 0) {
+		printk("Flash load: no page info (err %d)\n", err);
+		return;
+	}
+
+	for (uint8_t pattern = 0; ; pattern++) {
+		(void)memset(chunk, pattern, sizeof(chunk));
+		(void)flash_area_erase(fa, 0, info.size);
+
+		for (off_t off = 0; off + sizeof(chunk) <= info.size;
+		     off += sizeof(chunk)) {
+			(void)flash_area_write(fa, off, chunk, sizeof(chunk));
+		}
+
+		k_msleep(1);
+	}
+}
+
+K_THREAD_DEFINE(flash_load_id, LOAD_STACK_SIZE, flash_load,
+		NULL, NULL, NULL, LOAD_PRIO, 0, K_TICKS_FOREVER);
+#endif /* CONFIG_BENCHMARK_LOAD_FLASH */
+
+#ifdef CONFIG_BENCHMARK_LOAD_NET
+#include <net/socket.h>
+
+#define NET_LOAD_PORT 4242
+#define NET_LOAD_SIZE 256
+
+static void net_load(void *p1, void *p2, void *p3)
+{
+	static uint8_t buf[NET_LOAD_SIZE];
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(NET_LOAD_PORT),
+	};
+	int sock;
+
+	/* The datagrams are sent to the address of the interface itself. */
+	zsock_inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+			&addr.sin_addr);
+
+	sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0 ||
+	    zsock_bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("Net load: cannot create socket (errno %d)\n", errno);
+		return;
+	}
+
+	for (;;) {
+		(void)zsock_sendto(sock, buf, sizeof(buf), 0,
+				   (struct sockaddr *)&addr, sizeof(addr));
+
+		while (zsock_recv(sock, buf, sizeof(buf),
+				  ZSOCK_MSG_DONTWAIT) > 0) {
+		}
+
+		k_msleep(1);
+	}
+}
+
+K_THREAD_DEFINE(net_load_id, LOAD_STACK_SIZE * 2, net_load,
+		NULL, NULL, NULL, LOAD_PRIO, 0, K_TICKS_FOREVER);
+#endif /* CONFIG_BENCHMARK_LOAD_NET */
+
+void load_start(void)
+{
+#ifdef CONFIG_BENCHMARK_LOAD_LOGGING
+	k_thread_start(logging_load_id);
+#endif
+#ifdef CONFIG_BENCHMARK_LOAD_FLASH
+	k_thread_start(flash_load_id);
+#endif
+#ifdef CONFIG_BENCHMARK_LOAD_NET
+	k_thread_start(net_load_id);
+#endif
+}
+
+#ifdef CONFIG_BENCHMARK_LOAD_LOGGING
+#define LOAD_NAME_LOGGING "+logging"
+#else
+#define LOAD_NAME_LOGGING ""
+#endif
+#ifdef CONFIG_BENCHMARK_LOAD_FLASH
+#define LOAD_NAME_FLASH "+flash"
+#else
+#define LOAD_NAME_FLASH ""
+#endif
+#ifdef CONFIG_BENCHMARK_LOAD_NET
+#define LOAD_NAME_NET "+net"
+#else
+#define LOAD_NAME_NET ""
+#endif
+
+#define LOAD_NAME LOAD_NAME_LOGGING LOAD_NAME_FLASH LOAD_NAME_NET
+
+const char *load_name(void)
+{
+	/* Skip the leading separator. */
+	return (sizeof(LOAD_NAME) > 1) ? &LOAD_NAME[1] : "none";
+}
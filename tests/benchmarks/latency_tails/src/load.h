@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LATENCY_TAILS_LOAD_H_
+#define LATENCY_TAILS_LOAD_H_
+
+/* Start the background loads enabled in the configuration. */
+void load_start(void);
+
+/* Name of the enabled background loads, "none" if there are none. */
+const char *load_name(void);
+
+#endif /* LATENCY_TAILS_LOAD_H_ */
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the distribution of interrupt and scheduling latencies while the
+ * configured background loads run:
+ *
+ * - timer_jitter: deviation of the timer expiry interval from the mean
+ *   interval.
+ * - irq_to_thread: from the timer expiry to the woken up thread running.
+ * - sem_give_take: from a semaphore give to the higher priority thread
+ *   taking it running.
+ *
+ * On emulated platforms, irq_to_thread and sem_give_take mostly measure
+ * the host scheduling, they are only meaningful on hardware.
+ *
+ * Results are printed in ns, one line per measurement, in a format recorded
+ * by twister (see README.rst).
+ */
+
+#include <kernel.h>
+#include <timing/timing.h>
+#include <sys/printk.h>
+#include <stdlib.h>
+#include "hist.h"
+#include "load.h"
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WAITER_PRIO K_PRIO_PREEMPT(0)
+#define DRIVER_PRIO K_PRIO_PREEMPT(10)
+
+/* Timer expiries used to measure the mean interval, before the samples. */
+#define CALIBRATION_EXPIRIES 32
+
+static struct hist jitter_hist;
+static struct hist irq_hist;
+static struct hist sem_hist;
+
+/* Histogram the waiter currently records to. */
+static struct hist *volatile wake_hist;
+static volatile timing_t wake_start;
+
+static timing_t first_expiry;
+static timing_t last_expiry;
+static uint32_t expiries;
+static int64_t period_ns;
+
+static K_SEM_DEFINE(wake_sem, 0, 1);
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+static uint32_t ns_get(timing_t *start, timing_t *end)
+{
+	uint64_t ns = timing_cycles_to_ns(timing_cycles_get(start, end));
+
+	return (uint32_t)MIN(ns, UINT32_MAX);
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	struct hist *hist;
+	timing_t start, now;
+
+	for (;;) {
+		k_sem_take(&wake_sem, K_FOREVER);
+		now = timing_counter_get();
+		start = wake_start;
+		hist = wake_hist;
+
+		if (hist->count >= CONFIG_BENCHMARK_SAMPLES) {
+			continue;
+		}
+
+		hist_add(hist, ns_get(&start, &now));
+
+		if (hist->count == CONFIG_BENCHMARK_SAMPLES) {
+			k_sem_give(&done_sem);
+		}
+	}
+}
+
+K_THREAD_DEFINE(waiter_id, STACK_SIZE, waiter, NULL, NULL, NULL,
+		WAITER_PRIO, 0, 0);
+
+static void timer_expiry(struct k_timer *timer)
+{
+	timing_t now = timing_counter_get();
+	int64_t deviation;
+
+	/* The timing counter and the system clock may not run at exactly
+	 * the expected ratio, so the deviation is taken from the mean
+	 * interval of the first expiries instead of the nominal period.
+	 */
+	if (expiries < CALIBRATION_EXPIRIES) {
+		if (expiries == 0U) {
+			first_expiry = now;
+		}
+
+		if (++expiries == CALIBRATION_EXPIRIES) {
+			period_ns = (int64_t)(timing_cycles_to_ns(
+				timing_cycles_get(&first_expiry, &now)) /
+				(CALIBRATION_EXPIRIES - 1));
+		}
+
+		last_expiry = now;
+		return;
+	}
+
+	if (jitter_hist.count < CONFIG_BENCHMARK_SAMPLES) {
+		deviation = (int64_t)ns_get(&last_expiry, &now) - period_ns;
+		hist_add(&jitter_hist,
+			 (uint32_t)MIN(llabs(deviation), UINT32_MAX));
+	}
+
+	last_expiry = now;
+
+	wake_start = now;
+	k_sem_give(&wake_sem);
+}
+
+K_TIMER_DEFINE(timer, timer_expiry, NULL);
+
+static void report(const char *name, const struct hist *hist)
+{
+	printk("LATENCY %s %s: samples %u min %u p50 %u p90 %u p99 %u "
+	       "p999 %u max %u ns\n", load_name(), name, hist->count,
+	       hist->count ? hist->min : 0U,
+	       hist_percentile(hist, 500), hist_percentile(hist, 900),
+	       hist_percentile(hist, 990), hist_percentile(hist, 999),
+	       hist->max);
+}
+
+static void timer_latencies(void)
+{
+	k_timeout_t period = K_TICKS(CONFIG_BENCHMARK_TIMER_PERIOD_TICKS);
+
+	wake_hist = &irq_hist;
+
+	k_timer_start(&timer, period, period);
+	/* The jitter is recorded on the same expiries as the wake ups. */
+	k_sem_take(&done_sem, K_FOREVER);
+	k_timer_stop(&timer);
+
+	report("timer_jitter", &jitter_hist);
+	report("irq_to_thread", &irq_hist);
+}
+
+static void sem_latencies(void)
+{
+	wake_hist = &sem_hist;
+
+	for (int i = 0; i < CONFIG_BENCHMARK_SAMPLES; i++) {
+		/* Let the background loads run between the samples. */
+		k_sleep(K_TICKS(1));
+
+		wake_start = timing_counter_get();
+		k_sem_give(&wake_sem);
+	}
+
+	k_sem_take(&done_sem, K_FOREVER);
+
+	report("sem_give_take", &sem_hist);
+}
+
+static void driver(void *p1, void *p2, void *p3)
+{
+	hist_init(&jitter_hist);
+	hist_init(&irq_hist);
+	hist_init(&sem_hist);
+
+	timing_init();
+	timing_start();
+
+	printk("Latency tails: %u samples, load: %s, clock %u MHz\n",
+	       CONFIG_BENCHMARK_SAMPLES, load_name(), timing_freq_get_mhz());
+
+	load_start();
+
+	/* Let the loads reach their steady state. */
+	k_msleep(100);
+
+	timer_latencies();
+	sem_latencies();
+
+	timing_stop();
+
+	printk("fin\n");
+}
+
+K_THREAD_DEFINE(driver_id, STACK_SIZE, driver, NULL, NULL, NULL,
+		DRIVER_PRIO, 0, 0);
+
+void main(void)
+{
+}
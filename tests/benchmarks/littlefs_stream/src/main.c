@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the sustained throughput and the write amplification of a long
+ * append-only recording to littlefs, with and without an append stream, see
+ * README.rst.
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <fs/fs.h>
+#include <fs/littlefs.h>
+#include <storage/flash_map.h>
+#include <stats/stats.h>
+#include <sys/printk.h>
+
+#define MNT_POINT "/lfs"
+#define FILE_PATH MNT_POINT "/record.dat"
+
+#define RECORD_SIZE CONFIG_BENCHMARK_RECORD_SIZE
+#define RECORD_CNT (CONFIG_BENCHMARK_FILE_SIZE / RECORD_SIZE)
+
+#ifdef CONFIG_BENCHMARK_STREAM
+#define MODE "stream"
+#define OPEN_FLAGS (FS_O_CREATE | FS_O_WRITE | FS_O_STREAM)
+#else
+#define MODE "append"
+#define OPEN_FLAGS (FS_O_CREATE | FS_O_WRITE | FS_O_APPEND)
+#endif
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+static struct fs_mount_t lfs_mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)FLASH_AREA_ID(image_1),
+	.mnt_point = MNT_POINT,
+};
+
+static struct fs_file_t file;
+static uint8_t record[RECORD_SIZE];
+
+struct flash_counters {
+	uint32_t erases;
+	uint32_t bytes_written;
+};
+
+static int counters_walk(struct stats_hdr *hdr, void *arg, const char *name,
+			 uint16_t off)
+{
+	struct flash_counters *counters = arg;
+	uint32_t val = *(uint32_t *)((uint8_t *)hdr + off);
+
+	if (strcmp(name, "flash_erase_calls") == 0) {
+		counters->erases = val;
+	} else if (strcmp(name, "bytes_written") == 0) {
+		counters->bytes_written = val;
+	}
+
+	return 0;
+}
+
+static void flash_counters_get(struct flash_counters *counters)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+
+	memset(counters, 0, sizeof(*counters));
+	if (hdr != NULL) {
+		(void)stats_walk(hdr, counters_walk, counters);
+	}
+}
+
+static int partition_erase(void)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(image_1), &fa);
+	if (rc != 0) {
+		return rc;
+	}
+
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	flash_area_close(fa);
+
+	return rc;
+}
+
+static int record(void)
+{
+	int rc;
+
+	rc = fs_open(&file, FILE_PATH, OPEN_FLAGS);
+	if (rc != 0) {
+		return rc;
+	}
+
+#ifdef CONFIG_BENCHMARK_STREAM
+	rc = fs_fallocate(&file, CONFIG_BENCHMARK_FILE_SIZE);
+	if (rc != 0) {
+		(void)fs_close(&file);
+		return rc;
+	}
+#endif
+
+	for (uint32_t i = 0; i < RECORD_CNT; i++) {
+		ssize_t len;
+
+		memcpy(record, &i, sizeof(i));
+		len = fs_write(&file, record, sizeof(record));
+		if (len != sizeof(record)) {
+			rc = (len < 0) ? (int)len : -ENOSPC;
+			break;
+		}
+
+		if ((i + 1U) % CONFIG_BENCHMARK_SYNC_INTERVAL == 0U) {
+			rc = fs_sync(&file);
+			if (rc != 0) {
+				break;
+			}
+		}
+	}
+
+	if (rc == 0) {
+		rc = fs_close(&file);
+	} else {
+		(void)fs_close(&file);
+	}
+
+	return rc;
+}
+
+void main(void)
+{
+	struct flash_counters before, after;
+	uint32_t bytes = RECORD_CNT * RECORD_SIZE;
+	uint32_t flash_bytes, amplification;
+	int64_t start, ms;
+	int rc;
+
+	printk("littlefs recording: %u records of %u B, sync every %u, "
+	       "mode: %s\n", RECORD_CNT, RECORD_SIZE,
+	       CONFIG_BENCHMARK_SYNC_INTERVAL, MODE);
+
+	for (size_t i = sizeof(uint32_t); i < sizeof(record); i++) {
+		record[i] = (uint8_t)i;
+	}
+
+	rc = partition_erase();
+	if (rc != 0) {
+		printk("Erase failed (%d)\n", rc);
+		return;
+	}
+
+	rc = fs_mount(&lfs_mnt);
+	if (rc != 0) {
+		printk("Mount failed (%d)\n", rc);
+		return;
+	}
+
+	flash_counters_get(&before);
+	start = k_uptime_get();
+
+	rc = record();
+
+	ms = k_uptime_get() - start;
+	flash_counters_get(&after);
+
+	(void)fs_unmount(&lfs_mnt);
+
+	if (rc != 0) {
+		printk("Recording failed (%d)\n", rc);
+		return;
+	}
+
+	flash_bytes = after.bytes_written - before.bytes_written;
+	amplification = (uint32_t)((uint64_t)flash_bytes * 100U / bytes);
+
+	printk("LFS_STREAM %s: %u B in %u ms, %u KiB/s, erases %u, "
+	       "flash written %u B, write amplification %u.%02u\n",
+	       MODE, bytes, (uint32_t)ms,
+	       (uint32_t)(((uint64_t)bytes * 1000U / 1024U) / MAX(ms, 1)),
+	       after.erases - before.erases, flash_bytes,
+	       amplification / 100U, amplification % 100U);
+
+	printk("fin\n");
+}
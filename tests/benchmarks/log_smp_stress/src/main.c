@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <logging/log.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+
+/* Deferred logging from all CPUs at once, with a backend that discards
+ * the messages. Reports the log call rate and the number of messages
+ * processed and dropped.
+ */
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+#define DURATION_MS 2000
+#define TIMER_PERIOD_US 500
+
+#define LOGGER_STACK_SIZE 1024
+#define LOGGER_PRIORITY K_PRIO_PREEMPT(10)
+#define PROCESS_STACK_SIZE 2048
+#define PROCESS_PRIORITY K_PRIO_PREEMPT(5)
+
+#if defined(CONFIG_LOG_PER_CPU_BUFFERS)
+#define BUFFERS "per_cpu"
+#else
+#define BUFFERS "shared"
+#endif
+
+#if defined(CONFIG_LOG_MODE_OVERFLOW)
+#define MODE "overflow"
+#else
+#define MODE "no_overflow"
+#endif
+
+static K_THREAD_STACK_ARRAY_DEFINE(logger_stacks, CONFIG_MP_NUM_CPUS,
+				   LOGGER_STACK_SIZE);
+static struct k_thread logger_threads[CONFIG_MP_NUM_CPUS];
+static K_THREAD_STACK_DEFINE(process_stack, PROCESS_STACK_SIZE);
+static struct k_thread process_thread;
+
+static atomic_t calls;
+static volatile bool stop;
+
+static uint32_t processed;
+static uint32_t dropped_cnt;
+static uint32_t out_of_order;
+static uint32_t last_timestamp;
+
+static void put(const struct log_backend *const backend,
+		struct log_msg *msg)
+{
+	ARG_UNUSED(backend);
+	ARG_UNUSED(msg);
+}
+
+static void put_package(const struct log_backend *const backend,
+			struct log_msg_ids src_level, uint32_t timestamp,
+			const void *package, const uint8_t *data,
+			uint32_t length)
+{
+	if ((int32_t)(timestamp - last_timestamp) < 0) {
+		out_of_order++;
+	}
+
+	last_timestamp = timestamp;
+	processed++;
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+
+	dropped_cnt += cnt;
+}
+
+static void panic(const struct log_backend *const backend)
+{
+	ARG_UNUSED(backend);
+}
+
+static const struct log_backend_api bench_backend_api = {
+	.put = put,
+	.put_package = put_package,
+	.dropped = dropped,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(bench_backend, bench_backend_api, true);
+
+static void timer_fn(struct k_timer *timer)
+{
+	LOG_INF("isr sample %u", (uint32_t)atomic_inc(&calls));
+}
+
+static K_TIMER_DEFINE(log_timer, timer_fn, NULL);
+
+static void logger_fn(void *p1, void *p2, void *p3)
+{
+	uint32_t id = POINTER_TO_UINT(p1);
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!stop) {
+		LOG_INF("thread %u sample %u", id,
+			(uint32_t)atomic_inc(&calls));
+	}
+}
+
+static void process_fn(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		while (log_process(false)) {
+		}
+
+		k_sleep(K_MSEC(1));
+	}
+}
+
+void main(void)
+{
+	uint32_t start, elapsed_ms;
+	int i;
+
+	k_thread_create(&process_thread, process_stack,
+			K_THREAD_STACK_SIZEOF(process_stack), process_fn,
+			NULL, NULL, NULL, PROCESS_PRIORITY, 0, K_NO_WAIT);
+
+	start = k_uptime_get_32();
+
+	k_timer_start(&log_timer, K_USEC(TIMER_PERIOD_US),
+		      K_USEC(TIMER_PERIOD_US));
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		k_thread_create(&logger_threads[i], logger_stacks[i],
+				K_THREAD_STACK_SIZEOF(logger_stacks[i]),
+				logger_fn, UINT_TO_POINTER(i), NULL, NULL,
+				LOGGER_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	k_sleep(K_MSEC(DURATION_MS));
+
+	stop = true;
+	k_timer_stop(&log_timer);
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		k_thread_join(&logger_threads[i], K_FOREVER);
+	}
+
+	elapsed_ms = MAX(k_uptime_get_32() - start, 1);
+
+	/* Let the processing thread drain the buffers and report the
+	 * dropped messages.
+	 */
+	while (log_buffered_cnt() != 0) {
+		k_sleep(K_MSEC(10));
+	}
+
+	k_sleep(K_MSEC(10));
+
+	k_thread_abort(&process_thread);
+
+	printk("%s %s: %u calls/s, %u processed, %u dropped, %u out of order\n",
+	       BUFFERS, MODE, (uint32_t)(atomic_get(&calls) * 1000ULL /
+					 elapsed_ms),
+	       processed, dropped_cnt, out_of_order);
+	printk("fin\n");
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <logging/log.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_output.h>
+
+/* Deferred logging throughput and RAM usage per message, with a backend
+ * that formats messages and discards the output.
+ */
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+#define MAX_MSGS 1000
+
+#if defined(CONFIG_LOG_PACKAGED)
+#define MODE "packaged"
+#define STRDUP_POOL_SIZE 0
+#define MAX_STR_MSGS MAX_MSGS
+#else
+#define MODE "log_msg"
+/* Further strings would not be duplicated. */
+#define MAX_STR_MSGS CONFIG_LOG_STRDUP_BUF_COUNT
+/* Each log_strdup() buffer has a reference counter. */
+#define STRDUP_POOL_SIZE (CONFIG_LOG_STRDUP_BUF_COUNT * \
+			  (CONFIG_LOG_STRDUP_MAX_STRING + 1 + sizeof(atomic_t)))
+#endif
+
+static uint32_t processed;
+static uint8_t output_buf[64];
+
+/* Not in read-only memory */
+static char name[] = "sensor0";
+
+static int discard(uint8_t *data, size_t length, void *ctx)
+{
+	ARG_UNUSED(data);
+	ARG_UNUSED(ctx);
+
+	return length;
+}
+
+LOG_OUTPUT_DEFINE(bench_output, discard, output_buf, sizeof(output_buf));
+
+static void put(const struct log_backend *const backend,
+		struct log_msg *msg)
+{
+	log_msg_get(msg);
+	log_output_msg_process(&bench_output, msg,
+			       LOG_OUTPUT_FLAG_LEVEL | LOG_OUTPUT_FLAG_TIMESTAMP);
+	log_msg_put(msg);
+	processed++;
+}
+
+static void put_package(const struct log_backend *const backend,
+			struct log_msg_ids src_level, uint32_t timestamp,
+			const void *package, const uint8_t *data,
+			uint32_t length)
+{
+	log_output_package(&bench_output, src_level, timestamp, package, data,
+			   length,
+			   LOG_OUTPUT_FLAG_LEVEL | LOG_OUTPUT_FLAG_TIMESTAMP);
+	processed++;
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+	ARG_UNUSED(cnt);
+}
+
+static void panic(const struct log_backend *const backend)
+{
+	ARG_UNUSED(backend);
+}
+
+static const struct log_backend_api bench_backend_api = {
+	.put = put,
+	.put_package = put_package,
+	.dropped = dropped,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(bench_backend, bench_backend_api, true);
+
+static void log_int(uint32_t i)
+{
+	LOG_INF("sample %u value %d", i, -(int)i);
+}
+
+static void log_str(uint32_t i)
+{
+	LOG_INF("%s: sample %u", log_strdup(name), i);
+}
+
+static void flush(void)
+{
+	while (log_process(false)) {
+	}
+}
+
+static uint32_t rate(uint32_t count, uint32_t cycles)
+{
+	uint64_t ns = k_cyc_to_ns_floor64(MAX(cycles, 1));
+
+	return (uint32_t)(count * 1000000000ULL / MAX(ns, 1));
+}
+
+static void bench_run(const char *label, void (*log_fn)(uint32_t i),
+		      uint32_t max)
+{
+	uint32_t count, start, log_cycles, process_cycles, i;
+
+	flush();
+
+	/* Find how many messages fit in the buffer. */
+	for (i = 0; i < max; i++) {
+		log_fn(i);
+		if (log_buffered_cnt() < i + 1) {
+			break;
+		}
+	}
+
+	count = log_buffered_cnt();
+	flush();
+
+	if (count == 0) {
+		printk("%s %s: no messages buffered\n", MODE, label);
+		return;
+	}
+
+	/* Log and process as many messages as fit, so none is dropped. */
+	start = k_cycle_get_32();
+	for (i = 0; i < count; i++) {
+		log_fn(i);
+	}
+	log_cycles = k_cycle_get_32() - start;
+
+	processed = 0;
+	start = k_cycle_get_32();
+	flush();
+	process_cycles = k_cycle_get_32() - start;
+
+	printk("%s %s: %u msgs, %u B/msg, log %u msgs/s, process %u msgs/s\n",
+	       MODE, label, count,
+	       (uint32_t)((CONFIG_LOG_BUFFER_SIZE + STRDUP_POOL_SIZE) / count),
+	       rate(count, log_cycles), rate(processed, process_cycles));
+}
+
+void main(void)
+{
+	bench_run("int", log_int, MAX_MSGS);
+	bench_run("str", log_str, MAX_STR_MSGS);
+
+	printk("fin\n");
+}
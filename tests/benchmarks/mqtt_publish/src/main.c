@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <net/mqtt.h>
+
+/* QoS 1 publish throughput over loopback, with a minimal broker stand-in
+ * running in a separate thread. Each payload size is measured with
+ * stop-and-wait publishing (window of 1) and with pipelined publishing
+ * using the whole in-flight window.
+ *
+ * Loopback has no latency for pipelining to hide, so the broker delays
+ * each PUBACK by ACK_DELAY_MS, emulating the round trip to a real broker.
+ */
+
+#define BROKER_PORT 1883
+#define MSG_COUNT 200
+#define BUF_SIZE 128
+#define MAX_PAYLOAD 4096
+#define ACK_DELAY_MS 5
+#define ACK_QUEUE_SIZE 16
+
+#define BROKER_STACK_SIZE 2048
+#define BROKER_PRIORITY K_PRIO_PREEMPT(8)
+
+static K_THREAD_STACK_DEFINE(broker_stack, BROKER_STACK_SIZE);
+static struct k_thread broker_thread;
+
+static uint8_t rx_buffer[BUF_SIZE];
+static uint8_t tx_buffer[BUF_SIZE];
+static uint8_t payload[MAX_PAYLOAD];
+static uint8_t broker_buf[MAX_PAYLOAD + BUF_SIZE];
+
+struct pending_ack {
+	int64_t due;
+	uint8_t message_id[2];
+};
+
+/* Acknowledgments are delayed by the same amount, so they are due in
+ * the order they were queued.
+ */
+static struct pending_ack ack_queue[ACK_QUEUE_SIZE];
+static int ack_head;
+static int ack_count;
+
+static struct mqtt_client client;
+static struct sockaddr_in broker_addr;
+static bool connected;
+static int acked;
+
+static const size_t payload_sizes[] = { 64, 512, MAX_PAYLOAD };
+
+static int recv_all(int sock, uint8_t *buf, size_t len)
+{
+	size_t offset = 0;
+	int ret;
+
+	while (offset < len) {
+		ret = zsock_recv(sock, buf + offset, len - offset, 0);
+		if (ret <= 0) {
+			return -1;
+		}
+
+		offset += ret;
+	}
+
+	return 0;
+}
+
+static int send_all(int sock, const uint8_t *buf, size_t len)
+{
+	size_t offset = 0;
+	int ret;
+
+	while (offset < len) {
+		ret = zsock_send(sock, buf + offset, len - offset, 0);
+		if (ret < 0) {
+			return -1;
+		}
+
+		offset += ret;
+	}
+
+	return 0;
+}
+
+/* Read one MQTT packet, return the packet type and flags byte. */
+static int broker_read_packet(int sock, uint32_t *length)
+{
+	uint8_t byte, type;
+	uint32_t multiplier = 1;
+
+	if (recv_all(sock, &type, 1) < 0) {
+		return -1;
+	}
+
+	*length = 0;
+	do {
+		if (recv_all(sock, &byte, 1) < 0) {
+			return -1;
+		}
+
+		*length += (byte & 0x7f) * multiplier;
+		multiplier *= 128;
+	} while (byte & 0x80);
+
+	if (*length > sizeof(broker_buf) ||
+	    recv_all(sock, broker_buf, *length) < 0) {
+		return -1;
+	}
+
+	return type;
+}
+
+/* Send the acknowledgments that are due, return the time in milliseconds
+ * until the next one is, or -1 if there are none left.
+ */
+static int broker_send_due_acks(int sock)
+{
+	uint8_t puback[] = { 0x40, 0x02, 0x00, 0x00 };
+	struct pending_ack *ack;
+	int64_t now;
+
+	while (ack_count > 0) {
+		ack = &ack_queue[ack_head];
+		now = k_uptime_get();
+
+		if (ack->due > now) {
+			return (int)(ack->due - now);
+		}
+
+		puback[2] = ack->message_id[0];
+		puback[3] = ack->message_id[1];
+		(void)send_all(sock, puback, sizeof(puback));
+
+		ack_head = (ack_head + 1) % ACK_QUEUE_SIZE;
+		ack_count--;
+	}
+
+	return -1;
+}
+
+static void broker_queue_ack(int sock, const uint8_t *message_id)
+{
+	struct pending_ack *ack;
+
+	if (ack_count == ACK_QUEUE_SIZE) {
+		/* More messages in flight than expected, ack the oldest now. */
+		ack_queue[ack_head].due = 0;
+		(void)broker_send_due_acks(sock);
+	}
+
+	ack = &ack_queue[(ack_head + ack_count) % ACK_QUEUE_SIZE];
+	ack->due = k_uptime_get() + ACK_DELAY_MS;
+	ack->message_id[0] = message_id[0];
+	ack->message_id[1] = message_id[1];
+	ack_count++;
+}
+
+static void broker_fn(void *p1, void *p2, void *p3)
+{
+	static const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+	int listen_sock = POINTER_TO_INT(p1);
+	struct zsock_pollfd fds;
+	uint32_t length, topic_len;
+	int sock, type;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		sock = zsock_accept(listen_sock, NULL, NULL);
+		if (sock < 0) {
+			continue;
+		}
+
+		fds.fd = sock;
+		fds.events = ZSOCK_POLLIN;
+
+		while (true) {
+			if (zsock_poll(&fds, 1, broker_send_due_acks(sock)) == 0) {
+				continue;
+			}
+
+			type = broker_read_packet(sock, &length);
+			if (type < 0 || (type & 0xf0) == 0xe0) { /* DISCONNECT */
+				break;
+			}
+
+			switch (type & 0xf0) {
+			case 0x10: /* CONNECT */
+				(void)send_all(sock, connack, sizeof(connack));
+				break;
+
+			case 0x30: /* PUBLISH */
+				if (((type >> 1) & 0x03) == 0) {
+					break;
+				}
+
+				/* Message id follows the topic. */
+				topic_len = (broker_buf[0] << 8) | broker_buf[1];
+				broker_queue_ack(sock, &broker_buf[2 + topic_len]);
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		ack_count = 0;
+		(void)zsock_close(sock);
+	}
+}
+
+static void mqtt_evt_handler(struct mqtt_client *const c,
+			     const struct mqtt_evt *evt)
+{
+	switch (evt->type) {
+	case MQTT_EVT_CONNACK:
+		connected = (evt->result == 0);
+		break;
+
+	case MQTT_EVT_DISCONNECT:
+		connected = false;
+		break;
+
+	case MQTT_EVT_PUBACK:
+		acked++;
+		break;
+
+	default:
+		break;
+	}
+}
+
+static int wait_input(void)
+{
+	struct zsock_pollfd fds = {
+		.fd = client.transport.tcp.sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	if (zsock_poll(&fds, 1, 1000) <= 0) {
+		return -ETIMEDOUT;
+	}
+
+	return mqtt_input(&client);
+}
+
+static int client_connect(void)
+{
+	int ret;
+
+	mqtt_client_init(&client);
+
+	client.broker = &broker_addr;
+	client.evt_cb = mqtt_evt_handler;
+	client.client_id.utf8 = (uint8_t *)"bench";
+	client.client_id.size = strlen("bench");
+	client.protocol_version = MQTT_VERSION_3_1_1;
+	client.transport.type = MQTT_TRANSPORT_NON_SECURE;
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+
+	ret = mqtt_connect(&client);
+	if (ret < 0) {
+		return ret;
+	}
+
+	while (!connected) {
+		ret = wait_input();
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int publish_run(size_t payload_len, int window)
+{
+	struct mqtt_publish_param param = { 0 };
+	uint32_t start, elapsed_ms;
+	int sent = 0;
+	int ret;
+
+	param.message.topic.topic.utf8 = (uint8_t *)"bench/data";
+	param.message.topic.topic.size = strlen("bench/data");
+	param.message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE;
+	param.message.payload.data = payload;
+	param.message.payload.len = payload_len;
+
+	acked = 0;
+	start = k_uptime_get_32();
+
+	while (sent < MSG_COUNT) {
+		if (sent - acked >= window) {
+			ret = wait_input();
+			if (ret < 0) {
+				return ret;
+			}
+
+			continue;
+		}
+
+		param.message_id = sent + 1;
+
+		ret = mqtt_publish(&client, &param);
+		if (ret == -EBUSY) {
+			ret = wait_input();
+			if (ret < 0) {
+				return ret;
+			}
+
+			continue;
+		} else if (ret < 0) {
+			return ret;
+		}
+
+		sent++;
+	}
+
+	while (acked < MSG_COUNT) {
+		ret = wait_input();
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	elapsed_ms = MAX(k_uptime_get_32() - start, 1);
+
+	printk("window %d payload %zu: %u msg/s %u B/s\n", window,
+	       payload_len, MSG_COUNT * 1000U / elapsed_ms,
+	       (uint32_t)(MSG_COUNT * payload_len * 1000U / elapsed_ms));
+
+	return 0;
+}
+
+void main(void)
+{
+	int listen_sock, ret, i;
+
+	(void)memset(payload, 0xa5, sizeof(payload));
+
+	broker_addr.sin_family = AF_INET;
+	broker_addr.sin_port = htons(BROKER_PORT);
+	zsock_inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+			&broker_addr.sin_addr);
+
+	listen_sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listen_sock < 0 ||
+	    zsock_bind(listen_sock, (struct sockaddr *)&broker_addr,
+		       sizeof(broker_addr)) < 0 ||
+	    zsock_listen(listen_sock, 1) < 0) {
+		printk("Failed to set up broker socket (%d)\n", errno);
+		return;
+	}
+
+	k_thread_create(&broker_thread, broker_stack,
+			K_THREAD_STACK_SIZEOF(broker_stack),
+			broker_fn, INT_TO_POINTER(listen_sock), NULL, NULL,
+			BROKER_PRIORITY, 0, K_NO_WAIT);
+
+	ret = client_connect();
+	if (ret < 0) {
+		printk("Failed to connect (%d)\n", ret);
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(payload_sizes); i++) {
+		ret = publish_run(payload_sizes[i], 1);
+		if (ret == 0) {
+			ret = publish_run(payload_sizes[i],
+					  CONFIG_MQTT_INFLIGHT_WINDOW_SIZE);
+		}
+
+		if (ret < 0) {
+			printk("Publish failed (%d)\n", ret);
+			return;
+		}
+	}
+
+	(void)mqtt_disconnect(&client);
+
+	printk("fin\n");
+}
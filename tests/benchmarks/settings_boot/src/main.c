@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the boot time load of many settings spread over many handlers,
+ * the handler lookup and settings_get_val(), see README.rst.
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <settings/settings.h>
+#include <storage/flash_map.h>
+#include <stats/stats.h>
+#include <sys/printk.h>
+#include <sys/util.h>
+
+#define HANDLER_CNT 30
+#define KEY_CNT CONFIG_BENCHMARK_KEYS
+
+#if defined(CONFIG_SETTINGS_FCB_INDEX)
+#define MODE "index"
+#elif defined(CONFIG_SETTINGS_HANDLER_LOOKUP)
+#define MODE "lookup"
+#else
+#define MODE "linear"
+#endif
+
+static uint32_t loaded;
+
+/* Keys are "k<n>", of value n */
+static int bench_set(const char *key, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	uint32_t val;
+
+	if ((key == NULL) || (key[0] != 'k') || (len != sizeof(val)) ||
+	    (read_cb(cb_arg, &val, len) != len) ||
+	    (val != strtoul(&key[1], NULL, 10))) {
+		return -EINVAL;
+	}
+
+	loaded++;
+
+	return 0;
+}
+
+#define BENCH_HANDLER_DEFINE(i, _)					     \
+	SETTINGS_STATIC_HANDLER_DEFINE(bench_ ## i, "h" STRINGIFY(i), NULL, \
+				       bench_set, NULL, NULL);
+
+UTIL_LISTIFY(HANDLER_CNT, BENCH_HANDLER_DEFINE, _)
+
+static void key_name(char *name, size_t size, uint32_t i)
+{
+	snprintf(name, size, "h%u/k%u", i % HANDLER_CNT, i);
+}
+
+static int read_walk(struct stats_hdr *hdr, void *arg, const char *name,
+		     uint16_t off)
+{
+	if (strcmp(name, "flash_read_calls") == 0) {
+		*(uint32_t *)arg = *(uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static uint32_t flash_reads(void)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+	uint32_t reads = 0U;
+
+	if (hdr != NULL) {
+		(void)stats_walk(hdr, read_walk, &reads);
+	}
+
+	return reads;
+}
+
+static int storage_erase(void)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	if (rc != 0) {
+		return rc;
+	}
+
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	flash_area_close(fa);
+
+	return rc;
+}
+
+static int settings_add(void)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	int rc;
+
+	for (uint32_t i = 0; i < KEY_CNT; i++) {
+		key_name(name, sizeof(name), i);
+		rc = settings_save_one(name, &i, sizeof(i));
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+static int lookup_all(void)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	const char *next;
+
+	for (uint32_t i = 0; i < KEY_CNT; i++) {
+		key_name(name, sizeof(name), i);
+		if (settings_parse_and_lookup(name, &next) == NULL) {
+			return -ENOENT;
+		}
+	}
+
+	return 0;
+}
+
+static int get_val_some(uint32_t *cnt)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t val;
+	int rc;
+
+	*cnt = 0U;
+
+	for (uint32_t i = 0; i < KEY_CNT; i += CONFIG_BENCHMARK_GET_VAL_STEP) {
+		key_name(name, sizeof(name), i);
+		rc = settings_get_val(name, &val, sizeof(val));
+		if ((rc != sizeof(val)) || (val != i)) {
+			return (rc < 0) ? rc : -EIO;
+		}
+		(*cnt)++;
+	}
+
+	return 0;
+}
+
+void main(void)
+{
+	uint32_t start, load_us, lookup_us, get_val_us, reads, cnt;
+	int rc;
+
+	printk("Settings boot: %u settings over %u handlers, mode: %s\n",
+	       KEY_CNT, HANDLER_CNT, MODE);
+
+	rc = storage_erase();
+	if (rc != 0) {
+		printk("Erase failed (%d)\n", rc);
+		return;
+	}
+
+	rc = settings_subsys_init();
+	if (rc != 0) {
+		printk("Settings init failed (%d)\n", rc);
+		return;
+	}
+
+	rc = settings_add();
+	if (rc != 0) {
+		printk("Save failed (%d)\n", rc);
+		return;
+	}
+
+	reads = flash_reads();
+	start = k_cycle_get_32();
+
+	rc = settings_load();
+
+	load_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	reads = flash_reads() - reads;
+
+	if ((rc != 0) || (loaded != KEY_CNT)) {
+		printk("Load failed (%d), %u of %u settings\n", rc, loaded,
+		       KEY_CNT);
+		return;
+	}
+
+	start = k_cycle_get_32();
+	rc = lookup_all();
+	lookup_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	if (rc != 0) {
+		printk("Lookup failed (%d)\n", rc);
+		return;
+	}
+
+	start = k_cycle_get_32();
+	rc = get_val_some(&cnt);
+	get_val_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	if (rc != 0) {
+		printk("Get value failed (%d)\n", rc);
+		return;
+	}
+
+	printk("SETTINGS_BOOT %s: %u keys, %u handlers, load %u us, "
+	       "%u flash reads, lookup %u us, get_val %u us\n", MODE, KEY_CNT,
+	       HANDLER_CNT, load_us, reads, lookup_us,
+	       get_val_us / MAX(cnt, 1U));
+
+	printk("fin\n");
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure settings_load() from an FCB against the number of stored
+ * settings, see README.rst.
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <stdio.h>
+#include <settings/settings.h>
+#include <storage/flash_map.h>
+#include <stats/stats.h>
+#include <sys/printk.h>
+
+#if defined(CONFIG_SETTINGS_FCB_INDEX)
+#define MODE "index"
+#elif defined(CONFIG_FCB_SECTOR_SUMMARY)
+#define MODE "summary"
+#else
+#define MODE "scan"
+#endif
+
+static uint32_t loaded;
+
+static int bench_set(const char *name, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	uint32_t val;
+
+	if ((len != sizeof(val)) || (read_cb(cb_arg, &val, len) != len)) {
+		return -EINVAL;
+	}
+
+	loaded++;
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bench, "bench", NULL, bench_set, NULL, NULL);
+
+static int read_walk(struct stats_hdr *hdr, void *arg, const char *name,
+		     uint16_t off)
+{
+	if (strcmp(name, "flash_read_calls") == 0) {
+		*(uint32_t *)arg = *(uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static uint32_t flash_reads(void)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+	uint32_t reads = 0U;
+
+	if (hdr != NULL) {
+		(void)stats_walk(hdr, read_walk, &reads);
+	}
+
+	return reads;
+}
+
+static int storage_erase(void)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	if (rc != 0) {
+		return rc;
+	}
+
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	flash_area_close(fa);
+
+	return rc;
+}
+
+/* Each setting is stored twice, the first value being overridden. */
+static int settings_add(uint32_t first, uint32_t cnt)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	int rc;
+
+	for (uint32_t i = first; i < first + cnt; i++) {
+		for (uint32_t val = i; val < i + 2U; val++) {
+			snprintf(name, sizeof(name), "bench/%u", i);
+			rc = settings_save_one(name, &val, sizeof(val));
+			if (rc != 0) {
+				return rc;
+			}
+		}
+	}
+
+	return 0;
+}
+
+void main(void)
+{
+	uint32_t entries = 0U;
+	int rc;
+
+	printk("Settings load: up to %u settings by %u, mode: %s\n",
+	       CONFIG_BENCHMARK_ENTRIES, CONFIG_BENCHMARK_STEP, MODE);
+
+	rc = storage_erase();
+	if (rc != 0) {
+		printk("Erase failed (%d)\n", rc);
+		return;
+	}
+
+	rc = settings_subsys_init();
+	if (rc != 0) {
+		printk("Settings init failed (%d)\n", rc);
+		return;
+	}
+
+	while (entries < CONFIG_BENCHMARK_ENTRIES) {
+		uint32_t start, us, reads;
+
+		rc = settings_add(entries, CONFIG_BENCHMARK_STEP);
+		if (rc != 0) {
+			printk("Save failed (%d)\n", rc);
+			return;
+		}
+		entries += CONFIG_BENCHMARK_STEP;
+
+		loaded = 0U;
+		reads = flash_reads();
+		start = k_cycle_get_32();
+
+		rc = settings_load();
+
+		us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+		reads = flash_reads() - reads;
+
+		if ((rc != 0) || (loaded != entries)) {
+			printk("Load failed (%d), %u of %u settings\n", rc,
+			       loaded, entries);
+			return;
+		}
+
+		printk("SETTINGS_LOAD %s: %u entries, %u records, %u us, "
+		       "%u flash reads\n", MODE, entries, 2U * entries, us,
+		       reads);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the throughput of the UART shell output and the CPU time it leaves
+ * to the other threads, see README.rst.
+ */
+
+#include <kernel.h>
+#include <shell/shell.h>
+#include <shell/shell_uart.h>
+#include <sys/printk.h>
+#include <stdlib.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define BACKGROUND_LOOP_US 100
+
+#define LINE_FMT "line %05u: 0123456789abcdefghijklmnopqrstuvwxyz"
+
+static atomic_t background_loops;
+static uint32_t output_bytes;
+
+static void background(void *p1, void *p2, void *p3)
+{
+	for (;;) {
+		k_busy_wait(BACKGROUND_LOOP_US);
+		atomic_inc(&background_loops);
+		/* Let the shell thread run. */
+		k_yield();
+	}
+}
+
+K_THREAD_DEFINE(background_id, STACK_SIZE, background, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+static int cmd_bench_lines(const struct shell *shell, size_t argc,
+			   char **argv)
+{
+	char line[sizeof(LINE_FMT) + 8];
+	uint32_t cnt = strtoul(argv[1], NULL, 0);
+
+	output_bytes = 0U;
+
+	for (uint32_t i = 0; i < cnt; i++) {
+		/* Lines end with CR LF. */
+		output_bytes += snprintk(line, sizeof(line), LINE_FMT, i) + 2;
+		shell_print(shell, "%s", line);
+	}
+
+	return 0;
+}
+
+SHELL_CMD_ARG_REGISTER(bench_lines, NULL, "Print <count> lines.",
+		       cmd_bench_lines, 2, 0);
+
+static const char *mode_name(void)
+{
+	if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_ASYNC)) {
+		return "async";
+	} else if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN)) {
+		return "interrupt";
+	}
+
+	return "polled";
+}
+
+/* Wait until the transport has transmitted all of the output. */
+static void drain(const struct shell *shell)
+{
+	const struct shell_uart *sh_uart = shell->iface->ctx;
+
+	while (atomic_get(&sh_uart->ctrl_blk->tx_busy) != 0) {
+		k_msleep(1);
+	}
+}
+
+void main(void)
+{
+	const struct shell *shell = shell_backend_uart_get_ptr();
+	char cmd[sizeof("bench_lines ") + 10];
+	int64_t start, cmd_ms, total_ms;
+	uint32_t loops;
+
+	printk("Shell output: %u lines, mode: %s\n", CONFIG_BENCHMARK_LINES,
+	       mode_name());
+
+	/* Let the shell print its prompt. */
+	k_msleep(100);
+	drain(shell);
+
+	snprintk(cmd, sizeof(cmd), "bench_lines %u", CONFIG_BENCHMARK_LINES);
+	shell->stats->tx_stall_cnt = 0;
+	atomic_clear(&background_loops);
+	start = k_uptime_get();
+
+	(void)shell_execute_cmd(shell, cmd);
+	cmd_ms = k_uptime_get() - start;
+
+	drain(shell);
+	total_ms = MAX(k_uptime_get() - start, 1);
+	loops = (uint32_t)atomic_get(&background_loops);
+
+	printk("SHELL_OUTPUT %s: %u lines %u B, command %u ms, "
+	       "drained %u ms, %u lines/s, stalls %u, background %u %%\n",
+	       mode_name(), CONFIG_BENCHMARK_LINES, output_bytes,
+	       (uint32_t)cmd_ms, (uint32_t)total_ms,
+	       (uint32_t)(CONFIG_BENCHMARK_LINES * MSEC_PER_SEC / total_ms),
+	       (uint32_t)atomic_get(&shell->stats->tx_stall_cnt),
+	       (uint32_t)MIN((uint64_t)loops * BACKGROUND_LOOP_US * 100U /
+			     (total_ms * USEC_PER_MSEC), 100U));
+
+	printk("fin\n");
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the download time of an image written with stream flash, with
+ * synchronous writes, double buffered writes and double buffered writes
+ * erasing ahead, see README.rst.
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <storage/flash_map.h>
+#include <storage/stream_flash.h>
+#include <sys/printk.h>
+
+#define IMAGE_SIZE CONFIG_BENCHMARK_IMAGE_SIZE
+#define CHUNK_SIZE CONFIG_BENCHMARK_CHUNK_SIZE
+#define WRITE_SIZE CONFIG_BENCHMARK_WRITE_SIZE
+
+/* Time taken by the line to deliver a chunk */
+#define CHUNK_US ((uint32_t)((uint64_t)CHUNK_SIZE * USEC_PER_SEC / \
+			     CONFIG_BENCHMARK_LINE_RATE))
+
+BUILD_ASSERT(IMAGE_SIZE % CHUNK_SIZE == 0,
+	     "The image must be made of whole chunks");
+
+enum mode {
+	MODE_SYNC,
+	MODE_ASYNC,
+	MODE_AHEAD,
+};
+
+static const char *const mode_name[] = {
+	[MODE_SYNC] = "sync",
+	[MODE_ASYNC] = "async",
+	[MODE_AHEAD] = "ahead",
+};
+
+static struct stream_flash_ctx ctx;
+static uint8_t write_buf[2 * WRITE_SIZE];
+static uint8_t chunk[CHUNK_SIZE];
+static size_t progress;
+
+static void download_progress(struct stream_flash_ctx *sctx,
+			      size_t bytes_written)
+{
+	progress = bytes_written;
+}
+
+/*
+ * Network stand-in: the next chunk is requested when the previous one has
+ * been handed to stream flash, and arrives after the time the line takes
+ * to deliver it.
+ */
+static const uint8_t *chunk_receive(uint32_t idx)
+{
+	k_sleep(K_USEC(CHUNK_US));
+
+	for (size_t i = 0; i < CHUNK_SIZE; i++) {
+		chunk[i] = (uint8_t)(idx + i);
+	}
+
+	return chunk;
+}
+
+static int download(const struct flash_area *fa, enum mode mode)
+{
+	const struct device *fdev = device_get_binding(fa->fa_dev_name);
+	uint32_t start, wait = 0U, flush;
+	uint32_t t;
+	int rc;
+
+	/* The double buffered modes write halves of the buffer */
+	rc = stream_flash_init(&ctx, fdev, write_buf,
+			       (mode == MODE_SYNC) ? WRITE_SIZE :
+						     2 * WRITE_SIZE,
+			       fa->fa_off, fa->fa_size, NULL);
+	if (rc != 0) {
+		return rc;
+	}
+
+	stream_flash_progress_cb_set(&ctx, download_progress);
+	progress = 0U;
+
+	if (mode != MODE_SYNC) {
+		rc = stream_flash_async_enable(&ctx, (mode == MODE_AHEAD) ?
+					       CONFIG_BENCHMARK_ERASE_AHEAD :
+					       0);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0U; i < IMAGE_SIZE / CHUNK_SIZE; i++) {
+		const uint8_t *data = chunk_receive(i);
+
+		t = k_cycle_get_32();
+		rc = stream_flash_buffered_write(&ctx, data, CHUNK_SIZE,
+						 false);
+		wait += k_cycle_get_32() - t;
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	t = k_cycle_get_32();
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	flush = k_cycle_get_32() - t;
+	if (rc != 0) {
+		return rc;
+	}
+
+	if ((stream_flash_bytes_written(&ctx) != IMAGE_SIZE) ||
+	    (progress != IMAGE_SIZE)) {
+		return -EIO;
+	}
+
+	printk("STREAM_FLASH %s: %u bytes at %u B/s, download %u us, "
+	       "write wait %u us, flush %u us\n", mode_name[mode],
+	       IMAGE_SIZE, CONFIG_BENCHMARK_LINE_RATE,
+	       k_cyc_to_us_floor32(k_cycle_get_32() - start),
+	       k_cyc_to_us_floor32(wait), k_cyc_to_us_floor32(flush));
+
+	return 0;
+}
+
+void main(void)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	printk("Stream flash download: %u bytes in %u byte chunks, "
+	       "%u byte writes\n", IMAGE_SIZE, CHUNK_SIZE, WRITE_SIZE);
+
+	rc = flash_area_open(FLASH_AREA_ID(image_1), &fa);
+	if (rc != 0) {
+		printk("Flash area open failed (%d)\n", rc);
+		return;
+	}
+
+	for (enum mode mode = MODE_SYNC; mode <= MODE_AHEAD; mode++) {
+		rc = download(fa, mode);
+		if (rc != 0) {
+			printk("Download %s failed (%d)\n", mode_name[mode],
+			       rc);
+			return;
+		}
+	}
+
+	flash_area_close(fa);
+
+	printk("fin\n");
+}
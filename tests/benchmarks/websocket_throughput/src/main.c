@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <sys/base64.h>
+#include <net/socket.h>
+#include <net/websocket.h>
+#include <mbedtls/sha1.h>
+
+/* Websocket frame round trip throughput over loopback, with a minimal echo
+ * server running in a separate thread. The client sends masked frames,
+ * the server echoes them back unmasked.
+ */
+
+#define SERVER_PORT 8080
+#define FRAME_COUNT 200
+#define MAX_PAYLOAD 8192
+#define HTTP_BUF_SIZE 512
+
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+#define WS_MAGIC "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_KEY_FIELD "Sec-WebSocket-Key: "
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static uint8_t payload[MAX_PAYLOAD];
+static uint8_t recv_buf[MAX_PAYLOAD];
+static uint8_t server_buf[MAX_PAYLOAD];
+static uint8_t http_buf[HTTP_BUF_SIZE];
+static char server_http_buf[HTTP_BUF_SIZE];
+
+static struct sockaddr_in server_addr;
+
+static const size_t payload_sizes[] = { 16, 128, 1024, MAX_PAYLOAD };
+
+static int recv_all(int sock, uint8_t *buf, size_t len)
+{
+	size_t offset = 0;
+	int ret;
+
+	while (offset < len) {
+		ret = zsock_recv(sock, buf + offset, len - offset, 0);
+		if (ret <= 0) {
+			return -1;
+		}
+
+		offset += ret;
+	}
+
+	return 0;
+}
+
+static int send_all(int sock, const uint8_t *buf, size_t len)
+{
+	size_t offset = 0;
+	int ret;
+
+	while (offset < len) {
+		ret = zsock_send(sock, buf + offset, len - offset, 0);
+		if (ret < 0) {
+			return -1;
+		}
+
+		offset += ret;
+	}
+
+	return 0;
+}
+
+static int server_handshake(int sock)
+{
+	static const char response[] =
+		"HTTP/1.1 101 Switching Protocols\r\n"
+		"Upgrade: websocket\r\n"
+		"Connection: Upgrade\r\n"
+		"Sec-WebSocket-Accept: ";
+	uint8_t sha1[20];
+	char accept[64];
+	size_t len = 0, olen;
+	char *key, *end;
+	int ret;
+
+	/* Read the HTTP request header */
+	while (len < sizeof(server_http_buf) - 1) {
+		ret = zsock_recv(sock, server_http_buf + len,
+				 sizeof(server_http_buf) - 1 - len, 0);
+		if (ret <= 0) {
+			return -1;
+		}
+
+		len += ret;
+		server_http_buf[len] = '\0';
+
+		if (strstr(server_http_buf, "\r\n\r\n") != NULL) {
+			break;
+		}
+	}
+
+	key = strstr(server_http_buf, WS_KEY_FIELD);
+	if (key == NULL) {
+		return -1;
+	}
+
+	key += sizeof(WS_KEY_FIELD) - 1;
+	end = strstr(key, "\r\n");
+	if (end == NULL || end - key + sizeof(WS_MAGIC) > sizeof(accept)) {
+		return -1;
+	}
+
+	len = end - key;
+	memcpy(accept, key, len);
+	memcpy(accept + len, WS_MAGIC, sizeof(WS_MAGIC) - 1);
+
+	mbedtls_sha1_ret((const unsigned char *)accept,
+			 len + sizeof(WS_MAGIC) - 1, sha1);
+
+	if (base64_encode(accept, sizeof(accept), &olen, sha1,
+			  sizeof(sha1)) < 0) {
+		return -1;
+	}
+
+	if (send_all(sock, response, sizeof(response) - 1) < 0 ||
+	    send_all(sock, accept, olen) < 0 ||
+	    send_all(sock, "\r\n\r\n", 4) < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Read one client frame and echo its payload back unmasked. */
+static int server_echo_frame(int sock)
+{
+	uint8_t hdr[14];
+	uint8_t mask[4];
+	size_t len, hdr_len = 2;
+	int i;
+
+	if (recv_all(sock, hdr, 2) < 0) {
+		return -1;
+	}
+
+	len = hdr[1] & 0x7f;
+	if (len == 126) {
+		if (recv_all(sock, &hdr[2], 2) < 0) {
+			return -1;
+		}
+
+		len = (hdr[2] << 8) | hdr[3];
+		hdr_len += 2;
+	} else if (len == 127) {
+		/* Larger frames than MAX_PAYLOAD are not used */
+		return -1;
+	}
+
+	if (len > sizeof(server_buf)) {
+		return -1;
+	}
+
+	if (hdr[1] & 0x80) {
+		if (recv_all(sock, mask, sizeof(mask)) < 0) {
+			return -1;
+		}
+	}
+
+	if (recv_all(sock, server_buf, len) < 0) {
+		return -1;
+	}
+
+	if ((hdr[0] & 0x0f) == WEBSOCKET_OPCODE_CLOSE) {
+		return -1;
+	}
+
+	if (hdr[1] & 0x80) {
+		for (i = 0; i < len; i++) {
+			server_buf[i] ^= mask[i % sizeof(mask)];
+		}
+	}
+
+	/* Echo back without mask */
+	hdr[1] &= ~0x80;
+
+	if (send_all(sock, hdr, hdr_len) < 0 ||
+	    send_all(sock, server_buf, len) < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+static void server_fn(void *p1, void *p2, void *p3)
+{
+	int listen_sock = POINTER_TO_INT(p1);
+	int sock;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		sock = zsock_accept(listen_sock, NULL, NULL);
+		if (sock < 0) {
+			continue;
+		}
+
+		if (server_handshake(sock) == 0) {
+			while (server_echo_frame(sock) == 0) {
+			}
+		}
+
+		(void)zsock_close(sock);
+	}
+}
+
+static int echo_frame(int ws_sock, size_t payload_len)
+{
+	uint64_t remaining = 0;
+	uint32_t message_type;
+	size_t total = 0;
+	int ret;
+
+	ret = websocket_send_msg(ws_sock, payload, payload_len,
+				 WEBSOCKET_OPCODE_DATA_BINARY, true, true,
+				 SYS_FOREVER_MS);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (ret != payload_len) {
+		return -EIO;
+	}
+
+	do {
+		ret = websocket_recv_msg(ws_sock, recv_buf + total,
+					 sizeof(recv_buf) - total,
+					 &message_type, &remaining,
+					 SYS_FOREVER_MS);
+		if (ret == -EAGAIN) {
+			/* Only the frame header was received so far */
+			continue;
+		} else if (ret <= 0) {
+			return ret < 0 ? ret : -ECONNRESET;
+		}
+
+		total += ret;
+	} while (remaining > 0 || total < payload_len);
+
+	return 0;
+}
+
+static int echo_run(int ws_sock, size_t payload_len)
+{
+	uint32_t start, elapsed_ms;
+	int ret, i;
+
+	start = k_uptime_get_32();
+
+	for (i = 0; i < FRAME_COUNT; i++) {
+		ret = echo_frame(ws_sock, payload_len);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	elapsed_ms = MAX(k_uptime_get_32() - start, 1);
+
+	if (memcmp(recv_buf, payload, payload_len) != 0) {
+		printk("Echoed payload does not match\n");
+		return -EINVAL;
+	}
+
+	printk("payload %zu: %u frames/s %u B/s\n", payload_len,
+	       FRAME_COUNT * 1000U / elapsed_ms,
+	       (uint32_t)(FRAME_COUNT * payload_len * 1000U / elapsed_ms));
+
+	return 0;
+}
+
+void main(void)
+{
+	struct websocket_request req = { 0 };
+	int listen_sock, sock, ws_sock, ret, i;
+
+	for (i = 0; i < sizeof(payload); i++) {
+		payload[i] = i;
+	}
+
+	server_addr.sin_family = AF_INET;
+	server_addr.sin_port = htons(SERVER_PORT);
+	zsock_inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+			&server_addr.sin_addr);
+
+	listen_sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listen_sock < 0 ||
+	    zsock_bind(listen_sock, (struct sockaddr *)&server_addr,
+		       sizeof(server_addr)) < 0 ||
+	    zsock_listen(listen_sock, 1) < 0) {
+		printk("Failed to set up server socket (%d)\n", errno);
+		return;
+	}
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server_fn, INT_TO_POINTER(listen_sock), NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0 ||
+	    zsock_connect(sock, (struct sockaddr *)&server_addr,
+			  sizeof(server_addr)) < 0) {
+		printk("Failed to connect (%d)\n", errno);
+		return;
+	}
+
+	req.host = CONFIG_NET_CONFIG_MY_IPV4_ADDR;
+	req.url = "/";
+	req.tmp_buf = http_buf;
+	req.tmp_buf_len = sizeof(http_buf);
+
+	ws_sock = websocket_connect(sock, &req, 3000, NULL);
+	if (ws_sock < 0) {
+		printk("Websocket handshake failed (%d)\n", ws_sock);
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(payload_sizes); i++) {
+		ret = echo_run(ws_sock, payload_sizes[i]);
+		if (ret < 0) {
+			printk("Echo failed (%d)\n", ret);
+			return;
+		}
+	}
+
+	(void)websocket_disconnect(ws_sock);
+
+	printk("fin\n");
+}
@@ -6,7 +6,10 @@
 
 #include <ztest.h>
 #include <drivers/flash.h>
+#include <drivers/flash/flash_simulator.h>
 #include <device.h>
+#include <stats/stats.h>
+#include <string.h>
 
 /* configuration derived from DT */
 #ifdef CONFIG_ARCH_POSIX
@@ -306,6 +309,112 @@ static void test_get_erase_value(void)
 		      FLASH_SIMULATOR_ERASE_VALUE);
 }
 
+static void test_wear(void)
+{
+	struct flash_simulator_wear wear;
+	uint32_t cycles;
+	int rc;
+
+	flash_simulator_stats_reset(flash_dev);
+
+	rc = flash_write_protection_set(flash_dev, false);
+	zassert_equal(0, rc, NULL);
+
+	for (int i = 0; i < 3; i++) {
+		rc = flash_erase(flash_dev, FLASH_SIMULATOR_BASE_OFFSET +
+				 FLASH_SIMULATOR_ERASE_UNIT,
+				 FLASH_SIMULATOR_ERASE_UNIT);
+		zassert_equal(0, rc, "flash_erase should succeed");
+	}
+
+	rc = flash_simulator_erase_cycles_get(flash_dev,
+					      FLASH_SIMULATOR_BASE_OFFSET +
+					      FLASH_SIMULATOR_ERASE_UNIT + 1,
+					      &cycles);
+	zassert_equal(0, rc, "Unexpected error code (%d)", rc);
+	zassert_equal(3, cycles, "Unexpected erase cycles %u", cycles);
+
+	rc = flash_simulator_erase_cycles_get(flash_dev,
+					      FLASH_SIMULATOR_BASE_OFFSET,
+					      &cycles);
+	zassert_equal(0, rc, "Unexpected error code (%d)", rc);
+	zassert_equal(0, cycles, "Unexpected erase cycles %u", cycles);
+
+	rc = flash_simulator_erase_cycles_get(flash_dev, TEST_SIM_FLASH_END,
+					      &cycles);
+	zassert_equal(-EINVAL, rc, "Unexpected error code (%d)", rc);
+
+	flash_simulator_wear_get(flash_dev, &wear);
+	zassert_equal(0, wear.min_erase_cycles, NULL);
+	zassert_equal(3, wear.max_erase_cycles, NULL);
+	zassert_equal(3, wear.total_erase_cycles, NULL);
+	zassert_equal(FLASH_SIMULATOR_FLASH_SIZE / FLASH_SIMULATOR_ERASE_UNIT,
+		      wear.unit_count, NULL);
+	zassert_equal((CONFIG_FLASH_SIMULATOR_ENDURANCE != 0) &&
+		      (CONFIG_FLASH_SIMULATOR_ENDURANCE < 3), wear.worn_units,
+		      "Unexpected worn units %u", wear.worn_units);
+}
+
+#ifdef CONFIG_FLASH_SIMULATOR_SIMULATE_TIMING
+static uint32_t *write_time_us;
+static uint32_t *erase_time_us;
+
+static int flash_sim_stat_find(struct stats_hdr *hdr, void *arg,
+			       const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_write_time_us")) {
+		write_time_us = (uint32_t *)((uint8_t *)hdr + off);
+	} else if (!strcmp(name, "flash_erase_time_us")) {
+		erase_time_us = (uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static void test_timing(void)
+{
+	const uint32_t erase_us = CONFIG_FLASH_SIMULATOR_MIN_ERASE_TIME_US +
+			2 * CONFIG_FLASH_SIMULATOR_ERASE_TIME_US_PER_UNIT;
+	const uint32_t write_us = CONFIG_FLASH_SIMULATOR_MIN_WRITE_TIME_US +
+			64 * CONFIG_FLASH_SIMULATOR_WRITE_TIME_NS_PER_BYTE / 1000;
+	uint32_t start, elapsed;
+	int rc;
+
+	stats_walk(stats_group_find("flash_sim_stats"), flash_sim_stat_find,
+		   NULL);
+	zassert_not_null(write_time_us, "flash_write_time_us not found");
+	zassert_not_null(erase_time_us, "flash_erase_time_us not found");
+
+	flash_simulator_stats_reset(flash_dev);
+
+	rc = flash_write_protection_set(flash_dev, false);
+	zassert_equal(0, rc, NULL);
+
+	start = k_cycle_get_32();
+	rc = flash_erase(flash_dev, FLASH_SIMULATOR_BASE_OFFSET,
+			 FLASH_SIMULATOR_ERASE_UNIT * 2);
+	elapsed = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	zassert_equal(0, rc, "flash_erase should succeed");
+	zassert_equal(erase_us, *erase_time_us, "Unexpected erase time %u",
+		      *erase_time_us);
+	zassert_true(elapsed >= erase_us, "Erase took %u us", elapsed);
+
+	start = k_cycle_get_32();
+	rc = flash_write(flash_dev, FLASH_SIMULATOR_BASE_OFFSET,
+			 test_read_buf, 64);
+	elapsed = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	zassert_equal(0, rc, "flash_write should succeed");
+	zassert_equal(write_us, *write_time_us, "Unexpected write time %u",
+		      *write_time_us);
+	zassert_true(elapsed >= write_us, "Write took %u us", elapsed);
+}
+#else
+static void test_timing(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(flash_sim_api,
@@ -317,7 +426,9 @@ void test_main(void)
 			 ztest_unit_test(test_out_of_bounds),
 			 ztest_unit_test(test_align),
 			 ztest_unit_test(test_get_erase_value),
-			 ztest_unit_test(test_double_write));
+			 ztest_unit_test(test_double_write),
+			 ztest_unit_test(test_wear),
+			 ztest_unit_test(test_timing));
 
 	ztest_run_test_suite(flash_sim_api);
 }
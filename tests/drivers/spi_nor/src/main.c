@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <drivers/flash.h>
+#include <drivers/flash/spi_nor.h>
+#include <device.h>
+#include <string.h>
+
+#define FLASH_NODE DT_INST(0, jedec_spi_nor)
+#define FLASH_SIZE (DT_PROP(FLASH_NODE, size) / 8)
+
+#define SECTOR_SIZE 0x1000
+#define BLOCK_SIZE 0x10000
+
+/* Erase durations of the emulated device, in milliseconds */
+#define SE_TIME_MS 45
+#define BE_TIME_MS 150
+
+/* Areas used by the tests */
+#define RW_OFFSET 0x0
+#define ERASE_OFFSET 0x20000
+#define ASYNC_OFFSET 0x40000
+#define FAR_OFFSET 0x80000
+
+static const struct device *flash_dev;
+static uint8_t buf[2 * SECTOR_SIZE];
+static uint8_t pattern[2 * SECTOR_SIZE];
+
+static void pattern_fill(uint8_t seed)
+{
+	for (size_t i = 0; i < sizeof(pattern); i++) {
+		pattern[i] = (uint8_t)(seed + i);
+	}
+}
+
+static void check_erased(off_t offset, size_t size)
+{
+	while (size > 0) {
+		size_t len = MIN(size, sizeof(buf));
+
+		zassert_equal(flash_read(flash_dev, offset, buf, len), 0,
+			      "read failed");
+		for (size_t i = 0; i < len; i++) {
+			zassert_equal(buf[i], 0xff, "not erased at 0x%lx",
+				      (long)(offset + i));
+		}
+
+		offset += len;
+		size -= len;
+	}
+}
+
+static void test_setup(void)
+{
+	flash_dev = device_get_binding(DT_LABEL(FLASH_NODE));
+	zassert_not_null(flash_dev, "SPI NOR flash not found");
+}
+
+static void test_read_write(void)
+{
+	int rc;
+
+	rc = flash_erase(flash_dev, RW_OFFSET, 2 * SECTOR_SIZE);
+	zassert_equal(rc, 0, "erase failed: %d", rc);
+
+	/* Write across page boundaries */
+	pattern_fill(0x10);
+	rc = flash_write(flash_dev, RW_OFFSET + 100, pattern, 1000);
+	zassert_equal(rc, 0, "write failed: %d", rc);
+
+	rc = flash_read(flash_dev, RW_OFFSET + 100, buf, 1000);
+	zassert_equal(rc, 0, "read failed: %d", rc);
+	zassert_mem_equal(buf, pattern, 1000, "read back mismatch");
+
+	/* Small reads, within and across cache blocks */
+	for (size_t i = 0; i < 1000; i += 7) {
+		size_t len = MIN(13, 1000 - i);
+
+		rc = flash_read(flash_dev, RW_OFFSET + 100 + i, buf, len);
+		zassert_equal(rc, 0, "read failed: %d", rc);
+		zassert_mem_equal(buf, &pattern[i], len,
+				  "small read mismatch at %zu", i);
+	}
+
+	/* A write following a cached read is read back */
+	rc = flash_read(flash_dev, RW_OFFSET + 1100, buf, 4);
+	zassert_equal(rc, 0, "read failed: %d", rc);
+	zassert_equal(buf[0], 0xff, "not erased");
+
+	rc = flash_write(flash_dev, RW_OFFSET + 1100, pattern, 4);
+	zassert_equal(rc, 0, "write failed: %d", rc);
+
+	rc = flash_read(flash_dev, RW_OFFSET + 1100, buf, 4);
+	zassert_equal(rc, 0, "read failed: %d", rc);
+	zassert_mem_equal(buf, pattern, 4, "cached read is stale");
+
+	/* So is an erase */
+	rc = flash_erase(flash_dev, RW_OFFSET, SECTOR_SIZE);
+	zassert_equal(rc, 0, "erase failed: %d", rc);
+	check_erased(RW_OFFSET + 1100, 4);
+}
+
+static void test_erase_invalid(void)
+{
+	zassert_equal(flash_erase(flash_dev, ERASE_OFFSET + 1, SECTOR_SIZE),
+		      -EINVAL, "unaligned erase accepted");
+	zassert_equal(flash_erase(flash_dev, ERASE_OFFSET, SECTOR_SIZE + 1),
+		      -EINVAL, "partial sector erase accepted");
+	zassert_equal(flash_erase(flash_dev, FLASH_SIZE - SECTOR_SIZE,
+				  2 * SECTOR_SIZE),
+		      -ENODEV, "erase beyond the flash accepted");
+}
+
+static void test_erase_size_selection(void)
+{
+	uint32_t start;
+	uint32_t elapsed;
+	int rc;
+
+	pattern_fill(0x20);
+	for (off_t off = ERASE_OFFSET; off < ERASE_OFFSET + 2 * BLOCK_SIZE;
+	     off += SECTOR_SIZE) {
+		rc = flash_write(flash_dev, off, pattern, 16);
+		zassert_equal(rc, 0, "write failed: %d", rc);
+	}
+
+	/* An aligned block is erased with a single block erase */
+	start = k_uptime_get_32();
+	rc = flash_erase(flash_dev, ERASE_OFFSET, BLOCK_SIZE);
+	elapsed = k_uptime_get_32() - start;
+	zassert_equal(rc, 0, "erase failed: %d", rc);
+	zassert_true(elapsed < 2 * BE_TIME_MS, "block erase took %u ms",
+		     elapsed);
+	check_erased(ERASE_OFFSET, BLOCK_SIZE);
+
+	/* An unaligned block needs sector and smaller block erases, but
+	 * still less than one erase per sector.
+	 */
+	start = k_uptime_get_32();
+	rc = flash_erase(flash_dev, ERASE_OFFSET + BLOCK_SIZE - SECTOR_SIZE,
+			 BLOCK_SIZE);
+	elapsed = k_uptime_get_32() - start;
+	zassert_equal(rc, 0, "erase failed: %d", rc);
+	zassert_true(elapsed < (BLOCK_SIZE / SECTOR_SIZE) * SE_TIME_MS,
+		     "unaligned erase took %u ms", elapsed);
+	check_erased(ERASE_OFFSET + BLOCK_SIZE - SECTOR_SIZE, BLOCK_SIZE);
+
+	/* The sector after the area is kept */
+	rc = flash_read(flash_dev, ERASE_OFFSET + 2 * BLOCK_SIZE - SECTOR_SIZE,
+			buf, 16);
+	zassert_equal(rc, 0, "read failed: %d", rc);
+	zassert_mem_equal(buf, pattern, 16, "sector after the area erased");
+}
+
+#ifdef CONFIG_SPI_NOR_ERASE_ASYNC
+static K_SEM_DEFINE(erase_done, 0, 1);
+static int erase_result;
+
+static void erase_cb(const struct device *dev, int result, void *user_data)
+{
+	zassert_equal(dev, flash_dev, "wrong device");
+	zassert_equal(user_data, &erase_result, "wrong user data");
+
+	erase_result = result;
+	k_sem_give(&erase_done);
+}
+
+static void test_erase_async(void)
+{
+	uint32_t start;
+	uint32_t elapsed;
+	int rc;
+
+	zassert_equal(spi_nor_erase_async(flash_dev, ASYNC_OFFSET, BLOCK_SIZE,
+					  NULL, NULL),
+		      -EINVAL, "NULL callback accepted");
+
+	rc = flash_erase(flash_dev, FAR_OFFSET, SECTOR_SIZE);
+	zassert_equal(rc, 0, "erase failed: %d", rc);
+
+	pattern_fill(0x30);
+	rc = flash_write(flash_dev, FAR_OFFSET, pattern, 64);
+	zassert_equal(rc, 0, "write failed: %d", rc);
+	rc = flash_write(flash_dev, ASYNC_OFFSET, pattern, 64);
+	zassert_equal(rc, 0, "write failed: %d", rc);
+	rc = flash_write(flash_dev, ASYNC_OFFSET + BLOCK_SIZE, pattern, 64);
+	zassert_equal(rc, 0, "write failed: %d", rc);
+
+	rc = spi_nor_erase_async(flash_dev, ASYNC_OFFSET, 2 * BLOCK_SIZE,
+				 erase_cb, &erase_result);
+	zassert_equal(rc, 0, "async erase failed: %d", rc);
+
+	zassert_equal(spi_nor_erase_async(flash_dev, FAR_OFFSET, SECTOR_SIZE,
+					  erase_cb, &erase_result),
+		      -EBUSY, "concurrent async erase accepted");
+	zassert_equal(flash_erase(flash_dev, FAR_OFFSET, SECTOR_SIZE),
+		      -EBUSY, "concurrent erase accepted");
+
+	/* Let the first block erase start */
+	k_sleep(K_MSEC(10));
+	zassert_equal(k_sem_count_get(&erase_done), 0, "erase done early");
+
+	/* Reading outside the area doesn't wait for the erase */
+	start = k_uptime_get_32();
+	rc = flash_read(flash_dev, FAR_OFFSET, buf, 64);
+	elapsed = k_uptime_get_32() - start;
+	zassert_equal(rc, 0, "read failed: %d", rc);
+	zassert_mem_equal(buf, pattern, 64, "read mismatch");
+	if (IS_ENABLED(CONFIG_SPI_NOR_ERASE_SUSPEND)) {
+		zassert_true(elapsed < 50, "read took %u ms", elapsed);
+	}
+
+	/* Reading the block left to erase waits for the whole erase */
+	rc = flash_read(flash_dev, ASYNC_OFFSET + BLOCK_SIZE, buf, 64);
+	zassert_equal(rc, 0, "read failed: %d", rc);
+	for (size_t i = 0; i < 64; i++) {
+		zassert_equal(buf[i], 0xff, "read before erase completed");
+	}
+
+	/* Reading the area being erased waits for it to be erased */
+	rc = flash_read(flash_dev, ASYNC_OFFSET, buf, 64);
+	zassert_equal(rc, 0, "read failed: %d", rc);
+	for (size_t i = 0; i < 64; i++) {
+		zassert_equal(buf[i], 0xff, "read before erase completed");
+	}
+
+	rc = k_sem_take(&erase_done, K_MSEC(10 * BE_TIME_MS));
+	zassert_equal(rc, 0, "erase callback not called");
+	zassert_equal(erase_result, 0, "async erase failed: %d",
+		      erase_result);
+
+	check_erased(ASYNC_OFFSET, 2 * BLOCK_SIZE);
+
+	rc = flash_read(flash_dev, FAR_OFFSET, buf, 64);
+	zassert_equal(rc, 0, "read failed: %d", rc);
+	zassert_mem_equal(buf, pattern, 64, "area outside erased");
+}
+#else
+static void test_erase_async(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_SPI_NOR_ERASE_ASYNC */
+
+void test_main(void)
+{
+	ztest_test_suite(spi_nor,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_read_write),
+			 ztest_unit_test(test_erase_invalid),
+			 ztest_unit_test(test_erase_size_selection),
+			 ztest_unit_test(test_erase_async));
+	ztest_run_test_suite(spi_nor);
+}
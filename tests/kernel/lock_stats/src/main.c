@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define LOOPS 10
+
+static K_THREAD_STACK_DEFINE(contender_stack, STACK_SIZE);
+static struct k_thread contender_thread;
+
+static struct k_spinlock spin_obj;
+static K_MUTEX_DEFINE(mutex_obj);
+static K_SEM_DEFINE(sem_obj, 0, 1);
+
+struct find_ctx {
+	const void *obj;
+	k_lock_stats_t stats;
+	bool found;
+};
+
+static void find_cb(const k_lock_stats_t *stats, void *user_data)
+{
+	struct find_ctx *ctx = user_data;
+
+	if (stats->obj == ctx->obj) {
+		zassert_false(ctx->found, "object reported twice");
+		ctx->stats = *stats;
+		ctx->found = true;
+	}
+}
+
+static bool stats_find(const void *obj, k_lock_stats_t *stats)
+{
+	struct find_ctx ctx = { .obj = obj };
+
+	k_lock_stats_foreach(find_cb, &ctx);
+	*stats = ctx.stats;
+
+	return ctx.found;
+}
+
+/**
+ * @brief Test spinlock acquisition and hold accounting
+ */
+static void test_spinlock(void)
+{
+	k_lock_stats_t stats;
+	k_spinlock_key_t key;
+
+	k_lock_stats_reset();
+
+	for (int i = 0; i < LOOPS; i++) {
+		key = k_spin_lock(&spin_obj);
+		k_busy_wait(10);
+		k_spin_unlock(&spin_obj, key);
+	}
+
+	zassert_true(stats_find(&spin_obj, &stats), "not tracked");
+	zassert_equal(stats.type, K_LOCK_SPINLOCK, "bad type");
+	zassert_equal(stats.count, LOOPS, "bad count %u", stats.count);
+	zassert_true(stats.hold_cycles >= stats.hold_max_cycles,
+		     "bad hold time");
+	zassert_true(stats.hold_max_cycles > 0U, "no hold time");
+}
+
+static void mutex_contender(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_mutex_lock(&mutex_obj, K_FOREVER), 0, "lock failed");
+	zassert_equal(k_mutex_unlock(&mutex_obj), 0, "unlock failed");
+}
+
+/**
+ * @brief Test mutex contention accounting
+ *
+ * A higher priority thread blocks on the mutex held by the test thread.
+ */
+static void test_mutex(void)
+{
+	k_lock_stats_t stats;
+
+	/* Run below the contending thread. */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(1));
+	k_lock_stats_reset();
+
+	/* Recursive locks are not separate acquisitions. */
+	zassert_equal(k_mutex_lock(&mutex_obj, K_FOREVER), 0, "lock failed");
+	zassert_equal(k_mutex_lock(&mutex_obj, K_FOREVER), 0, "lock failed");
+	zassert_equal(k_mutex_unlock(&mutex_obj), 0, "unlock failed");
+
+	zassert_true(stats_find(&mutex_obj, &stats), "not tracked");
+	zassert_equal(stats.type, K_LOCK_MUTEX, "bad type");
+	zassert_equal(stats.count, 1, "bad count %u", stats.count);
+	zassert_equal(stats.contended, 0, "bad contended %u", stats.contended);
+
+	k_thread_create(&contender_thread, contender_stack, STACK_SIZE,
+			mutex_contender, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	/* The contender preempted the test thread and blocked on the mutex. */
+	zassert_equal(k_mutex_unlock(&mutex_obj), 0, "unlock failed");
+	k_thread_join(&contender_thread, K_FOREVER);
+
+	zassert_true(stats_find(&mutex_obj, &stats), "not tracked");
+	zassert_equal(stats.count, 2, "bad count %u", stats.count);
+	zassert_equal(stats.contended, 1, "bad contended %u", stats.contended);
+	zassert_true(stats.wait_max_cycles > 0U, "no wait time");
+	zassert_true(stats.hold_max_cycles > 0U, "no hold time");
+}
+
+static void sem_giver(void *p1, void *p2, void *p3)
+{
+	k_sem_give(&sem_obj);
+}
+
+/**
+ * @brief Test semaphore contention accounting
+ */
+static void test_sem(void)
+{
+	k_lock_stats_t stats;
+
+	k_lock_stats_reset();
+
+	k_sem_give(&sem_obj);
+	zassert_equal(k_sem_take(&sem_obj, K_NO_WAIT), 0, "take failed");
+	zassert_equal(k_sem_take(&sem_obj, K_NO_WAIT), -EBUSY,
+		      "take succeeded");
+
+	zassert_true(stats_find(&sem_obj, &stats), "not tracked");
+	zassert_equal(stats.type, K_LOCK_SEM, "bad type");
+	zassert_equal(stats.count, 1, "bad count %u", stats.count);
+	zassert_equal(stats.contended, 1, "bad contended %u", stats.contended);
+
+	k_thread_create(&contender_thread, contender_stack, STACK_SIZE,
+			sem_giver, NULL, NULL, NULL,
+			K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_MSEC(10));
+
+	zassert_equal(k_sem_take(&sem_obj, K_FOREVER), 0, "take failed");
+	k_thread_join(&contender_thread, K_FOREVER);
+
+	zassert_true(stats_find(&sem_obj, &stats), "not tracked");
+	zassert_equal(stats.count, 2, "bad count %u", stats.count);
+	zassert_equal(stats.contended, 2, "bad contended %u", stats.contended);
+	zassert_true(stats.wait_max_cycles > 0U, "no wait time");
+	zassert_equal(stats.hold_cycles, 0, "semaphores have no hold time");
+}
+
+/**
+ * @brief Test object names and reset
+ */
+static void test_names(void)
+{
+	static struct k_spinlock named_lock;
+	k_lock_stats_t stats;
+	k_spinlock_key_t key;
+
+	zassert_equal(k_lock_stats_name_set(&named_lock, "named_lock"), 0,
+		      "name not set");
+
+	key = k_spin_lock(&named_lock);
+	k_spin_unlock(&named_lock, key);
+
+	zassert_true(stats_find(&named_lock, &stats), "not tracked");
+	zassert_not_null(stats.name, "no name");
+	zassert_equal(strcmp(stats.name, "named_lock"), 0, "bad name");
+
+	k_lock_stats_reset();
+	zassert_false(stats_find(&named_lock, &stats), "not reset");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lock_stats,
+			 ztest_unit_test(test_spinlock),
+			 ztest_unit_test(test_mutex),
+			 ztest_unit_test(test_sem),
+			 ztest_unit_test(test_names));
+	ztest_run_test_suite(lock_stats);
+}
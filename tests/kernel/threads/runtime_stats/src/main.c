@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WAKEUPS 10
+
+static K_THREAD_STACK_DEFINE(waiter_stack, STACK_SIZE);
+static struct k_thread waiter_thread;
+static K_SEM_DEFINE(waiter_sem, 0, 1);
+
+static uint32_t hist_total(const k_thread_runtime_stats_t *stats)
+{
+	uint32_t total = 0U;
+
+	for (int i = 0; i < ARRAY_SIZE(stats->wait_hist); i++) {
+		total += stats->wait_hist[i];
+	}
+
+	return total;
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < WAKEUPS; i++) {
+		k_sem_take(&waiter_sem, K_FOREVER);
+	}
+}
+
+/**
+ * @brief Test that execution cycles are accounted to the running thread
+ */
+static void test_runtime_stats_execution(void)
+{
+	k_thread_runtime_stats_t before, after, all;
+
+	zassert_equal(k_thread_runtime_stats_get(NULL, &before), -EINVAL,
+		      "NULL thread accepted");
+	zassert_equal(k_thread_runtime_stats_all_get(NULL), -EINVAL,
+		      "NULL stats accepted");
+
+	/* Execution cycles are accounted from switch in to switch out.
+	 * Sleep first, so the busy wait is measured from a counted switch
+	 * in, then switch out again to account it.
+	 */
+	k_sleep(K_MSEC(1));
+
+	zassert_equal(k_thread_runtime_stats_get(k_current_get(), &before), 0,
+		      "Failed to get stats");
+
+	k_busy_wait(1000);
+	k_sleep(K_MSEC(1));
+
+	zassert_equal(k_thread_runtime_stats_get(k_current_get(), &after), 0,
+		      "Failed to get stats");
+	zassert_true(after.execution_cycles > before.execution_cycles,
+		     "Execution cycles not accounted");
+
+	zassert_equal(k_thread_runtime_stats_all_get(&all), 0,
+		      "Failed to get stats");
+	zassert_true(all.execution_cycles >= after.execution_cycles,
+		     "Thread cycles exceed total cycles");
+}
+
+/**
+ * @brief Test that every wake up of a thread is recorded in its wait-to-run
+ * latency histogram
+ */
+static void test_runtime_stats_wait_hist(void)
+{
+	k_thread_runtime_stats_t stats;
+	int prio = k_thread_priority_get(k_current_get());
+	uint32_t started;
+
+	/* The waiter preempts this thread each time it is woken up. */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(1));
+
+	k_thread_create(&waiter_thread, waiter_stack, STACK_SIZE, waiter,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	/* Starting the thread is recorded as well. */
+	zassert_equal(k_thread_runtime_stats_get(&waiter_thread, &stats), 0,
+		      "Failed to get stats");
+	started = hist_total(&stats);
+	zassert_equal(started, 1, "Start latency not recorded");
+
+	for (int i = 0; i < WAKEUPS; i++) {
+		k_sem_give(&waiter_sem);
+	}
+
+	k_thread_join(&waiter_thread, K_FOREVER);
+	k_thread_priority_set(k_current_get(), prio);
+
+	zassert_equal(k_thread_runtime_stats_get(&waiter_thread, &stats), 0,
+		      "Failed to get stats");
+	zassert_equal(hist_total(&stats) - started, WAKEUPS,
+		      "Wake ups not recorded");
+}
+
+#ifdef CONFIG_IRQ_RUNTIME_STATS
+#define OFFLOADS 5
+
+static uint32_t irq_count_total(void)
+{
+	k_irq_runtime_stats_t stats;
+	uint32_t total = 0U;
+
+	for (unsigned int irq = 0; irq < CONFIG_IRQ_RUNTIME_STATS_NUM_IRQS;
+	     irq++) {
+		zassert_equal(k_irq_runtime_stats_get(irq, &stats), 0,
+			      "Failed to get IRQ stats");
+		total += stats.count;
+	}
+
+	return total;
+}
+
+static void offload_func(const void *param)
+{
+	ARG_UNUSED(param);
+
+	k_busy_wait(100);
+}
+
+/**
+ * @brief Test that interrupts are counted and timed per IRQ line
+ */
+static void test_runtime_stats_irq(void)
+{
+	k_irq_runtime_stats_t stats;
+	uint32_t before, after;
+
+	zassert_equal(k_irq_runtime_stats_get(0, NULL), -EINVAL,
+		      "NULL stats accepted");
+	zassert_equal(k_irq_runtime_stats_get(CONFIG_IRQ_RUNTIME_STATS_NUM_IRQS,
+					      &stats), -EINVAL,
+		      "Out of range IRQ accepted");
+
+	before = irq_count_total();
+
+	for (int i = 0; i < OFFLOADS; i++) {
+		irq_offload(offload_func, NULL);
+	}
+
+	after = irq_count_total();
+
+	/* The system timer may fire meanwhile as well. */
+	zassert_true(after - before >= OFFLOADS, "Interrupts not counted");
+}
+#else
+static void test_runtime_stats_irq(void)
+{
+	ztest_test_skip();
+}
+#endif
+
+void test_main(void)
+{
+	ztest_test_suite(runtime_stats,
+			 ztest_unit_test(test_runtime_stats_execution),
+			 ztest_unit_test(test_runtime_stats_wait_hist),
+			 ztest_unit_test(test_runtime_stats_irq)
+			 );
+	ztest_run_test_suite(runtime_stats);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/cbprintf.h>
+#include <string.h>
+
+static uint8_t __aligned(sizeof(void *)) package[128];
+static char out_buf[128];
+static size_t out_len;
+
+static int out(int c, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	if (out_len < sizeof(out_buf) - 1) {
+		out_buf[out_len++] = (char)c;
+		out_buf[out_len] = '\0';
+	}
+
+	return c;
+}
+
+/* Package the arguments, clear the source string buffer when requested and
+ * check the formatted package against vsnprintf output.
+ */
+static void check(uint32_t flags, char *clear, const char *fmt, ...)
+{
+	char expected[sizeof(out_buf)];
+	va_list ap;
+	int len, dry_len, rc;
+
+	va_start(ap, fmt);
+	vsnprintf(expected, sizeof(expected), fmt, ap);
+	va_end(ap);
+
+	va_start(ap, fmt);
+	dry_len = cbvprintf_package(NULL, 0, flags, fmt, ap);
+	va_end(ap);
+
+	va_start(ap, fmt);
+	len = cbvprintf_package(package, sizeof(package), flags, fmt, ap);
+	va_end(ap);
+
+	zassert_true(len > 0, "Packaging failed (%d)", len);
+	zassert_equal(len, dry_len, "Length mismatch %d != %d", len, dry_len);
+
+	if (clear != NULL) {
+		memset(clear, 'x', strlen(clear));
+	}
+
+	out_len = 0;
+	out_buf[0] = '\0';
+
+	rc = cbpprintf(out, NULL, package);
+	zassert_equal(rc, strlen(expected), "Unexpected length %d", rc);
+	zassert_true(strcmp(out_buf, expected) == 0,
+		     "Expected \"%s\", got \"%s\"", expected, out_buf);
+}
+
+void test_package_integers(void)
+{
+	check(0, NULL, "%d %u %x", -1, 2U, 0xabU);
+	check(0, NULL, "%hhd %hu %ld %lu", (char)-5, (unsigned short)7,
+	      -100000L, 100000UL);
+	check(0, NULL, "%lld %llx", -1234567890123LL, 0x1122334455667788ULL);
+	check(0, NULL, "%zu %td %jd", (size_t)42, (ptrdiff_t)-3,
+	      (intmax_t)-9);
+	check(0, NULL, "%c%c %p", 'o', 'k', (void *)0x1234);
+}
+
+void test_package_width_precision(void)
+{
+	check(0, NULL, "[%*d] [%-*d] [%.*d]", 6, 42, 4, -7, 3, 5);
+	check(0, NULL, "[%*.*s]", 8, 3, "abcdef");
+	check(0, NULL, "100%% %d%%", 50);
+}
+
+void test_package_double(void)
+{
+	check(0, NULL, "%.3f %e", 3.25, -1.5e3);
+	check(0, NULL, "%d %.2f %lld", 1, 2.5, 3LL);
+}
+
+void test_package_strings(void)
+{
+	char str[] = "transient";
+
+	/* Strings stored as pointers are read when formatting. */
+	check(0, NULL, "%s %s", "const", str);
+
+	/* Copied strings are not affected by changes of the source. */
+	check(CBPRINTF_PACKAGE_COPY_STR, str, "<%s>", str);
+	strcpy(str, "transient");
+	check(CBPRINTF_PACKAGE_COPY_RW_STR, str, "<%s> %d", str, 1);
+}
+
+void test_package_no_space(void)
+{
+	int len;
+
+	len = cbprintf_package(NULL, 0, 0, "%d %d", 1, 2);
+	zassert_true(len > 0, "Unexpected length %d", len);
+
+	len = cbprintf_package(package, len - 1, 0, "%d %d", 1, 2);
+	zassert_equal(len, -ENOSPC, "Expected -ENOSPC, got %d", len);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_cbprintf_package,
+			 ztest_unit_test(test_package_integers),
+			 ztest_unit_test(test_package_width_precision),
+			 ztest_unit_test(test_package_double),
+			 ztest_unit_test(test_package_strings),
+			 ztest_unit_test(test_package_no_space));
+	ztest_run_test_suite(test_cbprintf_package);
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+#include <sys/mpsc_ring.h>
+
+#define RING_SIZE 64
+/* Each entry of one word uses 12 bytes of the ring. */
+#define ENTRY_SIZE (MPSC_RING_ENTRY_OVERHEAD + sizeof(uint32_t))
+#define ENTRIES_MAX (RING_SIZE / ENTRY_SIZE)
+
+static uint8_t __aligned(sizeof(uint32_t)) ring_buf[RING_SIZE];
+static struct mpsc_ring ring;
+
+static int put(uint32_t value, bool overwrite, uint32_t *dropped)
+{
+	struct mpsc_ring_entry entry;
+	uint32_t drop_cnt;
+	int err;
+
+	err = mpsc_ring_claim(&ring, sizeof(value), overwrite, &drop_cnt,
+			      &entry);
+	if (dropped != NULL) {
+		*dropped = drop_cnt;
+	}
+
+	if (err < 0) {
+		return err;
+	}
+
+	mpsc_ring_write(&ring, &entry, 0, &value, sizeof(value));
+	mpsc_ring_commit(&ring, &entry);
+
+	return 0;
+}
+
+static bool get(uint32_t *value)
+{
+	struct mpsc_ring_entry entry;
+
+	if (!mpsc_ring_peek(&ring, &entry)) {
+		return false;
+	}
+
+	zassert_equal(entry.len, sizeof(*value), "Unexpected length");
+	mpsc_ring_read(&ring, &entry, 0, value, sizeof(*value));
+
+	return mpsc_ring_consume(&ring, &entry);
+}
+
+static void setup(void)
+{
+	mpsc_ring_init(&ring, ring_buf, sizeof(ring_buf));
+}
+
+static void test_mpsc_ring_put_get(void)
+{
+	uint32_t value;
+
+	setup();
+
+	zassert_true(mpsc_ring_is_empty(&ring), "Ring not empty");
+	zassert_false(get(&value), "Got entry from empty ring");
+
+	/* Several laps to cover wrapping of the entries. */
+	for (uint32_t i = 0; i < 10 * ENTRIES_MAX; i++) {
+		zassert_equal(put(i, false, NULL), 0, "Put failed");
+		zassert_equal(put(i + 1, false, NULL), 0, "Put failed");
+
+		zassert_true(get(&value), "Get failed");
+		zassert_equal(value, i, "Unexpected value");
+		zassert_true(get(&value), "Get failed");
+		zassert_equal(value, i + 1, "Unexpected value");
+	}
+
+	zassert_true(mpsc_ring_is_empty(&ring), "Ring not empty");
+}
+
+static void test_mpsc_ring_full(void)
+{
+	uint32_t value, dropped;
+
+	setup();
+
+	for (uint32_t i = 0; i < ENTRIES_MAX; i++) {
+		zassert_equal(put(i, false, NULL), 0, "Put failed");
+	}
+
+	zassert_equal(put(ENTRIES_MAX, false, &dropped), -ENOMEM,
+		      "Put to full ring succeeded");
+	zassert_equal(dropped, 0, "Dropped without overwrite");
+
+	zassert_true(get(&value), "Get failed");
+	zassert_equal(value, 0, "Unexpected value");
+	zassert_equal(put(ENTRIES_MAX, false, NULL), 0, "Put failed");
+}
+
+static void test_mpsc_ring_overwrite(void)
+{
+	uint32_t value, dropped;
+
+	setup();
+
+	for (uint32_t i = 0; i < ENTRIES_MAX; i++) {
+		zassert_equal(put(i, true, &dropped), 0, "Put failed");
+		zassert_equal(dropped, 0, "Unexpected drop");
+	}
+
+	zassert_equal(put(ENTRIES_MAX, true, &dropped), 0, "Put failed");
+	zassert_equal(dropped, 1, "Oldest entry not dropped");
+
+	/* The entries after the oldest one are preserved. */
+	for (uint32_t i = 1; i <= ENTRIES_MAX; i++) {
+		zassert_true(get(&value), "Get failed");
+		zassert_equal(value, i, "Unexpected value");
+	}
+
+	zassert_false(get(&value), "Unexpected entry");
+}
+
+static void test_mpsc_ring_too_big(void)
+{
+	struct mpsc_ring_entry entry;
+	uint32_t dropped;
+
+	setup();
+
+	zassert_equal(mpsc_ring_claim(&ring, RING_SIZE, true, &dropped,
+				      &entry), -ENOMEM,
+		      "Claim bigger than the ring succeeded");
+	zassert_true(mpsc_ring_is_empty(&ring), "Ring not empty");
+}
+
+static void test_mpsc_ring_stale_copy(void)
+{
+	struct mpsc_ring_entry entry;
+	uint32_t value;
+
+	setup();
+
+	for (uint32_t i = 0; i < ENTRIES_MAX; i++) {
+		zassert_equal(put(i, true, NULL), 0, "Put failed");
+	}
+
+	zassert_true(mpsc_ring_peek(&ring, &entry), "Peek failed");
+
+	/* A producer overwrites the peeked entry before it is consumed. */
+	zassert_equal(put(ENTRIES_MAX, true, NULL), 0, "Put failed");
+	zassert_false(mpsc_ring_consume(&ring, &entry),
+		      "Dropped entry consumed");
+
+	zassert_true(get(&value), "Get failed");
+	zassert_equal(value, 1, "Unexpected value");
+}
+
+static void isr_put(const void *arg)
+{
+	zassert_equal(put((uint32_t)(uintptr_t)arg, false, NULL), 0,
+		      "Put from ISR failed");
+}
+
+static void test_mpsc_ring_nested_producer(void)
+{
+	struct mpsc_ring_entry entry;
+	uint32_t value, dropped;
+
+	setup();
+
+	zassert_equal(mpsc_ring_claim(&ring, sizeof(value), false, &dropped,
+				      &entry), 0, "Claim failed");
+
+	/* An interrupt commits its entry while the thread entry is claimed. */
+	irq_offload(isr_put, (const void *)2);
+
+	/* Entries are seen in claim order, the uncommitted entry blocks the
+	 * entry committed after it.
+	 */
+	zassert_false(get(&value), "Got entry behind uncommitted one");
+
+	value = 1;
+	mpsc_ring_write(&ring, &entry, 0, &value, sizeof(value));
+	mpsc_ring_commit(&ring, &entry);
+
+	zassert_true(get(&value), "Get failed");
+	zassert_equal(value, 1, "Unexpected value");
+	zassert_true(get(&value), "Get failed");
+	zassert_equal(value, 2, "Unexpected value");
+}
+
+static void test_mpsc_ring_overwrite_uncommitted(void)
+{
+	struct mpsc_ring_entry entry;
+	uint32_t value, dropped;
+
+	setup();
+
+	zassert_equal(mpsc_ring_claim(&ring, sizeof(value), true, &dropped,
+				      &entry), 0, "Claim failed");
+
+	for (uint32_t i = 1; i < ENTRIES_MAX; i++) {
+		zassert_equal(put(i, true, NULL), 0, "Put failed");
+	}
+
+	/* The oldest entry is being written, it can not be dropped. */
+	zassert_equal(put(ENTRIES_MAX, true, &dropped), -ENOMEM,
+		      "Uncommitted entry dropped");
+	zassert_equal(dropped, 0, "Unexpected drop");
+
+	value = 0;
+	mpsc_ring_write(&ring, &entry, 0, &value, sizeof(value));
+	mpsc_ring_commit(&ring, &entry);
+
+	zassert_true(get(&value), "Get failed");
+	zassert_equal(value, 0, "Unexpected value");
+}
+
+static void test_mpsc_ring_stale_tag(void)
+{
+	struct mpsc_ring_entry entry;
+	uint32_t stale_pos = 6 * ENTRY_SIZE;
+	uint32_t value, dropped;
+
+	setup();
+
+	/* The data of the first entry is where the tag of the entry at
+	 * stale_pos will be, make it look like the tag of a committed entry.
+	 */
+	zassert_equal(MPSC_RING_ENTRY_OVERHEAD, stale_pos % RING_SIZE,
+		      "Unexpected layout");
+	zassert_equal(put(stale_pos | 1, false, NULL), 0, "Put failed");
+	zassert_true(get(&value), "Get failed");
+
+	for (uint32_t i = 1; i < 6; i++) {
+		zassert_equal(put(i, false, NULL), 0, "Put failed");
+		zassert_true(get(&value), "Get failed");
+		zassert_equal(value, i, "Unexpected value");
+	}
+
+	zassert_equal(mpsc_ring_claim(&ring, sizeof(value), false, &dropped,
+				      &entry), 0, "Claim failed");
+	zassert_equal(entry.pos, stale_pos, "Unexpected position");
+
+	zassert_false(get(&value), "Uncommitted entry returned");
+
+	value = 6;
+	mpsc_ring_write(&ring, &entry, 0, &value, sizeof(value));
+	mpsc_ring_commit(&ring, &entry);
+
+	zassert_true(get(&value), "Get failed");
+	zassert_equal(value, 6, "Unexpected value");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_mpsc_ring,
+			 ztest_unit_test(test_mpsc_ring_put_get),
+			 ztest_unit_test(test_mpsc_ring_full),
+			 ztest_unit_test(test_mpsc_ring_overwrite),
+			 ztest_unit_test(test_mpsc_ring_too_big),
+			 ztest_unit_test(test_mpsc_ring_stale_copy),
+			 ztest_unit_test(test_mpsc_ring_nested_producer),
+			 ztest_unit_test(test_mpsc_ring_overwrite_uncommitted),
+			 ztest_unit_test(test_mpsc_ring_stale_tag)
+			 );
+	ztest_run_test_suite(test_mpsc_ring);
+}
@@ -0,0 +1,504 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <ztest_assert.h>
+#include <stdlib.h>
+
+#include <net/socket.h>
+#include <net/http_client.h>
+
+/* A minimal HTTP/1.1 server runs in a separate thread on the loopback
+ * interface. GET requests are answered with the request target as the body,
+ * POST requests with the length of the (chunked) request body.
+ *
+ * GET /close answers with "Connection: close". GET /drop answers normally,
+ * but the connection is closed afterwards without telling the client.
+ * Responses to requests that arrive together are sent together.
+ */
+
+#define SERVER_PORT 8080
+#define SERVER_HOST "192.0.2.1"
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+#define RECV_BUF_SIZE 256
+#define PIPELINE_DEPTH 4
+#define BENCH_COUNT 50
+#define TIMEOUT_MS 3000
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static char srv_in[1024];
+static size_t srv_in_len;
+static char srv_out[1024];
+static size_t srv_out_len;
+
+static atomic_t accepted;
+
+static struct sockaddr_in server_addr;
+
+static const struct http_client_endpoint endpoint = {
+	.addr = (const struct sockaddr *)&server_addr,
+	.addrlen = sizeof(server_addr),
+	.host = SERVER_HOST,
+};
+
+struct test_req {
+	struct http_request req;
+	uint8_t recv_buf[RECV_BUF_SIZE];
+	char body[64];
+	size_t body_len;
+};
+
+static struct test_req test_reqs[PIPELINE_DEPTH];
+
+static bool header_has(const char *hdr, size_t hdr_len, const char *str)
+{
+	size_t len = strlen(str);
+	size_t i;
+
+	for (i = 0; i + len <= hdr_len; i++) {
+		if (memcmp(hdr + i, str, len) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Returns length of the request at the start of the input buffer, or 0 if
+ * it is not complete yet.
+ */
+static size_t server_parse(size_t *body_len)
+{
+	char *end, *p, *line_end;
+	size_t hdr_len, size;
+
+	srv_in[srv_in_len] = '\0';
+
+	end = strstr(srv_in, "\r\n\r\n");
+	if (end == NULL) {
+		return 0;
+	}
+
+	hdr_len = end + 4 - srv_in;
+	*body_len = 0;
+
+	if (!header_has(srv_in, hdr_len, "Transfer-Encoding: chunked")) {
+		return hdr_len;
+	}
+
+	p = srv_in + hdr_len;
+
+	do {
+		line_end = strstr(p, "\r\n");
+		if (line_end == NULL) {
+			return 0;
+		}
+
+		size = strtoul(p, NULL, 16);
+		p = line_end + 2;
+
+		if (p + size + 2 > srv_in + srv_in_len) {
+			return 0;
+		}
+
+		p += size + 2;
+		*body_len += size;
+	} while (size > 0);
+
+	return p - srv_in;
+}
+
+static int server_respond(size_t req_len, size_t body_len)
+{
+	char target[32] = { 0 };
+	char body[32];
+	char *start, *end;
+	bool close;
+	int ret;
+
+	/* Request line is "<method> <target> HTTP/1.1" */
+	start = strchr(srv_in, ' ');
+	end = start ? strchr(start + 1, ' ') : NULL;
+	if (end != NULL && end - start - 1 < sizeof(target)) {
+		memcpy(target, start + 1, end - start - 1);
+	}
+
+	if (strncmp(srv_in, "POST ", 5) == 0) {
+		snprintk(body, sizeof(body), "%zu", body_len);
+	} else {
+		snprintk(body, sizeof(body), "%s", target);
+	}
+
+	close = (strcmp(target, "/close") == 0);
+
+	ret = snprintk(srv_out + srv_out_len,
+		       sizeof(srv_out) - srv_out_len,
+		       "HTTP/1.1 200 OK\r\n"
+		       "Content-Length: %zu\r\n"
+		       "%s\r\n%s",
+		       strlen(body), close ? "Connection: close\r\n" : "",
+		       body);
+	if (ret < 0 || ret >= sizeof(srv_out) - srv_out_len) {
+		return -ENOMEM;
+	}
+
+	srv_out_len += ret;
+
+	memmove(srv_in, srv_in + req_len, srv_in_len - req_len);
+	srv_in_len -= req_len;
+
+	return (close || strcmp(target, "/drop") == 0) ? 1 : 0;
+}
+
+static int server_flush(int sock)
+{
+	size_t offset = 0;
+	int ret;
+
+	while (offset < srv_out_len) {
+		ret = send(sock, srv_out + offset, srv_out_len - offset, 0);
+		if (ret < 0) {
+			return -errno;
+		}
+
+		offset += ret;
+	}
+
+	srv_out_len = 0;
+
+	return 0;
+}
+
+static void server_serve(int sock)
+{
+	size_t req_len, body_len;
+	int ret;
+
+	srv_in_len = 0;
+	srv_out_len = 0;
+
+	while (true) {
+		req_len = server_parse(&body_len);
+		if (req_len > 0) {
+			ret = server_respond(req_len, body_len);
+			if (ret != 0) {
+				(void)server_flush(sock);
+				return;
+			}
+
+			continue;
+		}
+
+		/* No complete request left, send out the responses */
+		if (server_flush(sock) < 0 ||
+		    srv_in_len >= sizeof(srv_in) - 1) {
+			return;
+		}
+
+		ret = recv(sock, srv_in + srv_in_len,
+			   sizeof(srv_in) - 1 - srv_in_len, 0);
+		if (ret <= 0) {
+			return;
+		}
+
+		srv_in_len += ret;
+	}
+}
+
+static void server_fn(void *p1, void *p2, void *p3)
+{
+	int listen_sock = POINTER_TO_INT(p1);
+	int sock;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		sock = accept(listen_sock, NULL, NULL);
+		if (sock < 0) {
+			continue;
+		}
+
+		atomic_inc(&accepted);
+
+		server_serve(sock);
+
+		(void)close(sock);
+	}
+}
+
+static int on_body(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_request *req = CONTAINER_OF(parser, struct http_request,
+						internal.parser);
+	struct test_req *treq = CONTAINER_OF(req, struct test_req, req);
+
+	length = MIN(length, sizeof(treq->body) - 1 - treq->body_len);
+	memcpy(treq->body + treq->body_len, at, length);
+	treq->body_len += length;
+	treq->body[treq->body_len] = '\0';
+
+	return 0;
+}
+
+static const struct http_parser_settings parser_cb = {
+	.on_body = on_body,
+};
+
+static void response_cb(struct http_response *rsp,
+			enum http_final_call final_data,
+			void *user_data)
+{
+}
+
+static struct http_request *prepare_req(struct test_req *treq,
+					enum http_method method,
+					const char *url)
+{
+	memset(treq, 0, sizeof(*treq));
+
+	treq->req.method = method;
+	treq->req.url = url;
+	treq->req.host = SERVER_HOST;
+	treq->req.protocol = "HTTP/1.1";
+	treq->req.response = response_cb;
+	treq->req.http_cb = &parser_cb;
+	treq->req.recv_buf = treq->recv_buf;
+	treq->req.recv_buf_len = sizeof(treq->recv_buf);
+
+	return &treq->req;
+}
+
+static void test_setup(void)
+{
+	int listen_sock;
+
+	server_addr.sin_family = AF_INET;
+	server_addr.sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, SERVER_HOST, &server_addr.sin_addr);
+
+	listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(listen_sock >= 0, "Cannot create server socket");
+	zassert_equal(bind(listen_sock, (struct sockaddr *)&server_addr,
+			   sizeof(server_addr)), 0, "Cannot bind");
+	zassert_equal(listen(listen_sock, 2), 0, "Cannot listen");
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server_fn, INT_TO_POINTER(listen_sock), NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+}
+
+static void pool_get(const char *url)
+{
+	struct http_request *req;
+	int ret;
+
+	req = prepare_req(&test_reqs[0], HTTP_GET, url);
+
+	ret = http_client_pool_req(&endpoint, req, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+	zassert_equal(req->internal.parser.status_code, 200,
+		      "Invalid status");
+	zassert_true(strcmp(test_reqs[0].body, url) == 0,
+		     "Invalid body '%s'", test_reqs[0].body);
+}
+
+static void test_pool_reuse(void)
+{
+	int i;
+
+	http_client_pool_flush();
+	atomic_set(&accepted, 0);
+
+	for (i = 0; i < 5; i++) {
+		pool_get("/reuse");
+	}
+
+	zassert_equal(atomic_get(&accepted), 1,
+		      "Connection was not reused (%d connections)",
+		      atomic_get(&accepted));
+}
+
+static void test_pool_connection_close(void)
+{
+	http_client_pool_flush();
+	atomic_set(&accepted, 0);
+
+	pool_get("/close");
+	pool_get("/reuse");
+
+	zassert_equal(atomic_get(&accepted), 2,
+		      "Closed connection was reused");
+}
+
+static void test_pool_stale_retry(void)
+{
+	http_client_pool_flush();
+	atomic_set(&accepted, 0);
+
+	/* Server silently drops the connection after the response, the
+	 * next request must be retried on a new connection.
+	 */
+	pool_get("/drop");
+	k_msleep(100);
+	pool_get("/reuse");
+
+	zassert_equal(atomic_get(&accepted), 2, "No new connection");
+}
+
+static void test_pool_pipeline(void)
+{
+	static const char * const urls[PIPELINE_DEPTH] = {
+		"/pipe/0", "/pipe/1", "/pipe/2", "/pipe/3"
+	};
+	struct http_request *reqs[PIPELINE_DEPTH];
+	int ret, i;
+
+	http_client_pool_flush();
+	atomic_set(&accepted, 0);
+
+	for (i = 0; i < PIPELINE_DEPTH; i++) {
+		reqs[i] = prepare_req(&test_reqs[i], HTTP_GET, urls[i]);
+	}
+
+	ret = http_client_pool_pipeline(&endpoint, reqs, PIPELINE_DEPTH,
+					TIMEOUT_MS, NULL);
+	zassert_equal(ret, PIPELINE_DEPTH, "Pipeline failed (%d)", ret);
+
+	for (i = 0; i < PIPELINE_DEPTH; i++) {
+		zassert_true(strcmp(test_reqs[i].body, urls[i]) == 0,
+			     "Response %d out of order ('%s')", i,
+			     test_reqs[i].body);
+	}
+
+	/* Connection stays usable after the pipeline */
+	pool_get("/reuse");
+
+	zassert_equal(atomic_get(&accepted), 1, "Connection was not reused");
+}
+
+#define UPLOAD_CHUNK_LEN 100
+#define UPLOAD_LEN 1000
+
+static uint8_t upload_data[UPLOAD_CHUNK_LEN];
+static size_t upload_sent;
+
+static int upload_chunk_cb(int sock, struct http_request *req,
+			   const uint8_t **data, void *user_data)
+{
+	size_t len = MIN(UPLOAD_CHUNK_LEN, UPLOAD_LEN - upload_sent);
+
+	*data = upload_data;
+	upload_sent += len;
+
+	return len;
+}
+
+static void test_chunked_upload(void)
+{
+	struct http_request *req;
+	int ret;
+
+	http_client_pool_flush();
+
+	memset(upload_data, 'a', sizeof(upload_data));
+	upload_sent = 0;
+
+	req = prepare_req(&test_reqs[0], HTTP_POST, "/upload");
+	req->payload_chunk_cb = upload_chunk_cb;
+	req->content_type_value = "application/octet-stream";
+
+	ret = http_client_pool_req(&endpoint, req, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "Upload failed (%d)", ret);
+	zassert_equal(upload_sent, UPLOAD_LEN, "Not all data sent");
+	zassert_true(strcmp(test_reqs[0].body, STRINGIFY(UPLOAD_LEN)) == 0,
+		     "Server received '%s' bytes", test_reqs[0].body);
+}
+
+/* Requests/s with a new connection for every request, compared to
+ * reusing a pooled connection, and to pipelining on it.
+ */
+static void test_requests_per_second(void)
+{
+	struct http_request *reqs[PIPELINE_DEPTH];
+	uint32_t start, elapsed;
+	int sock, ret, i, j;
+
+	/* The server handles one connection at a time */
+	http_client_pool_flush();
+
+	start = k_uptime_get_32();
+
+	for (i = 0; i < BENCH_COUNT; i++) {
+		sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		zassert_true(sock >= 0, "Cannot create socket");
+
+		ret = connect(sock, (struct sockaddr *)&server_addr,
+			      sizeof(server_addr));
+		zassert_equal(ret, 0, "Cannot connect (%d)", errno);
+
+		ret = http_client_req(sock, prepare_req(&test_reqs[0],
+							HTTP_GET, "/bench"),
+				      TIMEOUT_MS, NULL);
+		zassert_true(ret > 0, "Request failed (%d)", ret);
+
+		(void)close(sock);
+	}
+
+	elapsed = MAX(k_uptime_get_32() - start, 1);
+	TC_PRINT("new connection: %u requests/s\n",
+		 BENCH_COUNT * 1000U / elapsed);
+
+	start = k_uptime_get_32();
+
+	for (i = 0; i < BENCH_COUNT; i++) {
+		pool_get("/bench");
+	}
+
+	elapsed = MAX(k_uptime_get_32() - start, 1);
+	TC_PRINT("pooled connection: %u requests/s\n",
+		 BENCH_COUNT * 1000U / elapsed);
+
+	start = k_uptime_get_32();
+
+	for (i = 0; i < BENCH_COUNT; i += PIPELINE_DEPTH) {
+		for (j = 0; j < PIPELINE_DEPTH; j++) {
+			reqs[j] = prepare_req(&test_reqs[j], HTTP_GET,
+					      "/bench");
+		}
+
+		ret = http_client_pool_pipeline(&endpoint, reqs,
+						PIPELINE_DEPTH, TIMEOUT_MS,
+						NULL);
+		zassert_equal(ret, PIPELINE_DEPTH, "Pipeline failed (%d)",
+			      ret);
+	}
+
+	elapsed = MAX(k_uptime_get_32() - start, 1);
+	TC_PRINT("pipelined (depth %d): %u requests/s\n", PIPELINE_DEPTH,
+		 i * 1000U / elapsed);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(http_client_pool,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_pool_reuse),
+			 ztest_unit_test(test_pool_connection_close),
+			 ztest_unit_test(test_pool_stale_retry),
+			 ztest_unit_test(test_pool_pipeline),
+			 ztest_unit_test(test_chunked_upload),
+			 ztest_unit_test(test_requests_per_second));
+
+	ztest_run_test_suite(http_client_pool);
+}
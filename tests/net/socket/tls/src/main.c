@@ -0,0 +1,471 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <ztest_assert.h>
+#include <fcntl.h>
+#include <net/socket.h>
+#include <net/tls_credentials.h>
+
+#include "../../socket_helpers.h"
+
+#define SERVER_PORT 4242
+#define DTLS_SERVER_PORT 4243
+#define PROXY_PORT 4244
+
+#define PSK_TAG 1
+
+#define CONNECT_COUNT 3
+
+#define DTLS_MSG_COUNT 4
+
+#define SERVER_STACK_SIZE 8192
+#define PROXY_STACK_SIZE 1024
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+static const unsigned char psk[] = {
+	0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+	0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10
+};
+static const char psk_id[] = "test_identity";
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+static K_SEM_DEFINE(server_done, 0, 1);
+
+static int server_sock;
+
+static K_THREAD_STACK_DEFINE(proxy_stack, PROXY_STACK_SIZE);
+static struct k_thread proxy_thread;
+
+static int proxy_sock;
+static int proxy_upstream_sock[2];
+static volatile int proxy_upstream;
+static volatile bool proxy_stop;
+
+static void server_thread_fn(void *p1, void *p2, void *p3)
+{
+	int i, ret, new_sock;
+	uint8_t byte;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < CONNECT_COUNT; i++) {
+		new_sock = accept(server_sock, NULL, NULL);
+		zassert_true(new_sock >= 0, "accept failed (%d)", errno);
+
+		ret = recv(new_sock, &byte, sizeof(byte), 0);
+		zassert_equal(ret, sizeof(byte), "recv failed (%d)", errno);
+
+		ret = send(new_sock, &byte, sizeof(byte), 0);
+		zassert_equal(ret, sizeof(byte), "send failed (%d)", errno);
+
+		ret = close(new_sock);
+		zassert_equal(ret, 0, "close failed");
+	}
+
+	k_sem_give(&server_done);
+}
+
+static void prepare_tls_sock(int sock, bool enable_cache)
+{
+	sec_tag_t sec_tag_list[] = { PSK_TAG };
+	int cache = enable_cache ? TLS_SESSION_CACHE_ENABLED :
+				   TLS_SESSION_CACHE_DISABLED;
+	int ret;
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST,
+			 sec_tag_list, sizeof(sec_tag_list));
+	zassert_equal(ret, 0, "Failed to set TLS_SEC_TAG_LIST (%d)", errno);
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+			 &cache, sizeof(cache));
+	zassert_equal(ret, 0, "Failed to set TLS_SESSION_CACHE (%d)", errno);
+}
+
+static uint32_t client_connect(struct sockaddr_in *server_addr,
+			       bool *resumed)
+{
+	uint8_t byte = 0x5a;
+	uint32_t start, cycles;
+	int sock, ret, value;
+	socklen_t optlen = sizeof(value);
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(sock >= 0, "socket open failed (%d)", errno);
+
+	prepare_tls_sock(sock, true);
+
+	start = k_cycle_get_32();
+	ret = connect(sock, (struct sockaddr *)server_addr,
+		      sizeof(*server_addr));
+	cycles = k_cycle_get_32() - start;
+	zassert_equal(ret, 0, "connect failed (%d)", errno);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_SESSION_RESUMED, &value, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	*resumed = value;
+
+	ret = send(sock, &byte, sizeof(byte), 0);
+	zassert_equal(ret, sizeof(byte), "send failed (%d)", errno);
+
+	byte = 0;
+	ret = recv(sock, &byte, sizeof(byte), 0);
+	zassert_equal(ret, sizeof(byte), "recv failed (%d)", errno);
+	zassert_equal(byte, 0x5a, "invalid data received");
+
+	ret = close(sock);
+	zassert_equal(ret, 0, "close failed");
+
+	return (uint32_t)k_cyc_to_us_floor64(cycles);
+}
+
+static void test_session_cache_sockopt(void)
+{
+	int sock, ret, cache;
+	socklen_t optlen = sizeof(cache);
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(sock >= 0, "socket open failed (%d)", errno);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(cache, TLS_SESSION_CACHE_DISABLED,
+		      "session cache should be disabled by default");
+
+	cache = 2;
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+			 &cache, sizeof(cache));
+	zassert_equal(ret, -1, "invalid value accepted");
+	zassert_equal(errno, EINVAL, "invalid errno");
+
+	cache = TLS_SESSION_CACHE_ENABLED;
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE,
+			 &cache, sizeof(cache));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	cache = TLS_SESSION_CACHE_DISABLED;
+	ret = getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(cache, TLS_SESSION_CACHE_ENABLED,
+		      "session cache should be enabled");
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE_PURGE, NULL, 0);
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_SESSION_RESUMED, &cache, &optlen);
+	zassert_equal(ret, -1, "resumption status of unconnected socket");
+	zassert_equal(errno, ENOTCONN, "invalid errno");
+
+	ret = close(sock);
+	zassert_equal(ret, 0, "close failed");
+}
+
+static void test_session_resumption(void)
+{
+	struct sockaddr_in server_addr;
+	uint32_t full_us, resumed_us, purged_us;
+	bool resumed;
+	int ret;
+
+	ret = tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK,
+				 psk, sizeof(psk));
+	zassert_equal(ret, 0, "Failed to register PSK (%d)", ret);
+
+	ret = tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK_ID,
+				 psk_id, strlen(psk_id));
+	zassert_equal(ret, 0, "Failed to register PSK ID (%d)", ret);
+
+	server_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(server_sock >= 0, "socket open failed (%d)", errno);
+
+	prepare_tls_sock(server_sock, true);
+
+	(void)memset(&server_addr, 0, sizeof(server_addr));
+	server_addr.sin_family = AF_INET;
+	server_addr.sin_port = htons(SERVER_PORT);
+	ret = inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+			&server_addr.sin_addr);
+	zassert_equal(ret, 1, "inet_pton failed");
+
+	ret = bind(server_sock, (struct sockaddr *)&server_addr,
+		   sizeof(server_addr));
+	zassert_equal(ret, 0, "bind failed (%d)", errno);
+
+	ret = listen(server_sock, 1);
+	zassert_equal(ret, 0, "listen failed (%d)", errno);
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server_thread_fn, NULL, NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	/* First connection performs a full handshake. */
+	full_us = client_connect(&server_addr, &resumed);
+	zassert_false(resumed, "First handshake resumed a session");
+
+	/* Second connection should resume the cached session. */
+	resumed_us = client_connect(&server_addr, &resumed);
+	zassert_true(resumed, "Cached session not resumed");
+
+	/* After purging the cache, full handshake is needed again. */
+	ret = setsockopt(server_sock, SOL_TLS, TLS_SESSION_CACHE_PURGE,
+			 NULL, 0);
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	purged_us = client_connect(&server_addr, &resumed);
+	zassert_false(resumed, "Purged session resumed");
+
+	TC_PRINT("Handshake time: full %u us, resumed %u us, "
+		 "after purge %u us\n", full_us, resumed_us, purged_us);
+
+	ret = k_sem_take(&server_done, K_SECONDS(10));
+	zassert_equal(ret, 0, "Server thread did not finish");
+
+	ret = close(server_sock);
+	zassert_equal(ret, 0, "close failed");
+
+	(void)tls_credential_delete(PSK_TAG, TLS_CREDENTIAL_PSK);
+	(void)tls_credential_delete(PSK_TAG, TLS_CREDENTIAL_PSK_ID);
+}
+
+static void dtls_server_thread_fn(void *p1, void *p2, void *p3)
+{
+	uint8_t buf[16];
+	int i, ret, status;
+	socklen_t optlen = sizeof(status);
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < DTLS_MSG_COUNT; i++) {
+		ret = recv(server_sock, buf, sizeof(buf), 0);
+		zassert_true(ret > 0, "recv failed (%d)", errno);
+
+		ret = send(server_sock, buf, ret, 0);
+		zassert_true(ret > 0, "send failed (%d)", errno);
+	}
+
+	ret = getsockopt(server_sock, SOL_TLS, TLS_DTLS_CID_STATUS,
+			 &status, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_true(status & TLS_DTLS_CID_STATUS_DOWNLINK,
+		     "Server should receive records with Connection ID");
+
+	k_sem_give(&server_done);
+}
+
+/* UDP forwarder emulating a NAT, which changes the source port used
+ * towards the server when proxy_upstream is switched.
+ */
+static void proxy_thread_fn(void *p1, void *p2, void *p3)
+{
+	struct sockaddr_in *server_addr = p1;
+	struct sockaddr_in client_addr = { 0 };
+	socklen_t addrlen;
+	struct zsock_pollfd fds[3];
+	uint8_t buf[1280];
+	int i, ret;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	fds[0].fd = proxy_sock;
+	fds[1].fd = proxy_upstream_sock[0];
+	fds[2].fd = proxy_upstream_sock[1];
+
+	for (i = 0; i < ARRAY_SIZE(fds); i++) {
+		fds[i].events = ZSOCK_POLLIN;
+	}
+
+	while (!proxy_stop) {
+		ret = poll(fds, ARRAY_SIZE(fds), 100);
+		if (ret <= 0) {
+			continue;
+		}
+
+		if (fds[0].revents & ZSOCK_POLLIN) {
+			addrlen = sizeof(client_addr);
+			ret = recvfrom(proxy_sock, buf, sizeof(buf), 0,
+				       (struct sockaddr *)&client_addr,
+				       &addrlen);
+			if (ret > 0) {
+				(void)sendto(proxy_upstream_sock[proxy_upstream],
+					     buf, ret, 0,
+					     (struct sockaddr *)server_addr,
+					     sizeof(*server_addr));
+			}
+		}
+
+		for (i = 1; i < ARRAY_SIZE(fds); i++) {
+			if (!(fds[i].revents & ZSOCK_POLLIN)) {
+				continue;
+			}
+
+			ret = recv(fds[i].fd, buf, sizeof(buf), 0);
+			if (ret > 0) {
+				(void)sendto(proxy_sock, buf, ret, 0,
+					     (struct sockaddr *)&client_addr,
+					     sizeof(client_addr));
+			}
+		}
+	}
+}
+
+static void dtls_client_echo(int sock, const char *msg)
+{
+	uint8_t buf[16];
+	int ret;
+
+	ret = send(sock, msg, strlen(msg), 0);
+	zassert_equal(ret, strlen(msg), "send failed (%d)", errno);
+
+	ret = recv(sock, buf, sizeof(buf), 0);
+	zassert_equal(ret, strlen(msg), "recv failed (%d)", errno);
+	zassert_mem_equal(buf, msg, ret, "invalid data received");
+}
+
+static void test_dtls_cid_nat_rebinding(void)
+{
+	static struct sockaddr_in server_addr;
+	struct sockaddr_in proxy_addr;
+	sec_tag_t sec_tag_list[] = { PSK_TAG };
+	int role = TLS_DTLS_ROLE_SERVER;
+	int cid, status, client_sock, ret, i;
+	socklen_t optlen = sizeof(status);
+
+	ret = tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK,
+				 psk, sizeof(psk));
+	zassert_equal(ret, 0, "Failed to register PSK (%d)", ret);
+
+	ret = tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK_ID,
+				 psk_id, strlen(psk_id));
+	zassert_equal(ret, 0, "Failed to register PSK ID (%d)", ret);
+
+	/* DTLS server, requesting own Connection ID. */
+	server_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_DTLS_1_2);
+	zassert_true(server_sock >= 0, "socket open failed (%d)", errno);
+
+	ret = setsockopt(server_sock, SOL_TLS, TLS_SEC_TAG_LIST,
+			 sec_tag_list, sizeof(sec_tag_list));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	ret = setsockopt(server_sock, SOL_TLS, TLS_DTLS_ROLE,
+			 &role, sizeof(role));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	cid = TLS_DTLS_CID_ENABLED;
+	ret = setsockopt(server_sock, SOL_TLS, TLS_DTLS_CID,
+			 &cid, sizeof(cid));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	(void)memset(&server_addr, 0, sizeof(server_addr));
+	server_addr.sin_family = AF_INET;
+	server_addr.sin_port = htons(DTLS_SERVER_PORT);
+	ret = inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+			&server_addr.sin_addr);
+	zassert_equal(ret, 1, "inet_pton failed");
+
+	ret = bind(server_sock, (struct sockaddr *)&server_addr,
+		   sizeof(server_addr));
+	zassert_equal(ret, 0, "bind failed (%d)", errno);
+
+	/* NAT emulation: client side socket and two upstream sockets. */
+	memcpy(&proxy_addr, &server_addr, sizeof(proxy_addr));
+	proxy_addr.sin_port = htons(PROXY_PORT);
+	proxy_sock = prepare_listen_sock_udp_v4(&proxy_addr);
+
+	for (i = 0; i < ARRAY_SIZE(proxy_upstream_sock); i++) {
+		proxy_upstream_sock[i] = socket(AF_INET, SOCK_DGRAM,
+						IPPROTO_UDP);
+		zassert_true(proxy_upstream_sock[i] >= 0,
+			     "socket open failed (%d)", errno);
+	}
+
+	proxy_upstream = 0;
+	proxy_stop = false;
+
+	k_thread_create(&proxy_thread, proxy_stack,
+			K_THREAD_STACK_SIZEOF(proxy_stack),
+			proxy_thread_fn, &server_addr, NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			dtls_server_thread_fn, NULL, NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	/* DTLS client, accepting Connection ID requested by the server. */
+	client_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_DTLS_1_2);
+	zassert_true(client_sock >= 0, "socket open failed (%d)", errno);
+
+	ret = setsockopt(client_sock, SOL_TLS, TLS_SEC_TAG_LIST,
+			 sec_tag_list, sizeof(sec_tag_list));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	cid = TLS_DTLS_CID_SUPPORTED;
+	ret = setsockopt(client_sock, SOL_TLS, TLS_DTLS_CID,
+			 &cid, sizeof(cid));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	ret = connect(client_sock, (struct sockaddr *)&proxy_addr,
+		      sizeof(proxy_addr));
+	zassert_equal(ret, 0, "connect failed (%d)", errno);
+
+	/* The first message triggers the handshake. */
+	dtls_client_echo(client_sock, "before-1");
+	dtls_client_echo(client_sock, "before-2");
+
+	ret = getsockopt(client_sock, SOL_TLS, TLS_DTLS_CID_STATUS,
+			 &status, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(status, TLS_DTLS_CID_STATUS_UPLINK,
+		      "Client should send records with Connection ID");
+
+	/* NAT rebinding - server now sees a different source port. Without
+	 * Connection ID the server would drop the traffic, and the client
+	 * would have to perform a new handshake.
+	 */
+	proxy_upstream = 1;
+
+	dtls_client_echo(client_sock, "after-1");
+	dtls_client_echo(client_sock, "after-2");
+
+	ret = k_sem_take(&server_done, K_SECONDS(10));
+	zassert_equal(ret, 0, "Server thread did not finish");
+
+	proxy_stop = true;
+	k_thread_join(&proxy_thread, K_FOREVER);
+
+	ret = close(client_sock);
+	zassert_equal(ret, 0, "close failed");
+
+	ret = close(server_sock);
+	zassert_equal(ret, 0, "close failed");
+
+	(void)close(proxy_sock);
+	for (i = 0; i < ARRAY_SIZE(proxy_upstream_sock); i++) {
+		(void)close(proxy_upstream_sock[i]);
+	}
+
+	(void)tls_credential_delete(PSK_TAG, TLS_CREDENTIAL_PSK);
+	(void)tls_credential_delete(PSK_TAG, TLS_CREDENTIAL_PSK_ID);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_tls,
+			 ztest_unit_test(test_session_cache_sockopt),
+			 ztest_unit_test(test_session_resumption),
+			 ztest_unit_test(test_dtls_cid_nat_rebinding));
+
+	ztest_run_test_suite(socket_tls);
+}
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Enable server side session cache and session tickets for the test. */
+#define MBEDTLS_SSL_CACHE_C
+#define MBEDTLS_SSL_SESSION_TICKETS
+#define MBEDTLS_SSL_TICKET_C
+#define MBEDTLS_GCM_C
+
+/* Enable DTLS Connection ID for the test. */
+#define MBEDTLS_SSL_DTLS_CONNECTION_ID
@@ -269,44 +269,57 @@ static void test_recv_two_msg(void)
 	test_recv_2(sizeof(frame1) + FRAME1_HDR_SIZE / 2);
 }
 
+/* Masked payload is sent in several chunks, only the first one of them
+ * carries the frame header. The receive context is thus kept over calls.
+ */
 int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 {
 	static struct websocket_context ctx;
+	static size_t total_read;
 	uint32_t msg_type = -1;
 	uint64_t remaining = -1;
-	size_t split_len = 0, total_read = 0;
+	uint8_t *data = msg->msg_iov[1].iov_base;
+	size_t data_len = msg->msg_iov[1].iov_len;
+	size_t split_len = 0, chunk_read = 0;
 	int ret;
 
-	memset(&ctx, 0, sizeof(ctx));
+	if (msg->msg_iov[0].iov_len > 0) {
+		memset(&ctx, 0, sizeof(ctx));
 
-	ctx.tmp_buf = temp_recv_buf;
-	ctx.tmp_buf_len = sizeof(temp_recv_buf);
+		ctx.tmp_buf = temp_recv_buf;
+		ctx.tmp_buf_len = sizeof(temp_recv_buf);
 
-	/* Read first the header */
-	ret = test_recv_buf(msg->msg_iov[0].iov_base,
-			    msg->msg_iov[0].iov_len,
-			    &ctx, &msg_type, &remaining,
-			    recv_buf, sizeof(recv_buf));
-	zassert_equal(ret, -EAGAIN, "Msg header not found");
+		total_read = 0;
+
+		/* Read first the header */
+		ret = test_recv_buf(msg->msg_iov[0].iov_base,
+				    msg->msg_iov[0].iov_len,
+				    &ctx, &msg_type, &remaining,
+				    recv_buf, sizeof(recv_buf));
+		zassert_equal(ret, -EAGAIN, "Msg header not found");
+	} else {
+		zassert_true(total_read > 0, "Data without msg header");
+	}
 
 	/* Then the first split if it is enabled */
 	if (split_msg) {
-		split_len = msg->msg_iov[1].iov_len / 2;
+		split_len = data_len / 2;
 
-		ret = test_recv_buf(msg->msg_iov[1].iov_base,
-				    split_len,
+		ret = test_recv_buf(data, split_len,
 				    &ctx, &msg_type, &remaining,
 				    recv_buf, sizeof(recv_buf));
 		zassert_true(ret > 0, "Cannot read data (%d)", ret);
 
-		total_read = ret;
+		zassert_mem_equal(recv_buf, lorem_ipsum + total_read, ret,
+				  "Invalid split message");
+
+		total_read += ret;
+		chunk_read = ret;
 	}
 
 	/* Then the data */
-	while (remaining > 0) {
-		ret = test_recv_buf((uint8_t *)msg->msg_iov[1].iov_base +
-								total_read,
-				    msg->msg_iov[1].iov_len - total_read,
+	while (chunk_read < data_len) {
+		ret = test_recv_buf(data + chunk_read, data_len - chunk_read,
 				    &ctx, &msg_type, &remaining,
 				    recv_buf, sizeof(recv_buf));
 		zassert_true(ret > 0, "Cannot read data (%d)", ret);
@@ -316,20 +329,23 @@ int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 					"Received message should be");
 			LOG_HEXDUMP_ERR(recv_buf, ret, "but it was instead");
 			zassert_true(false, "Invalid received message "
-				     "after %d bytes", total_read);
+				     "after %zd bytes", total_read);
 		}
 
 		total_read += ret;
+		chunk_read += ret;
 	}
 
-	zassert_equal(total_read, test_msg_len,
-		      "Msg body not valid, received %d instead of %zd",
-		      total_read, test_msg_len);
+	if (remaining == 0) {
+		zassert_equal(total_read, test_msg_len,
+			      "Msg body not valid, received %zd instead of %zd",
+			      total_read, test_msg_len);
+	}
 
 	NET_DBG("Received %zd header and %zd body",
-		msg->msg_iov[0].iov_len, total_read);
+		msg->msg_iov[0].iov_len, chunk_read);
 
-	return msg->msg_iov[0].iov_len + total_read;
+	return msg->msg_iov[0].iov_len + chunk_read;
 }
 
 static void test_send_and_recv_lorem_ipsum(void)
@@ -353,6 +369,30 @@ static void test_send_and_recv_lorem_ipsum(void)
 		      test_msg_len, ret);
 }
 
+static void test_send_and_recv_masked_unaligned_len(void)
+{
+	static struct websocket_context ctx;
+	int ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.tmp_buf = temp_recv_buf;
+	ctx.tmp_buf_len = sizeof(temp_recv_buf);
+
+	/* Length that is not a multiple of the masking key or word size, so
+	 * that the payload also ends in the middle of a masking key.
+	 */
+	test_msg_len = sizeof(lorem_ipsum) - 6;
+
+	ret = websocket_send_msg(POINTER_TO_INT(&ctx),
+				 lorem_ipsum, test_msg_len,
+				 WEBSOCKET_OPCODE_DATA_BINARY, true, true,
+				 SYS_FOREVER_MS);
+	zassert_equal(ret, test_msg_len,
+		      "Should have sent %zd bytes but sent %d instead",
+		      test_msg_len, ret);
+}
+
 static void test_recv_two_large_split_msg(void)
 {
 	static struct websocket_context ctx;
@@ -390,6 +430,7 @@ void test_main(void)
 			 ztest_unit_test(test_recv_whole_msg),
 			 ztest_unit_test(test_recv_two_msg),
 			 ztest_unit_test(test_send_and_recv_lorem_ipsum),
+			 ztest_unit_test(test_send_and_recv_masked_unaligned_len),
 			 ztest_unit_test(test_recv_two_large_split_msg)
 		);
 
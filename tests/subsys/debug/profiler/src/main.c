@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <debug/profiler.h>
+#include <string.h>
+
+#define SPIN_MS 500
+#define MIN_SAMPLES (CONFIG_PROFILER_SAMPLE_RATE * SPIN_MS / MSEC_PER_SEC / 2)
+
+/* Return address of the call to spin(), in the profiled test function. */
+static uintptr_t spin_caller;
+
+struct drain_result {
+	uint32_t samples;
+	uint32_t own_thread;
+	uint32_t in_caller;
+};
+
+static __attribute__((noinline)) void spin(void)
+{
+	spin_caller = (uintptr_t)__builtin_return_address(0);
+
+	k_busy_wait(SPIN_MS * USEC_PER_MSEC);
+}
+
+static void drain_cb(const struct profiler_sample *sample, void *user_data)
+{
+	struct drain_result *result = user_data;
+
+	zassert_true(sample->depth <= PROFILER_STACK_DEPTH, "bad depth");
+
+	result->samples++;
+
+	if (sample->thread == k_current_get()) {
+		result->own_thread++;
+	}
+
+	for (uint32_t i = 1; i < sample->depth; i++) {
+		if (sample->pc[i] == spin_caller) {
+			result->in_caller++;
+			break;
+		}
+	}
+}
+
+static void drain_all(void)
+{
+	struct drain_result result = { 0 };
+
+	(void)profiler_drain(drain_cb, &result);
+}
+
+/**
+ * @brief Test starting and stopping the profiler
+ */
+static void test_start_stop(void)
+{
+	zassert_false(profiler_is_running(), "running before start");
+	zassert_equal(profiler_stop(), -EALREADY, "stopped twice");
+
+	zassert_equal(profiler_start(), 0, "start failed");
+	zassert_true(profiler_is_running(), "not running after start");
+	zassert_equal(profiler_start(), -EALREADY, "started twice");
+
+	zassert_equal(profiler_stop(), 0, "stop failed");
+	zassert_false(profiler_is_running(), "running after stop");
+
+	drain_all();
+}
+
+/**
+ * @brief Test sampling a busy thread
+ *
+ * The samples taken while the test thread spins must belong to it and,
+ * with call stacks, include the call to the spinning function.
+ */
+static void test_sampling(void)
+{
+	struct drain_result result = { 0 };
+	struct profiler_stats before, after;
+
+	drain_all();
+	profiler_stats_get(&before);
+
+	zassert_equal(profiler_start(), 0, "start failed");
+	spin();
+	zassert_equal(profiler_stop(), 0, "stop failed");
+
+	profiler_stats_get(&after);
+	zassert_equal(profiler_drain(drain_cb, &result), result.samples,
+		      "bad drained count");
+
+	zassert_true(result.samples >= MIN_SAMPLES, "too few samples: %u",
+		     result.samples);
+	zassert_equal(result.samples + (after.dropped - before.dropped),
+		      after.samples - before.samples, "samples lost");
+	zassert_true(result.own_thread >= MIN_SAMPLES,
+		     "too few samples in the test thread: %u",
+		     result.own_thread);
+
+	if (IS_ENABLED(CONFIG_PROFILER_STACK_TRACE)) {
+		zassert_true(result.in_caller >= MIN_SAMPLES,
+			     "too few stacks through spin(): %u",
+			     result.in_caller);
+	} else {
+		zassert_equal(result.in_caller, 0, "unexpected stacks");
+	}
+}
+
+struct dump_result {
+	uint32_t samples;
+	uint32_t threads;
+	uint32_t end;
+};
+
+static void dump_cb(const char *line, void *user_data)
+{
+	struct dump_result *result = user_data;
+
+	zassert_equal(strncmp(line, "PROF", 4), 0, "bad line: %s", line);
+
+	if (strncmp(line, "PROF-THREAD ", 12) == 0) {
+		result->threads++;
+	} else if (strncmp(line, "PROF-END ", 9) == 0) {
+		result->end++;
+	} else {
+		zassert_equal(strncmp(line, "PROF 0x", 7), 0, "bad line: %s",
+			      line);
+		zassert_equal(result->end, 0, "sample after end");
+		result->samples++;
+	}
+}
+
+/**
+ * @brief Test the text output of the samples
+ */
+static void test_dump(void)
+{
+	struct dump_result result = { 0 };
+	uint32_t cnt;
+
+	k_thread_name_set(k_current_get(), "profiled");
+
+	drain_all();
+
+	zassert_equal(profiler_start(), 0, "start failed");
+	spin();
+	zassert_equal(profiler_stop(), 0, "stop failed");
+
+	cnt = profiler_dump(dump_cb, &result);
+
+	zassert_true(cnt >= MIN_SAMPLES, "too few samples: %u", cnt);
+	zassert_equal(result.samples, cnt, "bad sample lines");
+	zassert_true(result.threads >= 1, "no thread lines");
+	zassert_equal(result.end, 1, "no end line");
+	zassert_equal(profiler_dump(dump_cb, &result), 0, "not drained");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(profiler,
+			 ztest_unit_test(test_start_stop),
+			 ztest_unit_test(test_sampling),
+			 ztest_unit_test(test_dump));
+	ztest_run_test_suite(profiler);
+}
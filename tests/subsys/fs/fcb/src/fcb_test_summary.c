@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "fcb_test.h"
+
+#ifdef CONFIG_FCB_SECTOR_SUMMARY
+static struct fcb_sector_summary test_fcb_summary[2];
+
+static void fcb_summary_init(struct fcb *fcb)
+{
+	int rc;
+
+	(void)memset(fcb, 0, sizeof(*fcb));
+	fcb->f_erase_value = fcb_test_erase_value;
+	fcb->f_sector_cnt = 2U;
+	fcb->f_sectors = test_fcb_sector;
+	fcb->f_summaries = test_fcb_summary;
+
+	rc = fcb_init(TEST_FCB_FLASH_AREA_ID, fcb);
+	zassert_true(rc == 0, "fcb_init call failure");
+}
+
+static void fcb_summary_append(struct fcb *fcb, int len,
+			       struct fcb_entry *loc, bool finish)
+{
+	uint8_t test_data[128];
+	int rc;
+	int i;
+
+	rc = fcb_append(fcb, len, loc);
+	zassert_true(rc == 0, "fcb_append call failure");
+
+	for (i = 0; i < len; i++) {
+		test_data[i] = fcb_test_append_data(len, i);
+	}
+	rc = flash_area_write(fcb->fap, FCB_ENTRY_FA_DATA_OFF((*loc)),
+			      test_data, len);
+	zassert_true(rc == 0, "flash_area_write call failure");
+
+	if (finish) {
+		rc = fcb_append_finish(fcb, loc);
+		zassert_true(rc == 0, "fcb_append_finish call failure");
+	}
+}
+
+static void fcb_summary_check(struct fcb *fcb, uint16_t elem_cnt,
+			      uint16_t bad_cnt, uint32_t last_off)
+{
+	const struct fcb_sector_summary *sum = &test_fcb_summary[0];
+	int var_cnt;
+	int rc;
+
+	zassert_equal(sum->fss_elem_cnt, elem_cnt, "wrong element count");
+	zassert_equal(sum->fss_bad_cnt, bad_cnt, "wrong invalid count");
+	zassert_equal(sum->fss_first_off, sizeof(struct fcb_disk_area),
+		      "wrong first element offset");
+	zassert_equal(sum->fss_last_off, last_off,
+		      "wrong last element offset");
+	zassert_equal(sum->fss_end_off, fcb->f_active.fe_elem_off,
+		      "wrong end offset");
+
+	var_cnt = 1;
+	rc = fcb_walk(fcb, 0, fcb_test_data_walk_cb, &var_cnt);
+	zassert_true(rc == 0, "fcb_walk call failure");
+	zassert_equal(var_cnt, 4,
+		      "fcb_walk: elements count read different than expected");
+}
+#endif /* CONFIG_FCB_SECTOR_SUMMARY */
+
+void test_fcb_summary(void)
+{
+#ifdef CONFIG_FCB_SECTOR_SUMMARY
+	struct fcb *fcb = &test_fcb;
+	struct fcb_entry loc;
+	uint32_t last_off;
+
+	fcb_summary_init(fcb);
+
+	fcb_summary_append(fcb, 1, &loc, true);
+	fcb_summary_append(fcb, 2, &loc, true);
+	fcb_summary_append(fcb, 3, &loc, true);
+	last_off = loc.fe_elem_off;
+
+	fcb_summary_check(fcb, 3, 0, last_off);
+
+	/*
+	 * Unfinished element is counted as invalid, and skipped by the walk.
+	 */
+	fcb_summary_append(fcb, 4, &loc, false);
+	fcb_summary_check(fcb, 4, 1, last_off);
+
+	/*
+	 * Pretend reset, the summary is rebuilt from flash.
+	 */
+	fcb_summary_init(fcb);
+	fcb_summary_check(fcb, 4, 1, last_off);
+#else
+	ztest_test_skip();
+#endif
+}
@@ -172,6 +172,7 @@ void test_fcb_reset(void);
 void test_fcb_rotate(void);
 void test_fcb_multi_scratch(void);
 void test_fcb_last_of_n(void);
+void test_fcb_summary(void);
 
 void test_main(void)
 {
@@ -202,6 +203,9 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(test_fcb_last_of_n,
 							fcb_pretest_4_sectors,
 							teardown_nothing),
+			 ztest_unit_test_setup_teardown(test_fcb_summary,
+							fcb_pretest_2_sectors,
+							teardown_nothing),
 			 /* Finally, run one that leaves behind a
 			  * flash.bin file without any random content */
 			 ztest_unit_test_setup_teardown(test_fcb_reset,
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Append streams and space reservation:
+ * * commit of a stream deferred until enough data was appended
+ * * space reserved for a file is not available to other files
+ * * reservation released as the file grows and on close
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include "testfs_tests.h"
+#include "testfs_lfs.h"
+
+#define STREAM "stream"
+#define RESERVED "reserved"
+#define OTHER "other"
+
+/* 14 of the 16 blocks of the small partition, two being used by the root
+ * directory.
+ */
+#define RESERVE_SIZE (48 * 1024)
+
+static uint8_t buf[1024];
+
+static off_t stat_size(struct fs_mount_t *mp, const char *name)
+{
+	struct testfs_path path;
+	struct fs_dirent stat;
+
+	zassert_equal(fs_stat(testfs_path_init(&path, mp, name,
+					       TESTFS_PATH_END),
+			      &stat),
+		      0,
+		      "stat failed");
+
+	return stat.size;
+}
+
+static void file_open(struct fs_file_t *file, struct fs_mount_t *mp,
+		      const char *name, fs_mode_t flags)
+{
+	struct testfs_path path;
+
+	zassert_equal(fs_open(file,
+			      testfs_path_init(&path, mp, name,
+					       TESTFS_PATH_END),
+			      flags),
+		      0,
+		      "open failed");
+}
+
+static int stream_commits(struct fs_mount_t *mp)
+{
+	struct fs_file_t file;
+	size_t written = 0;
+
+	TC_PRINT("checking deferred commit of a stream\n");
+
+	file_open(&file, mp, STREAM, FS_O_CREATE | FS_O_WRITE | FS_O_STREAM);
+
+	zassert_equal(fs_write(&file, buf, 100), 100,
+		      "write failed");
+	zassert_equal(fs_sync(&file), 0,
+		      "sync failed");
+	zassert_equal(stat_size(mp, STREAM), 0,
+		      "commit not deferred");
+
+	while (written < CONFIG_FS_LITTLEFS_STREAM_COMMIT_SIZE) {
+		zassert_equal(fs_write(&file, buf, sizeof(buf)), sizeof(buf),
+			      "write failed");
+		written += sizeof(buf);
+	}
+
+	zassert_equal(stat_size(mp, STREAM), 100 + written,
+		      "stream not committed");
+
+	zassert_equal(fs_close(&file), 0,
+		      "close failed");
+
+	return TC_PASS;
+}
+
+static int reservation(struct fs_mount_t *mp)
+{
+	struct fs_file_t reserved, other;
+
+	TC_PRINT("checking space reservation\n");
+
+	file_open(&reserved, mp, RESERVED, FS_O_CREATE | FS_O_WRITE);
+	file_open(&other, mp, OTHER, FS_O_CREATE | FS_O_WRITE);
+
+	zassert_equal(fs_fallocate(&reserved, RESERVE_SIZE), 0,
+		      "fallocate failed");
+	zassert_equal(stat_size(mp, RESERVED), 0,
+		      "fallocate changed size");
+	zassert_equal(fs_fallocate(&other, RESERVE_SIZE), -ENOSPC,
+		      "reserved space reserved again");
+
+	zassert_equal(fs_write(&other, buf, sizeof(buf)), -ENOSPC,
+		      "reserved space used by other file");
+
+	for (size_t n = 0; n < RESERVE_SIZE; n += sizeof(buf)) {
+		zassert_equal(fs_write(&reserved, buf, sizeof(buf)),
+			      sizeof(buf),
+			      "write to reservation failed");
+	}
+
+	zassert_equal(fs_write(&other, buf, sizeof(buf)), sizeof(buf),
+		      "consumed reservation still held");
+
+	zassert_equal(fs_close(&reserved), 0,
+		      "close failed");
+	zassert_equal(fs_close(&other), 0,
+		      "close failed");
+
+	return TC_PASS;
+}
+
+void test_lfs_stream(void)
+{
+	struct fs_mount_t *mp = &testfs_small_mnt;
+	struct testfs_path path;
+
+	memset(buf, 0xa5, sizeof(buf));
+
+	zassert_equal(testfs_lfs_wipe_partition(mp), TC_PASS,
+		      "failed to wipe partition");
+	zassert_equal(fs_mount(mp), 0,
+		      "mount failed");
+
+	zassert_equal(stream_commits(mp), TC_PASS,
+		      "stream commits failed");
+
+	zassert_equal(fs_unlink(testfs_path_init(&path, mp, STREAM,
+						 TESTFS_PATH_END)),
+		      0,
+		      "unlink failed");
+
+	zassert_equal(reservation(mp), TC_PASS,
+		      "reservation failed");
+
+	zassert_equal(fs_unmount(mp), 0,
+		      "unmount failed");
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Vectored and asynchronous file operations:
+ * * writev
+ * * readv
+ * * asynchronous write, sync and read
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <fs/fs_async.h>
+#include "testfs_tests.h"
+#include "testfs_lfs.h"
+
+#define VECTORED "vectored"
+
+static const char part1[] = "scatter";
+static const char part2[] = "/gather ";
+static const char part3[] = "done";
+
+static int write_parts(struct fs_file_t *file)
+{
+	const struct fs_iovec iov[] = {
+		{ .base = (void *)part1, .len = strlen(part1) },
+		{ .base = (void *)part2, .len = strlen(part2) },
+		{ .base = (void *)part3, .len = strlen(part3) },
+	};
+
+	TC_PRINT("writing vectored\n");
+
+	zassert_equal(fs_writev(file, iov, ARRAY_SIZE(iov)),
+		      strlen(part1) + strlen(part2) + strlen(part3),
+		      "writev failed");
+
+	return TC_PASS;
+}
+
+static int read_parts(struct fs_file_t *file)
+{
+	char buf1[sizeof(part1) - 1];
+	char buf2[32] = { 0 };
+	const struct fs_iovec iov[] = {
+		{ .base = buf1, .len = sizeof(buf1) },
+		{ .base = buf2, .len = sizeof(buf2) - 1 },
+	};
+
+	TC_PRINT("reading vectored\n");
+
+	zassert_equal(fs_seek(file, 0, FS_SEEK_SET), 0,
+		      "seek failed");
+	zassert_equal(fs_readv(file, iov, ARRAY_SIZE(iov)),
+		      strlen(part1) + strlen(part2) + strlen(part3),
+		      "readv failed");
+	zassert_equal(memcmp(buf1, part1, sizeof(buf1)), 0,
+		      "first buffer mismatch");
+	zassert_equal(strncmp(buf2, part2, strlen(part2)), 0,
+		      "second buffer mismatch");
+	zassert_equal(strcmp(buf2 + strlen(part2), part3), 0,
+		      "second buffer tail mismatch");
+
+	return TC_PASS;
+}
+
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+static ssize_t async_run(struct fs_async_req *req)
+{
+	struct k_poll_signal signal;
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &signal);
+	unsigned int signaled;
+	int result;
+
+	k_poll_signal_init(&signal);
+	req->signal = &signal;
+
+	zassert_equal(fs_async_submit(req), 0,
+		      "submit failed");
+	zassert_equal(k_poll(&event, 1, K_SECONDS(5)), 0,
+		      "request not completed");
+
+	k_poll_signal_check(&signal, &signaled, &result);
+	zassert_equal(result, req->result,
+		      "signal result mismatch");
+
+	return req->result;
+}
+
+static int async_parts(struct fs_file_t *file)
+{
+	char buf[sizeof(part1) - 1];
+	struct fs_iovec iov = { .base = (void *)part1, .len = strlen(part1) };
+	struct fs_async_req req = {
+		.op = FS_ASYNC_WRITE,
+		.zfp = file,
+		.iov = &iov,
+		.iovcnt = 1,
+	};
+
+	TC_PRINT("writing, syncing and reading asynchronously\n");
+
+	zassert_equal(fs_seek(file, 0, FS_SEEK_SET), 0,
+		      "seek failed");
+	zassert_equal(async_run(&req), strlen(part1),
+		      "async write failed");
+
+	req.op = FS_ASYNC_SYNC;
+	zassert_equal(async_run(&req), 0,
+		      "async sync failed");
+
+	iov.base = buf;
+	req.op = FS_ASYNC_READ;
+	zassert_equal(fs_seek(file, 0, FS_SEEK_SET), 0,
+		      "seek failed");
+	zassert_equal(async_run(&req), sizeof(buf),
+		      "async read failed");
+	zassert_equal(memcmp(buf, part1, sizeof(buf)), 0,
+		      "async read mismatch");
+
+	req.zfp = NULL;
+	zassert_equal(fs_async_submit(&req), -EINVAL,
+		      "request without file accepted");
+
+	return TC_PASS;
+}
+#endif /* CONFIG_FILE_SYSTEM_ASYNC */
+
+void test_lfs_vectored(void)
+{
+	struct fs_mount_t *mp = &testfs_small_mnt;
+	struct testfs_path path;
+	struct fs_file_t file;
+
+	zassert_equal(testfs_lfs_wipe_partition(mp), TC_PASS,
+		      "failed to wipe partition");
+	zassert_equal(fs_mount(mp), 0,
+		      "mount failed");
+
+	zassert_equal(fs_open(&file,
+			      testfs_path_init(&path, mp,
+					       VECTORED,
+					       TESTFS_PATH_END),
+			      FS_O_CREATE | FS_O_RDWR),
+		      0,
+		      "open failed");
+
+	zassert_equal(write_parts(&file), TC_PASS,
+		      "write parts failed");
+	zassert_equal(read_parts(&file), TC_PASS,
+		      "read parts failed");
+#ifdef CONFIG_FILE_SYSTEM_ASYNC
+	zassert_equal(async_parts(&file), TC_PASS,
+		      "async parts failed");
+#endif
+
+	zassert_equal(fs_close(&file), 0,
+		      "close failed");
+	zassert_equal(fs_unmount(mp), 0,
+		      "unmount failed");
+}
@@ -24,6 +24,12 @@ void test_lfs_dirops(void);
 /* Tests in test_lfs_perf */
 void test_lfs_perf(void);
 
+/* Tests in test_lfs_vectored */
+void test_lfs_vectored(void);
+
+/* Tests in test_lfs_stream */
+void test_lfs_stream(void);
+
 /* Test fs_open flags */
 void test_fs_open_flags_lfs(void);
 
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test dictionary based log output
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <tc_util.h>
+#include <sys/cbprintf.h>
+#include <logging/log.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_output.h>
+#include <logging/log_output_dict.h>
+
+LOG_MODULE_REGISTER(test, LOG_LEVEL_INF);
+
+#define BENCH_MSGS 64
+
+static uint8_t capture_buf[4096];
+static uint32_t capture_len;
+static uint8_t output_buf[64];
+static uint32_t out_flags;
+
+/* Not in read-only memory, copied into the package. */
+static char name[] = "sensor0";
+
+static int capture(uint8_t *data, size_t length, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	length = MIN(length, sizeof(capture_buf) - capture_len);
+	memcpy(&capture_buf[capture_len], data, length);
+	capture_len += length;
+
+	return length;
+}
+
+LOG_OUTPUT_DEFINE(test_output, capture, output_buf, sizeof(output_buf));
+
+static void put(const struct log_backend *const backend,
+		struct log_msg *msg)
+{
+	ARG_UNUSED(backend);
+	ARG_UNUSED(msg);
+}
+
+static void put_package(const struct log_backend *const backend,
+			struct log_msg_ids src_level, uint32_t timestamp,
+			const void *package, const uint8_t *data,
+			uint32_t length)
+{
+	log_output_package(&test_output, src_level, timestamp, package, data,
+			   length, out_flags);
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	ARG_UNUSED(backend);
+
+	if (out_flags & LOG_OUTPUT_FLAG_FORMAT_DICTIONARY) {
+		log_output_dict_dropped_process(&test_output, cnt);
+	}
+}
+
+static void panic(const struct log_backend *const backend)
+{
+	ARG_UNUSED(backend);
+}
+
+static const struct log_backend_api test_backend_api = {
+	.put = put,
+	.put_package = put_package,
+	.dropped = dropped,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(test_backend, test_backend_api, true);
+
+struct str_ctx {
+	char *buf;
+	size_t len;
+};
+
+static int str_out(int c, void *ctx)
+{
+	struct str_ctx *str = ctx;
+
+	str->buf[str->len++] = (char)c;
+
+	return c;
+}
+
+static bool contains(const uint8_t *buf, size_t len, const char *str)
+{
+	size_t str_len = strlen(str);
+	size_t i;
+
+	for (i = 0; i + str_len <= len; i++) {
+		if (memcmp(&buf[i], str, str_len) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void flush(void)
+{
+	while (log_process(false)) {
+	}
+}
+
+static void reset(uint32_t flags)
+{
+	flush();
+	out_flags = flags;
+	capture_len = 0U;
+}
+
+static void test_log_dictionary_std(void)
+{
+	struct log_dict_msg_hdr hdr;
+	char text[64] = "";
+	struct str_ctx str = { .buf = text };
+
+	reset(LOG_OUTPUT_FLAG_FORMAT_DICTIONARY);
+
+	LOG_INF("val %d %s", 5, name);
+	flush();
+
+	zassert_true(capture_len > sizeof(hdr), "No record written");
+	memcpy(&hdr, capture_buf, sizeof(hdr));
+
+	zassert_equal(hdr.type, LOG_DICT_MSG_TYPE_STD, "Unexpected type");
+	zassert_equal(hdr.ids, LOG_DICT_MSG_IDS(LOG_LEVEL_INF, 0),
+		      "Unexpected ids");
+	zassert_equal(hdr.source_id, LOG_CURRENT_MODULE_ID(),
+		      "Unexpected source id");
+	zassert_equal(hdr.data_len, 0, "Unexpected data length");
+	zassert_equal(capture_len, sizeof(hdr) + hdr.pkg_len,
+		      "Unexpected record length");
+
+	/* Only the format string pointer is written, not the text. */
+	zassert_false(contains(capture_buf, capture_len, "val "),
+		      "Format string in the record");
+
+	cbpprintf(str_out, &str, &capture_buf[sizeof(hdr)]);
+	zassert_equal(strcmp(text, "val 5 sensor0"), 0,
+		      "Unexpected text: %s", text);
+}
+
+static void test_log_dictionary_hexdump(void)
+{
+	static const uint8_t data[] = { 1, 2, 3, 4, 5, 6 };
+	struct log_dict_msg_hdr hdr;
+
+	reset(LOG_OUTPUT_FLAG_FORMAT_DICTIONARY);
+
+	LOG_HEXDUMP_INF(data, sizeof(data), "dump");
+	flush();
+
+	memcpy(&hdr, capture_buf, sizeof(hdr));
+
+	zassert_equal(hdr.type, LOG_DICT_MSG_TYPE_HEXDUMP, "Unexpected type");
+	zassert_equal(hdr.data_len, sizeof(data), "Unexpected data length");
+	zassert_equal(capture_len, sizeof(hdr) + hdr.pkg_len + sizeof(data),
+		      "Unexpected record length");
+	zassert_equal(memcmp(&capture_buf[sizeof(hdr) + hdr.pkg_len], data,
+			     sizeof(data)), 0, "Unexpected data");
+}
+
+static void test_log_dictionary_dropped(void)
+{
+	struct log_dict_dropped_hdr hdr;
+
+	reset(LOG_OUTPUT_FLAG_FORMAT_DICTIONARY);
+
+	log_backend_dropped(&test_backend, 3);
+
+	zassert_equal(capture_len, sizeof(hdr), "Unexpected record length");
+	memcpy(&hdr, capture_buf, sizeof(hdr));
+	zassert_equal(hdr.type, LOG_DICT_MSG_TYPE_DROPPED, "Unexpected type");
+	zassert_equal(hdr.count, 3, "Unexpected count");
+}
+
+static void bench_run(uint32_t flags, uint32_t *bytes, uint32_t *cycles)
+{
+	uint32_t start;
+	int i;
+
+	reset(flags);
+
+	for (i = 0; i < BENCH_MSGS; i++) {
+		LOG_INF("sample %d value %d name %s", i, -i, name);
+	}
+
+	start = k_cycle_get_32();
+	flush();
+	*cycles = k_cycle_get_32() - start;
+	*bytes = capture_len;
+}
+
+static void test_log_dictionary_vs_text(void)
+{
+	uint32_t text_bytes, text_cycles, dict_bytes, dict_cycles;
+
+	bench_run(LOG_OUTPUT_FLAG_LEVEL | LOG_OUTPUT_FLAG_TIMESTAMP,
+		  &text_bytes, &text_cycles);
+	bench_run(LOG_OUTPUT_FLAG_FORMAT_DICTIONARY, &dict_bytes,
+		  &dict_cycles);
+
+	TC_PRINT("text: %u B/msg, %u cycles/msg\n", text_bytes / BENCH_MSGS,
+		 text_cycles / BENCH_MSGS);
+	TC_PRINT("dictionary: %u B/msg, %u cycles/msg\n",
+		 dict_bytes / BENCH_MSGS, dict_cycles / BENCH_MSGS);
+
+	zassert_true(dict_bytes < text_bytes,
+		     "Dictionary output is not smaller than text");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_log_dictionary,
+			 ztest_unit_test(test_log_dictionary_std),
+			 ztest_unit_test(test_log_dictionary_hexdump),
+			 ztest_unit_test(test_log_dictionary_dropped),
+			 ztest_unit_test(test_log_dictionary_vs_text));
+	ztest_run_test_suite(test_log_dictionary);
+}
@@ -606,6 +606,93 @@ static void test_direct_loading_filter(void)
 	}
 }
 
+static void test_get_val(void)
+{
+	const struct test_loading_data *ldata;
+	const char *prefix = filtered_loader_settings.name;
+	char buffer[48];
+	char val[32];
+	int rc;
+
+	/* The newest of the duplicated values */
+	for (ldata = data_final; ldata->n; ++ldata) {
+		strcpy(buffer, prefix);
+		strcat(buffer, "/");
+		strcat(buffer, ldata->n);
+
+		memset(val, 0, sizeof(val));
+		rc = settings_get_val(buffer, val, sizeof(val));
+		zassert_equal(strlen(ldata->v) + 1, rc, "%s: %d", buffer, rc);
+		zassert_false(strcmp(ldata->v, val), "e: \"%s\", a:\"%s\"",
+			      ldata->v, val);
+	}
+
+	/* Truncated value */
+	memset(val, 0, sizeof(val));
+	rc = settings_get_val("filtered_test/val/1", val, 5);
+	zassert_equal(5, rc, NULL);
+	zassert_false(memcmp("final", val, 5), NULL);
+
+	rc = settings_get_val("val/2", val, sizeof(val));
+	zassert_equal(1, rc, NULL);
+	zassert_equal(23, val[0], NULL);
+
+	/* Deleted, missing, and parent of stored settings */
+	rc = settings_get_val("filtered_test/to_delete", val, sizeof(val));
+	zassert_equal(-ENOENT, rc, NULL);
+	rc = settings_get_val("filtered_test/val/5", val, sizeof(val));
+	zassert_equal(-ENOENT, rc, NULL);
+	rc = settings_get_val("filtered_test/val", val, sizeof(val));
+	zassert_equal(-ENOENT, rc, NULL);
+
+	rc = settings_get_val("val/2", val, 0);
+	zassert_equal(-EINVAL, rc, NULL);
+}
+
+static struct settings_handler lookup_settings[] = {
+	{ .name = "lookup" },
+	{ .name = "lookup/a" },
+	{ .name = "lookup/a/b/c" },
+};
+
+static void test_handler_lookup(void)
+{
+	struct settings_handler_static *handler;
+	const char *next;
+	int rc;
+
+	for (int i = 0; i < ARRAY_SIZE(lookup_settings); i++) {
+		rc = settings_register(&lookup_settings[i]);
+		zassert_true(rc == 0, NULL);
+	}
+
+	rc = settings_register(&lookup_settings[1]);
+	zassert_equal(-EEXIST, rc, NULL);
+
+	handler = settings_parse_and_lookup("lookup", &next);
+	zassert_equal_ptr(&lookup_settings[0], handler, NULL);
+	zassert_is_null(next, NULL);
+
+	handler = settings_parse_and_lookup("lookup/ab", &next);
+	zassert_equal_ptr(&lookup_settings[0], handler, NULL);
+	zassert_false(strcmp("ab", next), NULL);
+
+	handler = settings_parse_and_lookup("lookup/a/b", &next);
+	zassert_equal_ptr(&lookup_settings[1], handler, NULL);
+	zassert_false(strcmp("b", next), NULL);
+
+	handler = settings_parse_and_lookup("lookup/a=1", &next);
+	zassert_equal_ptr(&lookup_settings[1], handler, NULL);
+	zassert_is_null(next, NULL);
+
+	handler = settings_parse_and_lookup("lookup/a/b/c/d/e", &next);
+	zassert_equal_ptr(&lookup_settings[2], handler, NULL);
+	zassert_false(strcmp("d/e", next), NULL);
+
+	handler = settings_parse_and_lookup("lookups/a", &next);
+	zassert_is_null(handler, NULL);
+	zassert_is_null(next, NULL);
+}
 
 void test_main(void)
 {
@@ -614,7 +701,9 @@ void test_main(void)
 			 ztest_unit_test(test_support_rtn),
 			 ztest_unit_test(test_register_and_loading),
 			 ztest_unit_test(test_direct_loading),
-			 ztest_unit_test(test_direct_loading_filter)
+			 ztest_unit_test(test_direct_loading_filter),
+			 ztest_unit_test(test_get_val),
+			 ztest_unit_test(test_handler_lookup)
 			);
 
 	ztest_run_test_suite(settings_test_suite);
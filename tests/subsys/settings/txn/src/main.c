@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ztest.h>
+#include <settings/settings.h>
+#include <storage/flash_map.h>
+#include <stats/stats.h>
+
+#define TEST_KEYS 8
+#define TEST_OLD_VAL(i) (100U + (i))
+#define TEST_NEW_VAL(i) (200U + (i))
+
+extern bool settings_subsys_initialized;
+
+static uint32_t loaded[TEST_KEYS];
+
+static uint32_t *flash_write_calls;
+static uint32_t *flash_max_write_calls;
+
+static int txn_test_set(const char *name, size_t len,
+			settings_read_cb read_cb, void *cb_arg)
+{
+	unsigned long i;
+	char *end;
+
+	i = strtoul(name, &end, 10);
+	if ((*end != '\0') || (i >= TEST_KEYS) ||
+	    (len != sizeof(loaded[0]))) {
+		return -EINVAL;
+	}
+
+	if (read_cb(cb_arg, &loaded[i], len) != len) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(txn_test, "txn", NULL, txn_test_set, NULL,
+			       NULL);
+
+static int flash_sim_stat_find(struct stats_hdr *hdr, void *arg,
+			       const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_write_calls")) {
+		flash_write_calls = (uint32_t *)((uint8_t *)hdr + off);
+	} else if (!strcmp(name, "max_write_calls")) {
+		flash_max_write_calls = (uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+/* Pretend reset: initialize the settings from flash again. */
+static void settings_reinit(void)
+{
+	int rc;
+
+	settings_subsys_initialized = false;
+	rc = settings_subsys_init();
+	zassert_equal(rc, 0, "settings_subsys_init failed (%d)", rc);
+}
+
+static void storage_erase(void)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	zassert_equal(rc, 0, "flash_area_open failed (%d)", rc);
+
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	zassert_equal(rc, 0, "flash_area_erase failed (%d)", rc);
+
+	flash_area_close(fa);
+
+	settings_reinit();
+}
+
+static void keys_save(uint32_t val_base)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t val;
+	int rc;
+
+	for (int i = 0; i < TEST_KEYS; i++) {
+		snprintf(name, sizeof(name), "txn/%d", i);
+		val = val_base + i;
+		rc = settings_save_one(name, &val, sizeof(val));
+		zassert_equal(rc, 0, "settings_save_one failed (%d)", rc);
+	}
+}
+
+static void keys_load(void)
+{
+	int rc;
+
+	memset(loaded, 0, sizeof(loaded));
+	rc = settings_load_subtree("txn");
+	zassert_equal(rc, 0, "settings_load_subtree failed (%d)", rc);
+}
+
+static bool keys_equal(uint32_t val_base)
+{
+	for (int i = 0; i < TEST_KEYS; i++) {
+		if (loaded[i] != val_base + i) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void test_txn_setup(void)
+{
+	struct stats_hdr *hdr;
+
+	hdr = stats_group_find("flash_sim_stats");
+	zassert_not_null(hdr, "flash simulator stats not found");
+	stats_walk(hdr, flash_sim_stat_find, NULL);
+
+	hdr = stats_group_find("flash_sim_thresholds");
+	zassert_not_null(hdr, "flash simulator thresholds not found");
+	stats_walk(hdr, flash_sim_stat_find, NULL);
+
+	zassert_not_null(flash_write_calls, "flash_write_calls not found");
+	zassert_not_null(flash_max_write_calls, "max_write_calls not found");
+}
+
+static void test_txn_commit(void)
+{
+	uint32_t val;
+	int rc;
+
+	storage_erase();
+	keys_save(TEST_OLD_VAL(0));
+
+	rc = settings_txn_begin();
+	zassert_equal(rc, 0, "settings_txn_begin failed (%d)", rc);
+
+	rc = settings_txn_begin();
+	zassert_equal(rc, -EBUSY, "nested transaction not rejected (%d)", rc);
+
+	keys_save(TEST_NEW_VAL(0));
+
+	/* Nothing is written before the commit. */
+	rc = settings_get_val("txn/0", &val, sizeof(val));
+	zassert_equal(rc, sizeof(val), "settings_get_val failed (%d)", rc);
+	zassert_equal(val, TEST_OLD_VAL(0), "value written before commit");
+
+	rc = settings_delete("txn/1");
+	zassert_equal(rc, 0, "settings_delete failed (%d)", rc);
+
+	rc = settings_txn_commit();
+	zassert_equal(rc, 0, "settings_txn_commit failed (%d)", rc);
+
+	rc = settings_txn_commit();
+	zassert_equal(rc, -EINVAL, "commit without transaction (%d)", rc);
+
+	settings_reinit();
+	keys_load();
+	zassert_equal(loaded[0], TEST_NEW_VAL(0), "wrong value");
+	zassert_equal(loaded[1], 0U, "deleted setting loaded");
+	for (int i = 2; i < TEST_KEYS; i++) {
+		zassert_equal(loaded[i], TEST_NEW_VAL(i), "wrong value");
+	}
+}
+
+static void test_txn_abort(void)
+{
+	int rc;
+
+	storage_erase();
+	keys_save(TEST_OLD_VAL(0));
+
+	rc = settings_txn_begin();
+	zassert_equal(rc, 0, "settings_txn_begin failed (%d)", rc);
+
+	keys_save(TEST_NEW_VAL(0));
+
+	rc = settings_txn_abort();
+	zassert_equal(rc, 0, "settings_txn_abort failed (%d)", rc);
+
+	rc = settings_txn_abort();
+	zassert_equal(rc, -EINVAL, "abort without transaction (%d)", rc);
+
+	keys_load();
+	zassert_true(keys_equal(TEST_OLD_VAL(0)), "aborted values stored");
+}
+
+/* A setting which does not fit keeps its pending value. */
+static void test_txn_full(void)
+{
+	static uint8_t big[CONFIG_SETTINGS_TXN_BUF_SIZE];
+	int rc;
+
+	storage_erase();
+	keys_save(TEST_OLD_VAL(0));
+
+	rc = settings_txn_begin();
+	zassert_equal(rc, 0, "settings_txn_begin failed (%d)", rc);
+
+	keys_save(TEST_NEW_VAL(0));
+
+	rc = settings_save_one("txn/0", big, sizeof(big));
+	zassert_equal(rc, -ENOMEM, "oversized setting not rejected (%d)", rc);
+
+	rc = settings_txn_commit();
+	zassert_equal(rc, 0, "settings_txn_commit failed (%d)", rc);
+
+	keys_load();
+	zassert_true(keys_equal(TEST_NEW_VAL(0)), "pending value lost");
+}
+
+/* Flash writes of the stored settings saved individually and batched. */
+static void txn_flash_writes(int saves, uint32_t *individual,
+			     uint32_t *batched)
+{
+	int rc;
+
+	storage_erase();
+	keys_save(TEST_OLD_VAL(0));
+	*flash_write_calls = 0;
+	for (int i = 0; i < saves; i++) {
+		keys_save(TEST_NEW_VAL(i));
+	}
+	*individual = *flash_write_calls;
+
+	storage_erase();
+	keys_save(TEST_OLD_VAL(0));
+	*flash_write_calls = 0;
+	rc = settings_txn_begin();
+	zassert_equal(rc, 0, "settings_txn_begin failed (%d)", rc);
+	for (int i = 0; i < saves; i++) {
+		keys_save(TEST_NEW_VAL(i));
+	}
+	rc = settings_txn_commit();
+	zassert_equal(rc, 0, "settings_txn_commit failed (%d)", rc);
+	*batched = *flash_write_calls;
+
+	keys_load();
+	zassert_true(keys_equal(TEST_NEW_VAL(saves - 1)), "wrong values");
+}
+
+/*
+ * Settings saved once cost one journal record and its deletion more in a
+ * transaction, settings saved twice are written once instead of twice.
+ */
+static void test_txn_flash_writes(void)
+{
+	uint32_t individual, batched;
+
+	txn_flash_writes(1, &individual, &batched);
+	TC_PRINT("%d settings saved once: %u flash writes, %u in a "
+		 "transaction\n", TEST_KEYS, individual, batched);
+	zassert_true(batched > individual, "journal not written");
+
+	txn_flash_writes(2, &individual, &batched);
+	TC_PRINT("%d settings saved twice: %u flash writes, %u in a "
+		 "transaction\n", TEST_KEYS, individual, batched);
+	zassert_true(batched < individual, "settings written twice");
+}
+
+/*
+ * Cut the power at every flash write of a transaction: after the reset
+ * either all the old or all the new settings are loaded.
+ */
+static void test_txn_power_cut(void)
+{
+	uint8_t journal[16];
+	uint32_t cut = 0U;
+	bool done = false;
+	int rc;
+
+	while (!done) {
+		cut++;
+
+		storage_erase();
+		keys_save(TEST_OLD_VAL(0));
+
+		/* Writes from the cut-th one on are lost. */
+		*flash_max_write_calls = cut;
+		*flash_write_calls = 0;
+
+		rc = settings_txn_begin();
+		zassert_equal(rc, 0, "settings_txn_begin failed (%d)", rc);
+		keys_save(TEST_NEW_VAL(0));
+		(void)settings_txn_commit();
+
+		done = (*flash_write_calls < cut);
+		*flash_max_write_calls = 0;
+
+		settings_reinit();
+		keys_load();
+
+		zassert_true(keys_equal(TEST_OLD_VAL(0)) ||
+			     keys_equal(TEST_NEW_VAL(0)),
+			     "partial transaction after a cut at write %u",
+			     cut);
+		zassert_true(!done || keys_equal(TEST_NEW_VAL(0)),
+			     "transaction lost");
+
+		rc = settings_get_val("settings/txn", journal,
+				      sizeof(journal));
+		zassert_equal(rc, -ENOENT, "journal left after recovery");
+	}
+
+	TC_PRINT("power cut at each of %u flash writes\n", cut - 1);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(settings_txn,
+			 ztest_unit_test(test_txn_setup),
+			 ztest_unit_test(test_txn_commit),
+			 ztest_unit_test(test_txn_abort),
+			 ztest_unit_test(test_txn_full),
+			 ztest_unit_test(test_txn_flash_writes),
+			 ztest_unit_test(test_txn_power_cut)
+			);
+
+	ztest_run_test_suite(settings_txn);
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Shell UART transport with asynchronous transmission test suite
+ *
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+#include <drivers/uart.h>
+#include <shell/shell_uart.h>
+
+SHELL_UART_DEFINE(test_transport, 64, 16);
+
+static uart_callback_t fake_uart_cb;
+static void *fake_uart_cb_data;
+static int fake_uart_tx_err;
+static int fake_uart_tx_cnt;
+static uint8_t fake_uart_tx_buf[64];
+static size_t fake_uart_tx_len;
+
+static int fake_uart_callback_set(const struct device *dev,
+				  uart_callback_t callback, void *user_data)
+{
+	fake_uart_cb = callback;
+	fake_uart_cb_data = user_data;
+
+	return 0;
+}
+
+static int fake_uart_tx(const struct device *dev, const uint8_t *buf,
+			size_t len, int32_t timeout)
+{
+	fake_uart_tx_cnt++;
+
+	if (fake_uart_tx_err) {
+		return fake_uart_tx_err;
+	}
+
+	memcpy(fake_uart_tx_buf, buf, len);
+	fake_uart_tx_len = len;
+
+	return 0;
+}
+
+static int fake_uart_tx_abort(const struct device *dev)
+{
+	return 0;
+}
+
+static int fake_uart_poll_in(const struct device *dev, unsigned char *c)
+{
+	return -1;
+}
+
+static void fake_uart_poll_out(const struct device *dev, unsigned char c)
+{
+}
+
+static const struct uart_driver_api fake_uart_api = {
+	.callback_set = fake_uart_callback_set,
+	.tx = fake_uart_tx,
+	.tx_abort = fake_uart_tx_abort,
+	.poll_in = fake_uart_poll_in,
+	.poll_out = fake_uart_poll_out,
+};
+
+static int fake_uart_init(const struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_DEFINE(fake_uart, "FAKE_UART", fake_uart_init, device_pm_control_nop,
+	      NULL, NULL, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+	      &fake_uart_api);
+
+static void transport_handler(enum shell_transport_evt evt, void *context)
+{
+}
+
+static atomic_val_t tx_busy_get(void)
+{
+	const struct shell_uart *sh_uart = test_transport.ctx;
+
+	return atomic_get(&sh_uart->ctrl_blk->tx_busy);
+}
+
+static void transport_write(const char *str)
+{
+	size_t cnt;
+	int err;
+
+	err = test_transport.api->write(&test_transport, str, strlen(str),
+					&cnt);
+	zassert_equal(err, 0, "Unexpected write error %d", err);
+	zassert_equal(cnt, strlen(str), "Data not accepted");
+}
+
+/**
+ * Test that a failing uart_tx() drops the data and does not leave the
+ * transmission busy, so that the following output is still transmitted.
+ */
+static void test_uart_async_tx_error(void)
+{
+	const struct shell_uart *sh_uart = test_transport.ctx;
+	int err;
+
+	err = test_transport.api->init(&test_transport, DEVICE_GET(fake_uart),
+				       transport_handler, NULL);
+	zassert_equal(err, 0, "Unexpected init error %d", err);
+	zassert_not_null(fake_uart_cb, "UART callback not set");
+
+	fake_uart_tx_err = -EIO;
+	transport_write("dropped");
+
+	zassert_equal(fake_uart_tx_cnt, 1, "uart_tx not called");
+	zassert_true(ring_buf_is_empty(sh_uart->tx_ringbuf),
+		     "Rejected data not dropped");
+	zassert_equal(tx_busy_get(), 0, "Transmission stuck after error");
+
+	fake_uart_tx_err = 0;
+	transport_write("sent");
+
+	zassert_equal(fake_uart_tx_cnt, 2, "uart_tx not called after error");
+	zassert_equal(fake_uart_tx_len, strlen("sent"), "Wrong length");
+	zassert_mem_equal(fake_uart_tx_buf, "sent", strlen("sent"),
+			  "Wrong data");
+	zassert_equal(tx_busy_get(), 1, "Transmission not in progress");
+
+	struct uart_event evt = {
+		.type = UART_TX_DONE,
+		.data.tx.buf = fake_uart_tx_buf,
+		.data.tx.len = fake_uart_tx_len,
+	};
+
+	fake_uart_cb(DEVICE_GET(fake_uart), &evt, fake_uart_cb_data);
+
+	zassert_true(ring_buf_is_empty(sh_uart->tx_ringbuf),
+		     "Transmitted data not freed");
+	zassert_equal(tx_busy_get(), 0, "Transmission not finished");
+
+	(void)test_transport.api->uninit(&test_transport);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(shell_uart_async_test,
+			 ztest_unit_test(test_uart_async_tx_error));
+
+	ztest_run_test_suite(shell_uart_async_test);
+}
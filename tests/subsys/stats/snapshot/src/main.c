@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2021 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <stats/stats.h>
+#include <stats/stats_snapshot.h>
+#include "tinycbor/cbor.h"
+#include "tinycbor/cbor_buf_reader.h"
+
+#define MAX_VALUES 64
+#define BUF_SIZE 512
+#define BIG_CNT 16
+#define ENCODE_LOOPS 100
+
+STATS_SECT_START(test_a)
+STATS_SECT_ENTRY(a0)
+STATS_SECT_ENTRY(a1)
+STATS_SECT_ENTRY(a2)
+STATS_SECT_END;
+
+STATS_NAME_START(test_a)
+STATS_NAME(test_a, a0)
+STATS_NAME(test_a, a1)
+STATS_NAME(test_a, a2)
+STATS_NAME_END(test_a);
+
+STATS_SECT_START(test_b)
+STATS_SECT_ENTRY64(b0)
+STATS_SECT_ENTRY64(b1)
+STATS_SECT_END;
+
+STATS_NAME_START(test_b)
+STATS_NAME(test_b, b0)
+STATS_NAME(test_b, b1)
+STATS_NAME_END(test_b);
+
+/* Group of generically named entries, for the payload measurement. */
+STATS_SECT_START(test_big)
+STATS_SECT_ENTRY(e[BIG_CNT])
+STATS_SECT_END;
+
+STATS_NAME_START(test_big)
+STATS_NAME_END(test_big);
+
+static STATS_SECT_DECL(test_a) test_a;
+static STATS_SECT_DECL(test_b) test_b;
+static STATS_SECT_DECL(test_big) test_big;
+
+K_MEM_SLAB_DEFINE(test_slab, 16, 4, 4);
+
+STATS_SNAPSHOT_CTX_DEFINE(test_ctx, MAX_VALUES);
+
+static uint8_t buf[BUF_SIZE];
+
+struct snapshot {
+	uint64_t schema;
+	uint64_t seq;
+	uint64_t base;
+	bool full;
+	bool delta;
+	uint64_t items[MAX_VALUES * 2];
+	size_t item_cnt;
+};
+
+static void items_decode(CborValue *map, struct snapshot *s)
+{
+	CborValue arr;
+
+	zassert_true(cbor_value_is_array(map), "not an array");
+	zassert_equal(cbor_value_enter_container(map, &arr), CborNoError,
+		      "bad array");
+
+	while (!cbor_value_at_end(&arr)) {
+		zassert_true(s->item_cnt < ARRAY_SIZE(s->items),
+			     "too many items");
+		zassert_equal(cbor_value_get_uint64(&arr,
+						    &s->items[s->item_cnt++]),
+			      CborNoError, "bad item");
+		zassert_equal(cbor_value_advance_fixed(&arr), CborNoError,
+			      "bad item");
+	}
+
+	zassert_equal(cbor_value_leave_container(map, &arr), CborNoError,
+		      "bad array");
+}
+
+static void snapshot_decode(int len, struct snapshot *s)
+{
+	struct cbor_buf_reader reader;
+	CborParser parser;
+	CborValue value, map;
+	uint64_t key, val;
+
+	zassert_true(len > 0, "encoding failed: %d", len);
+
+	(void)memset(s, 0, sizeof(*s));
+	cbor_buf_reader_init(&reader, buf, len);
+	zassert_equal(cbor_parser_init(&reader.r, 0, &parser, &value),
+		      CborNoError, "bad snapshot");
+	zassert_true(cbor_value_is_map(&value), "not a map");
+	zassert_equal(cbor_value_enter_container(&value, &map), CborNoError,
+		      "bad map");
+
+	while (!cbor_value_at_end(&map)) {
+		zassert_equal(cbor_value_get_uint64(&map, &key), CborNoError,
+			      "bad key");
+		zassert_equal(cbor_value_advance_fixed(&map), CborNoError,
+			      "bad key");
+
+		if (key == STATS_SNAPSHOT_KEY_VALUES) {
+			s->full = true;
+			items_decode(&map, s);
+			continue;
+		} else if (key == STATS_SNAPSHOT_KEY_DELTA) {
+			s->delta = true;
+			items_decode(&map, s);
+			continue;
+		}
+
+		zassert_equal(cbor_value_get_uint64(&map, &val), CborNoError,
+			      "bad value");
+		zassert_equal(cbor_value_advance_fixed(&map), CborNoError,
+			      "bad value");
+
+		if (key == STATS_SNAPSHOT_KEY_SCHEMA) {
+			s->schema = val;
+		} else if (key == STATS_SNAPSHOT_KEY_SEQ) {
+			s->seq = val;
+		} else if (key == STATS_SNAPSHOT_KEY_BASE) {
+			s->base = val;
+		} else {
+			zassert_unreachable("unexpected key %u", (uint32_t)key);
+		}
+	}
+
+	zassert_true(s->full != s->delta, "bad snapshot kind");
+}
+
+static void encode(bool delta, struct snapshot *s)
+{
+	snapshot_decode(stats_snapshot_encode(&test_ctx, delta, buf,
+					      sizeof(buf)), s);
+}
+
+/* Index of the test slab usage among the snapshot values. */
+static uint16_t slab_idx(void)
+{
+	uint16_t cnt, slabs = 0U, idx = 0U;
+
+	Z_STRUCT_SECTION_FOREACH(k_mem_slab, slab) {
+		if (slab == &test_slab) {
+			idx = slabs;
+		}
+		slabs++;
+	}
+
+	(void)stats_snapshot_schema(&cnt);
+
+	return cnt - slabs + idx;
+}
+
+/**
+ * @brief Test a full snapshot
+ */
+static void test_full(void)
+{
+	struct snapshot s;
+	uint16_t cnt;
+
+	STATS_INCN(test_a, a1, 5);
+	STATS_INCN(test_a, a2, 7);
+
+	encode(false, &s);
+
+	zassert_equal(s.schema, stats_snapshot_schema(&cnt), "bad schema");
+	zassert_equal(s.item_cnt, cnt, "bad value count");
+	zassert_equal(s.items[0], test_a.a0, "bad a0");
+	zassert_equal(s.items[1], test_a.a1, "bad a1");
+	zassert_equal(s.items[2], test_a.a2, "bad a2");
+	zassert_equal(s.items[slab_idx()], test_slab.num_used, "bad slab");
+}
+
+/**
+ * @brief Test delta snapshots
+ */
+static void test_delta(void)
+{
+	struct snapshot s;
+	uint64_t seq;
+	void *block;
+
+	encode(false, &s);
+	seq = s.seq;
+
+	encode(true, &s);
+	zassert_true(s.delta, "not a delta");
+	zassert_equal(s.base, seq, "bad base");
+	zassert_equal(s.seq, seq + 1, "bad seq");
+	zassert_equal(s.item_cnt, 0, "unchanged values sent");
+
+	STATS_INC(test_a, a1);
+	zassert_equal(k_mem_slab_alloc(&test_slab, &block, K_NO_WAIT), 0,
+		      "alloc failed");
+
+	encode(true, &s);
+	zassert_true(s.delta, "not a delta");
+	zassert_equal(s.base, seq + 1, "bad base");
+	zassert_equal(s.item_cnt, 4, "bad changed values");
+	zassert_equal(s.items[0], 1, "bad index");
+	zassert_equal(s.items[1], test_a.a1, "bad value");
+	zassert_equal(s.items[2], slab_idx(), "bad index");
+	zassert_equal(s.items[3], test_slab.num_used, "bad value");
+
+	k_mem_slab_free(&test_slab, &block);
+}
+
+/**
+ * @brief Test that a new group changes the schema and resets the deltas
+ */
+static void test_schema_change(void)
+{
+	struct snapshot s;
+	uint32_t schema;
+	uint16_t cnt, new_cnt;
+
+	encode(false, &s);
+	schema = stats_snapshot_schema(&cnt);
+
+	zassert_equal(STATS_INIT_AND_REG(test_b, STATS_SIZE_64, "test_b"), 0,
+		      "register failed");
+	STATS_INCN(test_b, b1, 0x100000000ULL);
+
+	zassert_not_equal(stats_snapshot_schema(&new_cnt), schema,
+			  "schema not changed");
+	zassert_equal(new_cnt, cnt + 2, "bad value count");
+
+	encode(true, &s);
+	zassert_true(s.full, "delta across schemas");
+	zassert_equal(s.item_cnt, new_cnt, "bad value count");
+	zassert_equal(s.items[4], 0x100000000ULL, "bad 64-bit value");
+}
+
+/**
+ * @brief Test that a failed snapshot is not the base of a delta
+ */
+static void test_no_mem(void)
+{
+	struct snapshot s;
+
+	encode(false, &s);
+
+	STATS_INC(test_a, a0);
+	zassert_equal(stats_snapshot_encode(&test_ctx, true, buf, 4), -ENOMEM,
+		      "encoded in a too small buffer");
+
+	encode(true, &s);
+	zassert_true(s.full, "delta after a failure");
+	zassert_equal(s.items[0], test_a.a0, "bad a0");
+}
+
+/**
+ * @brief Test the schema encoding
+ */
+static void test_schema_encode(void)
+{
+	struct cbor_buf_reader reader;
+	CborParser parser;
+	CborValue value, map, groups, group;
+	uint64_t key, schema, cnt, total = 0U;
+	bool found = false, eq;
+	uint16_t schema_cnt;
+	int len;
+
+	len = stats_snapshot_schema_encode(buf, sizeof(buf));
+	zassert_true(len > 0, "encoding failed: %d", len);
+
+	cbor_buf_reader_init(&reader, buf, len);
+	zassert_equal(cbor_parser_init(&reader.r, 0, &parser, &value),
+		      CborNoError, "bad schema");
+	zassert_equal(cbor_value_enter_container(&value, &map), CborNoError,
+		      "bad map");
+
+	zassert_equal(cbor_value_get_uint64(&map, &key), CborNoError, "");
+	zassert_equal(key, STATS_SNAPSHOT_KEY_SCHEMA, "bad key");
+	zassert_equal(cbor_value_advance_fixed(&map), CborNoError, "");
+	zassert_equal(cbor_value_get_uint64(&map, &schema), CborNoError, "");
+	zassert_equal(schema, stats_snapshot_schema(&schema_cnt), "bad hash");
+	zassert_equal(cbor_value_advance_fixed(&map), CborNoError, "");
+
+	zassert_equal(cbor_value_get_uint64(&map, &key), CborNoError, "");
+	zassert_equal(key, STATS_SNAPSHOT_KEY_GROUPS, "bad key");
+	zassert_equal(cbor_value_advance_fixed(&map), CborNoError, "");
+	zassert_equal(cbor_value_enter_container(&map, &groups), CborNoError,
+		      "bad groups");
+
+	while (!cbor_value_at_end(&groups)) {
+		zassert_equal(cbor_value_enter_container(&groups, &group),
+			      CborNoError, "bad group");
+		zassert_equal(cbor_value_text_string_equals(&group, "test_a",
+							    &eq),
+			      CborNoError, "bad group name");
+		zassert_equal(cbor_value_advance(&group), CborNoError, "");
+		zassert_equal(cbor_value_get_uint64(&group, &cnt), CborNoError,
+			      "bad group count");
+		zassert_equal(cbor_value_advance_fixed(&group), CborNoError,
+			      "");
+		total += cnt;
+
+		if (eq) {
+			const char *names[] = { "a0", "a1", "a2" };
+
+			found = true;
+			zassert_equal(cnt, ARRAY_SIZE(names), "bad count");
+
+			for (int i = 0; i < ARRAY_SIZE(names); i++) {
+				/* Generated names without CONFIG_STATS_NAMES */
+				char gen[] = "s0";
+
+				gen[1] += i;
+				zassert_equal(cbor_value_text_string_equals(
+					&group, IS_ENABLED(CONFIG_STATS_NAMES) ?
+					names[i] : gen, &eq),
+					CborNoError, "");
+				zassert_true(eq, "bad name %d", i);
+				zassert_equal(cbor_value_advance(&group),
+					      CborNoError, "");
+			}
+		}
+
+		while (!cbor_value_at_end(&group)) {
+			zassert_equal(cbor_value_advance(&group), CborNoError,
+				      "");
+		}
+
+		zassert_equal(cbor_value_leave_container(&groups, &group),
+			      CborNoError, "bad group");
+	}
+
+	zassert_true(found, "test_a not found");
+	zassert_equal(total, schema_cnt, "bad value count");
+}
+
+/**
+ * @brief Measure the encoding time and payload size
+ *
+ * On native_posix the time is simulated, so only the sizes are meaningful
+ * there.
+ */
+static void test_measure(void)
+{
+	uint32_t start, full_cycles, delta_cycles;
+	int full_len, delta_len, schema_len;
+	uint16_t cnt;
+
+	zassert_equal(STATS_INIT_AND_REG(test_big, STATS_SIZE_32, "test_big"),
+		      0, "register failed");
+	(void)stats_snapshot_schema(&cnt);
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < ENCODE_LOOPS; i++) {
+		full_len = stats_snapshot_encode(&test_ctx, false, buf,
+						 sizeof(buf));
+	}
+	full_cycles = (k_cycle_get_32() - start) / ENCODE_LOOPS;
+
+	/* One counter changed between the snapshots. */
+	start = k_cycle_get_32();
+	for (int i = 0; i < ENCODE_LOOPS; i++) {
+		STATS_INC(test_big, e[i % BIG_CNT]);
+		delta_len = stats_snapshot_encode(&test_ctx, true, buf,
+						  sizeof(buf));
+	}
+	delta_cycles = (k_cycle_get_32() - start) / ENCODE_LOOPS;
+
+	schema_len = stats_snapshot_schema_encode(buf, sizeof(buf));
+
+	zassert_true(full_len > 0, "full encoding failed");
+	zassert_true(delta_len > 0 && delta_len < full_len,
+		     "bad delta encoding");
+	zassert_true(schema_len > full_len, "bad schema encoding");
+
+	TC_PRINT("%u values: schema %d B, full %d B %u cycles, "
+		 "delta %d B %u cycles\n", cnt, schema_len,
+		 full_len, full_cycles, delta_len, delta_cycles);
+}
+
+void test_main(void)
+{
+	zassert_equal(STATS_INIT_AND_REG(test_a, STATS_SIZE_32, "test_a"), 0,
+		      "register failed");
+
+	ztest_test_suite(stats_snapshot,
+			 ztest_unit_test(test_full),
+			 ztest_unit_test(test_delta),
+			 ztest_unit_test(test_schema_change),
+			 ztest_unit_test(test_no_mem),
+			 ztest_unit_test(test_schema_encode),
+			 ztest_unit_test(test_measure));
+	ztest_run_test_suite(stats_snapshot);
+}
@@ -34,6 +34,8 @@ static uint8_t *cb_buf;
 static size_t cb_len;
 static size_t cb_offset;
 static int cb_ret;
+static size_t progress_bytes;
+static int progress_calls;
 
 static uint8_t buf[BUF_LEN];
 static uint8_t read_buf[TESTBUF_SIZE];
@@ -62,6 +64,16 @@ int stream_flash_callback(uint8_t *buf, size_t len, size_t offset)
 	return cb_ret;
 }
 
+static void stream_flash_progress(struct stream_flash_ctx *sctx,
+				  size_t bytes_written)
+{
+	zassert_equal(sctx, &ctx, "incorrect context");
+	zassert_true(bytes_written > progress_bytes, "no progress");
+
+	progress_bytes = bytes_written;
+	progress_calls++;
+}
+
 static void erase_flash(void)
 {
 	int rc;
@@ -94,6 +106,8 @@ static void init_target(void)
 	cb_offset = 0;
 	cb_buf = NULL;
 	cb_ret = 0;
+	progress_bytes = 0;
+	progress_calls = 0;
 
 	erase_flash();
 
@@ -306,6 +320,25 @@ static void test_stream_flash_buffered_write_callback(void)
 	zassert_equal(rc, -EFAULT, "expected failure from callback");
 }
 
+static void test_stream_flash_progress(void)
+{
+	int rc;
+
+	init_target();
+	stream_flash_progress_cb_set(&ctx, stream_flash_progress);
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN * 2 + 128,
+					 false);
+	zassert_equal(rc, 0, "expected success");
+	zassert_equal(progress_calls, 2, "expected a call per buffer");
+	zassert_equal(progress_bytes, BUF_LEN * 2, "incorrect progress");
+
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, 0, "expected success");
+	zassert_equal(progress_calls, 3, "expected a call on flush");
+	zassert_equal(progress_bytes, BUF_LEN * 2 + 128, "incorrect progress");
+}
+
 static void test_stream_flash_flush(void)
 {
 	int rc;
@@ -375,6 +408,137 @@ static void test_stream_flash_buffered_write_whole_page(void)
 }
 #endif
 
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+static void test_stream_flash_async(void)
+{
+	int rc;
+
+	init_target();
+	stream_flash_progress_cb_set(&ctx, stream_flash_progress);
+
+	rc = stream_flash_async_enable(&ctx, 0);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_async_enable(&ctx, 0);
+	zassert_equal(rc, -EINVAL, "should fail as already enabled");
+
+	/* Three and a half halves of the buffer */
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN * 2 - 128,
+					 false);
+	zassert_equal(rc, 0, "expected success");
+
+	/* The flush waits for all the halves to be written */
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, 0, "expected success");
+	zassert_equal(stream_flash_bytes_written(&ctx), BUF_LEN * 2 - 128,
+		      "incorrect bytes written");
+	zassert_equal(progress_calls, 4, "expected a call per half");
+	zassert_equal(progress_bytes, BUF_LEN * 2 - 128, "incorrect progress");
+
+	VERIFY_WRITTEN(0, BUF_LEN * 2 - 128);
+	VERIFY_ERASED(BUF_LEN * 2 - 128, 128);
+
+	/* Writes continue after a flush */
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN, true);
+	zassert_equal(rc, 0, "expected success");
+	VERIFY_WRITTEN(0, BUF_LEN * 3 - 128);
+}
+
+static void test_stream_flash_async_callback(void)
+{
+	int rc;
+
+	init_target();
+
+	rc = stream_flash_async_enable(&ctx, 0);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN, true);
+	zassert_equal(rc, 0, "expected success");
+
+	/* A failing callback is reported by a later call */
+	cb_ret = -EFAULT;
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN / 2, false);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, -EFAULT, "expected failure from callback");
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN, true);
+	zassert_equal(rc, -EFAULT, "expected failure to be kept");
+
+	/* Data is rejected before the first call */
+	init_target();
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, 1, false);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_async_enable(&ctx, 0);
+	zassert_equal(rc, -EINVAL, "should fail as data is buffered");
+}
+
+#ifdef CONFIG_STREAM_FLASH_ERASE
+static void test_stream_flash_async_erase_ahead(void)
+{
+	int rc;
+
+	init_target();
+
+	/* Fill the pages following the first one */
+	rc = flash_write_protection_set(fdev, false);
+	zassert_equal(rc, 0, "should succeed");
+	rc = flash_write(fdev, FLASH_BASE + page_size, write_buf,
+			 page_size * (MAX_NUM_PAGES - 1));
+	zassert_equal(rc, 0, "should succeed");
+	rc = flash_write_protection_set(fdev, true);
+	zassert_equal(rc, 0, "should succeed");
+
+	rc = stream_flash_async_enable(&ctx, 2);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, BUF_LEN, false);
+	zassert_equal(rc, 0, "expected success");
+
+	/* Let the stream flash thread erase the next two pages */
+	k_sleep(K_MSEC(100));
+
+	VERIFY_WRITTEN(0, BUF_LEN);
+	VERIFY_ERASED(BUF_LEN, page_size * 3 - BUF_LEN);
+	VERIFY_WRITTEN(page_size * 3, page_size);
+
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, 0, "expected success");
+	VERIFY_WRITTEN(0, BUF_LEN);
+	VERIFY_WRITTEN(page_size * 3, page_size);
+}
+#else
+static void test_stream_flash_async_erase_ahead(void)
+{
+	int rc;
+
+	init_target();
+
+	rc = stream_flash_async_enable(&ctx, 2);
+	zassert_equal(rc, -ENOTSUP, "should fail as erase is disabled");
+}
+#endif /* CONFIG_STREAM_FLASH_ERASE */
+#else
+static void test_stream_flash_async(void)
+{
+	ztest_test_skip();
+}
+
+static void test_stream_flash_async_callback(void)
+{
+	ztest_test_skip();
+}
+
+static void test_stream_flash_async_erase_ahead(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_STREAM_FLASH_ASYNC */
+
 void test_main(void)
 {
 	fdev = device_get_binding(FLASH_NAME);
@@ -392,10 +556,14 @@ void test_main(void)
 	     ztest_unit_test(test_stream_flash_buffered_write_multi_page),
 	     ztest_unit_test(test_stream_flash_buf_size_greater_than_page_size),
 	     ztest_unit_test(test_stream_flash_buffered_write_callback),
+	     ztest_unit_test(test_stream_flash_progress),
 	     ztest_unit_test(test_stream_flash_flush),
 	     ztest_unit_test(test_stream_flash_buffered_write_whole_page),
 	     ztest_unit_test(test_stream_flash_erase_page),
-	     ztest_unit_test(test_stream_flash_bytes_written)
+	     ztest_unit_test(test_stream_flash_bytes_written),
+	     ztest_unit_test(test_stream_flash_async),
+	     ztest_unit_test(test_stream_flash_async_callback),
+	     ztest_unit_test(test_stream_flash_async_erase_ahead)
 	 );
 
 	ztest_run_test_suite(lib_stream_flash_test);